@@ -53,9 +53,11 @@ static uint8_t border_in_front = False;	/**< Kennung fuer Abgrund voraus */
 
 #define GROUND_GOAL_DEF      GROUND_GOAL
 
+#ifndef NEURALNET_FIXED_AVAILABLE
 static uint8_t append_learnpattern = False;	/**< Kennung ob Lernpattern dem Lernarray zugefuegt werden soll oder nicht */
 static uint8_t teachout0 = 0;	/**< Belegungen der Output-Neuronen beim Speichern der Patterns */
 static uint8_t teachout1 = 0;
+#endif
 
 /** Array zum Speichern der Belegungen der einzelnen Sektoren; Werte werden im
  * Wertebereich 0-1 gespeichert als Reziproke der Entfernung, d.h. umso weiter weg ein
@@ -399,6 +401,7 @@ void bot_check_sector_behaviour(Behaviour_t * data) {
 		break;
 
 	default:
+#ifndef NEURALNET_FIXED_AVAILABLE
 		// Abspeichern des Lernpatterns wenn bei Aufruf des Verhaltens gewuenscht
 		if (append_learnpattern) {
 			//LOG_DEBUG("Pattern gespeichert in NN index %u , Outputs: %u  %u", no_of_pairs, teachout0, teachout1);
@@ -409,6 +412,7 @@ void bot_check_sector_behaviour(Behaviour_t * data) {
 				bot_simple_drivewish(NULL, bot_wish_action);
 			}
 		}
+#endif // ! NEURALNET_FIXED_AVAILABLE
 
 		return_from_behaviour(data);
 		break;
@@ -421,12 +425,15 @@ void bot_check_sector_behaviour(Behaviour_t * data) {
  * \param *caller	Verhaltensdatensatz
  */
 void bot_check_sectors(Behaviour_t * caller) {
+#ifndef NEURALNET_FIXED_AVAILABLE
 	append_learnpattern = False;
+#endif
 	switch_to_behaviour(caller, bot_check_sector_behaviour, BEHAVIOUR_OVERRIDE);
 	check_sector_state = 0;
 	bot_wish_action = 0;
 }
 
+#ifndef NEURALNET_FIXED_AVAILABLE
 /**
  * Verhalten analog oben, jedoch zusaetzliche Parameter mitgegeben zum Ausfuehren und Speichern eines Patterns
  * der Wunschaktion im neur. Netz
@@ -449,8 +456,9 @@ void bot_check_sectors_savepattern(Behaviour_t * caller, uint8_t out0, uint8_t o
 		bot_wish_action = wishaction;
 	}
 }
+#endif // ! NEURALNET_FIXED_AVAILABLE
 
-#ifdef DISPLAY_DRIVE_NEURALNET_AVAILABLE
+#if defined DISPLAY_DRIVE_NEURALNET_AVAILABLE && ! defined NEURALNET_FIXED_AVAILABLE	// Lernen neuer Patterns nur mit dem float-Netz
 
 /**
  * Aus der Botaktion heraus wird die Belegung der binaeren Outputwerte der Ausgangsneuronen zurueckgegeben
@@ -565,6 +573,6 @@ void neuralnet_learn_display(void) {
 	neuralnet_learn_disp_key_handler();	// Aufrufen des Key-Handlers
 }
 
-#endif // DISPLAY_DRIVE_NEURALNET_AVAILABLE
+#endif // DISPLAY_DRIVE_NEURALNET_AVAILABLE && ! NEURALNET_FIXED_AVAILABLE
 
 #endif // BEHAVIOUR_DRIVE_NEURALNET_AVAILABLE
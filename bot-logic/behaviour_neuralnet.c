@@ -32,7 +32,14 @@
 #include <stdlib.h>
 #include <timer.h>
 #ifdef PC
+#include <stdio.h>
+#include <math.h>
 #include <time.h>
+#include <sys/time.h>
+#include <string.h>
+#endif
+#ifdef NEURALNET_PARALLEL_AVAILABLE
+#include <pthread.h>
 #endif
 
 #include "ui/available_screens.h"
@@ -41,14 +48,18 @@
 #include "log.h"
 
 #include "lwneuralnet.h"
+#include "neuralnet_fixed.h"
 
+#ifndef NEURALNET_FIXED_AVAILABLE
 uint16_t max_trainings;	/**< max. Anzahl der Lern-Iterationen; temporaer gesetzt */
 
 static uint8_t neuralnet_state = 0;	/**< Status des neuralnet-Verhaltens */
 
 #define STATE_NEURALNET_INIT 0	/**< die Verhaltens-Zustaende */
 #define STATE_NEURALNET_WORK 1
+#define STATE_NEURALNET_PARALLEL 2
 #define STATE_NEURALNET_DONE 3
+#endif // ! NEURALNET_FIXED_AVAILABLE
 
 //#define DEBUG_BEHAVIOUR_NN	/**<  Schalter fuer Debug-Code */
 #ifndef LOG_AVAILABLE
@@ -59,6 +70,7 @@ static uint8_t neuralnet_state = 0;	/**< Status des neuralnet-Verhaltens */
 #define LOG_DEBUG(a, ...) {}
 #endif
 
+#if ! defined NEURALNET_FIXED_AVAILABLE || defined PC
 /**
  * hier einige vordefinierte Lernpatterns fuer die 6 Input-Neuronen und die zugehoerigen 2 Output-Neuronen mit folgender Bedeutung an den 6 Indexstellen:
  * Es erfolgt eine Unterteilung in 3 Sektoren jeweils links vom Bot, gradeaus und rechts vom Bot und fuer diese Sektoren gibt es jeweils
@@ -99,7 +111,11 @@ static float targets_def[NO_PAIRS][NO_OUTPUT_NEURONS] = { { 1, 1 }, { 1, 1 },	/*
 	{ 0, 1 },	/**< nach rechts fahren */
 	{ 1, 0 },	/**< ... */
 	{ 1, 1 }, { 0, 1 }, { 1, 0 }, { 0, 1 }, { 1, 0 } };
+#endif // ! NEURALNET_FIXED_AVAILABLE || PC
 
+#ifdef NEURALNET_FIXED_AVAILABLE
+static uint8_t outputarr_q[NO_OUTPUT_NEURONS];	/**< Netz-Rueckgabewerte des Festkomma-Netzes, NNQ_ONE entspricht 1.0 */
+#else
 uint16_t no_of_pairs = NO_PAIRS;	/**< Anzahl der vorkommenden Testpaare */
 
 static float inputs[NO_PAIRS][NO_INPUT_NEURONS];	/**< hier werden die zu erlernenden Patterns fuer das Netz gespeichert */
@@ -158,6 +174,7 @@ void fill_pattern_in_lernarray(float *sectorarray, uint16_t index, uint8_t out0,
 	targets[index][1] = out1;
 }
 #endif // BEHAVIOUR_DRIVE_NEURALNET_AVAILABLE
+#endif // NEURALNET_FIXED_AVAILABLE
 
 /**
  * Testen des NN Netzes mit den Sektor-Eingabewerten, die normalisiert sein muessen im Wertebereich 0-1
@@ -168,6 +185,13 @@ void fill_pattern_in_lernarray(float *sectorarray, uint16_t index, uint8_t out0,
 void test_net(float *sectorarray) {
 	uint8_t i;
 
+#ifdef NEURALNET_FIXED_AVAILABLE
+	uint8_t input[NO_INPUT_NEURONS];
+	for (i = 0; i < NO_INPUT_NEURONS; i++)
+		input[i] = nnq_from_float(sectorarray[i]);
+
+	nnq_compute(nnq_net_data, input, outputarr_q);
+#else
 	// zum Testen des Netzwerks
 	static float testinputs[1][NO_INPUT_NEURONS] = { { 0, 0, 0, 0, 0, 0 } };
 
@@ -175,6 +199,7 @@ void test_net(float *sectorarray) {
 		testinputs[0][i] = sectorarray[i];
 
 	net_compute(net, testinputs[0], outputarr);
+#endif // NEURALNET_FIXED_AVAILABLE
 }
 
 /**
@@ -191,10 +216,16 @@ void test_net(float *sectorarray) {
  * */
 void net_get_test_out(uint8_t *out1, uint8_t *out2) {
 	// die berechneten IST-Outputwerte digitalisieren auf 0 oder 1
+#ifdef NEURALNET_FIXED_AVAILABLE
+	*out1 = (outputarr_q[0] < NNQ_ONE / 2) ? 0 : 1;
+	*out2 = (outputarr_q[1] < NNQ_ONE / 2) ? 0 : 1;
+#else
 	*out1 = (outputarr[0] < 0.5f) ? 0 : 1;
 	*out2 = (outputarr[1] < 0.5f) ? 0 : 1;
+#endif
 }
 
+#ifndef NEURALNET_FIXED_AVAILABLE
 /**
  *  Initialzustand mit den vordefinierten Inputpatterns und deren Teachoutput wiederherstellen
  */
@@ -259,6 +290,153 @@ void net_init(void) {
 	no_of_pairs = 0;	// nix im Array, total leer
 }
 
+#ifdef NEURALNET_PARALLEL_AVAILABLE
+/** Daten des parallelen Trainings; die Threads arbeiten nur mit ihren Netzen und einer Kopie der Patterns */
+static struct {
+	network_t * nets[NEURALNET_PARALLEL_STARTS];	/**< Netze, eins je Zufallsstartwert */
+	float errors[NEURALNET_PARALLEL_STARTS];		/**< Fehler der Netze nach dem Training */
+	float inputs[NO_PAIRS][NO_INPUT_NEURONS];		/**< Kopie der Lernpatterns */
+	float targets[NO_PAIRS][NO_OUTPUT_NEURONS];		/**< Kopie der Ziel-Outputs */
+	uint16_t pairs;									/**< Anzahl der Lernpatterns */
+	float learning_rate;							/**< Lernrate fuer das Training nach jedem Pattern */
+	pthread_t threads[NEURALNET_PARALLEL_THREADS];	/**< Trainings-Threads */
+	uint8_t joinable[NEURALNET_PARALLEL_THREADS];	/**< 1, falls der Thread gestartet wurde */
+	uint8_t no_of_threads;							/**< Anzahl der Threads des laufenden Trainings */
+	uint8_t finished;								/**< Anzahl der fertigen Threads (atomar) */
+	uint8_t running;								/**< 1, solange ein Training laeuft */
+	uint8_t requested;								/**< 1, falls das Verhalten per bot_neuralnet_multi() gestartet wurde */
+} nn_parallel;
+
+/**
+ * Batch-Training eines Netzes ueber alle Patterns, bis der Fehler unter ERROR_THRESHOLD liegt
+ * \param *n			Netz
+ * \param (*in)[]		Lernpatterns
+ * \param (*tg)[]		Ziel-Outputs
+ * \param pairs			Anzahl der Lernpatterns
+ * \param max_epochs	max. Anzahl Epochen
+ * \return				Fehler der letzten Epoche (Mittelwert ueber alle Patterns)
+ */
+static float net_train_epochs(network_t * n, float (* in)[NO_INPUT_NEURONS], float (* tg)[NO_OUTPUT_NEURONS], uint16_t pairs,
+		uint32_t max_epochs) {
+	float out[NO_OUTPUT_NEURONS];
+	float err = 1.f;
+	uint32_t e;
+	for (e = 0; e < max_epochs && err >= ERROR_THRESHOLD; ++e) {
+		uint16_t i;
+		err = 0.f;
+		net_begin_batch(n);
+		for (i = 0; i < pairs; ++i) {
+			net_compute(n, in[i], out);
+			err += net_compute_output_error(n, tg[i]);
+			net_train_batch(n);
+		}
+		net_end_batch(n);
+		err /= pairs;
+	}
+	return err;
+}
+
+/**
+ * Trainings-Thread, trainiert die Netze arg, arg + no_of_threads, ...
+ * \param arg	Nummer des Threads
+ * \return		NULL
+ */
+static void * neuralnet_parallel_thread(void * arg) {
+	uint8_t s;
+	for (s = (uint8_t) (uintptr_t) arg; s < NEURALNET_PARALLEL_STARTS; s = (uint8_t) (s + nn_parallel.no_of_threads)) {
+		nn_parallel.errors[s] = net_train_epochs(nn_parallel.nets[s], nn_parallel.inputs, nn_parallel.targets, nn_parallel.pairs,
+			NEURALNET_PARALLEL_EPOCHS);
+	}
+	__atomic_add_fetch(&nn_parallel.finished, 1, __ATOMIC_RELEASE);
+	return NULL;
+}
+
+/**
+ * Startet das parallele Training von NEURALNET_PARALLEL_STARTS Netzen. Die Netze werden hier mit rand() initialisiert,
+ * der Zufallsgenerator muss also vorher initialisiert sein.
+ * \param (*in)[]	Lernpatterns
+ * \param (*tg)[]	Ziel-Outputs
+ * \param pairs		Anzahl der Lernpatterns (1 bis NO_PAIRS)
+ * \param *base		Netz, dessen Kopie als erstes Netz weitertrainiert wird, oder NULL
+ * \param threads	Anzahl der Threads (1 bis NEURALNET_PARALLEL_THREADS)
+ * \return			0, falls das Training laeuft; -1 kein Speicher
+ */
+static int8_t neuralnet_parallel_start(float (* in)[NO_INPUT_NEURONS], float (* tg)[NO_OUTPUT_NEURONS], uint16_t pairs,
+		const network_t * base, uint8_t threads) {
+	uint8_t s;
+	for (s = 0; s < NEURALNET_PARALLEL_STARTS; ++s) {
+		nn_parallel.nets[s] = s == 0 && base ? net_copy(base) : net_allocate(NO_LAYERS, NO_INPUT_NEURONS, NO_HIDDEN_NEURONS,
+			NO_OUTPUT_NEURONS);
+		if (! nn_parallel.nets[s]) {
+			while (s > 0) {
+				net_free(nn_parallel.nets[--s]);
+			}
+			return -1;
+		}
+	}
+	memcpy(nn_parallel.inputs, in, pairs * sizeof(nn_parallel.inputs[0]));
+	memcpy(nn_parallel.targets, tg, pairs * sizeof(nn_parallel.targets[0]));
+	nn_parallel.pairs = pairs;
+
+	/* Beim Batch-Training werden die Gewichte nur einmal je Epoche mit dem Mittelwert ueber alle Patterns angepasst,
+	 * daher die Lernrate mit der Anzahl der Patterns skalieren */
+	nn_parallel.learning_rate = net_get_learning_rate(nn_parallel.nets[0]);
+	for (s = 0; s < NEURALNET_PARALLEL_STARTS; ++s) {
+		net_set_learning_rate(nn_parallel.nets[s], nn_parallel.learning_rate * pairs);
+	}
+
+	nn_parallel.no_of_threads = threads;
+	nn_parallel.finished = 0;
+	nn_parallel.running = 1;
+	uint8_t i;
+	for (i = 0; i < threads; ++i) {
+		nn_parallel.joinable[i] = pthread_create(&nn_parallel.threads[i], NULL, neuralnet_parallel_thread, (void *) (uintptr_t) i) == 0;
+		if (! nn_parallel.joinable[i]) {
+			LOG_DEBUG("pthread_create() fehlgeschlagen, trainiere ohne Thread");
+			neuralnet_parallel_thread((void *) (uintptr_t) i);
+		}
+	}
+	return 0;
+}
+
+/**
+ * Prueft, ob alle Threads des parallelen Trainings fertig sind
+ * \return	1, falls fertig
+ */
+static uint8_t neuralnet_parallel_done(void) {
+	return __atomic_load_n(&nn_parallel.finished, __ATOMIC_ACQUIRE) >= nn_parallel.no_of_threads;
+}
+
+/**
+ * Wartet auf das Ende des parallelen Trainings und gibt das Netz mit dem kleinsten Fehler zurueck, alle anderen
+ * Netze werden freigegeben
+ * \param *best_error	Fehler des zurueckgegebenen Netzes
+ * \return				Netz mit dem kleinsten Fehler
+ */
+static network_t * neuralnet_parallel_finish(float * best_error) {
+	uint8_t i, best = 0;
+	for (i = 0; i < nn_parallel.no_of_threads; ++i) {
+		if (nn_parallel.joinable[i]) {
+			pthread_join(nn_parallel.threads[i], NULL);
+		}
+	}
+	for (i = 1; i < NEURALNET_PARALLEL_STARTS; ++i) {
+		if (nn_parallel.errors[i] < nn_parallel.errors[best]) {
+			best = i;
+		}
+	}
+	for (i = 0; i < NEURALNET_PARALLEL_STARTS; ++i) {
+		if (i != best) {
+			net_free(nn_parallel.nets[i]);
+		}
+	}
+	net_set_learning_rate(nn_parallel.nets[best], nn_parallel.learning_rate);
+	*best_error = nn_parallel.errors[best];
+	nn_parallel.running = 0;
+	return nn_parallel.nets[best];
+}
+#endif // NEURALNET_PARALLEL_AVAILABLE
+
 /**
  * Das neuralnet-Verhalten selbst, das Netz wird mit den Inputpatterns im input-Array trainiert
  * bis zum maximalen Zaehlerwert in max_trainings
@@ -267,6 +445,13 @@ void net_init(void) {
 void bot_neuralnet_behaviour(Behaviour_t* data) {
 	switch (neuralnet_state) {
 	case STATE_NEURALNET_INIT:
+#ifdef NEURALNET_PARALLEL_AVAILABLE
+		if (nn_parallel.running) {
+			// Training laeuft noch, erst dessen Ergebnis abwarten
+			neuralnet_state = STATE_NEURALNET_PARALLEL;
+			break;
+		}
+#endif
 		neuralnet_state = STATE_NEURALNET_WORK; //1
 
 		// Falls bei Start sofort active, dann muss ohne Botenfunktion der Wert gesetzt werden
@@ -287,6 +472,15 @@ void bot_neuralnet_behaviour(Behaviour_t* data) {
 		}
 		total_error = 0;
 		t = 0;
+
+#ifdef NEURALNET_PARALLEL_AVAILABLE
+		// Multi-Start-Training in Threads nur auf Anforderung, sonst wie bisher eine Epoche je Verhaltensdurchlauf
+		if (nn_parallel.requested && max_trainings > 1 && no_of_pairs > 0
+				&& neuralnet_parallel_start(inputs, targets, no_of_pairs, net, NEURALNET_PARALLEL_THREADS) == 0) {
+			neuralnet_state = STATE_NEURALNET_PARALLEL;
+		}
+		nn_parallel.requested = 0;
+#endif
 		break;
 
 	case STATE_NEURALNET_WORK:
@@ -321,6 +515,20 @@ void bot_neuralnet_behaviour(Behaviour_t* data) {
 		}
 		break;
 
+#ifdef NEURALNET_PARALLEL_AVAILABLE
+	case STATE_NEURALNET_PARALLEL:
+		if (neuralnet_parallel_done()) {
+			// bestes Netz uebernehmen, das Fahrverhalten arbeitet danach damit
+			network_t * best = neuralnet_parallel_finish(&total_error);
+			if (net != NULL) {
+				net_free(net);
+			}
+			net = best;
+			neuralnet_state = STATE_NEURALNET_DONE;
+		}
+		break;
+#endif // NEURALNET_PARALLEL_AVAILABLE
+
 	default:
 #ifdef DEBUG_BEHAVIOUR_NN
 		LOG_DEBUG("Number of training performed: %i (max %i)\n", t, max_trainings);
@@ -356,6 +564,19 @@ void bot_neuralnet(Behaviour_t * caller) {
 	}
 }
 
+#ifdef NEURALNET_PARALLEL_AVAILABLE
+/**
+ * Ruft das neuralnet-Verhalten auf, das Netz wird im Hintergrund per Multi-Start-Training in Threads trainiert:
+ * NEURALNET_PARALLEL_STARTS Netze (eins davon eine Kopie des aktuellen Netzes) lernen per Batch-Training ueber alle
+ * Patterns, das Netz mit dem kleinsten Fehler wird uebernommen
+ * \param *caller	Verhaltensdatensatz
+ */
+void bot_neuralnet_multi(Behaviour_t * caller) {
+	bot_neuralnet(caller);
+	nn_parallel.requested = (uint8_t) (no_of_pairs > 0);
+}
+#endif // NEURALNET_PARALLEL_AVAILABLE
+
 /**
  * Ruft das neuralnet-Verhalten auf, wobei das Netz nur 1x durchlaufen wird zur Fehlerermittlung
  * \param *caller	Der obligatorische Verhaltensdatensatz des Aufrufers
@@ -368,6 +589,266 @@ void net_check_one_step(Behaviour_t * caller) {
 		neuralnet_state = STATE_NEURALNET_INIT;
 	}
 }
+#endif // ! NEURALNET_FIXED_AVAILABLE
+
+#ifdef PC
+/**
+ * Misst die Trainingsgeschwindigkeit mit den vordefinierten Patterns (inputs_def / targets_def), einmal
+ * mit der Netzgroesse des Verhaltens und einmal mit einer breiten Hidden-Schicht, jeweils mit Training
+ * nach jedem Pattern (wie bot_neuralnet_behaviour()) und als Batch-Training ueber alle Patterns
+ * \param epochs	Anzahl der Epochen (Durchlaeufe ueber alle Patterns) je Netz und Variante
+ */
+void neuralnet_benchmark(uint32_t epochs) {
+	static const int hidden[] = { NO_HIDDEN_NEURONS, 64 };
+	float out[NO_OUTPUT_NEURONS];
+	uint8_t h;
+
+	printf("Neuronales Netz: %" PRIu32 " Epochen mit %u Patterns\n", epochs, NO_PAIRS);
+	for (h = 0; h < sizeof(hidden) / sizeof(hidden[0]); ++h) {
+		uint64_t t_us[2];
+		float err[2];
+		uint8_t batch;
+		for (batch = 0; batch < 2; ++batch) {
+			srand(1);
+			network_t * bench_net = net_allocate(NO_LAYERS, NO_INPUT_NEURONS, hidden[h], NO_OUTPUT_NEURONS);
+			if (! bench_net) {
+				return;
+			}
+			struct timeval start, now;
+			gettimeofday(&start, NULL);
+			uint32_t e;
+			for (e = 0; e < epochs; ++e) {
+				uint16_t i;
+				err[batch] = 0.f;
+				if (batch) {
+					net_begin_batch(bench_net);
+				}
+				for (i = 0; i < NO_PAIRS; ++i) {
+					net_compute(bench_net, inputs_def[i], out);
+					err[batch] += net_compute_output_error(bench_net, targets_def[i]);
+					if (batch) {
+						net_train_batch(bench_net);
+					} else {
+						net_train(bench_net);
+					}
+				}
+				if (batch) {
+					net_end_batch(bench_net);
+				}
+			}
+			gettimeofday(&now, NULL);
+			t_us[batch] = (uint64_t) (now.tv_sec - start.tv_sec) * 1000000ULL + (uint64_t) now.tv_usec - (uint64_t) start.tv_usec;
+			if (t_us[batch] == 0) {
+				t_us[batch] = 1;
+			}
+			err[batch] /= NO_PAIRS;
+			net_free(bench_net);
+		}
+
+		printf("%d-%2d-%d  einzeln %9.0f Epochen/s (Fehler %.5f), Batch %9.0f Epochen/s (Fehler %.5f)\n",
+			NO_INPUT_NEURONS, hidden[h], NO_OUTPUT_NEURONS, (double) epochs * 1e6 / (double) t_us[0], (double) err[0],
+			(double) epochs * 1e6 / (double) t_us[1], (double) err[1]);
+	}
+}
+
+/**
+ * Prueft das Festkomma-Netz (neuralnet_fixed.h) gegen das float-Netz: trainiert Netze mit den vordefinierten
+ * Patterns, speichert sie mit net_bsave(), quantisiert sie mit nnq_load_bsave() und vergleicht die Entscheidungen;
+ * prueft die Ausgaben des Netzes aus neuralnet_fixed_data.inc gegen Referenzwerte und misst die Inferenzzeit
+ * \param runs	Anzahl der Durchlaeufe ueber alle Patterns fuer die Zeitmessung
+ * \return		0 falls alles OK, 1 falls Fehler
+ */
+int8_t neuralnet_fixed_benchmark(uint32_t runs) {
+	/* Ausgaben des Netzes aus neuralnet_fixed_data.inc fuer inputs_def, nach "ct-Bot -Q" neu eintragen */
+	static const uint8_t expected[NO_PAIRS][NO_OUTPUT_NEURONS] = {
+		{ 128, 128 }, { 128, 126 }, { 124, 4 }, { 127, 0 }, { 126, 128 }, { 128, 128 }, { 0, 128 }, { 4, 5 },
+		{ 0, 128 }, { 127, 0 }, { 123, 124 }, { 3, 123 }, { 127, 1 }, { 2, 128 }, { 128, 1 }
+	};
+	static const char bsave_name[] = "nn-bench.bin";
+	static uint8_t q_net[NNQ_MAX_SIZE];
+	uint8_t q_in[NO_PAIRS][NO_INPUT_NEURONS];
+	uint8_t q_out[NO_OUTPUT_NEURONS];
+	float out[NO_OUTPUT_NEURONS];
+	uint16_t i, j;
+
+	for (i = 0; i < NO_PAIRS; ++i) {
+		for (j = 0; j < NO_INPUT_NEURONS; ++j) {
+			q_in[i][j] = nnq_from_float(inputs_def[i][j]);
+		}
+	}
+
+	/* Netze wie bot_neuralnet_behaviour() trainieren, ueber net_bsave() / nnq_load_bsave() quantisieren und vergleichen */
+	int8_t result = 0;
+	float best_error = 1.f;
+	unsigned seed;
+	for (seed = 1; seed <= 10; ++seed) {
+		srand(seed);
+		network_t * bench_net = net_allocate(NO_LAYERS, NO_INPUT_NEURONS, NO_HIDDEN_NEURONS, NO_OUTPUT_NEURONS);
+		float err = 0.f;
+		uint16_t epoch;
+		for (epoch = 0; epoch < 10 * MAX_TRAINING_DEF && (epoch == 0 || err >= ERROR_THRESHOLD); ++epoch) {
+			float e = 0.f;
+			for (i = 0; i < NO_PAIRS; ++i) {
+				net_compute(bench_net, inputs_def[i], out);
+				e += net_compute_output_error(bench_net, targets_def[i]);
+				net_train(bench_net);
+			}
+			err = epoch == 0 ? e / NO_PAIRS : 0.9f * err + 0.1f * e / NO_PAIRS;
+		}
+		if (net_bsave("nn-bench.tmp", bench_net) != 0 || nnq_load_bsave("nn-bench.tmp", q_net, sizeof(q_net)) < 0) {
+			printf("Fehler beim Speichern / Quantisieren des Netzes\n");
+			net_free(bench_net);
+			return 1;
+		}
+		uint8_t same = 0, correct = 0;
+		float max_diff = 0.f;
+		for (i = 0; i < NO_PAIRS; ++i) {
+			net_compute(bench_net, inputs_def[i], out);
+			nnq_compute(q_net, q_in[i], q_out);
+			uint8_t same_all = 1, correct_all = 1;
+			for (j = 0; j < NO_OUTPUT_NEURONS; ++j) {
+				const uint8_t d_float = out[j] < 0.5f ? 0 : 1;
+				const uint8_t d_fixed = q_out[j] < NNQ_ONE / 2 ? 0 : 1;
+				same_all = (uint8_t) (same_all && d_float == d_fixed);
+				correct_all = (uint8_t) (correct_all && d_fixed == (uint8_t) targets_def[i][j]);
+				const float diff = fabsf(out[j] - (float) q_out[j] / NNQ_ONE);
+				if (diff > max_diff) {
+					max_diff = diff;
+				}
+			}
+			same = (uint8_t) (same + same_all);
+			correct = (uint8_t) (correct + correct_all);
+		}
+		printf("Seed %2u: %5u Epochen, Fehler %.5f, Entscheidungen float = Festkomma %2u/%u, korrekt %2u/%u, max. Abweichung %.4f%s\n",
+			seed, epoch, (double) err, same, NO_PAIRS, correct, NO_PAIRS, (double) max_diff, same == NO_PAIRS ? "" : " FEHLER");
+		if (same != NO_PAIRS) {
+			result = 1;
+		}
+		if (err < best_error) {
+			best_error = err;
+			rename("nn-bench.tmp", bsave_name);
+		}
+		net_free(bench_net);
+	}
+	remove("nn-bench.tmp");
+	printf("Bestes Netz in \"%s\", Konvertierung mit \"ct-Bot -Q %s\"\n", bsave_name, bsave_name);
+
+	/* Netz aus dem Flash: Ausgaben sind die Referenz fuer den Bot (gleiche Ganzzahl-Rechnung) */
+	uint8_t correct = 0, matches = 0;
+	printf("neuralnet_fixed_data.inc:");
+	for (i = 0; i < NO_PAIRS; ++i) {
+		nnq_compute(nnq_net_data, q_in[i], q_out);
+		uint8_t correct_all = 1;
+		for (j = 0; j < NO_OUTPUT_NEURONS; ++j) {
+			correct_all = (uint8_t) (correct_all && (q_out[j] < NNQ_ONE / 2 ? 0 : 1) == (uint8_t) targets_def[i][j]);
+		}
+		correct = (uint8_t) (correct + correct_all);
+		matches = (uint8_t) (matches + (memcmp(q_out, expected[i], sizeof(q_out)) == 0));
+		printf(" %u/%u", q_out[0], q_out[1]);
+	}
+	printf("\n  Entscheidungen korrekt %u/%u, Referenzwerte %u/%u%s\n", correct, NO_PAIRS, matches, NO_PAIRS,
+		correct == NO_PAIRS && matches == NO_PAIRS ? "" : " FEHLER");
+	if (correct != NO_PAIRS || matches != NO_PAIRS) {
+		result = 1;
+	}
+
+	/* Inferenzzeit und Speicherbedarf */
+	srand(1);
+	network_t * bench_net = net_allocate(NO_LAYERS, NO_INPUT_NEURONS, NO_HIDDEN_NEURONS, NO_OUTPUT_NEURONS);
+	const int16_t q_size = nnq_quantize(bench_net, q_net, sizeof(q_net));
+	uint64_t t_us[2];
+	uint8_t fixed;
+	volatile uint8_t sink = 0;
+	for (fixed = 0; fixed < 2; ++fixed) {
+		struct timeval start, now;
+		gettimeofday(&start, NULL);
+		uint32_t r;
+		for (r = 0; r < runs; ++r) {
+			for (i = 0; i < NO_PAIRS; ++i) {
+				if (fixed) {
+					nnq_compute(q_net, q_in[i], q_out);
+					sink = (uint8_t) (sink + q_out[0]);
+				} else {
+					net_compute(bench_net, inputs_def[i], out);
+					sink = (uint8_t) (sink + (out[0] < 0.5f));
+				}
+			}
+		}
+		gettimeofday(&now, NULL);
+		t_us[fixed] = (uint64_t) (now.tv_sec - start.tv_sec) * 1000000ULL + (uint64_t) now.tv_usec - (uint64_t) start.tv_usec;
+		if (t_us[fixed] == 0) {
+			t_us[fixed] = 1;
+		}
+	}
+	const double count = (double) runs * NO_PAIRS;
+	printf("Inferenz float %.1f ns, Festkomma %.1f ns\n", (double) t_us[0] * 1e3 / count, (double) t_us[1] * 1e3 / count);
+	printf("Speicher float: Gewichte + Deltas %u Byte, Sigmoid-Tabelle %u Byte; Festkomma: Netz %d Byte, Sigmoid-Tabelle 34 Byte\n",
+		(unsigned) (2 * sizeof(float) * (size_t) net_get_no_of_weights(bench_net)), (unsigned) (2000 * sizeof(float)), q_size);
+	net_free(bench_net);
+	return result;
+}
+
+#ifdef NEURALNET_PARALLEL_AVAILABLE
+/**
+ * Misst das parallele Training mit den vordefinierten Patterns mit einem und mit NEURALNET_PARALLEL_THREADS
+ * Threads und vergleicht es mit dem Training des Verhaltens nach jedem Pattern
+ */
+void neuralnet_parallel_benchmark(void) {
+	const uint8_t threads[] = { 1, NEURALNET_PARALLEL_THREADS };
+	float out[NO_OUTPUT_NEURONS];
+	uint16_t i, j;
+	uint8_t k;
+
+	/* Referenz: MAX_TRAINING_DEF Epochen mit Training nach jedem Pattern wie bot_neuralnet_behaviour(), dort eine Epoche je Verhaltensdurchlauf */
+	srand(1);
+	network_t * bench_net = net_allocate(NO_LAYERS, NO_INPUT_NEURONS, NO_HIDDEN_NEURONS, NO_OUTPUT_NEURONS);
+	if (! bench_net) {
+		return;
+	}
+	struct timeval start, now;
+	gettimeofday(&start, NULL);
+	float err = 0.f;
+	uint16_t epoch;
+	for (epoch = 0; epoch < MAX_TRAINING_DEF; ++epoch) {
+		float e = 0.f;
+		for (i = 0; i < NO_PAIRS; ++i) {
+			net_compute(bench_net, inputs_def[i], out);
+			e += net_compute_output_error(bench_net, targets_def[i]);
+			net_train(bench_net);
+		}
+		err = epoch == 0 ? e / NO_PAIRS : 0.9f * err + 0.1f * e / NO_PAIRS;
+	}
+	gettimeofday(&now, NULL);
+	net_free(bench_net);
+	printf("Verhalten: %u Epochen (= Verhaltensdurchlaeufe) nach jedem Pattern: %.3f s, Fehler %.5f\n", MAX_TRAINING_DEF,
+		(double) (now.tv_sec - start.tv_sec) + (double) (now.tv_usec - start.tv_usec) * 1e-6, (double) err);
+
+	printf("Parallel: %u Netze als Batch-Training, max. %u Epochen je Netz\n", NEURALNET_PARALLEL_STARTS, NEURALNET_PARALLEL_EPOCHS);
+	for (k = 0; k < sizeof(threads); ++k) {
+		srand(1);
+		gettimeofday(&start, NULL);
+		if (neuralnet_parallel_start(inputs_def, targets_def, NO_PAIRS, NULL, threads[k]) != 0) {
+			return;
+		}
+		bench_net = neuralnet_parallel_finish(&err);
+		gettimeofday(&now, NULL);
+
+		uint8_t correct = 0;
+		for (i = 0; i < NO_PAIRS; ++i) {
+			net_compute(bench_net, inputs_def[i], out);
+			uint8_t correct_all = 1;
+			for (j = 0; j < NO_OUTPUT_NEURONS; ++j) {
+				correct_all = (uint8_t) (correct_all && (out[j] < 0.5f ? 0 : 1) == (uint8_t) targets_def[i][j]);
+			}
+			correct = (uint8_t) (correct + correct_all);
+		}
+		printf("  %u Thread(s): %.3f s, bester Fehler %.5f, Entscheidungen korrekt %u/%u\n", threads[k],
+			(double) (now.tv_sec - start.tv_sec) + (double) (now.tv_usec - start.tv_usec) * 1e-6, (double) err, correct, NO_PAIRS);
+		net_free(bench_net);
+	}
+}
+#endif // NEURALNET_PARALLEL_AVAILABLE
+#endif // PC
 
 #ifdef DISPLAY_NEURALNET_AVAILABLE
 /**
@@ -376,6 +857,7 @@ void net_check_one_step(Behaviour_t * caller) {
 static void neuralnet_disp_key_handler(void) {
 	/* Keyhandling fuer NN-Verhalten */
 	switch (RC5_Code) {
+#ifndef NEURALNET_FIXED_AVAILABLE
 	case RC5_CODE_4:
 		// Defaultpatterns werden wiederhergestellt wie nach Botstart
 		RC5_Code = 0;
@@ -384,6 +866,7 @@ static void neuralnet_disp_key_handler(void) {
 		// einmaligen Test durchfuehren zur Fehlerermittlung und Anzeige
 		net_check_one_step(NULL);
 		break;
+#endif // ! NEURALNET_FIXED_AVAILABLE
 
 #ifdef BEHAVIOUR_DRIVE_NEURALNET_AVAILABLE
 		/**
@@ -392,6 +875,7 @@ static void neuralnet_disp_key_handler(void) {
 	case RC5_CODE_5:
 		// Start des Fahrverhaltens, Richtungsentscheidungen aus dem Netz genommen
 		RC5_Code = 0;
+#ifndef NEURALNET_FIXED_AVAILABLE
 		// Totaler Fehler bewegt sich zwischen 0 und 1 aber nicht genau drauf, sonst ungelernt
 		if (total_error == 1 || total_error == 0) {
 			LOG_DEBUG("Netz noch ungelernt, wird jetzt wenigstens 1x trainiert");
@@ -399,17 +883,20 @@ static void neuralnet_disp_key_handler(void) {
 			// aber fuer Anschauungseffekt zum Fahren mit untrainiertem Netz so gelassen
 			net_check_one_step(NULL);	// wenigstens 1x Netz durchlaufen lassen
 		}
+#endif
 
 		bot_drive_neuralnet(NULL);
 		break;
 #endif // BEHAVIOUR_DRIVE_NEURALNET_AVAILABLE
 
+#ifndef NEURALNET_FIXED_AVAILABLE
 	case RC5_CODE_9:
 		// Netz trainieren
 		RC5_Code = 0;
 		// nur trainierbar wenn auch zu lernende Patterns im Lernarray drinstehen
 		bot_neuralnet(NULL);
 		break;
+#endif // ! NEURALNET_FIXED_AVAILABLE
 	} // switch
 } // Ende NN-Keyhandler
 
@@ -418,11 +905,17 @@ static void neuralnet_disp_key_handler(void) {
  */
 void neuralnet_display(void) {
 	display_cursor(1, 1);
+#ifdef NEURALNET_FIXED_AVAILABLE
+	display_puts("NET Festkomma");
+	display_cursor(2, 1);
+	display_printf("Out: %3u %3u", outputarr_q[0], outputarr_q[1]);
+#else
 	display_printf("NET Err: %f", (double)total_error);
 	//display_cursor(2, 1);
 	//display_printf("Patterns: %2u", no_of_pairs);
 	display_cursor(3, 1);
 	display_puts("InitPatt/Train: 4/9");
+#endif // NEURALNET_FIXED_AVAILABLE
 
 	display_cursor(4, 1);
 #ifdef BEHAVIOUR_DRIVE_NEURALNET_AVAILABLE
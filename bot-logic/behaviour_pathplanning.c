@@ -20,12 +20,16 @@
 
 /**
  * \file 	behaviour_pathplanning.c
- * \brief   Wave-Pfadplanungsverhalten
+ * \brief   Pfadplanungsverhalten (A* oder Welle)
  *
  * Eine niedrigaufloesende Map wird ueber die hochaufloesende gelegt und auf dieser folgende Schritte ausgefuehrt:
  * -Innerhalb des wirklich benutzten Mappenbereiches wird jede Zelle durchlaufen und falls der Durchschnittswert
  * der Hochaufloesenden Map < 0 ist (Hinderniswert) hier eingetragen mit Wert 1
- * -anzufahrende Zielposition erhaelt Mapwert 2
+ * -A* (Standard): ausgehend von der Zielposition wird mit Octile-Heuristik (8er Nachbarschaft, keine Diagonale an
+ * Hinderniskanten vorbei) bis zur Botposition gesucht; die offene Liste ist ein Binaerheap, die geschlossene eine
+ * Bitmap, jede abgeschlossene Zelle erhaelt als Mapwert die Richtung, aus der sie erreicht wurde. Von der Botposition
+ * aus wird diesen Richtungen bis zum Ziel gefolgt.
+ * -Welle (PATHPLANNING_USE_WAVE): anzufahrende Zielposition erhaelt Mapwert 2
  * -ausgehend von Zielposition laeuft eine Welle los bis zum Bot-Ausgangspunkt, d.h. von 2 beginnend erhaelt jede Nachbarzelle
  * den naechst hoeheren Zellenwert
  * -wird als ein Nachbar die Botposition erreicht, wird der Pfad zurueckverfolgt und immer die Zelle mit kleinerem Wert gewaehlt;
@@ -50,7 +54,13 @@
 #include "display.h"
 #include "log.h"
 #include "pos_store.h"
+#include "timer.h"
+#ifdef PC
+#include <sys/time.h>
+#endif
 
+//#define PATHPLANNING_USE_WAVE	// Schalter fuer die alte Wellen-Planung (Breitensuche) statt A*
+#define PATHPLANNING_REPLAN_AVAILABLE	// Schalter fuer inkrementelle Neuplanung (D* Lite) bei Kartenaenderungen waehrend der Fahrt, nur PC
 //#define DEBUG_PATHPLANNING	// Schalter fuer Debugausgaben
 //#define DEBUG_PATHPLANNING_VERBOSE	// zeichnet Zellen in die Map-Anzeige des Sim ein, rot: Hindernis, gruen: frei
 
@@ -61,6 +71,24 @@
 #define QUEUE_SIZE POS_STORE_SIZE
 #endif
 
+#ifndef PATHPLANNING_USE_WAVE
+/* Groesse der offenen Liste fuer A*, jeder Eintrag belegt 7 Byte RAM */
+#ifdef PC
+#define PATHPLANNING_HEAP_SIZE	4096	/**< Anzahl der Eintraege in der offenen Liste */
+#elif defined __AVR_ATmega1284P__
+#define PATHPLANNING_HEAP_SIZE	128		/**< Anzahl der Eintraege in der offenen Liste */
+#else
+#define PATHPLANNING_HEAP_SIZE	48		/**< Anzahl der Eintraege in der offenen Liste */
+#endif
+
+#define COST_STRAIGHT	5	/**< Kosten fuer einen Schritt in X- oder Y-Richtung */
+#define COST_DIAGONAL	7	/**< Kosten fuer einen diagonalen Schritt (~ COST_STRAIGHT * sqrt(2)) */
+#endif // ! PATHPLANNING_USE_WAVE
+
+#if ! defined PC || ! defined MAP_CHANGE_HANDLER_AVAILABLE || defined PATHPLANNING_USE_WAVE
+#undef PATHPLANNING_REPLAN_AVAILABLE
+#endif
+
 #ifdef MCU
 #undef DEBUG_PATHPLANNING
 #endif
@@ -131,6 +159,10 @@ static uint8_t wavecounter = 0;
 #define SEARCH_STACKPATH_AND_QUEUE		3
 #define START_BOT_GO_STACK_BEHAVIOUR	4
 #define CORRECT_POSITION				5
+#define ASTAR_SEARCH					6
+#define ASTAR_TRACE						7
+#define REPLAN_DRIVE					8
+#define REPLAN_UPDATE					9
 #define END								99
 
 /** Begrenzung des Wellenzaehlers, d.h. obere Grenze als Abbruchbedingung */
@@ -140,6 +172,78 @@ static uint8_t wave_state = 0; /**< Statusvariable */
 
 static int8_t map_compare_haz = 0; /**< Vergleichswert unterhalb dem Hinderniswert gesetzt wird */
 
+/** Messwerte der letzten Planung */
+static struct {
+	uint32_t hazards_us;	/**< Laufzeit von set_hazards() [us] */
+	uint32_t search_us;		/**< Laufzeit der Suche [us] */
+	uint16_t expanded;		/**< Anzahl der expandierten Zellen */
+	uint16_t max_open;		/**< maximale Anzahl an Eintraegen in der offenen Liste (bzw. Queue) */
+	uint16_t overflows;		/**< Anzahl der Eintraege, die wegen voller offener Liste (bzw. Queue) verworfen wurden */
+#ifdef PATHPLANNING_REPLAN_AVAILABLE
+	uint16_t replans;		/**< Anzahl der inkrementellen Neuplanungen */
+#endif
+} planning_stats;
+
+static uint8_t waypoint_skip_count = 0; /**< Zaehlt die Anzahl der in der Queue uebersprungenen Punkte */
+#ifdef MAP_2_SIM_AVAILABLE
+static position_t waypoint_last; /**< zuletzt eingezeichneter Pfadpunkt [Map-Koordinaten] */
+#endif
+
+#ifndef PATHPLANNING_USE_WAVE
+#define CELL_PARENT	2	/**< Mapwert abgeschlossener Zellen: CELL_PARENT + Richtung, aus der die Zelle erreicht wurde */
+#define CELL_START	(CELL_PARENT + 8)	/**< Mapwert der Startzelle der Suche (Zielpunkt des Bots) */
+
+/** Eintrag der offenen Liste */
+typedef struct {
+	uint8_t x;		/**< X-Koordinate [Lowres-Map] */
+	uint8_t y;		/**< Y-Koordinate [Lowres-Map] */
+	uint8_t dir;	/**< Richtung, aus der die Zelle erreicht wurde (Index fuer neighbour_dx / neighbour_dy, 8: Startzelle) */
+	uint16_t g;		/**< Kosten vom Start bis hier */
+	uint16_t f;		/**< g + geschaetzte Kosten bis zum Ziel */
+} PACKED astar_node_t;
+
+static astar_node_t astar_heap[PATHPLANNING_HEAP_SIZE]; /**< offene Liste als Binaerheap (Minimum von f in [0]) */
+static uint16_t astar_heap_count; /**< Anzahl der Eintraege in astar_heap */
+#ifndef PATHPLANNING_REPLAN_AVAILABLE
+static uint8_t astar_closed[(MAP_LENGTH_LOWRES * MAP_LENGTH_LOWRES + 7) / 8]; /**< geschlossene Liste, ein Bit pro Zelle */
+#else
+#define COST_INFINITE	0xffff	/**< Kosten fuer unerreichbare Zellen */
+
+/* D* Lite sucht wie A* vom Zielpunkt (startwave) zur Botposition (endkoord). Fuer jede Zelle werden die Kosten bis zum Zielpunkt
+ * (g) und deren Einschritt-Vorausschau (rhs) gespeichert; aendern sich Zellen, werden nur die inkonsistenten Zellen neu
+ * expandiert. In der offenen Liste steht key1 in f und key2 invertiert in g, damit astar_node_less() unveraendert gilt. */
+static uint16_t dstar_g[MAP_LENGTH_LOWRES * MAP_LENGTH_LOWRES]; /**< Kosten bis zum Zielpunkt je Zelle */
+static uint16_t dstar_rhs[MAP_LENGTH_LOWRES * MAP_LENGTH_LOWRES]; /**< Einschritt-Vorausschau der Kosten je Zelle */
+static uint16_t dstar_km; /**< Summe der Heuristik-Verschiebungen durch Bewegung des Bots */
+static position_t dstar_last; /**< Botzelle bei der letzten (Neu-)Planung */
+
+/** Rechteck der seit der letzten Planung veraenderten Zellen [Lowres-Map], leer falls min_x > max_x */
+static volatile struct {
+	int16_t min_x;
+	int16_t min_y;
+	int16_t max_x;
+	int16_t max_y;
+} dstar_dirty;
+#endif // PATHPLANNING_REPLAN_AVAILABLE
+
+static const int8_t neighbour_dx[8] = {1, 0, -1, 0, 1, -1, -1, 1}; /**< X-Versatz der Nachbarn, 0..3 gerade, 4..7 diagonal */
+static const int8_t neighbour_dy[8] = {0, 1, 0, -1, 1, 1, -1, -1}; /**< Y-Versatz der Nachbarn, 0..3 gerade, 4..7 diagonal */
+#endif // ! PATHPLANNING_USE_WAVE
+
+/**
+ * Zeitmessung fuer die Statistik
+ * \return Zeit [us]; auf dem PC echte Rechenzeit, auf dem MCU Systemzeit in TIMER_STEPS Aufloesung
+ */
+static uint32_t get_time_us(void) {
+#ifdef PC
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return (uint32_t) now.tv_sec * 1000000UL + (uint32_t) now.tv_usec;
+#else
+	return TIMER_GET_TICKCOUNT_32 * TIMER_STEPS;
+#endif
+}
+
 /**
  * Konvertiert eine Lowres-Kartenkoordinate in eine Weltkoordinate
  * \param map_koord	Kartenkoordinate
@@ -223,6 +327,21 @@ static inline void delete_lowres(void) {
 	}
 }
 
+/**
+ * Prueft anhand der Highres-Karte, ob eine Lowres-Zelle ein Hindernis ist
+ * \param x	X-Koordinate der Zelle [Lowres-Map]
+ * \param y	Y-Koordinate der Zelle [Lowres-Map]
+ * \return	True, falls die Zelle als Hindernis gilt
+ */
+static uint8_t hazard_at(int16_t x, int16_t y) {
+	const int16_t yw = map_to_world_lowres(y) + MAP_CELL_SIZE_LOWRES / 2; // Mittelpunkt der Zelle
+	const int16_t x1 = map_to_world_lowres(x); // Punkt "unten"
+	const int16_t x2 = x1 + MAP_CELL_SIZE_LOWRES; // Punkt "oben"
+	const uint8_t ratio = map_get_ratio(x1, yw, x2, yw, MAP_CELL_SIZE_LOWRES, map_compare_haz, 127);
+	//fuer Vergleich auf bereits befahrene Strecke gilt anderer Schwellwert als fuer Hindernis
+	return (uint8_t) (ratio < ((map_compare_haz == 0) ? RATIO_THRESHOLD : RATIO_THRESHOLD_DRIVEN));
+}
+
 /**
  * Eintragen der Hindernisse in Lowres-Karte aus der Map-Highres-Karte
  */
@@ -237,26 +356,17 @@ static void set_hazards(void) {
 	min_y = (min_y > 0) ? min_y : 0; // sicherstellen dass Grenzen positiv sind
 	min_x = (min_x > 0) ? min_x : 0;
 
-	int16_t yw;
-
 	// Zellen durchlaufen und aus der hochaufloesenden Weltkarte Hindernisse hier eintragen
 	for (y = max_y; y >= min_y; y--) {
-		yw = map_to_world_lowres(y) + MAP_CELL_SIZE_LOWRES / 2; // Zeilenwert als Weltkoord umrechnen, Mittelpunkt der Zelle
 		for (x = min_x; x <= max_x; x++) {
-			int16_t xw = map_to_world_lowres(x) + MAP_CELL_SIZE_LOWRES / 2; // Mittelpunkt der Zelle, also Haelfte addieren
-			int16_t x1 = xw - MAP_CELL_SIZE_LOWRES / 2; // Punkt "unten", darum Haelfte der Zellengroesse abziehen
-			int16_t x2 = xw + MAP_CELL_SIZE_LOWRES / 2; // Punkt "oben", darum Haelfte der Zellegroesse addieren
 #ifdef DEBUG_PATHPLANNING_VERBOSE
 			position_t from, to;
-			from.x = world_to_map(x1);
-			from.y = world_to_map(yw);
-			to.x = world_to_map(x2);
+			from.x = world_to_map(map_to_world_lowres(x));
+			from.y = world_to_map(map_to_world_lowres(y) + MAP_CELL_SIZE_LOWRES / 2);
+			to.x = world_to_map(map_to_world_lowres(x) + MAP_CELL_SIZE_LOWRES);
 			to.y = from.y;
 #endif	// DEBUG_PATHPLANNING_VERBOSE
-			uint8_t ratio = map_get_ratio(x1, yw, x2, yw, MAP_CELL_SIZE_LOWRES,
-					map_compare_haz, 127);
-//fuer Vergleich auf bereits befahrene Strecke gilt anderer Schwellwert als fuer Hindernis
-			if (ratio < ((map_compare_haz==0)?RATIO_THRESHOLD:RATIO_THRESHOLD_DRIVEN)) {
+			if (hazard_at(x, y)) {
 				access_field_lowres((position_t) {x, y}, 1, 1);
 #if defined DEBUG_PATHPLANNING_VERBOSE && defined MAP_2_SIM_AVAILABLE
 //				LOG_DEBUG("Trage Hindernis in (%d|%d) ein, ratio=%u", x, y, ratio);
@@ -272,6 +382,73 @@ static void set_hazards(void) {
 	}
 }
 
+/**
+ * Setzt die Pfadpunkt-Verwaltung vor dem Zurueckverfolgen eines Pfades zurueck
+ */
+static void waypoints_reset(void) {
+	waypoint_skip_count = 0;
+#ifdef MAP_2_SIM_AVAILABLE
+	waypoint_last.x = 0;
+	waypoint_last.y = 0;
+#endif
+}
+
+/**
+ * Haengt eine Zelle als Pfadpunkt (Weltkoordinaten der Zellenmitte) an die Queue an; liegt der neue Punkt auf einer
+ * Linie mit den beiden letzten, wird der letzte Eintrag (hoechstens 3 Mal hintereinander) verworfen
+ * \param cell	Zelle [Lowres-Map]
+ * \return		True, falls der Punkt eingefuegt wurde, False falls die Queue voll ist
+ */
+static uint8_t store_waypoint(position_t cell) {
+	// zum spaeteren Stack-Abfahren die Zwischenziel-Koordinaten als Weltkoordinaten auf den Stack legen
+	position_t pos_;
+	pos_.x = map_to_world_lowres(cell.x) + MAP_CELL_SIZE_LOWRES / 2;
+	pos_.y = map_to_world_lowres(cell.y) + MAP_CELL_SIZE_LOWRES / 2;
+
+	position_t pos_1, pos_2;
+	if (pos_store_top(planning_pos_store, &pos_1, 1) == True && pos_store_top(planning_pos_store, &pos_2, 2) == True) {
+		int8_t m_1 = (int8_t) (pos_1.x == pos_2.x ? 100 : (pos_1.y - pos_2.y) / (pos_1.x - pos_2.x));
+		int8_t m = (int8_t) (pos_.x == pos_1.x ? 100 : (pos_.y - pos_1.y) / (pos_.x - pos_1.x));
+#ifdef DEBUG_PATHPLANNING_VERBOSE
+		LOG_DEBUG(" pos_2=(%d|%d)", pos_2.x, pos_2.y);
+		LOG_DEBUG(" pos_1=(%d|%d)", pos_1.x, pos_1.y);
+		LOG_DEBUG(" pos_ =(%d|%d)", pos_.x, pos_.y);
+		LOG_DEBUG("  m_1=%3d\tm=%3d", m_1, m);
+		LOG_DEBUG("  skip_count=%u", waypoint_skip_count);
+#endif // DEBUG_PATHPLANNING_VERBOSE
+		if (m_1 == m) {
+			LOG_DEBUG("Neuer Punkt auf einer Linie mit beiden Letzten");
+			if (waypoint_skip_count < 3) {
+				LOG_DEBUG(" Verwerfe letzten Queue-Eintrag (%d|%d)", pos_1.x, pos_1.y);
+				pos_store_pop(planning_pos_store, &pos_1);
+				waypoint_skip_count++;
+			} else {
+				LOG_DEBUG(" Verwerfe Eintrag NICHT, skip_count=%u", waypoint_skip_count);
+				waypoint_skip_count = 0;
+			}
+		} else {
+			waypoint_skip_count = 0;
+		}
+	}
+
+	if (! pos_store_queue(planning_pos_store, pos_)) {
+		LOG_DEBUG("Queue ging schief - voll?");
+		return False;
+	}
+
+#ifdef MAP_2_SIM_AVAILABLE
+	position_t aktpos;
+	aktpos.x = world_to_map(pos_.x);
+	aktpos.y = world_to_map(pos_.y);
+	if (waypoint_last.x != 0 && waypoint_last.y != 0) {
+		map_draw_line(waypoint_last, aktpos, 2); // Pfadpunkte schwarz darstellen
+	}
+	waypoint_last = aktpos;
+#endif // MAP_2_SIM_AVAILABLE
+	return True;
+}
+
+#ifdef PATHPLANNING_USE_WAVE
 /**
  * Wellenwert wird auf die uebergebene Koordinate eingetragen und in die FIFO-Queu uebernommen auf nicht-Hinderniswert
  * \param map 				X/Y-Lowres-Map Koordinate
@@ -301,6 +478,7 @@ static uint8_t get_neighbour(position_t map, int8_t actual_wave,
 		// in FIFO-Queue aufnehmen zur weiteren Nachbarsuche
 		if (!pos_store_queue(planning_pos_store, map)) {
 			LOG_DEBUG(">> -Queue voll- %1d %1d bei Punkt: %1d %1d zu Welle: %1d", map.x, map.y, actual_wave);
+			planning_stats.overflows++;
 		}
 	} // nur initiale Felder
 
@@ -313,6 +491,568 @@ static uint8_t get_neighbour(position_t map, int8_t actual_wave,
 	// vorherigen Wert zurueckgeben
 	return end_reached;
 } // Ende get_neighbour
+#else // A*
+
+/**
+ * Schaetzt die Kosten zwischen zwei Zellen bei 8er Nachbarschaft ab (Octile-Distanz)
+ * \param x	X-Koordinate der Zelle [Lowres-Map]
+ * \param y	Y-Koordinate der Zelle [Lowres-Map]
+ * \return		Geschaetzte Kosten bis zur Botposition
+ */
+static uint16_t astar_heuristic(int16_t x, int16_t y) {
+	uint16_t dx = (uint16_t) abs(x - endkoord.x);
+	uint16_t dy = (uint16_t) abs(y - endkoord.y);
+	if (dx > dy) {
+		return COST_STRAIGHT * dx + (COST_DIAGONAL - COST_STRAIGHT) * dy;
+	}
+	return COST_STRAIGHT * dy + (COST_DIAGONAL - COST_STRAIGHT) * dx;
+}
+
+/**
+ * Vergleicht zwei Eintraege der offenen Liste
+ * \param *a	Erster Eintrag
+ * \param *b	Zweiter Eintrag
+ * \return		True, falls a vor b expandiert werden soll (kleineres f, bei Gleichstand groesseres g)
+ */
+static uint8_t astar_node_less(const astar_node_t * a, const astar_node_t * b) {
+	if (a->f != b->f) {
+		return (uint8_t) (a->f < b->f);
+	}
+	return (uint8_t) (a->g > b->g);
+}
+
+/**
+ * Laesst einen Eintrag der offenen Liste im Heap nach oben wandern
+ * \param index	Index des Eintrags
+ */
+static void astar_heap_up(uint16_t index) {
+	astar_node_t node = astar_heap[index];
+	while (index > 0) {
+		const uint16_t parent = (uint16_t) ((index - 1) / 2);
+		if (! astar_node_less(&node, &astar_heap[parent])) {
+			break;
+		}
+		astar_heap[index] = astar_heap[parent];
+		index = parent;
+	}
+	astar_heap[index] = node;
+}
+
+/**
+ * Fuegt eine Zelle in die offene Liste ein. Ist die Liste voll, ersetzt der neue Eintrag den schlechtesten
+ * Blatteintrag, falls er besser als dieser ist.
+ * \param *node	Einzufuegender Eintrag
+ */
+static void astar_heap_push(const astar_node_t * node) {
+	uint16_t index = astar_heap_count;
+	if (astar_heap_count < PATHPLANNING_HEAP_SIZE) {
+		astar_heap_count++;
+		if (astar_heap_count > planning_stats.max_open) {
+			planning_stats.max_open = astar_heap_count;
+		}
+	} else {
+		/* der schlechteste Eintrag ist immer ein Blatt */
+		planning_stats.overflows++;
+		uint16_t i;
+		index = PATHPLANNING_HEAP_SIZE / 2;
+		for (i = (uint16_t) (index + 1); i < PATHPLANNING_HEAP_SIZE; ++i) {
+			if (astar_node_less(&astar_heap[index], &astar_heap[i])) {
+				index = i;
+			}
+		}
+		if (! astar_node_less(node, &astar_heap[index])) {
+			return;
+		}
+	}
+	astar_heap[index] = *node;
+	astar_heap_up(index);
+}
+
+/**
+ * Entnimmt den besten Eintrag aus der offenen Liste
+ * \param *node	Zeiger auf Speicher fuer den Eintrag
+ * \return		False, falls die Liste leer ist
+ */
+static uint8_t astar_heap_pop(astar_node_t * node) {
+	if (astar_heap_count == 0) {
+		return False;
+	}
+	*node = astar_heap[0];
+	astar_heap_count--;
+	const astar_node_t last = astar_heap[astar_heap_count];
+	uint16_t index = 0;
+	for (;;) {
+		uint16_t child = (uint16_t) (2 * index + 1);
+		if (child >= astar_heap_count) {
+			break;
+		}
+		if (child + 1 < astar_heap_count && astar_node_less(&astar_heap[child + 1], &astar_heap[child])) {
+			child++;
+		}
+		if (! astar_node_less(&astar_heap[child], &last)) {
+			break;
+		}
+		astar_heap[index] = astar_heap[child];
+		index = child;
+	}
+	astar_heap[index] = last;
+	return True;
+}
+
+/**
+ * Prueft, ob eine Zelle befahren werden darf
+ * \param x	X-Koordinate der Zelle [Lowres-Map]
+ * \param y	Y-Koordinate der Zelle [Lowres-Map]
+ * \return		True, falls die Zelle innerhalb des Planungsbereichs liegt und kein Hindernis ist; Start- und Zielzelle sind immer befahrbar
+ */
+static uint8_t astar_passable(int16_t x, int16_t y) {
+	if (x < min_x || x > max_x || y < min_y || y > max_y) {
+		return False;
+	}
+	if ((x == endkoord.x && y == endkoord.y) || (x == startwave.x && y == startwave.y)) {
+		return True;
+	}
+	return (uint8_t) (access_field_lowres((position_t) {x, y}, 0, 0) != 1);
+}
+
+/**
+ * Begrenzt den Planungsbereich auf die Karte und erweitert ihn um Start- und Zielzelle
+ * \return False, falls Zielpunkt oder Botposition ausserhalb der Karte liegen
+ */
+static uint8_t set_bounds(void) {
+	if (startwave.x < 0 || startwave.x >= MAP_LENGTH_LOWRES || startwave.y < 0 || startwave.y >= MAP_LENGTH_LOWRES
+		|| endkoord.x < 0 || endkoord.x >= MAP_LENGTH_LOWRES || endkoord.y < 0 || endkoord.y >= MAP_LENGTH_LOWRES) {
+		LOG_DEBUG("Start- oder Zielpunkt ausserhalb der Karte");
+		return False;
+	}
+	min_x = min_x < startwave.x ? min_x : startwave.x;
+	min_x = min_x < endkoord.x ? min_x : endkoord.x;
+	max_x = max_x > startwave.x ? max_x : startwave.x;
+	max_x = max_x > endkoord.x ? max_x : endkoord.x;
+	min_y = min_y < startwave.y ? min_y : startwave.y;
+	min_y = min_y < endkoord.y ? min_y : endkoord.y;
+	max_y = max_y > startwave.y ? max_y : startwave.y;
+	max_y = max_y > endkoord.y ? max_y : endkoord.y;
+	max_x = max_x < MAP_LENGTH_LOWRES - 1 ? max_x : MAP_LENGTH_LOWRES - 1;
+	max_y = max_y < MAP_LENGTH_LOWRES - 1 ? max_y : MAP_LENGTH_LOWRES - 1;
+	return True;
+}
+
+#ifndef PATHPLANNING_REPLAN_AVAILABLE
+/**
+ * Prueft, ob eine Zelle bereits abgeschlossen wurde
+ * \param x	X-Koordinate der Zelle [Lowres-Map]
+ * \param y	Y-Koordinate der Zelle [Lowres-Map]
+ * \return		True, falls die Zelle in der geschlossenen Liste ist
+ */
+static uint8_t astar_is_closed(int16_t x, int16_t y) {
+	const uint16_t index = (uint16_t) (y * MAP_LENGTH_LOWRES + x);
+	return (uint8_t) ((astar_closed[index >> 3] >> (index & 7)) & 1);
+}
+
+/**
+ * A*-Suche vom Zielpunkt (startwave) zur Botposition (endkoord). Jede abgeschlossene Zelle erhaelt in der Lowres-Map
+ * den Wert CELL_PARENT + Richtung, aus der sie erreicht wurde.
+ * \return True, falls die Botposition erreicht wurde
+ */
+static uint8_t astar_search(void) {
+	if (! set_bounds()) {
+		return False;
+	}
+
+	memset(astar_closed, 0, sizeof(astar_closed));
+	astar_heap_count = 0;
+
+	astar_node_t node;
+	node.x = (uint8_t) startwave.x;
+	node.y = (uint8_t) startwave.y;
+	node.dir = 8;
+	node.g = 0;
+	node.f = astar_heuristic(startwave.x, startwave.y);
+	astar_heap_push(&node);
+
+	while (astar_heap_pop(&node)) {
+		/* Eintraege fuer bereits abgeschlossene Zellen sind Duplikate mit schlechterem g */
+		if (astar_is_closed(node.x, node.y)) {
+			continue;
+		}
+		const uint16_t index = (uint16_t) (node.y * MAP_LENGTH_LOWRES + node.x);
+		astar_closed[index >> 3] |= (uint8_t) (1 << (index & 7));
+		access_field_lowres((position_t) {node.x, node.y}, (int8_t) (CELL_PARENT + node.dir), 1);
+		planning_stats.expanded++;
+
+		if (node.x == endkoord.x && node.y == endkoord.y) {
+			LOG_DEBUG("Botpos erreicht, Kosten %u", node.g);
+			return True;
+		}
+
+		uint8_t dir;
+		for (dir = 0; dir < 8; ++dir) {
+			const int16_t x = (int16_t) (node.x + neighbour_dx[dir]);
+			const int16_t y = (int16_t) (node.y + neighbour_dy[dir]);
+			if (! astar_passable(x, y) || astar_is_closed(x, y)) {
+				continue;
+			}
+			uint16_t cost = COST_STRAIGHT;
+			if (dir >= 4) {
+				/* keine Diagonale an einer Hinderniskante vorbei */
+				if (! astar_passable(x, node.y) || ! astar_passable(node.x, y)) {
+					continue;
+				}
+				cost = COST_DIAGONAL;
+			}
+			astar_node_t next;
+			next.x = (uint8_t) x;
+			next.y = (uint8_t) y;
+			next.dir = dir;
+			next.g = (uint16_t) (node.g + cost);
+			next.f = (uint16_t) (next.g + astar_heuristic(x, y));
+			astar_heap_push(&next);
+		}
+	}
+
+	LOG_DEBUG("offene Liste leer, Botpos nicht erreichbar");
+	return False;
+}
+
+/**
+ * Verfolgt den von astar_search() gefundenen Pfad von der Botposition zum Zielpunkt und legt die Pfadpunkte in die Queue
+ * \return True, falls der Zielpunkt erreicht wurde
+ */
+static uint8_t astar_trace(void) {
+	position_t pos = endkoord;
+	uint16_t steps = 0;
+	waypoints_reset();
+
+	while (pos.x != startwave.x || pos.y != startwave.y) {
+		const int8_t dir = (int8_t) (access_field_lowres(pos, 0, 0) - CELL_PARENT);
+		if (dir < 0 || dir >= 8 || ++steps > planning_stats.expanded) {
+			LOG_DEBUG("ungueltige Richtung %d bei %1d %1d", dir, pos.x, pos.y);
+			return False;
+		}
+		pos.x -= neighbour_dx[dir];
+		pos.y -= neighbour_dy[dir];
+		LOG_DEBUG("Pfadpunkt in Queue %1d %1d", pos.x, pos.y);
+		if (! store_waypoint(pos)) {
+			return False;
+		}
+	}
+	return True;
+}
+#else // PATHPLANNING_REPLAN_AVAILABLE
+
+/**
+ * Kosten fuer einen Schritt von einer Zelle zu einem Nachbarn
+ * \param x		X-Koordinate der Zelle [Lowres-Map]
+ * \param y		Y-Koordinate der Zelle [Lowres-Map]
+ * \param dir	Richtung zum Nachbarn (Index fuer neighbour_dx / neighbour_dy)
+ * \return		Kosten oder COST_INFINITE, falls eine der Zellen (oder bei Diagonalen eine Ecke) nicht befahrbar ist
+ */
+static uint16_t dstar_cost(int16_t x, int16_t y, uint8_t dir) {
+	const int16_t nx = (int16_t) (x + neighbour_dx[dir]);
+	const int16_t ny = (int16_t) (y + neighbour_dy[dir]);
+	if (! astar_passable(x, y) || ! astar_passable(nx, ny)) {
+		return COST_INFINITE;
+	}
+	if (dir < 4) {
+		return COST_STRAIGHT;
+	}
+	if (! astar_passable(nx, y) || ! astar_passable(x, ny)) {
+		return COST_INFINITE;
+	}
+	return COST_DIAGONAL;
+}
+
+/**
+ * Addiert zwei Kosten, COST_INFINITE bleibt erhalten
+ * \param a	Kosten
+ * \param b	Kosten
+ * \return	a + b, hoechstens COST_INFINITE
+ */
+static uint16_t dstar_add(uint16_t a, uint16_t b) {
+	const uint32_t sum = (uint32_t) a + b;
+	return sum < COST_INFINITE ? (uint16_t) sum : COST_INFINITE;
+}
+
+/**
+ * Berechnet den Schluessel einer Zelle fuer die offene Liste
+ * \param x		X-Koordinate der Zelle [Lowres-Map]
+ * \param y		Y-Koordinate der Zelle [Lowres-Map]
+ * \param *node	Eintrag, in dem x, y, f (key1) und g (invertierter key2) gesetzt werden
+ */
+static void dstar_key(int16_t x, int16_t y, astar_node_t * node) {
+	const uint16_t index = (uint16_t) (y * MAP_LENGTH_LOWRES + x);
+	const uint16_t k2 = dstar_g[index] < dstar_rhs[index] ? dstar_g[index] : dstar_rhs[index];
+	node->x = (uint8_t) x;
+	node->y = (uint8_t) y;
+	node->dir = 0;
+	node->f = dstar_add(dstar_add(k2, astar_heuristic(x, y)), dstar_km);
+	node->g = (uint16_t) (COST_INFINITE - k2);
+}
+
+/**
+ * Berechnet rhs einer Zelle aus ihren Nachbarn neu und traegt sie in die offene Liste ein, falls sie inkonsistent ist.
+ * Alte Eintraege der Zelle bleiben in der Liste und werden beim Entnehmen verworfen.
+ * \param x	X-Koordinate der Zelle [Lowres-Map]
+ * \param y	Y-Koordinate der Zelle [Lowres-Map]
+ */
+static void dstar_update_cell(int16_t x, int16_t y) {
+	if (x < min_x || x > max_x || y < min_y || y > max_y) {
+		return;
+	}
+	const uint16_t index = (uint16_t) (y * MAP_LENGTH_LOWRES + x);
+	if (x != startwave.x || y != startwave.y) {
+		uint16_t rhs = COST_INFINITE;
+		uint8_t dir;
+		for (dir = 0; dir < 8; ++dir) {
+			const uint16_t cost = dstar_cost(x, y, dir);
+			if (cost == COST_INFINITE) {
+				continue;
+			}
+			const uint16_t n = (uint16_t) (index + neighbour_dy[dir] * MAP_LENGTH_LOWRES + neighbour_dx[dir]);
+			const uint16_t tmp = dstar_add(cost, dstar_g[n]);
+			if (tmp < rhs) {
+				rhs = tmp;
+			}
+		}
+		dstar_rhs[index] = rhs;
+	}
+	if (dstar_g[index] != dstar_rhs[index]) {
+		astar_node_t node;
+		dstar_key(x, y, &node);
+		astar_heap_push(&node);
+	}
+}
+
+/**
+ * Aktualisiert eine Zelle und alle ihre Nachbarn
+ * \param x	X-Koordinate der Zelle [Lowres-Map]
+ * \param y	Y-Koordinate der Zelle [Lowres-Map]
+ */
+static void dstar_update_neighbourhood(int16_t x, int16_t y) {
+	uint8_t dir;
+	dstar_update_cell(x, y);
+	for (dir = 0; dir < 8; ++dir) {
+		dstar_update_cell((int16_t) (x + neighbour_dx[dir]), (int16_t) (y + neighbour_dy[dir]));
+	}
+}
+
+/**
+ * Expandiert inkonsistente Zellen, bis die Kosten der Botposition feststehen
+ * \return True, falls die Botposition erreichbar ist; False auch, falls die offene Liste uebergelaufen ist
+ */
+static uint8_t dstar_compute(void) {
+	const uint16_t overflows = planning_stats.overflows;
+	const uint16_t start = (uint16_t) (endkoord.y * MAP_LENGTH_LOWRES + endkoord.x);
+	astar_node_t node;
+	while (astar_heap_count > 0) {
+		astar_node_t start_key;
+		dstar_key(endkoord.x, endkoord.y, &start_key);
+		if (! astar_node_less(&astar_heap[0], &start_key) && dstar_g[start] == dstar_rhs[start]) {
+			break;
+		}
+		astar_heap_pop(&node);
+		const uint16_t index = (uint16_t) (node.y * MAP_LENGTH_LOWRES + node.x);
+		if (dstar_g[index] == dstar_rhs[index]) {
+			continue; // veralteter Eintrag
+		}
+		astar_node_t key;
+		dstar_key(node.x, node.y, &key);
+		if (astar_node_less(&node, &key)) {
+			astar_heap_push(&key); // Schluessel ist inzwischen groesser
+			continue;
+		}
+		planning_stats.expanded++;
+		if (dstar_g[index] > dstar_rhs[index]) {
+			dstar_g[index] = dstar_rhs[index];
+			uint8_t dir;
+			for (dir = 0; dir < 8; ++dir) {
+				dstar_update_cell((int16_t) (node.x + neighbour_dx[dir]), (int16_t) (node.y + neighbour_dy[dir]));
+			}
+		} else {
+			dstar_g[index] = COST_INFINITE;
+			dstar_update_neighbourhood(node.x, node.y);
+		}
+	}
+	if (planning_stats.overflows != overflows) {
+		LOG_DEBUG("offene Liste uebergelaufen");
+		return False;
+	}
+	return (uint8_t) (dstar_g[start] != COST_INFINITE);
+}
+
+/**
+ * Initialisiert D* Lite und plant vom Zielpunkt (startwave) zur Botposition (endkoord)
+ * \return True, falls die Botposition erreicht wurde
+ */
+static uint8_t dstar_search(void) {
+	if (! set_bounds()) {
+		return False;
+	}
+	memset(dstar_g, 0xff, sizeof(dstar_g));
+	memset(dstar_rhs, 0xff, sizeof(dstar_rhs));
+	dstar_km = 0;
+	dstar_last = endkoord;
+	astar_heap_count = 0;
+
+	dstar_rhs[startwave.y * MAP_LENGTH_LOWRES + startwave.x] = 0;
+	dstar_update_cell(startwave.x, startwave.y);
+	return dstar_compute();
+}
+
+/**
+ * Folgt von der Botposition aus jeweils dem Nachbarn mit den geringsten Kosten bis zum Zielpunkt und legt die Pfadpunkte
+ * in die Queue
+ * \return True, falls der Zielpunkt erreicht wurde
+ */
+static uint8_t dstar_trace(void) {
+	position_t pos = endkoord;
+	uint16_t steps = 0;
+	pos_store_clear(planning_pos_store);
+	waypoints_reset();
+
+	while (pos.x != startwave.x || pos.y != startwave.y) {
+		uint16_t best = COST_INFINITE;
+		uint8_t best_dir = 0;
+		uint8_t dir;
+		for (dir = 0; dir < 8; ++dir) {
+			const uint16_t cost = dstar_cost(pos.x, pos.y, dir);
+			if (cost == COST_INFINITE) {
+				continue;
+			}
+			const uint16_t tmp = dstar_add(cost, dstar_g[(pos.y + neighbour_dy[dir]) * MAP_LENGTH_LOWRES + pos.x + neighbour_dx[dir]]);
+			if (tmp < best) {
+				best = tmp;
+				best_dir = dir;
+			}
+		}
+		if (best == COST_INFINITE || ++steps > MAP_LENGTH_LOWRES * MAP_LENGTH_LOWRES) {
+			LOG_DEBUG("kein Nachfolger bei %1d %1d", pos.x, pos.y);
+			return False;
+		}
+		pos.x += neighbour_dx[best_dir];
+		pos.y += neighbour_dy[best_dir];
+		LOG_DEBUG("Pfadpunkt in Queue %1d %1d", pos.x, pos.y);
+		if (! store_waypoint(pos)) {
+			return False;
+		}
+	}
+	return True;
+}
+
+/**
+ * Handler fuer veraenderte Kartenbereiche, merkt sich die betroffenen Lowres-Zellen. Laeuft im Map-Update-Thread.
+ * \param x1	kleinste X-Koordinate der veraenderten Felder [mm]
+ * \param y1	kleinste Y-Koordinate der veraenderten Felder [mm]
+ * \param x2	groesste X-Koordinate der veraenderten Felder [mm]
+ * \param y2	groesste Y-Koordinate der veraenderten Felder [mm]
+ */
+static void dstar_map_changed(int16_t x1, int16_t y1, int16_t x2, int16_t y2) {
+	const int16_t cx1 = world_to_map_lowres(x1);
+	const int16_t cy1 = world_to_map_lowres(y1);
+	const int16_t cx2 = world_to_map_lowres(x2);
+	const int16_t cy2 = world_to_map_lowres(y2);
+	os_enterCS();
+	if (cx1 < dstar_dirty.min_x) {
+		dstar_dirty.min_x = cx1;
+	}
+	if (cy1 < dstar_dirty.min_y) {
+		dstar_dirty.min_y = cy1;
+	}
+	if (cx2 > dstar_dirty.max_x) {
+		dstar_dirty.max_x = cx2;
+	}
+	if (cy2 > dstar_dirty.max_y) {
+		dstar_dirty.max_y = cy2;
+	}
+	os_exitCS();
+}
+
+/**
+ * Prueft, ob seit der letzten Planung Kartenbereiche veraendert wurden
+ * \return True, falls eine Neuplanung noetig sein kann
+ */
+static uint8_t dstar_changed(void) {
+	os_enterCS();
+	const uint8_t dirty = (uint8_t) (dstar_dirty.min_x <= dstar_dirty.max_x);
+	os_exitCS();
+	return dirty;
+}
+
+/**
+ * Repariert den Plan nach Kartenaenderungen: die veraenderten Zellen werden neu bewertet, nur Zellen, deren Hinderniswert
+ * sich geaendert hat, und ihre Nachbarn werden aktualisiert. Danach wird ab der aktuellen Botposition neu berechnet.
+ * \return 1, falls ein Pfad gefunden wurde, 0 falls nicht, -1 falls die Karte ueber den Planungsbereich hinaus gewachsen ist
+ * oder die offene Liste uebergelaufen ist und komplett neu geplant werden muss
+ */
+static int8_t dstar_replan(void) {
+	os_enterCS();
+	int16_t x1 = dstar_dirty.min_x;
+	int16_t y1 = dstar_dirty.min_y;
+	int16_t x2 = dstar_dirty.max_x;
+	int16_t y2 = dstar_dirty.max_y;
+	dstar_dirty.min_x = INT16_MAX;
+	dstar_dirty.min_y = INT16_MAX;
+	dstar_dirty.max_x = INT16_MIN;
+	dstar_dirty.max_y = INT16_MIN;
+	os_exitCS();
+
+	/* Karte ausserhalb des Planungsbereichs erweitert? */
+	if (world_to_map_lowres(map_get_min_x()) - 1 < min_x || world_to_map_lowres(map_get_max_x()) + 1 > max_x
+		|| world_to_map_lowres(map_get_min_y()) - 1 < min_y || world_to_map_lowres(map_get_max_y()) + 1 > max_y) {
+		LOG_DEBUG("Karte ueber den Planungsbereich hinaus gewachsen");
+		return -1;
+	}
+
+	/* Botposition verschoben: Heuristik-Offset anpassen; Start- und Zielzellen sind immer befahrbar */
+	const position_t bot = { world_to_map_lowres(x_pos), world_to_map_lowres(y_pos) };
+	if (bot.x < min_x || bot.x > max_x || bot.y < min_y || bot.y > max_y) {
+		return -1;
+	}
+	endkoord = bot;
+	if (bot.x != dstar_last.x || bot.y != dstar_last.y) {
+		dstar_km = dstar_add(dstar_km, astar_heuristic(dstar_last.x, dstar_last.y));
+		if (access_field_lowres(dstar_last, 0, 0) == 1) {
+			dstar_update_neighbourhood(dstar_last.x, dstar_last.y);
+		}
+		if (access_field_lowres(bot, 0, 0) == 1) {
+			dstar_update_neighbourhood(bot.x, bot.y);
+		}
+		dstar_last = bot;
+	}
+
+	/* ein Feld an der Zellengrenze kann die Nachbarzelle beeinflussen */
+	x1 = (int16_t) (x1 - 1 > min_x ? x1 - 1 : min_x);
+	y1 = (int16_t) (y1 - 1 > min_y ? y1 - 1 : min_y);
+	x2 = (int16_t) (x2 + 1 < max_x ? x2 + 1 : max_x);
+	y2 = (int16_t) (y2 + 1 < max_y ? y2 + 1 : max_y);
+	int16_t x, y;
+	uint16_t changed = 0;
+	for (y = y1; y <= y2; ++y) {
+		for (x = x1; x <= x2; ++x) {
+			const position_t cell = { x, y };
+			const int8_t hazard = (int8_t) hazard_at(x, y);
+			if (hazard != access_field_lowres(cell, 0, 0)) {
+				access_field_lowres(cell, hazard, 1);
+				dstar_update_neighbourhood(x, y);
+				++changed;
+			}
+		}
+	}
+
+	planning_stats.replans++;
+	const uint16_t expanded = planning_stats.expanded;
+	const uint32_t time_us = get_time_us();
+	const uint8_t found = dstar_compute();
+	LOG_INFO("Neuplanung %u: %u Zellen geaendert, %u Zellen expandiert, %" PRIu32 " us", planning_stats.replans, changed,
+		planning_stats.expanded - expanded, get_time_us() - time_us);
+	if (planning_stats.overflows) {
+		return -1;
+	}
+	return (int8_t) (found && dstar_trace());
+}
+#endif // PATHPLANNING_REPLAN_AVAILABLE
+#endif // PATHPLANNING_USE_WAVE
 
 #ifdef DEBUG_PATHPLANNING
 /**
@@ -375,11 +1115,12 @@ static void show_labmap(void) {
 #endif // DEBUG_PATHPLANNING
 
 /**
- * Wave-Verhalten; berechnet die Welle ausgehend vom Zielpunkt bis zur Botposition; dann wird diese zurueckverfolgt und sich der Pfad
- * auf dem Stack gemerkt und anschliessend das Stack-Fahrverhalten aufgerufen
+ * Pfadplanungs-Verhalten; sucht per A* (bzw. Welle) ausgehend vom Zielpunkt einen Weg bis zur Botposition; dann wird dieser
+ * zurueckverfolgt und sich der Pfad auf dem Stack gemerkt und anschliessend das Stack-Fahrverhalten aufgerufen
  * \param *data	Zeiger auf Verhaltensdatensatz
  */
 void bot_calc_wave_behaviour(Behaviour_t * data) {
+#ifdef PATHPLANNING_USE_WAVE
 	/** Mapvariable zum Durchlaufen der Lowres-Planungs-Map */
 	static position_t pos = { 0, 0 };
 
@@ -389,11 +1130,15 @@ void bot_calc_wave_behaviour(Behaviour_t * data) {
 
 	// Kennung ob eine gueltige Nachbarzelle gefunden werden konnte
 	static uint8_t neighbour_found = 0;
+#endif // PATHPLANNING_USE_WAVE
 
 	// Endekennung
 	static uint8_t endreached = False; // Kennung gesetzt fuer Ziel gefunden; Terminierung der Schleife
 
-	static uint8_t skip_count = 0; // Zaehlt die Anzahl der in der Queue uebersprungenen Punkte
+	uint32_t time_us;
+#ifdef PATHPLANNING_REPLAN_AVAILABLE
+	position_t next_pos;
+#endif
 
 	switch (wave_state) {
 	// zuerst loeschen der Planungs-LowRes-Karte
@@ -403,6 +1148,18 @@ void bot_calc_wave_behaviour(Behaviour_t * data) {
 		planning_pos_store = pos_store_create_size(data, pos_store_data, QUEUE_SIZE); // Stack / Queue anlegen / und leeren
 		wavecounter = 2; // geht ab Wert 2 los; d.h. Wert Wellenzentrum - Zielpunkt bekommt diesen Wert
 		access_field_lowres(startwave, 2, 1);
+		memset(&planning_stats, 0, sizeof(planning_stats));
+		endreached = False;
+#ifdef PATHPLANNING_REPLAN_AVAILABLE
+		/* Aenderungen ab jetzt merken, set_hazards() sieht den Stand davor */
+		os_enterCS();
+		dstar_dirty.min_x = INT16_MAX;
+		dstar_dirty.min_y = INT16_MAX;
+		dstar_dirty.max_x = INT16_MIN;
+		dstar_dirty.max_y = INT16_MIN;
+		os_exitCS();
+		map_set_change_handler(dstar_map_changed);
+#endif
 
 		wave_state = SET_HAZARDS_TO_LOWRES;
 		break;
@@ -410,12 +1167,45 @@ void bot_calc_wave_behaviour(Behaviour_t * data) {
 	// Uebertragen der in der Highres-Karte vermerkten Hindernisse in die Lowres-Planungs-Karte
 	case SET_HAZARDS_TO_LOWRES:
 		LOG_DEBUG("Hindernisse eintragen");
+		time_us = get_time_us();
 		set_hazards(); // Hindernisse aus der Highres-Karte in die Planungs-Lowres-Karte eintragen
+		planning_stats.hazards_us = get_time_us() - time_us;
+#ifdef PATHPLANNING_USE_WAVE
 		wave_state = NEIGHBOURS_FROM_FIFO;
+#else
+		wave_state = ASTAR_SEARCH;
+#endif
+		break;
+
+#ifndef PATHPLANNING_USE_WAVE
+	// A*-Suche vom Zielpunkt zur Botposition, Richtungen zu den Vorgaengern werden in die Lowres-Karte eingetragen
+	case ASTAR_SEARCH:
+		time_us = get_time_us();
+#ifdef PATHPLANNING_REPLAN_AVAILABLE
+		endreached = dstar_search();
+#else
+		endreached = astar_search();
+#endif
+		planning_stats.search_us = get_time_us() - time_us;
+		pos_store_clear(planning_pos_store);
+		wave_state = (uint8_t) (endreached ? ASTAR_TRACE : END);
 		break;
 
+	// Vorgaengern von der Botposition bis zum Zielpunkt folgen und die anzufahrenden Koordinaten in den Stack speichern
+	case ASTAR_TRACE:
+#ifdef PATHPLANNING_REPLAN_AVAILABLE
+		endreached = dstar_trace();
+#else
+		endreached = astar_trace();
+#endif
+		wave_state = (uint8_t) (endreached ? START_BOT_GO_STACK_BEHAVIOUR : END);
+		break;
+
+#else // PATHPLANNING_USE_WAVE
+
 	// hier abarbeiten aller in der FIFO-Queue eingetragenen Koordinaten, d.h. fuer jede wird wieder der gueltige Nachbar in die Queue hinten eingefuegt bis Ende erreicht
 	case NEIGHBOURS_FROM_FIFO:
+		time_us = get_time_us();
 		wavecounter++; // die ersten Nachbarn haben den Startwellenwert (2) + 1
 		endreached = False; // Abbruchbedingung der Schleife init.
 
@@ -442,6 +1232,7 @@ void bot_calc_wave_behaviour(Behaviour_t * data) {
 				// Kennung fuer gueltigen Nachbarn wieder ruecksetzen
 				neighbour_found = False;
 			} else {
+				planning_stats.expanded++;
 				// abarbeiten aller 4 Nachbarn zu einem Punkt der Queue, auch wenn schon gefunden wurde zwecks guter Pfadfindung; ein True wird nicht ueberschrieben
 				// nur 4 Nachbarn kann bei Pfadsuche auf befahrenem Gebiet zu keinem Pfad fuehren, wenn Bot bisher nur eine Fahrspur hat und schraeg faehrt, dann wuerde
 				// nur 8er Nachbarschaft Pfad erkennen
@@ -463,6 +1254,7 @@ void bot_calc_wave_behaviour(Behaviour_t * data) {
 		// Loeschen der FIFO-Queue; Stack- bzw. Queue-Array wird ja im folgenden
 		// verwendet zur Speicherung der Abfahrpositionen bei der Wellenrueckverfolgung vom Bot ausgehend zum Wellenstartpunkt
 		pos_store_clear(planning_pos_store);
+		planning_stats.search_us = get_time_us() - time_us;
 
 		// Wellenpfad zurueckverfolgen oder gleich Ende wenn nichts gefunden
 		wave_state = (uint8_t) (endreached ? SEARCH_STACKPATH_AND_QUEUE : END);
@@ -490,14 +1282,7 @@ void bot_calc_wave_behaviour(Behaviour_t * data) {
 		int8_t mapval_min = (int8_t) (wavecounter + 1); // auf erhoehten Wellenwert setzen, weil in Schleife der Wellenwert immer kleiner dem letzten Wellewert ist
 		endreached = False; // Schleifenabbruchvar init.
 		wavecounter = 0; // Wellenzaehler init.
-		skip_count = 0;
-
-#ifdef MAP_2_SIM_AVAILABLE
-        position_t lastpos ;
-        position_t aktpos ;
-        lastpos.x = 0; // initialisieren
-        lastpos.y = 0;
-#endif // MAP_2_SIM_AVAILABLE
+		waypoints_reset();
 
 		// Map durchlaufen und den Nachbarn mit immer niedrigerem Mapwert verfolgen bis Wellenstartpunkt erreicht wurde
 		while (!endreached) {
@@ -544,52 +1329,11 @@ void bot_calc_wave_behaviour(Behaviour_t * data) {
 			// Positionen auch zuerst abfahren
 			if (neighbour_found || endreached) {
 				LOG_DEBUG("Pfadpunkt in Queue %1d %1d Ende %1d", nextdest.x, nextdest.y, endreached);
-				// zum spaeteren Stack-Abfahren die Zwischenziel-Koordinaten als Weltkoordinaten auf den Stack legen
-				position_t pos_;
-				pos_.x = map_to_world_lowres(nextdest.x) + MAP_CELL_SIZE_LOWRES / 2;
-				pos_.y = map_to_world_lowres(nextdest.y) + MAP_CELL_SIZE_LOWRES / 2;
-
-				position_t pos_1, pos_2;
-				if (pos_store_top(planning_pos_store, &pos_1, 1) == True && pos_store_top(planning_pos_store, &pos_2, 2) == True) {
-					int8_t m_1 = (int8_t) (pos_1.x == pos_2.x ? 100 : (pos_1.y - pos_2.y) / (pos_1.x - pos_2.x));
-					int8_t m = (int8_t) (pos_.x == pos_1.x ? 100 : (pos_.y - pos_1.y) / (pos_.x - pos_1.x));
-#ifdef DEBUG_PATHPLANNING_VERBOSE
-					LOG_DEBUG(" pos_2=(%d|%d)", pos_2.x, pos_2.y);
-					LOG_DEBUG(" pos_1=(%d|%d)", pos_1.x, pos_1.y);
-					LOG_DEBUG(" pos_ =(%d|%d)", pos_.x, pos_.y);
-					LOG_DEBUG("  m_1=%3d\tm=%3d", m_1, m);
-					LOG_DEBUG("  skip_count=%u", skip_count);
-#endif // DEBUG_PATHPLANNING_VERBOSE
-					if (m_1 == m) {
-						LOG_DEBUG("Neuer Punkt auf einer Linie mit beiden Letzten");
-						if (skip_count < 3) {
-							LOG_DEBUG(" Verwerfe letzten Queue-Eintrag (%d|%d)", pos_1.x, pos_1.y);
-							pos_store_pop(planning_pos_store, &pos_1);
-							skip_count++;
-						} else {
-							LOG_DEBUG(" Verwerfe Eintrag NICHT, skip_count=%u", skip_count);
-							skip_count = 0;
-						}
-					} else {
-						skip_count = 0;
-					}
-				}
-
-				if (! pos_store_queue(planning_pos_store, pos_)) {
-					LOG_DEBUG("Queue ging schief - voll?");
+				if (! store_waypoint(nextdest)) {
 					endreached = False;
 					wave_state = END; // Fehler und Abbruch
 					break;
 				}
-
-#ifdef MAP_2_SIM_AVAILABLE
-				aktpos.x = world_to_map(map_to_world_lowres(nextdest.x) + MAP_CELL_SIZE_LOWRES / 2);
-				aktpos.y = world_to_map(map_to_world_lowres(nextdest.y) + MAP_CELL_SIZE_LOWRES / 2);
-				if (lastpos.x != 0 && lastpos.y != 0) {
-					map_draw_line(lastpos, aktpos, 2); // Pfadpunkte schwarz darstellen
-				}
-				lastpos = aktpos;
-#endif // MAP_2_SIM_AVAILABLE
 			}
 			wavecounter++; // Wellencounter erhoehen; dient hier nur fuer Abbruchbedingung nach erreichen eines bestimmten Zaehlerstandes
 
@@ -612,16 +1356,54 @@ void bot_calc_wave_behaviour(Behaviour_t * data) {
 			LOG_DEBUG("Pfad not found->Ende");
 		}
 		break;
+#endif // PATHPLANNING_USE_WAVE
 
 	case START_BOT_GO_STACK_BEHAVIOUR:
 		LOG_DEBUG("--Pfad gefunden und Abfahren -STACKGO--");
 #ifdef DEBUG_PATHPLANNING
 		show_labmap();
 #endif
+#ifdef PATHPLANNING_REPLAN_AVAILABLE
+		wave_state = REPLAN_DRIVE;
+#else
 		bot_drive_stack_x(data, pos_store_get_index(planning_pos_store), 1);
 		wave_state = CORRECT_POSITION;
+#endif
 		break;
 
+#ifdef PATHPLANNING_REPLAN_AVAILABLE
+	// Pfadpunkte einzeln anfahren, vor jedem Punkt auf Kartenaenderungen pruefen
+	case REPLAN_DRIVE:
+		if (dstar_changed()) {
+			wave_state = REPLAN_UPDATE;
+			break;
+		}
+		if (pos_store_dequeue(planning_pos_store, &next_pos)) {
+			LOG_DEBUG("fahre zu %1d %1d", next_pos.x, next_pos.y);
+			bot_goto_pos(data, next_pos.x, next_pos.y, 999);
+		} else {
+			wave_state = CORRECT_POSITION;
+		}
+		break;
+
+	// Plan an die veraenderte Karte anpassen
+	case REPLAN_UPDATE: {
+		const int8_t result = dstar_replan();
+		if (result < 0) {
+			LOG_DEBUG("Neuplanung nicht moeglich, plane komplett neu");
+			endkoord.x = world_to_map_lowres(x_pos);
+			endkoord.y = world_to_map_lowres(y_pos);
+			wave_state = START;
+		} else if (result) {
+			wave_state = REPLAN_DRIVE;
+		} else {
+			endreached = False;
+			wave_state = END;
+		}
+		break;
+	}
+#endif // PATHPLANNING_REPLAN_AVAILABLE
+
 	case CORRECT_POSITION:
 		bot_goto_pos(data, destination.x, destination.y, 999);
 		wave_state = END;
@@ -629,6 +1411,13 @@ void bot_calc_wave_behaviour(Behaviour_t * data) {
 
 	default:
 		LOG_DEBUG("Waveverhalten beendet. Wavecounter %1d", wavecounter);
+		LOG_INFO("Pfadplanung %s: %u Zellen expandiert, Hindernisse %" PRIu32 " us, Suche %" PRIu32 " us, offene Liste max. %u, %u Ueberlaeufe",
+			endreached ? "ok" : "ohne Pfad", planning_stats.expanded, planning_stats.hazards_us, planning_stats.search_us,
+			planning_stats.max_open, planning_stats.overflows);
+#ifdef PATHPLANNING_REPLAN_AVAILABLE
+		LOG_INFO("%u Neuplanungen", planning_stats.replans);
+		map_set_change_handler(NULL);
+#endif
 		pos_store_release(planning_pos_store);
 		planning_pos_store = NULL;
 		exit_behaviour(data, (uint8_t) (endreached ? BEHAVIOUR_SUBSUCCESS : BEHAVIOUR_SUBFAIL));
@@ -39,6 +39,7 @@
 #include "rc5.h"
 #include "rc5-codes.h"
 #include "gui.h"
+#include "os_thread.h"
 
 #define REMOTE_CALL_IDLE 0
 #define REMOTE_CALL_SCHEDULED 1
@@ -63,6 +64,10 @@ static const uint8_t * parameter_length = NULL; /**< Hier speichern wir die Laen
 
 //#define DEBUG_REMOTE_CALLS /**< Schalter um recht viel Debug-Code anzumachen */
 
+#if defined PC || defined __AVR_ATmega1284P__
+#define REMOTE_CALL_HASH_AVAILABLE /**< Namen ueber Hashtabelle statt linear suchen, braucht 2 Byte RAM pro Remote-Call */
+#endif
+
 #ifndef LOG_AVAILABLE
 #undef DEBUG_REMOTE_CALLS
 #endif
@@ -185,9 +190,12 @@ const remotecall_entry_t remotecall_beh_list[] PROGMEM = {
 #ifdef BEHAVIOUR_DRIVE_AREA_AVAILABLE
 	PREPARE_REMOTE_CALL(bot_drive_area, 0, "", 0),
 #endif
-#ifdef BEHAVIOUR_NEURALNET_AVAILABLE
+#if defined BEHAVIOUR_NEURALNET_AVAILABLE && ! defined NEURALNET_FIXED_AVAILABLE
 	PREPARE_REMOTE_CALL(bot_neuralnet, 0, "", 0),
 #endif
+#ifdef NEURALNET_PARALLEL_AVAILABLE
+	PREPARE_REMOTE_CALL_MANUAL(bot_neuralnet_multi, bot_neuralnet_behaviour, 0, "", 0),
+#endif
 #ifdef BEHAVIOUR_DRIVE_NEURALNET_AVAILABLE
 	PREPARE_REMOTE_CALL(bot_drive_neuralnet, 0, "", 0),
 #endif
@@ -267,6 +275,49 @@ const remotecall_entry_t remotecall_beh_list[] PROGMEM = {
 /** Anzahl der Remote-Calls im Array */
 #define STORED_CALLS (sizeof(remotecall_beh_list) / sizeof(remotecall_entry_t))
 
+#ifdef REMOTE_CALL_HASH_AVAILABLE
+/*
+ * Die Liste haengt von den aktiven Verhalten ab und liegt auf dem MCU im Flash, daher wird die
+ * Hashtabelle (offene Adressierung, lineares Sondieren, hoechstens halb voll) beim ersten Zugriff
+ * aufgebaut. Eintraege sind Index + 1, 0 markiert einen freien Platz.
+ */
+#define REMOTE_CALL_HASH_SIZE (STORED_CALLS * 2) /**< Groesse der Hashtabelle */
+static uint8_t remotecall_hash[REMOTE_CALL_HASH_SIZE]; /**< Hashtabelle Name -> Index + 1 */
+static volatile uint8_t remotecall_hash_ready = 0; /**< Hashtabelle aufgebaut? */
+
+/**
+ * Berechnet den Hashwert eines Funktionsnamens
+ * \param *name		Name der Funktion
+ * \param progmem	True, falls name im Flash liegt
+ * \return			Startposition in remotecall_hash
+ */
+static uint8_t remotecall_hash_name(const char * name, uint8_t progmem) {
+	uint16_t hash = 0;
+	char c;
+	while ((c = (char) (progmem ? pgm_read_byte(name) : *name)) != 0) {
+		hash = (uint16_t) (hash * 31 + (uint8_t) c);
+		++name;
+	}
+	return (uint8_t) (hash % REMOTE_CALL_HASH_SIZE);
+}
+
+/**
+ * Baut die Hashtabelle auf; bei doppelten Namen liegt der erste Eintrag
+ * in der Sondierungsfolge vorne und wird wie bei der linearen Suche gefunden
+ */
+static void remotecall_hash_build(void) {
+	uint8_t i;
+	for (i = 0; i < STORED_CALLS; ++i) {
+		uint8_t pos = remotecall_hash_name(remotecall_beh_list[i].name, 1);
+		while (remotecall_hash[pos] != 0) {
+			pos = (uint8_t) ((pos + 1) % REMOTE_CALL_HASH_SIZE);
+		}
+		remotecall_hash[pos] = (uint8_t) (i + 1);
+	}
+	remotecall_hash_ready = 1;
+}
+#endif // REMOTE_CALL_HASH_AVAILABLE
+
 /**
  * Sucht den Index des Remote-Calls heraus
  * \param *call	String mit dem Namen der gesuchten fkt
@@ -275,6 +326,26 @@ const remotecall_entry_t remotecall_beh_list[] PROGMEM = {
 uint8_t get_remotecall_id(const char * call) {
 	LOG_DEBUG("Suche nach Funktion: \"%s\"", call);
 
+#ifdef REMOTE_CALL_HASH_AVAILABLE
+	if (! remotecall_hash_ready) {
+		os_enterCS();
+		if (! remotecall_hash_ready) {
+			remotecall_hash_build();
+		}
+		os_exitCS();
+	}
+
+	uint8_t pos = remotecall_hash_name(call, 0);
+	uint8_t entry;
+	while ((entry = remotecall_hash[pos]) != 0) {
+		if (! strcmp_P(call, remotecall_beh_list[entry - 1].name)) {
+			LOG_DEBUG("calls[%u].name=\"%s\" passt", entry - 1, call);
+			return (uint8_t) (entry - 1);
+		}
+		pos = (uint8_t) ((pos + 1) % REMOTE_CALL_HASH_SIZE);
+	}
+	return 255;
+#else
 	uint8_t i;
 	for (i = 0; i < STORED_CALLS; ++i) {
 		if (!strcmp_P (call, remotecall_beh_list[i].name)) {
@@ -283,6 +354,7 @@ uint8_t get_remotecall_id(const char * call) {
 		}
 	}
 	return 255;
+#endif // REMOTE_CALL_HASH_AVAILABLE
 }
 
 /**
@@ -443,7 +515,7 @@ void bot_remotecall_behaviour(Behaviour_t * data) {
  * \param *data		Zeiger auf die Daten
  * \return 			Fehlercode (0: RemoteCall gestartet, -1: noch ein RC aktiv, -2: Funktion nicht gefunden)
  */
-static int8_t bot_remotecall_from_id(Behaviour_t * caller, const uint8_t id, const remote_call_data_t * data) {
+int8_t bot_remotecall_from_id(Behaviour_t * caller, const uint8_t id, const remote_call_data_t * data) {
 	if (running_behaviour != REMOTE_CALL_IDLE) {
 		/* Verhalten noch aktiv, Abbruch */
 		LOG_DEBUG("Bereits ein RemoteCall aktiv (ID=%u)!", function_id);
@@ -481,7 +553,7 @@ static int8_t bot_remotecall_from_id(Behaviour_t * caller, const uint8_t id, con
 	running_behaviour = REMOTE_CALL_SCHEDULED;
 
 #ifdef CREATE_TRACEFILE_AVAILABLE
-	trace_add_remotecall(remotecall_beh_list[function_id].name, parameter_count, (remote_call_data_t *) parameter_data);
+	trace_add_remotecall(remotecall_beh_list[function_id].name, parameter_count, (remote_call_data_t *) parameter_data, caller == NULL);
 #endif // CREATE_TRACEFILE_AVAILABLE
 
 	return 0;
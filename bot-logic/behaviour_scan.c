@@ -50,6 +50,7 @@
 //#define DEBUG_SCAN_OTF // Debug-Infos an
 
 scan_mode_t scan_otf_modes = {{1, 1, 1, 1}}; /**< Modi des Verhaltens */
+uint16_t scan_otf_halt_count = 0; /**< Anzahl, wie oft der Bot angehalten wurde, weil der Map-Cache voll war */
 
 /*!
  * Der Roboter aktualisiert kontinuierlich seine Karte
@@ -60,6 +61,7 @@ void bot_scan_onthefly_behaviour(Behaviour_t * data) {
 	static int16_t last_dist_x, last_dist_y, last_dist_head;
 	static int16_t last_border_x, last_border_y, last_border_head;
 	static uint8_t index = 0;
+	static uint8_t halted = False;
 
 	(void) data; // kein warning
 
@@ -73,8 +75,12 @@ void bot_scan_onthefly_behaviour(Behaviour_t * data) {
 				/* Stoppe den Bot, damit wir Zeit haben die Karte einzutragen
 				 * aber nur, wenn kein Abgrund erkannt wurde */
 				motor_set(BOT_SPEED_STOP, BOT_SPEED_STOP);
+				if (halted == False) {
+					halted = True;
+					++scan_otf_halt_count;
+				}
 #ifdef DEBUG_SCAN_OTF
-				LOG_DEBUG("Map-Cache voll, halte Bot an");
+				LOG_DEBUG("Map-Cache voll, halte Bot an (%u. Mal)", scan_otf_halt_count);
 #endif
 				/* Halte alle Verhalten eine Weile an, weil sie ja sonst evtl. weiterfahren wuerden */
 				os_thread_sleep(SCAN_OTF_SLEEP_TIME);
@@ -86,6 +92,7 @@ void bot_scan_onthefly_behaviour(Behaviour_t * data) {
 			}
 			return;
 		}
+		halted = False;
 		/* Cache sehr voll */
 		if (v_enc_left == 0 && v_enc_right == 0) {
 			/* Falls Bot gerade steht, dann kleine Pause */
@@ -94,13 +101,17 @@ void bot_scan_onthefly_behaviour(Behaviour_t * data) {
 		}
 	}
 
+	halted = False;
+
 	/* Cache updaten, falls sich der Bot weit genug bewegt hat. */
 	index++;
 	if (index == MAP_UPDATE_CACHE_SIZE) {
 		index = 0;
 	}
 	map_cache_t * cache_tmp = &map_update_cache[index];
-	cache_tmp->mode.raw = 0;
+	cache_tmp->location = 0;
+	cache_tmp->distance = 0;
+	cache_tmp->border = 0;
 	cache_tmp->dataL = 0;
 	cache_tmp->dataR = 0;
 #ifdef MEASURE_POSITION_ERRORS_AVAILABLE
@@ -117,7 +128,7 @@ void bot_scan_onthefly_behaviour(Behaviour_t * data) {
 		uint16_t diff = (uint16_t) get_dist(x_pos, y_pos, last_location_x, last_location_y);
 		if (diff > (SCAN_OTF_RESOLUTION_DISTANCE_LOCATION * SCAN_OTF_RESOLUTION_DISTANCE_LOCATION)) {
 			// ist er weiter als SCAN_ONTHEFLY_DIST_RESOLUTION gefahren ==> Standflaeche aktualisieren
-			cache_tmp->mode.data.location = 1;
+			cache_tmp->location = 1;
 			// Letzte Location-Update-Position sichern
 			last_location_x = x_pos;
 			last_location_y = y_pos;
@@ -138,7 +149,7 @@ void bot_scan_onthefly_behaviour(Behaviour_t * data) {
 		if ((turned > SCAN_OTF_RESOLUTION_ANGLE_DISTSENS) ||
 			(diff > (SCAN_OTF_RESOLUTION_DISTANCE_DISTSENS * SCAN_OTF_RESOLUTION_DISTANCE_DISTSENS))) {
 			// Hat sich der Bot mehr als SCAN_ONTHEFLY_ANGLE_RESOLUTION gedreht ==> Blickstrahlen aktualisieren
-			cache_tmp->mode.data.distance = 1;
+			cache_tmp->distance = 1;
 
 			cache_tmp->dataL = (uint8_t) (sensDistL / 5);
 			cache_tmp->dataR = (uint8_t) (sensDistR / 5);
@@ -162,8 +173,8 @@ void bot_scan_onthefly_behaviour(Behaviour_t * data) {
 		int16_t turned = turned_angle(last_border_head);
 		if (((diff > (SCAN_OTF_RESOLUTION_DISTANCE_BORDER * SCAN_OTF_RESOLUTION_DISTANCE_BORDER)) || (turned > SCAN_OTF_RESOLUTION_ANGLE_BORDER))
 			&& ((sensBorderL > BORDER_DANGEROUS) || (sensBorderR > BORDER_DANGEROUS))) {
-				cache_tmp->mode.data.border = 1;
-				cache_tmp->mode.data.distance = 0;
+				cache_tmp->border = 1;
+				cache_tmp->distance = 0;
 				cache_tmp->dataL = (uint8_t) (sensBorderL > BORDER_DANGEROUS);
 				cache_tmp->dataR = (uint8_t) (sensBorderR > BORDER_DANGEROUS);
 
@@ -174,21 +185,14 @@ void bot_scan_onthefly_behaviour(Behaviour_t * data) {
 	}
 
 	// ist ein Update angesagt?
-	if (cache_tmp->mode.data.distance || cache_tmp->mode.data.location || cache_tmp->mode.data.border) {
+	if (cache_tmp->distance || cache_tmp->location || cache_tmp->border) {
 		cache_tmp->x_pos = x_pos;
 		cache_tmp->y_pos = y_pos;
 
-#ifdef MAP_USE_TRIG_CACHE
-		if (cache_tmp->mode.data.distance || cache_tmp->mode.data.border) {
-			cache_tmp->sin = heading_sin;
-			cache_tmp->cos = heading_cos;
-		}
-#else
-		cache_tmp->heading = heading_10_int;
-#endif // MAP_USE_TRIG_CACHE
+		cache_tmp->heading = (uint16_t) heading_10_int;
 
 #ifdef DEBUG_SCAN_OTF
-		LOG_DEBUG("neuer Eintrag: x=%d y=%d head=%f distance=%d loaction=%d border=%d", cache_tmp->x_pos, cache_tmp->y_pos, cache_tmp->heading / 10.0f, cache_tmp->mode.distance, cache_tmp->mode.location, cache_tmp->mode.border);
+		LOG_DEBUG("neuer Eintrag: x=%d y=%d head=%f distance=%d loaction=%d border=%d", cache_tmp->x_pos, cache_tmp->y_pos, cache_tmp->heading / 10.0f, cache_tmp->distance, cache_tmp->location, cache_tmp->border);
 #endif
 
 		_inline_fifo_put(&map_update_fifo, index, False);
@@ -42,6 +42,9 @@
 
 #include <stdio.h>
 #include <string.h>
+#ifdef PC
+#include <sys/time.h>
+#endif
 
 //#define DEBUG_UBASIC_BEHAV /**< Debug-Schalter fuer das uBasic-Verhalten */
 
@@ -82,11 +85,26 @@ void bot_ubasic_load_file(char* filename, pFatFile* file) {
 	LOG_DEBUG(" ubasic_prog_file=%p", ubasic_prog_file);
 	sdfat_rewind(*file);
 	ubasic_ptr = 0xffff;
+#if UBASIC_BYTECODE
+	/* Datei kann noch leer sein (Programmempfang vom Sim), daher erst beim Start uebersetzen */
+	tokenizer_discard_bytecode();
+#endif
 #if UBASIC_EXT_PROC
 	strncpy(current_proc, filename, MAX_PROG_NAME_LEN);
 #endif
 }
 
+#if UBASIC_BYTECODE
+/**
+ * Uebersetzt das geladene Programm in Token-Code
+ */
+static void compile_prog(void) {
+	if (tokenizer_compile(0) != 0) {
+		LOG_INFO("Programm passt nicht in den Token-Code-Puffer, wird direkt interpretiert");
+	}
+}
+#endif // UBASIC_BYTECODE
+
 /**
  * Liest eine uBasic-Programmdatei ein
  * \param keynum	Ziffer im Basic-Dateinamen
@@ -192,6 +210,9 @@ void bot_ubasic(Behaviour_t* caller) {
 	ubasic_behaviour_data = get_behaviour(bot_ubasic_behaviour);
 	ubasic_set_speed(BOT_SPEED_IGNORE, BOT_SPEED_IGNORE); // alte Speed-Wuensche neutralisieren
 
+#if UBASIC_BYTECODE
+	compile_prog();
+#endif
 	ubasic_init(0);
 }
 
@@ -202,6 +223,77 @@ void bot_ubasic_break(void) {
 	ubasic_break();
 }
 
+#ifdef PC
+/**
+ * Misst die Ausfuehrungsgeschwindigkeit des Interpreters mit den Beispielprogrammen
+ * aus bot-logic/basic, einmal direkt aus dem Quelltext und einmal als Token-Code
+ * \param lines	Anzahl der auszufuehrenden Zeilen je Programm und Variante
+ */
+void bot_ubasic_benchmark(uint32_t lines) {
+	/* bas4 / bas5 fehlen, weil sie nur aus print-Anweisungen und einem Aufruf von /basic/bas5.txt bestehen */
+	static const char* const progs[] = { "bas1.txt", "bas2.txt", "bas3.txt", "solve_maze.txt", "solve_maze_v2.txt" };
+	static char tmp_name[] = "ubasic.tmp";
+	uint8_t block[SD_BLOCK_SIZE];
+	uint8_t p;
+
+	printf("uBasic: %" PRIu32 " Zeilen je Programm\n", lines);
+	for (p = 0; p < sizeof(progs) / sizeof(progs[0]); ++p) {
+		char src_name[64];
+		snprintf(src_name, sizeof(src_name), "bot-logic/basic/%s", progs[p]);
+		FILE* src = fopen(src_name, "rb");
+		if (! src) {
+			printf("%s nicht gefunden\n", src_name);
+			continue;
+		}
+
+		/* wie beim Programmempfang vom Sim blockweise und mit Nullen aufgefuellt speichern */
+		pFatFile file;
+		if (sdfat_open(tmp_name, &file, SDFAT_O_RDWR | SDFAT_O_TRUNC | SDFAT_O_CREAT)) {
+			fclose(src);
+			return;
+		}
+		size_t n;
+		do {
+			memset(block, 0, sizeof(block));
+			n = fread(block, 1, sizeof(block), src);
+			sdfat_write(file, block, sizeof(block));
+		} while (n == sizeof(block));
+		fclose(src);
+		sdfat_flush(file);
+
+		uint64_t t_us[2];
+		uint8_t compiled;
+		for (compiled = 0; compiled < 2; ++compiled) {
+			bot_ubasic_load_file(tmp_name, &file);
+			if (compiled && tokenizer_compile(0) != 0) {
+				printf("%s passt nicht in den Token-Code-Puffer\n", progs[p]);
+			}
+			ubasic_init(0);
+			struct timeval start, now;
+			gettimeofday(&start, NULL);
+			uint32_t i;
+			for (i = 0; i < lines; ++i) {
+				ubasic_run();
+				if (ubasic_finished()) {
+					ubasic_init(0);
+				}
+			}
+			gettimeofday(&now, NULL);
+			t_us[compiled] = (uint64_t) (now.tv_sec - start.tv_sec) * 1000000ULL + (uint64_t) now.tv_usec - (uint64_t) start.tv_usec;
+			if (t_us[compiled] == 0) {
+				t_us[compiled] = 1;
+			}
+		}
+		sdfat_close(file);
+		tokenizer_discard_bytecode();
+
+		printf("%-18s Text %10.0f Zeilen/s, Token-Code %10.0f Zeilen/s, Beschleunigung %.2f\n", progs[p],
+			(double) lines * 1e6 / (double) t_us[0], (double) lines * 1e6 / (double) t_us[1], (double) t_us[0] / (double) t_us[1]);
+	}
+	remove(tmp_name);
+}
+#endif // PC
+
 /**
  * Keyhandler fuer das Basic-Verhalten; laedt nach druecken einer Taste 1-9
  * das Basic-Prog /basic/bas[1-9].txt
@@ -268,6 +360,9 @@ void switch_proc(char* p_name) {
 		ubasic_break();
 	} else {
 		bot_ubasic_load_file(p_name, &new_prog);
+#if UBASIC_BYTECODE
+		compile_prog();
+#endif
 		program_ptr = 0;
 		tokenizer_init(program_ptr);
 	}
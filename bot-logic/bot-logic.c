@@ -209,7 +209,7 @@ void bot_behave_init(void) {
 	insert_behaviour_to_list(&behaviour, new_behaviour(103, bot_adventcal_behaviour, BEHAVIOUR_ACTIVE));
 #endif
 
-#ifdef BEHAVIOUR_NEURALNET_AVAILABLE
+#if defined BEHAVIOUR_NEURALNET_AVAILABLE && ! defined NEURALNET_FIXED_AVAILABLE
 	// Training des neuronalen Netzes sofort starten bei Vorhandensein, da initiale Lernpattern vorhanden sind
 	insert_behaviour_to_list(&behaviour, new_behaviour(102, bot_neuralnet_behaviour, BEHAVIOUR_ACTIVE));
 #endif
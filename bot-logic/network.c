@@ -17,7 +17,9 @@
 
 #include "bot-logic.h"
 
-#ifdef BEHAVIOUR_NEURALNET_AVAILABLE
+/* with NEURALNET_FIXED_AVAILABLE the bot only runs the fixed-point net
+ * (neuralnet_fixed.c), the PC build still needs the library for the converter */
+#if defined BEHAVIOUR_NEURALNET_AVAILABLE && (defined PC || ! defined NEURALNET_FIXED_AVAILABLE)
 
 #include <assert.h>
 #include <stdarg.h>
@@ -50,17 +52,16 @@
 void
 net_randomize (network_t *net, float range)
 {
-  int l, nu, nl;
+  int l, i, n;
 
   assert (net != NULL);
   assert (range >= 0.0f);
 
   for (l = 1; l < net->no_of_layers; l++) {
-    for (nu = 0; nu < net->layer[l].no_of_neurons; nu++) {
-      for (nl = 0; nl <= net->layer[l - 1].no_of_neurons; nl++) {
-        net->layer[l].neuron[nu].weight[nl] =
-          2.0f * range * ((float) rand() / RAND_MAX - 0.5f);
-      }
+    n = net->layer[l].no_of_neurons * (net->layer[l - 1].no_of_neurons + 1);
+    for (i = 0; i < n; i++) {
+      net->layer[l].weight[i] =
+        2.0f * range * ((float) rand() / RAND_MAX - 0.5f);
     }
   }
 }
@@ -72,16 +73,13 @@ net_randomize (network_t *net, float range)
 static void
 net_reset_weights (network_t *net)
 {
-  int l, nu, nl;
+  int l;
 
   assert (net != NULL);
 
   for (l = 1; l < net->no_of_layers; l++) {
-    for (nu = 0; nu < net->layer[l].no_of_neurons; nu++) {
-      for (nl = 0; nl <= net->layer[l - 1].no_of_neurons; nl++) {
-        net->layer[l].neuron[nu].weight[nl] = 0.0f;
-      }
-    }
+    memset (net->layer[l].weight, 0, (size_t)(net->layer[l].no_of_neurons *
+            (net->layer[l - 1].no_of_neurons + 1)) * sizeof (float));
   }
 }
 #endif
@@ -92,16 +90,13 @@ net_reset_weights (network_t *net)
 void
 net_reset_deltas (network_t *net)
 {
-  int l, nu, nl;
+  int l;
 
   assert (net != NULL);
 
   for (l = 1; l < net->no_of_layers; l++) {
-    for (nu = 0; nu < net->layer[l].no_of_neurons; nu++) {
-      for (nl = 0; nl <= net->layer[l - 1].no_of_neurons; nl++) {
-        net->layer[l].neuron[nu].delta[nl] = 0.0f;
-      }
-    }
+    memset (net->layer[l].delta, 0, (size_t)(net->layer[l].no_of_neurons *
+            (net->layer[l - 1].no_of_neurons + 1)) * sizeof (float));
   }
 }
 
@@ -121,12 +116,12 @@ net_use_bias(network_t *net, int flag)
   if (flag != 0) {
     /* permanently set output of bias neurons to 1 */
     for (l = 0; l < net->no_of_layers; l++) {
-      net->layer[l].neuron[net->layer[l].no_of_neurons].output = 1.0f;
+      net->layer[l].output[net->layer[l].no_of_neurons] = 1.0f;
     }
   } else {
     /* permanently set output of bias neurons to 0 */
     for (l = 0; l < net->no_of_layers; l++) {
-      net->layer[l].neuron[net->layer[l].no_of_neurons].output = 0.0f;
+      net->layer[l].output[net->layer[l].no_of_neurons] = 0.0f;
     }
   }
 }
@@ -139,8 +134,9 @@ net_use_bias(network_t *net, int flag)
  * \param layer Pointer to layer of a neural network.
  * \param no_of_neurons Integer.
  *
- * Allocate memory for a list of no_of_neuron + 1 neurons in the specified
- * layer. The extra neuron is used for the bias.
+ * Allocate memory for the outputs and errors of no_of_neuron + 1 neurons
+ * in the specified layer. The extra neuron is used for the bias. Both
+ * arrays share one block of memory.
  */
 static void
 allocate_layer (layer_t *layer, int no_of_neurons)
@@ -149,7 +145,8 @@ allocate_layer (layer_t *layer, int no_of_neurons)
   assert (no_of_neurons > 0);
 
   layer->no_of_neurons = no_of_neurons;
-  layer->neuron = (neuron_t *) calloc ((size_t)(no_of_neurons + 1), sizeof (neuron_t));
+  layer->output = (float *) calloc (2 * (size_t)(no_of_neurons + 1), sizeof (float));
+  layer->error = layer->output + no_of_neurons + 1;
 }
 
 /*!\brief [Internal] Allocate memory for the weights connecting two layers.
@@ -163,21 +160,16 @@ allocate_layer (layer_t *layer, int no_of_neurons)
 static void
 allocate_weights (layer_t *lower, layer_t *upper)
 {
-  int n;
+  size_t n;
 
   assert (lower != NULL);
   assert (upper != NULL);
 
-  for (n = 0; n < upper->no_of_neurons; n++) {
-    upper->neuron[n].weight =
-      (float *) calloc ((size_t)(lower->no_of_neurons + 1), sizeof (float));
-    upper->neuron[n].delta =
-      (float *) calloc ((size_t)(lower->no_of_neurons + 1), sizeof (float));
-  }
-
-  /* no incoming weights for bias neurons */
-  upper->neuron[n].weight = NULL;
-  upper->neuron[n].delta = NULL;
+  /* one row per neuron of the upper layer, no incoming weights for the
+   * bias neuron; weights and deltas share one block of memory */
+  n = (size_t) upper->no_of_neurons * (size_t)(lower->no_of_neurons + 1);
+  upper->weight = (float *) calloc (2 * n, sizeof (float));
+  upper->delta = upper->weight + n;
 }
 
 /*!\brief Allocate memory for a network.
@@ -267,18 +259,13 @@ net_allocate (int no_of_layers, ...)
 void
 net_free (network_t *net)
 {
-  int l, n;
+  int l;
 
   assert (net != NULL);
 
   for (l = 0; l < net->no_of_layers; l++) {
-    if (l != 0) {
-      for (n = 0; n < net->layer[l].no_of_neurons; n++) {
-        free (net->layer[l].neuron[n].weight);
-        free (net->layer[l].neuron[n].delta);
-      }
-    }
-    free (net->layer[l].neuron);
+    free (net->layer[l].weight);
+    free (net->layer[l].output);
   }
   free (net->layer);
   free (net);
@@ -409,11 +396,11 @@ void
 net_set_weight (network_t *net, int l, int nl, int nu, float weight)
 {
   assert (net != NULL);
-  assert (0 <= l && l < net->no_of_layers);
+  assert (0 <= l && l < net->no_of_layers-1);
   assert (0 <= nl && nl <= net->layer[l].no_of_neurons);
   assert (0 <= nu && nu < net->layer[l+1].no_of_neurons);
 
-  net->layer[l].neuron[nu].weight[nl] = weight;
+  net->layer[l+1].weight[nu * (net->layer[l].no_of_neurons + 1) + nl] = weight;
 }
 
 /*!\brief Retrieve a weight of a network.
@@ -432,7 +419,7 @@ net_get_weight (const network_t *net, int l, int nl, int nu)
   assert (0 <= nl && nl <= net->layer[l].no_of_neurons);
   assert (0 <= nu && nu < net->layer[l+1].no_of_neurons);
 
-  return net->layer[l].neuron[nu].weight[nl];
+  return net->layer[l+1].weight[nu * (net->layer[l].no_of_neurons + 1) + nl];
 }
 
 /*!\brief Retrieve a bias weight of a network.
@@ -493,7 +480,7 @@ net_set_bias (network_t *net, int l, int nu, float weight)
 int
 net_fprint (FILE *file, const network_t *net)
 {
-  int l, nu, nl, result;
+  int l, i, n, result;
 
   assert (file != NULL);
   assert (net != NULL);
@@ -526,12 +513,11 @@ net_fprint (FILE *file, const network_t *net)
 
   /* write network weights */
   for (l = 1; l < net->no_of_layers; l++) {
-    for (nu = 0; nu < net->layer[l].no_of_neurons; nu++) {
-      for (nl = 0; nl <= net->layer[l - 1].no_of_neurons; nl++) {
-        result = fprintf (file, "%f\n", (double)net->layer[l].neuron[nu].weight[nl]);
-        if (result < 0) {
-          return result;
-        }
+    n = net->layer[l].no_of_neurons * (net->layer[l - 1].no_of_neurons + 1);
+    for (i = 0; i < n; i++) {
+      result = fprintf (file, "%f\n", (double)net->layer[l].weight[i]);
+      if (result < 0) {
+        return result;
       }
     }
   }
@@ -546,7 +532,7 @@ net_fprint (FILE *file, const network_t *net)
 network_t *
 net_fscan (FILE *file)
 {
-  int no_of_layers, l, nu, nl, *arglist, result;
+  int no_of_layers, l, i, n, *arglist, result;
   network_t *net;
 
   assert (file != NULL);
@@ -593,13 +579,12 @@ net_fscan (FILE *file)
 
   /* read network weights */
   for (l = 1; l < net->no_of_layers; l++) {
-    for (nu = 0; nu < net->layer[l].no_of_neurons; nu++) {
-      for (nl = 0; nl <= net->layer[l - 1].no_of_neurons; nl++) {
-        result = fscanf (file, "%f", &net->layer[l].neuron[nu].weight[nl]);
-        if (result <= 0) {
-          net_free (net);
-          return NULL;
-        }
+    n = net->layer[l].no_of_neurons * (net->layer[l - 1].no_of_neurons + 1);
+    for (i = 0; i < n; i++) {
+      result = fscanf (file, "%f", &net->layer[l].weight[i]);
+      if (result <= 0) {
+        net_free (net);
+        return NULL;
       }
     }
   }
@@ -679,7 +664,7 @@ net_load (const char *filename)
 int
 net_fbprint (FILE *file, const network_t *net)
 {
-  int l, nu;
+  int l;
   size_t info_dim = (size_t)(net->no_of_layers + 1);
   int info[info_dim];
   float constants[3];
@@ -702,12 +687,10 @@ net_fbprint (FILE *file, const network_t *net)
   constants[2] = net->global_error;
   fwrite (constants, sizeof (float), 3, file);
 
-  /* write network weights */
+  /* write network weights, one row per neuron */
   for (l = 1; l < net->no_of_layers; l++) {
-    for (nu = 0; nu < net->layer[l].no_of_neurons; nu++) {
-      fwrite (net->layer[l].neuron[nu].weight, sizeof (float),
-              (size_t)net->layer[l - 1].no_of_neurons + 1, file);
-    }
+    fwrite (net->layer[l].weight, sizeof (float), (size_t)net->layer[l].no_of_neurons *
+            ((size_t)net->layer[l - 1].no_of_neurons + 1), file);
   }
 
   return 0;
@@ -720,7 +703,7 @@ net_fbprint (FILE *file, const network_t *net)
 network_t *
 net_fbscan (FILE *file)
 {
-  int no_of_layers, l, nu, *arglist;
+  int no_of_layers, l, *arglist;
   network_t *net;
 
   assert (file != NULL);
@@ -746,9 +729,8 @@ net_fbscan (FILE *file)
 
   /* read network weights */
   for (l = 1; l < net->no_of_layers; l++) {
-    for (nu = 0; nu < net->layer[l].no_of_neurons; nu++) {
-    	fread (net->layer[l].neuron[nu].weight, sizeof (float), (size_t)net->layer[l - 1].no_of_neurons + 1, file);
-    }
+    fread (net->layer[l].weight, sizeof (float), (size_t)net->layer[l].no_of_neurons *
+           ((size_t)net->layer[l - 1].no_of_neurons + 1), file);
   }
 
   return net;
@@ -811,14 +793,10 @@ net_bload (const char *filename)
 static inline void
 set_input (network_t *net, const float *input)
 {
-  int n;
-
   assert (net != NULL);
   assert (input != NULL);
 
-  for (n = 0; n < net->input_layer->no_of_neurons; n++) {
-    net->input_layer->neuron[n].output = input[n];
-  }
+  memcpy (net->input_layer->output, input, (size_t)net->input_layer->no_of_neurons * sizeof (float));
 }
 
 /*!\brief [Interal] Copy outputs from output layer of a network.
@@ -826,14 +804,10 @@ set_input (network_t *net, const float *input)
 static inline void
 get_output (const network_t *net, float *output)
 {
-  int n;
-  
   assert (net != NULL);
   assert (output != NULL);
 
-  for (n = 0; n < net->output_layer->no_of_neurons; n++) {
-    output[n] = net->output_layer->neuron[n].output;
-  }
+  memcpy (output, net->output_layer->output, (size_t)net->output_layer->no_of_neurons * sizeof (float));
 }
 
 /****************************************
@@ -874,30 +848,102 @@ sigma (float x)
 
 #endif
 
+/****************************************
+ * Vector Operations
+ ****************************************/
+
+/* The loops below handle four elements per iteration with independent
+ * operations, so the compiler maps them onto SIMD instructions (SSE,
+ * NEON) at -O2 without being allowed to reorder floating point math. */
+
+/*!\brief [Internal] Dot product of two vectors of length n.
+ */
+static inline float
+dot_product (const float *restrict a, const float *restrict b, int n)
+{
+  float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+  int i;
+
+  for (i = 0; i + 4 <= n; i += 4) {
+    s0 += a[i] * b[i];
+    s1 += a[i + 1] * b[i + 1];
+    s2 += a[i + 2] * b[i + 2];
+    s3 += a[i + 3] * b[i + 3];
+  }
+  for (; i < n; i++) {
+    s0 += a[i] * b[i];
+  }
+
+  return (s0 + s1) + (s2 + s3);
+}
+
+/*!\brief [Internal] y += alpha * x for vectors of length n.
+ */
+static inline void
+add_scaled (float *restrict y, const float *restrict x, float alpha, int n)
+{
+  int i;
+
+  for (i = 0; i + 4 <= n; i += 4) {
+    y[i] += alpha * x[i];
+    y[i + 1] += alpha * x[i + 1];
+    y[i + 2] += alpha * x[i + 2];
+    y[i + 3] += alpha * x[i + 3];
+  }
+  for (; i < n; i++) {
+    y[i] += alpha * x[i];
+  }
+}
+
+/*!\brief [Internal] delta = alpha * x + momentum * delta, weight += delta
+ * for vectors of length n.
+ */
+static inline void
+add_scaled_momentum (float *restrict weight, float *restrict delta,
+                     const float *restrict x, float alpha, float momentum,
+                     int n)
+{
+  int i;
+
+  for (i = 0; i + 4 <= n; i += 4) {
+    delta[i] = alpha * x[i] + momentum * delta[i];
+    delta[i + 1] = alpha * x[i + 1] + momentum * delta[i + 1];
+    delta[i + 2] = alpha * x[i + 2] + momentum * delta[i + 2];
+    delta[i + 3] = alpha * x[i + 3] + momentum * delta[i + 3];
+    weight[i] += delta[i];
+    weight[i + 1] += delta[i + 1];
+    weight[i + 2] += delta[i + 2];
+    weight[i + 3] += delta[i + 3];
+  }
+  for (; i < n; i++) {
+    delta[i] = alpha * x[i] + momentum * delta[i];
+    weight[i] += delta[i];
+  }
+}
+
 /****************************************
  * Forward and Backward Propagation
  ****************************************/
 
 /*!\brief [Internal] Forward propagate inputs from one layer to next layer.
+ *
+ * Matrix-vector product of the weight matrix of the upper layer with the
+ * outputs (including bias) of the lower layer.
  */
 static inline void
 propagate_layer (layer_t *lower, layer_t *upper)
 {
-  int nu, nl;
-  float value;
+  int nu, cols;
+  const float *weight;
 
   assert (lower != NULL);
   assert (upper != NULL);
 
+  cols = lower->no_of_neurons + 1;
+  weight = upper->weight;
   for (nu = 0; nu < upper->no_of_neurons; nu++) {
-    value = 0.0f;
-    for (nl = 0; nl <= lower->no_of_neurons; nl++) {
-      value += upper->neuron[nu].weight[nl] * lower->neuron[nl].output;
-    }
-#if 0 /* if activation value has to be stored in neuron */
-    upper->neuron[nu].activation = value;
-#endif
-    upper->neuron[nu].output = sigma (value);
+    upper->output[nu] = sigma (dot_product (weight, lower->output, cols));
+    weight += cols;
   }
 }
 
@@ -941,9 +987,9 @@ net_compute_output_error (network_t *net, const float *target)
 
   net->global_error = 0.0f;
   for (n = 0; n < net->output_layer->no_of_neurons; n++) {
-    output = net->output_layer->neuron[n].output;
+    output = net->output_layer->output[n];
     error = target[n] - output;
-    net->output_layer->neuron[n].error = output * (1.0f - output) * error;
+    net->output_layer->error[n] = output * (1.0f - output) * error;
     net->global_error += error * error;
   }
   net->global_error *= 0.5f;
@@ -970,23 +1016,27 @@ net_get_output_error (const network_t *net)
 }
 
 /*!\brief [Internal] Backpropagate error from one layer to previous layer.
+ *
+ * The transposed matrix-vector product is accumulated row by row, so the
+ * weights are read in memory order.
  */
 static inline void
 backpropagate_layer (layer_t *lower, layer_t *upper)
 {
-  int nl, nu;
-  float output, error;
+  int nl, nu, cols;
+  float output;
 
   assert (lower != NULL);
   assert (upper != NULL);
 
-  for (nl = 0; nl <= lower->no_of_neurons; nl++) {
-    error = 0.0f;
-    for (nu = 0; nu < upper->no_of_neurons; nu++) {
-      error += upper->neuron[nu].weight[nl] * upper->neuron[nu].error;
-    }
-    output = lower->neuron[nl].output;
-    lower->neuron[nl].error = output * (1.0f - output) * error;
+  cols = lower->no_of_neurons + 1;
+  memset (lower->error, 0, (size_t)cols * sizeof (float));
+  for (nu = 0; nu < upper->no_of_neurons; nu++) {
+    add_scaled (lower->error, &upper->weight[nu * cols], upper->error[nu], cols);
+  }
+  for (nl = 0; nl < cols; nl++) {
+    output = lower->output[nl];
+    lower->error[nl] = output * (1.0f - output) * lower->error[nl];
   }
 }
 
@@ -1009,26 +1059,24 @@ backward_pass (network_t *net)
 static inline void
 adjust_weights (network_t *net)
 {
-  int l, nu, nl;
-  float error, delta;
+  int l, nu, cols;
+  layer_t *lower, *upper;
 
   assert (net != NULL);
 
   for (l = 1; l < net->no_of_layers; l++) {
-    for (nu = 0; nu < net->layer[l].no_of_neurons; nu++) {
-      error = net->layer[l].neuron[nu].error;
-      for (nl = 0; nl <= net->layer[l - 1].no_of_neurons; nl++) {
+    lower = &net->layer[l - 1];
+    upper = &net->layer[l];
+    cols = lower->no_of_neurons + 1;
+    for (nu = 0; nu < upper->no_of_neurons; nu++) {
 #if 1
-        delta =
-          net->learning_rate * error * net->layer[l - 1].neuron[nl].output +
-          net->momentum * net->layer[l].neuron[nu].delta[nl];
-        net->layer[l].neuron[nu].weight[nl] += delta;
-        net->layer[l].neuron[nu].delta[nl] = delta;
+      add_scaled_momentum (&upper->weight[nu * cols], &upper->delta[nu * cols],
+                           lower->output, net->learning_rate * upper->error[nu],
+                           net->momentum, cols);
 #else /* without momentum */
-        net->layer[l].neuron[nu].weight[nl] +=
-          net->learning_rate * error * net->layer[l - 1].neuron[nl].output;
+      add_scaled (&upper->weight[nu * cols], lower->output,
+                  net->learning_rate * upper->error[nu], cols);
 #endif
-      }
     }
   }
 }
@@ -1090,18 +1138,18 @@ net_train (network_t *net)
 static inline void
 adjust_deltas_batch (network_t *net)
 {
-  int l, nu, nl;
-  float error;
+  int l, nu, cols;
+  layer_t *lower, *upper;
 
   assert (net != NULL);
 
   for (l = 1; l < net->no_of_layers; l++) {
-    for (nu = 0; nu < net->layer[l].no_of_neurons; nu++) {
-      error = net->layer[l].neuron[nu].error;
-      for (nl = 0; nl <= net->layer[l - 1].no_of_neurons; nl++) {
-        net->layer[l].neuron[nu].delta[nl] +=
-          net->learning_rate * error * net->layer[l - 1].neuron[nl].output;
-      }
+    lower = &net->layer[l - 1];
+    upper = &net->layer[l];
+    cols = lower->no_of_neurons + 1;
+    for (nu = 0; nu < upper->no_of_neurons; nu++) {
+      add_scaled (&upper->delta[nu * cols], lower->output,
+                  net->learning_rate * upper->error[nu], cols);
     }
   }
 }
@@ -1113,17 +1161,14 @@ adjust_deltas_batch (network_t *net)
 static inline void
 adjust_weights_batch (network_t *net)
 {
-  int l, nu, nl;
+  int l;
 
   assert (net != NULL);
 
   for (l = 1; l < net->no_of_layers; l++) {
-    for (nu = 0; nu < net->layer[l].no_of_neurons; nu++) {
-      for (nl = 0; nl <= net->layer[l - 1].no_of_neurons; nl++) {
-        net->layer[l].neuron[nu].weight[nl] +=
-          net->layer[l].neuron[nu].delta[nl] / net->no_of_patterns;
-      }
-    }
+    add_scaled (net->layer[l].weight, net->layer[l].delta,
+                1.0f / (float) net->no_of_patterns,
+                net->layer[l].no_of_neurons * (net->layer[l - 1].no_of_neurons + 1));
   }
 }
 
@@ -1196,7 +1241,8 @@ net_end_batch (network_t *net)
 void
 net_jolt (network_t *net, float factor, float range)
 {
-  int l, nu, nl;
+  int l, i, n;
+  float *weight;
 
   assert (net != NULL);
   assert (factor >= 0.0f);
@@ -1204,15 +1250,13 @@ net_jolt (network_t *net, float factor, float range)
 
   /* modify weights */
   for (l = 1; l < net->no_of_layers; l++) {
-    for (nu = 0; nu < net->layer[l].no_of_neurons; nu++) {
-      for (nl = 0; nl <= net->layer[l - 1].no_of_neurons; nl++) {
-        if ((fabsf (net->layer[l].neuron[nu].weight[nl])) < range) {
-          net->layer[l].neuron[nu].weight[nl] =
-            2.0f * range * ((float)rand() / RAND_MAX - 0.5f);
-        } else {
-          net->layer[l].neuron[nu].weight[nl] *=
-            1.0f + 2.0f * factor * ((float)rand() / RAND_MAX - 0.5f);
-        }
+    weight = net->layer[l].weight;
+    n = net->layer[l].no_of_neurons * (net->layer[l - 1].no_of_neurons + 1);
+    for (i = 0; i < n; i++) {
+      if ((fabsf (weight[i])) < range) {
+        weight[i] = 2.0f * range * ((float)rand() / RAND_MAX - 0.5f);
+      } else {
+        weight[i] *= 1.0f + 2.0f * factor * ((float)rand() / RAND_MAX - 0.5f);
       }
     }
   }
@@ -1229,7 +1273,7 @@ void
 net_add_neurons (network_t *net, int layer, int neuron, int number,
                  float range)
 {
-  int l, nu, nl, new_nu, new_nl, *arglist;
+  int l, nu, nl, i, new_nu, new_nl, new_i, *arglist;
   network_t *new_net, *tmp_net;
 
   assert (net != NULL);
@@ -1253,7 +1297,7 @@ net_add_neurons (network_t *net, int layer, int neuron, int number,
   free (arglist);
 
   /* the new neuron will be connected with small, random weights */
-  net_randomize (net, range);
+  net_randomize (new_net, range);
 
   /* copy the original network's weights and deltas into the new one */
   for (l = 1; l < net->no_of_layers; l++) {
@@ -1261,10 +1305,10 @@ net_add_neurons (network_t *net, int layer, int neuron, int number,
       new_nu = (l == layer) && (nu >= neuron) ? nu + number : nu;
       for (nl = 0; nl <= net->layer[l - 1].no_of_neurons; nl++) {
         new_nl = (l == layer + 1) && (nl >= neuron) ? nl + number : nl;
-        new_net->layer[l].neuron[new_nu].weight[new_nl] =
-          net->layer[l].neuron[nu].weight[nl];
-        new_net->layer[l].neuron[new_nu].delta[new_nl] =
-          net->layer[l].neuron[nu].delta[nl];
+        i = nu * (net->layer[l - 1].no_of_neurons + 1) + nl;
+        new_i = new_nu * (new_net->layer[l - 1].no_of_neurons + 1) + new_nl;
+        new_net->layer[l].weight[new_i] = net->layer[l].weight[i];
+        new_net->layer[l].delta[new_i] = net->layer[l].delta[i];
       }
     }
   }
@@ -1293,7 +1337,7 @@ net_add_neurons (network_t *net, int layer, int neuron, int number,
 void
 net_remove_neurons (network_t *net, int layer, int neuron, int number)
 {
-  int l, nu, nl, orig_nu, orig_nl, *arglist;
+  int l, nu, nl, i, orig_nu, orig_nl, orig_i, *arglist;
   network_t *new_net, *tmp_net;
 
   assert (net != NULL);
@@ -1316,10 +1360,10 @@ net_remove_neurons (network_t *net, int layer, int neuron, int number)
       orig_nu = (l == layer) && (nu >= neuron) ? nu + number : nu;
       for (nl = 0; nl <= new_net->layer[l - 1].no_of_neurons; nl++) {
         orig_nl = (l == layer + 1) && (nl >= neuron) ? nl + number : nl;
-        new_net->layer[l].neuron[nu].weight[nl] =
-          net->layer[l].neuron[orig_nu].weight[orig_nl];
-        new_net->layer[l].neuron[nu].delta[nl] =
-          net->layer[l].neuron[orig_nu].delta[orig_nl];
+        i = nu * (new_net->layer[l - 1].no_of_neurons + 1) + nl;
+        orig_i = orig_nu * (net->layer[l - 1].no_of_neurons + 1) + orig_nl;
+        new_net->layer[l].weight[i] = net->layer[l].weight[orig_i];
+        new_net->layer[l].delta[i] = net->layer[l].delta[orig_i];
       }
     }
   }
@@ -1346,7 +1390,7 @@ net_remove_neurons (network_t *net, int layer, int neuron, int number)
 network_t *
 net_copy (const network_t *net)
 {
-  int l, nu, nl, *arglist;
+  int l, *arglist;
   network_t *new_net;
 
   assert (net != NULL);
@@ -1359,16 +1403,11 @@ net_copy (const network_t *net)
   new_net = net_allocate_l (net->no_of_layers, arglist);
   free (arglist);
 
-  /* copy the original network's weights and deltas into the new one */
+  /* copy the original network's weights and deltas into the new one,
+   * they share one block of memory per layer */
   for (l = 1; l < net->no_of_layers; l++) {
-    for (nu = 0; nu < net->layer[l].no_of_neurons; nu++) {
-      for (nl = 0; nl <= net->layer[l - 1].no_of_neurons; nl++) {
-        new_net->layer[l].neuron[nu].weight[nl] =
-          net->layer[l].neuron[nu].weight[nl];
-        new_net->layer[l].neuron[nu].delta[nl] =
-          net->layer[l].neuron[nu].delta[nl];
-      }
-    }
+    memcpy (new_net->layer[l].weight, net->layer[l].weight, 2 *
+            (size_t)(net->layer[l].no_of_neurons * (net->layer[l - 1].no_of_neurons + 1)) * sizeof (float));
   }
 
   /* copy the original network's constants into the new one */
@@ -1407,4 +1446,4 @@ net_overwrite (network_t *dest, const network_t *src)
   net_free (new_net);
 }
 
-#endif // BEHAVIOUR_NEURALNET_AVAILABLE
+#endif // BEHAVIOUR_NEURALNET_AVAILABLE && (PC || ! NEURALNET_FIXED_AVAILABLE)
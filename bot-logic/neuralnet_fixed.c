@@ -0,0 +1,240 @@
+/*
+ * c't-Bot
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ * This program is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307, USA.
+ *
+ */
+
+/**
+ * \file 	neuralnet_fixed.c
+ * \brief 	Festkomma-Inferenz fuer offline trainierte neuronale Netze (lwneuralnet)
+ * \author 	c't-Bot-Team
+ * \date 	18.10.2026
+ */
+
+#include "bot-logic.h"
+
+#if defined BEHAVIOUR_NEURALNET_AVAILABLE && (defined PC || defined NEURALNET_FIXED_AVAILABLE)
+#include "neuralnet_fixed.h"
+#ifdef PC
+#include <stdio.h>
+#include <math.h>
+#endif
+
+#define SIGMA_SHIFT	15	/**< Nachkommabits der Sigmoid-Tabelle (Q1.15) */
+#define SIGMA_STEP	3	/**< log2 der Schrittweite der Tabelle in Einheiten von 1/16 (Stuetzstellen alle 0,5) */
+
+/** 1 / (1 + exp(-x)) fuer x = 0; 0,5; ... 8 in Q1.15, fuer negative x gilt sigma(-x) = 1 - sigma(x) */
+static const uint16_t sigma_table[17] PROGMEM = {
+	16384, 20397, 23955, 26790, 28862, 30282, 31214, 31807, 32179, 32408,
+	32549, 32635, 32687, 32719, 32738, 32750, 32757
+};
+
+#include "neuralnet_fixed_data.inc"
+
+/**
+ * Sigmoid-Funktion per Tabelle (linear interpoliert)
+ * \param sum	Gewichtete Summe der Eingaben eines Neurons, Gewichte mit shift Nachkommabits, Aktivierungen mit NNQ_ONE als 1.0
+ * \param shift	Nachkommabits der Gewichte
+ * \return		Aktivierung des Neurons mit NNQ_ONE als 1.0
+ */
+static uint8_t sigma_fixed(int32_t sum, uint8_t shift) {
+	/* |sum| in 1/16 umrechnen; NNQ_ONE entspricht 7 Bit */
+	const uint32_t abs_sum = sum < 0 ? (uint32_t) -sum : (uint32_t) sum;
+	const uint32_t x = (abs_sum + (1UL << (shift + 2))) >> (shift + 3);
+
+	uint16_t y;
+	if (x >= (16UL << SIGMA_STEP)) {
+		y = pgm_read_word(&sigma_table[16]);
+	} else {
+		const uint8_t index = (uint8_t) (x >> SIGMA_STEP);
+		const uint8_t frac = (uint8_t) (x & ((1 << SIGMA_STEP) - 1));
+		y = pgm_read_word(&sigma_table[index]);
+		if (frac) {
+			const uint16_t next = pgm_read_word(&sigma_table[index + 1]);
+			y = (uint16_t) (y + (((uint16_t) (next - y) * frac) >> SIGMA_STEP));
+		}
+	}
+	if (sum < 0) {
+		y = (uint16_t) ((1U << SIGMA_SHIFT) - y);
+	}
+	return (uint8_t) ((y + (1U << (SIGMA_SHIFT - 8))) >> (SIGMA_SHIFT - 7));
+}
+
+/**
+ * Berechnet die Ausgaben eines quantisierten Netzes
+ * \param *net		Netz im Flash (z.B. nnq_net_data), auf dem PC auch im RAM
+ * \param *input	Eingaben (Anzahl wie Neuronen der ersten Schicht) mit NNQ_ONE als 1.0
+ * \param *output	Puffer fuer die Ausgaben (Anzahl wie Neuronen der letzten Schicht) mit NNQ_ONE als 1.0
+ */
+void nnq_compute(const uint8_t * net, const uint8_t * input, uint8_t * output) {
+	uint8_t buffer[2][NNQ_MAX_NEURONS];
+	const uint8_t layers = pgm_read_byte(net);
+	const uint8_t * weight = net + 2 * layers;
+	const uint8_t * lower = input;
+	uint8_t n_lower = pgm_read_byte(net + 1);
+	uint8_t l;
+
+	for (l = 1; l < layers; ++l) {
+		const uint8_t n_upper = pgm_read_byte(net + 1 + l);
+		const uint8_t shift = pgm_read_byte(net + layers + l);
+		uint8_t * upper = l == layers - 1 ? output : buffer[l & 1];
+		uint8_t nu;
+		for (nu = 0; nu < n_upper; ++nu) {
+			int32_t sum = 0;
+			uint8_t nl;
+			for (nl = 0; nl < n_lower; ++nl) {
+				sum += (int16_t) ((int8_t) pgm_read_byte(weight++) * lower[nl]);
+			}
+			/* Bias-Gewicht am Ende der Zeile, Ausgabe des Bias-Neurons ist 1.0 */
+			sum += (int16_t) ((int8_t) pgm_read_byte(weight++) * NNQ_ONE);
+			upper[nu] = sigma_fixed(sum, shift);
+		}
+		lower = upper;
+		n_lower = n_upper;
+	}
+}
+
+#ifdef PC
+/**
+ * Quantisiert ein Netz fuer nnq_compute(). Die Nachkommabits der Gewichte werden je Schicht so gewaehlt,
+ * dass das betragsgroesste Gewicht gerade noch in einen int8_t passt.
+ * \param *net		Netz
+ * \param *buffer	Puffer fuer das quantisierte Netz
+ * \param size		Groesse des Puffers [Byte]
+ * \return			Groesse des quantisierten Netzes [Byte]; -1 zu viele Schichten oder Neuronen, -2 Puffer zu klein
+ */
+int16_t nnq_quantize(const network_t * net, uint8_t * buffer, uint16_t size) {
+	const int layers = net_get_no_of_layers(net);
+	if (layers < 2 || layers > NNQ_MAX_LAYERS) {
+		return -1;
+	}
+	int l;
+	for (l = 0; l < layers; ++l) {
+		if (net->layer[l].no_of_neurons > NNQ_MAX_NEURONS) {
+			return -1;
+		}
+	}
+	const int needed = 2 * layers + net_get_no_of_weights(net);
+	if (needed > size) {
+		return -2;
+	}
+
+	buffer[0] = (uint8_t) layers;
+	for (l = 0; l < layers; ++l) {
+		buffer[1 + l] = (uint8_t) net->layer[l].no_of_neurons;
+	}
+	int8_t * weight = (int8_t *) &buffer[2 * layers];
+	for (l = 1; l < layers; ++l) {
+		const int n_lower = net->layer[l - 1].no_of_neurons;
+		const int n_upper = net->layer[l].no_of_neurons;
+		int nu, nl;
+
+		/* groesstmoegliche Anzahl an Nachkommabits, so dass alle Gewichte in einen int8_t passen */
+		float max = 0.f;
+		for (nu = 0; nu < n_upper; ++nu) {
+			for (nl = 0; nl <= n_lower; ++nl) {
+				const float w = fabsf(net_get_weight(net, l - 1, nl, nu));
+				if (w > max) {
+					max = w;
+				}
+			}
+		}
+		uint8_t shift = 0;
+		while (shift < 24 && lroundf(ldexpf(max, shift + 1)) <= 127) {
+			++shift;
+		}
+		buffer[layers + l] = shift;
+
+		for (nu = 0; nu < n_upper; ++nu) {
+			for (nl = 0; nl <= n_lower; ++nl) {
+				long w = lroundf(ldexpf(net_get_weight(net, l - 1, nl, nu), shift));
+				if (w > 127) {
+					w = 127;
+				} else if (w < -127) {
+					w = -127;
+				}
+				*weight++ = (int8_t) w;
+			}
+		}
+	}
+
+	return (int16_t) needed;
+}
+
+/**
+ * Liest ein mit net_bsave() gespeichertes Netz ein und quantisiert es
+ * \param *filename	Name der Datei von net_bsave()
+ * \param *buffer	Puffer fuer das quantisierte Netz
+ * \param size		Groesse des Puffers [Byte]
+ * \return			Groesse des quantisierten Netzes [Byte]; -1 zu viele Schichten oder Neuronen, -2 Puffer zu klein,
+ * 					-3 Datei nicht lesbar
+ */
+int16_t nnq_load_bsave(const char * filename, uint8_t * buffer, uint16_t size) {
+	FILE * file = fopen(filename, "rb");
+	if (! file) {
+		return -3;
+	}
+	network_t * net = net_fbscan(file);
+	fclose(file);
+	if (! net) {
+		return -3;
+	}
+	const int16_t res = nnq_quantize(net, buffer, size);
+	net_free(net);
+	return res;
+}
+
+/**
+ * Konvertiert ein mit net_bsave() gespeichertes Netz in eine Include-Datei mit nnq_net_data fuer den Flash
+ * (Ersatz fuer bot-logic/neuralnet_fixed_data.inc)
+ * \param *bsave_file	Name der Datei von net_bsave()
+ * \param *inc_file		Name der zu schreibenden Include-Datei
+ * \return				0, falls alles OK; Fehlercode von nnq_load_bsave() oder -4 Include-Datei nicht schreibbar
+ */
+int8_t nnq_convert(const char * bsave_file, const char * inc_file) {
+	static uint8_t buffer[NNQ_MAX_SIZE];
+	const int16_t len = nnq_load_bsave(bsave_file, buffer, sizeof(buffer));
+	if (len < 0) {
+		return (int8_t) len;
+	}
+
+	FILE * file = fopen(inc_file, "w");
+	if (! file) {
+		return -4;
+	}
+	const uint8_t layers = buffer[0];
+	uint8_t l;
+	fprintf(file, "/* %s - quantisiertes neuronales Netz fuer nnq_compute(), erzeugt mit \"ct-Bot -Q %s\" */\n\n", inc_file, bsave_file);
+	fprintf(file, "/** Netz ");
+	for (l = 0; l < layers; ++l) {
+		fprintf(file, "%s%u", l ? "-" : "", buffer[1 + l]);
+	}
+	fprintf(file, ", Nachkommabits der Gewichte");
+	for (l = 1; l < layers; ++l) {
+		fprintf(file, " %u", buffer[layers + l]);
+	}
+	fprintf(file, ", %d Byte */\nconst uint8_t nnq_net_data[] PROGMEM = {", len);
+	int16_t i;
+	for (i = 0; i < len; ++i) {
+		fprintf(file, "%s0x%02x%s", i % 12 ? " " : "\n\t", buffer[i], i < len - 1 ? "," : "\n");
+	}
+	fprintf(file, "};\n");
+
+	return fclose(file) == 0 ? 0 : -4;
+}
+#endif // PC
+
+#endif // BEHAVIOUR_NEURALNET_AVAILABLE && (PC || NEURALNET_FIXED_AVAILABLE)
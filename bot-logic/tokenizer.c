@@ -51,6 +51,7 @@
 #include "ubasic_ext_proc.h"
 
 #include <ctype.h>
+#include <string.h>
 
 #if USE_AVR
 //	#include "../uart/usart.h"
@@ -75,6 +76,31 @@ extern PTR_TYPE program_ptr;
 	extern char current_proc[MAX_PROG_NAME_LEN + 1];
 #endif
 
+#if UBASIC_BYTECODE
+/*
+ * Token-Code: jedes Token belegt ein Byte, gefolgt von seinen Daten
+ * (Zahl: 2 Byte little endian, Variable: 1 Byte Index, String: 1 Byte
+ * Laenge, 1 Byte Cache fuer den Aufrufer (z.B. aufgeloester Index eines
+ * call()-Namens, anfangs TOKENIZER_NO_CACHE) und die Zeichen ohne
+ * Null-Terminierung). Leerzeichen und
+ * Kommentare fallen weg, jeder Zeilenumbruch bleibt als TOKENIZER_CR
+ * erhalten, damit Zeilenstruktur und Quelltextzeilen erhalten bleiben.
+ * Programm-Zeiger sind im Token-Code-Modus Offsets in bytecode[].
+ */
+static uint8_t bytecode[UBASIC_BYTECODE_SIZE];
+static PTR_TYPE bytecode_len;
+static PTR_TYPE bytecode_ptr;
+static uint8_t bytecode_active;
+static PTR_TYPE last_string_cache;
+
+// Sprungtabelle: Zeilennummer -> Offset, aufsteigend sortiert
+static struct {
+	int16_t linenum;
+	PTR_TYPE ptr;
+} line_table[UBASIC_BYTECODE_LINES];
+static uint8_t line_count;
+#endif
+
 
 #if TOKENIZER_STANDARD
 #if USE_PROGMEM
@@ -191,12 +217,72 @@ int16_t iFastParserGetKeyWord (void);
 #endif
 
 
+#if UBASIC_BYTECODE
+/*---------------------------------------------------------------------------*/
+static PTR_TYPE bytecode_record_len(PTR_TYPE pos) {
+	switch (bytecode[pos]) {
+		case TOKENIZER_NUMBER:		return 3;
+		case TOKENIZER_VARIABLE:
+		case TOKENIZER_STRINGVAR:	return 2;
+		case TOKENIZER_STRING:		return (PTR_TYPE) (3 + bytecode[pos + 1]);
+		default:					return 1;
+	}
+}
+/*---------------------------------------------------------------------------*/
+static int16_t bytecode_next_token(void) {
+	int16_t token;
+	uint8_t len;
+
+	if (bytecode_ptr >= bytecode_len) {
+		return TOKENIZER_ENDOFINPUT;
+	}
+	token = bytecode[bytecode_ptr++];
+	switch (token) {
+		case TOKENIZER_NUMBER:
+			last_value = (int16_t) (bytecode[bytecode_ptr] | (bytecode[bytecode_ptr + 1] << 8));
+			bytecode_ptr += 2;
+			break;
+		case TOKENIZER_VARIABLE:
+		case TOKENIZER_STRINGVAR:
+			last_var_num = bytecode[bytecode_ptr++];
+			break;
+		case TOKENIZER_STRING:
+			len = bytecode[bytecode_ptr++];
+			last_string_cache = bytecode_ptr++;
+			memcpy(last_string, &bytecode[bytecode_ptr], len);
+			last_string[len] = 0;
+			bytecode_ptr += len;
+			break;
+	}
+	return token;
+}
+/*---------------------------------------------------------------------------*/
+static void set_token_ptr(PTR_TYPE ptr) {
+	if (bytecode_active) {
+		bytecode_ptr = ptr;
+	} else {
+		SET_PROG_PTR_ABSOLUT(ptr);
+	}
+}
+#define TOKEN_PTR					(bytecode_active ? bytecode_ptr : PROG_PTR)
+#define SET_TOKEN_PTR(param)		set_token_ptr(param)
+#define END_OF_TOKENS				(bytecode_active ? bytecode_ptr >= bytecode_len : END_OF_PROG_TEXT)
+#else
+#define TOKEN_PTR					PROG_PTR
+#define SET_TOKEN_PTR(param)		SET_PROG_PTR_ABSOLUT(param)
+#define END_OF_TOKENS				END_OF_PROG_TEXT
+#endif // UBASIC_BYTECODE
+
 /*---------------------------------------------------------------------------*/
 PTR_TYPE get_prog_text_pointer(void) {
 	return line_begin_ptr;
 }
 /*---------------------------------------------------------------------------*/
 static void skip_whitespaces(void){
+#if UBASIC_BYTECODE
+	// Token-Code enthaelt keine Leerzeichen
+	if (bytecode_active) return;
+#endif
 	while((GET_CONTENT_PROG_PTR == ' '  ||
 		   GET_CONTENT_PROG_PTR == '\r' ||
 		   GET_CONTENT_PROG_PTR == '\t'    ) &&
@@ -205,6 +291,12 @@ static void skip_whitespaces(void){
 }
 /*---------------------------------------------------------------------------*/
 void skip_all_whitespaces(void){
+#if UBASIC_BYTECODE
+	if (bytecode_active) {
+		while (bytecode_ptr < bytecode_len && bytecode[bytecode_ptr] == TOKENIZER_CR) bytecode_ptr++;
+		return;
+	}
+#endif
 	while((GET_CONTENT_PROG_PTR == ' '  ||
 		   GET_CONTENT_PROG_PTR == '\n' ||
 		   GET_CONTENT_PROG_PTR == '\r' ||
@@ -214,18 +306,25 @@ void skip_all_whitespaces(void){
 }
 /*---------------------------------------------------------------------------*/
 void jump_to_prog_text_pointer(PTR_TYPE jump_ptr) {
-	SET_PROG_PTR_ABSOLUT(jump_ptr);
+	SET_TOKEN_PTR(jump_ptr);
 	skip_whitespaces();
 	current_token = get_next_token();
 }
 
 /*---------------------------------------------------------------------------*/
 void jump_to_next_linenum(void) {
+#if UBASIC_BYTECODE
+	if (bytecode_active) {
+		while (bytecode_ptr < bytecode_len && bytecode[bytecode_ptr] != TOKENIZER_CR) {
+			bytecode_ptr += bytecode_record_len(bytecode_ptr);
+		}
+	} else
+#endif
 	while(GET_CONTENT_PROG_PTR != '\n' && GET_CONTENT_PROG_PTR != 0) {
 		INCR_PROG_PTR;
 	}
 	skip_all_whitespaces();
-	line_begin_ptr = PROG_PTR;
+	line_begin_ptr = TOKEN_PTR;
 	current_token = get_next_token();
 }
 
@@ -296,6 +395,11 @@ static int16_t get_next_token(void) {
 	char k_temp[MAX_KEYWORD_LEN+1];
 #endif
 
+#if UBASIC_BYTECODE
+	if (bytecode_active) {
+		return bytecode_next_token();
+	}
+#endif
 	if(END_OF_PROG_TEXT) {
 		return TOKENIZER_ENDOFINPUT;
 	}
@@ -424,7 +528,7 @@ static int16_t get_next_token(void) {
 }
 /*---------------------------------------------------------------------------*/
 void tokenizer_init(PTR_TYPE program) {
-	SET_PROG_PTR_ABSOLUT(program);
+	SET_TOKEN_PTR(program);
 	line_begin_ptr=program;
 #if UBASIC_NO_LINENUM_ALLOWED
 	last_value = -1;
@@ -439,7 +543,7 @@ int16_t tokenizer_token(void) {
 /*---------------------------------------------------------------------------*/
 void tokenizer_next(void) {
 	if(tokenizer_finished()) return;
-	if (tokenizer_token() == TOKENIZER_CR) line_begin_ptr = PROG_PTR;
+	if (tokenizer_token() == TOKENIZER_CR) line_begin_ptr = TOKEN_PTR;
 	skip_whitespaces();
 	current_token = get_next_token();
 	return;
@@ -462,15 +566,27 @@ void tokenizer_error_print(int16_t linenum, int16_t error_nr) {
 	(void) error_nr;
 	PTR_TYPE current_prog_ptr;
 	uint16_t source_linenum;
+	source_linenum=1;
+#if UBASIC_BYTECODE
+	if (bytecode_active) {
+		// jeder Zeilenumbruch ist als TOKENIZER_CR erhalten
+		PTR_TYPE pos;
+		for (pos = program_ptr; pos < bytecode_ptr; pos += bytecode_record_len(pos)) {
+			if (bytecode[pos] == TOKENIZER_CR) source_linenum++;
+		}
+		current_prog_ptr = bytecode_ptr;
+	} else
+#endif
+	{
 	// alten Textpointer retten
 	current_prog_ptr=PROG_PTR;
 	// Quelltextzeilennummer suchen
 	SET_PROG_PTR_ABSOLUT(program_ptr);
-	source_linenum=1;
 	while (!END_OF_PROG_TEXT && (PROG_PTR < current_prog_ptr)) {
 		if (GET_CONTENT_PROG_PTR=='\n') source_linenum++;
 		INCR_PROG_PTR;
 	}
+	}
 	// Fehlertextausgabe
 	PRINTF("\n\rerror %i at sourceline: %i (%i?) ", error_nr, source_linenum, linenum);
 #if UBASIC_EXT_PROC
@@ -478,11 +594,11 @@ void tokenizer_error_print(int16_t linenum, int16_t error_nr) {
 #endif
 	PRINTF("\n\r");
 	// Textpointer wieder auf alten Wert
-	SET_PROG_PTR_ABSOLUT(current_prog_ptr);
+	SET_TOKEN_PTR(current_prog_ptr);
 }
 /*---------------------------------------------------------------------------*/
 int16_t tokenizer_finished(void) {
-	return END_OF_PROG_TEXT || current_token == TOKENIZER_ENDOFINPUT;
+	return END_OF_TOKENS || current_token == TOKENIZER_ENDOFINPUT;
 }
 /*---------------------------------------------------------------------------*/
 int16_t tokenizer_variable_num(void) {
@@ -492,17 +608,107 @@ int16_t tokenizer_variable_num(void) {
 /*---------------------------------------------------------------------------*/
 struct tokenizer_pos_t tokenizer_get_position(void) {
 	struct tokenizer_pos_t pos;
-	pos.prog_ptr = PROG_PTR;
+	pos.prog_ptr = TOKEN_PTR;
 	pos.token = current_token;
 	return pos;
 }
 
 /*---------------------------------------------------------------------------*/
 void tokenizer_set_position(struct tokenizer_pos_t pos) {
-	SET_PROG_PTR_ABSOLUT(pos.prog_ptr);
+	SET_TOKEN_PTR(pos.prog_ptr);
 	current_token = pos.token;
 }
 
+#if UBASIC_BYTECODE
+/*---------------------------------------------------------------------------*/
+int8_t tokenizer_compile(PTR_TYPE program) {
+	int16_t token;
+	PTR_TYPE len;
+	uint8_t i, line_start = 1;
+
+	bytecode_active = 0;
+	bytecode_len = 0;
+	line_count = 0;
+	SET_PROG_PTR_ABSOLUT(program);
+	for (;;) {
+		skip_whitespaces();
+		const PTR_TYPE pos = bytecode_len;
+		token = get_next_token();
+		if (token == TOKENIZER_ENDOFINPUT) break;
+
+		len = 1;
+		if (token == TOKENIZER_NUMBER) len = 3;
+		else if (token == TOKENIZER_VARIABLE || token == TOKENIZER_STRINGVAR) len = 2;
+		else if (token == TOKENIZER_STRING) len = (PTR_TYPE) (3 + strlen(last_string));
+		if (len > UBASIC_BYTECODE_SIZE - bytecode_len) return -1;
+
+		bytecode[bytecode_len++] = (uint8_t) token;
+		switch (token) {
+			case TOKENIZER_NUMBER:
+				bytecode[bytecode_len++] = (uint8_t) last_value;
+				bytecode[bytecode_len++] = (uint8_t) ((uint16_t) last_value >> 8);
+				break;
+			case TOKENIZER_VARIABLE:
+			case TOKENIZER_STRINGVAR:
+				bytecode[bytecode_len++] = (uint8_t) last_var_num;
+				break;
+			case TOKENIZER_STRING:
+				bytecode[bytecode_len++] = (uint8_t) (len - 3);
+				bytecode[bytecode_len++] = TOKENIZER_NO_CACHE;
+				memcpy(&bytecode[bytecode_len], last_string, len - 3);
+				bytecode_len += len - 3;
+				break;
+			case TOKENIZER_REM:
+			case TOKENIZER_ERROR:
+				// Rest der Zeile wird nie tokenisiert
+				while (GET_CONTENT_PROG_PTR != '\n' && !END_OF_PROG_TEXT) INCR_PROG_PTR;
+				break;
+		}
+
+		// Zeilennummer am Zeilenanfang in Sprungtabelle einsortieren, bei
+		// doppelten Nummern gewinnt (wie beim Suchen im Text) die erste
+		if (line_start && token == TOKENIZER_NUMBER) {
+			if (line_count >= UBASIC_BYTECODE_LINES) return -1;
+			for (i = line_count; i > 0 && line_table[i - 1].linenum > last_value; --i) {
+				line_table[i] = line_table[i - 1];
+			}
+			line_table[i].linenum = last_value;
+			line_table[i].ptr = pos;
+			line_count++;
+		}
+		line_start = (uint8_t) (token == TOKENIZER_CR);
+	}
+
+	bytecode_active = 1;
+	return 0;
+}
+/*---------------------------------------------------------------------------*/
+void tokenizer_discard_bytecode(void) {
+	bytecode_active = 0;
+}
+/*---------------------------------------------------------------------------*/
+uint8_t tokenizer_is_compiled(void) {
+	return bytecode_active;
+}
+/*---------------------------------------------------------------------------*/
+uint8_t * tokenizer_string_cache(void) {
+	return bytecode_active ? &bytecode[last_string_cache] : NULL;
+}
+/*---------------------------------------------------------------------------*/
+PTR_TYPE tokenizer_find_linenum(int16_t linenum) {
+	uint8_t lo = 0, hi = line_count;
+	while (lo < hi) {
+		const uint8_t mid = (uint8_t) ((lo + hi) / 2);
+		if (line_table[mid].linenum < linenum) lo = (uint8_t) (mid + 1);
+		else hi = mid;
+	}
+	if (lo < line_count && line_table[lo].linenum == linenum) {
+		return line_table[lo].ptr;
+	}
+	return TOKENIZER_NO_LINE;
+}
+#endif // UBASIC_BYTECODE
+
 /*---------------------------------------------------------------------------*/
 /*----------------------- FASTPARSER... -------------------------------------*/
 /*---------------------------------------------------------------------------*/
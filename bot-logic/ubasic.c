@@ -433,6 +433,19 @@ static int16_t relation(void) {
 /*---------------------------------------------------------------------------*/
 static void jump_linenum(int16_t linenum) {
 
+#if UBASIC_BYTECODE
+	// Token-Code hat alle Sprungziele schon beim Laden aufgeloest
+	if (tokenizer_is_compiled()) {
+		const PTR_TYPE line_ptr = tokenizer_find_linenum(linenum);
+		if (line_ptr == TOKENIZER_NO_LINE) {
+			tokenizer_error_print(current_linenum, UNKNOWN_LINENUMBER);
+			ubasic_break();
+		} else {
+			jump_to_prog_text_pointer(line_ptr);
+		}
+		return;
+	}
+#endif
 #if USE_LINENUM_CACHE
 	unsigned char i;
 	// zuerst die Zeilennummer im Cache suchen
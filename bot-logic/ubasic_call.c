@@ -82,26 +82,45 @@ int16_t call_statement(void) {
 	int p4=0;
 #endif
 	int r=0;
+#if UBASIC_BYTECODE
+	uint8_t *cache=NULL;
+#endif
 
 	ubasic_accept(TOKENIZER_CALL);
 	// Parameterliste wird durch linke Klammer eingeleitet
     ubasic_accept(TOKENIZER_LEFTPAREN);
 	// Funktionsname ermitteln
 	if(tokenizer_token() == TOKENIZER_STRING) {
+#if UBASIC_BYTECODE
+		cache = tokenizer_string_cache();
+#endif
 		tokenizer_next();
 	}
-	// Funktionsname in Tabelle suchen
+	// Funktionsname in Tabelle suchen (im Token-Code nur beim ersten Aufruf,
+	// danach steht der Index im Cache-Byte des Strings)
+#if UBASIC_BYTECODE
+	if (cache && *cache != TOKENIZER_NO_CACHE) {
+		idx = *cache;
+	} else {
+#endif
 #if USE_PROGMEM
 	while(pgm_read_byte(&callfunct[idx].typ) != 255 &&
 	      strncasecmp_P(tokenizer_last_string_ptr(), callfunct[idx].funct_name, MAX_NAME_LEN)) {
     	idx++;
     }
-    f_typ_temp = pgm_read_byte(&callfunct[idx].typ);
 #else
 	while(callfunct[idx].typ != 255 &&
 	      strncasecmp(callfunct[idx].funct_name, tokenizer_last_string_ptr(), MAX_NAME_LEN)) {
     	idx++;
     }
+#endif
+#if UBASIC_BYTECODE
+		if (cache) *cache = idx;
+	}
+#endif
+#if USE_PROGMEM
+    f_typ_temp = pgm_read_byte(&callfunct[idx].typ);
+#else
     f_typ_temp = callfunct[idx].typ;
 #endif
     // keinen Tabelleneintrag gefunden!
@@ -222,6 +241,9 @@ int16_t call_statement(void) {
 				// Remotecall
 				ubasic_accept(TOKENIZER_COMMA);
 				const char * const func = tokenizer_last_string_ptr();
+#if UBASIC_BYTECODE
+				uint8_t * const rc_cache = tokenizer_token() == TOKENIZER_STRING ? tokenizer_string_cache() : NULL;
+#endif
 				ubasic_accept(TOKENIZER_STRING);
 				remote_call_data_t params[REMOTE_CALL_MAX_PARAM] = { {0} };
 				uint8_t i;
@@ -232,6 +254,18 @@ int16_t call_statement(void) {
 					ubasic_accept(TOKENIZER_COMMA);
 					params[i].s16 = ubasic_expr();
 				}
+#if UBASIC_BYTECODE
+				// ID des Remote-Calls einmal aufloesen und im Token-Code merken
+				if (rc_cache) {
+					if (*rc_cache == TOKENIZER_NO_CACHE) {
+						*rc_cache = get_remotecall_id(func);
+					}
+					if (*rc_cache != TOKENIZER_NO_CACHE) {
+						bot_remotecall_from_id(ubasic_behaviour_data, *rc_cache, params);
+						break;
+					}
+				}
+#endif
 				int8_t (* rc)(Behaviour_t *, const char *, const remote_call_data_t *) =
 					(int8_t (*)(Behaviour_t *, const char *, const remote_call_data_t *)) pgm_read_word(&callfunct[idx].funct_ptr.VoidFuncRC);
 				rc(ubasic_behaviour_data, func, params);
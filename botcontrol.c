@@ -69,6 +69,10 @@ void pre_behaviour(void) {
 #endif // ARM_LINUX_BOARD
 #endif // BOT_2_SIM_AVAILABLE
 
+#ifdef CREATE_TRACEFILE_AVAILABLE
+	trace_add_inputs();
+#endif // CREATE_TRACEFILE_AVAILABLE
+
 	/* Sensordaten aktualisieren / auswerten */
 	bot_sens();
 
@@ -151,7 +155,22 @@ void post_behaviour(void) {
 #ifdef ARM_LINUX_BOARD
 	set_bot_2_atmega();
 #endif // ARM_LINUX_BOARD
-	command_write(CMD_DONE, SUB_CMD_NORM, simultime, 0, 0); // flusht auch den Sendepuffer
+#ifdef BOT_2_SIM_ASYNC_AVAILABLE
+	/* Done-Token nur, wenn der Sim in diesem Durchlauf einen Zyklus abgeschlossen hat */
+	if (bot_2_sim_done_pending())
+#endif
+	{
+#ifdef CMD_SNAPSHOT_AVAILABLE
+		if (cmd_snapshot_active) {
+			/* alle Aktuatorwerte mit dem Done-Token */
+			command_write_akt_snapshot(simultime, 0); // flusht auch den Sendepuffer
+		} else {
+			command_write(CMD_DONE, SUB_CMD_NORM, simultime, 0, 0); // flusht auch den Sendepuffer
+		}
+#else
+		command_write(CMD_DONE, SUB_CMD_NORM, simultime, 0, 0); // flusht auch den Sendepuffer
+#endif // CMD_SNAPSHOT_AVAILABLE
+	}
 
 #ifdef DEBUG_TIMES
 	/* Zum Debuggen der Zeiten */
@@ -186,7 +205,7 @@ void ctbot_shutdown(void) {
 	motor_set(BOT_SPEED_STOP, BOT_SPEED_STOP);
 
 #ifdef MAP_AVAILABLE
-	map_flush_cache();
+	map_close();
 #endif
 
 #ifdef LOG_MMC_AVAILABLE
@@ -102,6 +102,10 @@ cmd_func_t cmd_functions = {
 	.read = NULL,
 	.crc_check = NULL,
 	.crc_calc = NULL,
+#ifdef PC
+	.peek = NULL,
+	.consume = NULL,
+#endif
 };
 
 
@@ -133,6 +137,9 @@ void command_init(void) {
 	fflush(stdout);
 	LOG_DEBUG("command_init(): Sending CMD_DONE to ATmega...");
 	set_bot_2_atmega();
+#ifdef CMD_SNAPSHOT_AVAILABLE
+	command_offer_snapshot();
+#endif
 	command_write(CMD_DONE, SUB_CMD_NORM, simultime, 0, 0);
 	LOG_DEBUG("command_init(): Waiting for CMD_DONE from ATmega...");
 	const int8_t r = receive_until_frame(CMD_DONE);
@@ -153,22 +160,63 @@ void command_init(void) {
 	LOG_DEBUG("command_init() done.");
 }
 
+static int8_t command_check(command_t * command);
+
+#ifdef PC
+/**
+ * Liest ein Kommando direkt aus dem Empfangspuffer der Verbindung (cmd_functions.peek()),
+ * ohne Zwischenkopie. Bei ungueltigen Daten wird bis zum naechsten Startcode verworfen.
+ * \return 0 oder Fehlercode wie command_read()
+ */
+static int8_t command_read_buffered(void) {
+	command_t * command = cmd_functions.peek(sizeof(command_t));
+	if (! command) {
+		LOG_ERROR("command_read(): peek() failed");
+		return -1;
+	}
+	const uint8_t * ptr = (const uint8_t *) command;
+	if (ptr[0] != CMD_STARTCODE) {
+		/* bis zum naechsten Startcode verwerfen */
+		int16_t skip = 1;
+		while (skip < (int16_t) sizeof(command_t) && ptr[skip] != CMD_STARTCODE) {
+			++skip;
+		}
+		LOG_DEBUG("falscher Startcode: 0x%02x (should be 0x%02x), %d Bytes verworfen", ptr[0], CMD_STARTCODE, skip);
+		cmd_functions.consume(skip);
+		return -2;
+	}
+	if (command->CRC != CMD_STOPCODE) {
+		/* kein gueltiges Kommando, ab dem naechsten Byte neu synchronisieren */
+		cmd_functions.consume(1);
+		LOG_ERROR("Invalid Command:");
+		command_display(command);
+		return -6;
+	}
+
+	/* Die Daten bleiben bis zum naechsten peek() / read() im Puffer gueltig */
+	cmd_functions.consume(sizeof(command_t));
+	return command_check(command);
+}
+#endif // PC
+
 /**
  * Liest ein Kommando ein, ist blockierend!
- * Greift auf cmd_functions.read() zurueck
+ * Greift auf cmd_functions.read() zurueck bzw. auf cmd_functions.peek(), falls
+ * die Verbindung einen Empfangspuffer hat.
  * Achtung, die Payload wird nicht mitgelesen!
  */
 int8_t command_read(void) {
+#ifdef PC
+	if (cmd_functions.peek) {
+		return command_read_buffered();
+	}
+#endif // PC
+
 	int16_t bytesRcvd;
 	int8_t start = 0; // Start des Kommandos
 	int8_t i;
 	command_t * command; // Pointer zum Casten der empfangegen Daten
 	uint8_t buffer[RCVBUFSIZE]; // Puffer
-#ifdef PC
-#if BYTE_ORDER == BIG_ENDIAN
-	uint16_t store; // Puffer fuer die Endian-Konvertierung
-#endif
-#endif // PC
 
 #ifdef MCU
 	uint16_t old_ticks; // alte Systemzeit
@@ -243,6 +291,21 @@ int8_t command_read(void) {
 
 	command = (command_t *) (buffer + start); // Cast in command_t
 
+	return command_check(command);
+}
+
+/**
+ * Prueft ein empfangenes Kommando (Stopcode, CRC, Adresse) und uebernimmt es nach received_command
+ * \param *command	Zeiger auf das Kommando, Startcode muss bereits korrekt sein
+ * \return			0 oder Fehlercode wie command_read()
+ */
+static int8_t command_check(command_t * command) {
+#ifdef PC
+#if BYTE_ORDER == BIG_ENDIAN
+	uint16_t store; // Puffer fuer die Endian-Konvertierung
+#endif
+#endif // PC
+
 #ifdef DEBUG_COMMAND_NOISY
 	LOG_DEBUG("start: %c ", command->startCode);
 	//	command_display(command);
@@ -577,6 +640,7 @@ void register_bot(void) {
 			unsigned basic:1;		// | 8
 			unsigned map:1;			// | 16
 			unsigned remotecall:1;	// | 32
+			unsigned snapshot:1;	// | 64
 		} PACKED_FORCE data;
 		int16_t raw;
 	} features = {
@@ -610,10 +674,20 @@ void register_bot(void) {
 			1,
 #else
 			0,
+#endif
+#if defined CMD_SNAPSHOT_AVAILABLE && ! defined ARM_LINUX_BOARD
+			1,
+#else
+			0,
 #endif
 		}
 	};
 
+#if defined CMD_SNAPSHOT_AVAILABLE && ! defined ARM_LINUX_BOARD
+	/* Sim bestaetigt Snapshots ggf. mit CMD_SETTINGS / SUB_SETTINGS_SNAPSHOT */
+	cmd_snapshot_active = 0;
+#endif
+
 	/* Bot beim Sim anmelden */
 #if defined MCU || defined ARM_LINUX_BOARD
 	command_write(CMD_WELCOME, SUB_WELCOME_REAL, features.raw, 0, 0);
@@ -623,14 +697,237 @@ void register_bot(void) {
 }
 #endif // BOT_2_SIM_AVAILABLE
 
+#ifdef RC5_AVAILABLE
+static uint16_t RC5_Last_Toggle = 0xffff; /**< Toggle-Bit fuer RC5-Codes vom Sim bzw. ATmega */
+#endif
+
+#ifdef CMD_SNAPSHOT_AVAILABLE
+uint8_t cmd_snapshot_active = 0; /**< Gegenstelle akzeptiert Snapshots */
+
+/**
+ * Berechnet die CRC eines Snapshots
+ * \param *p_data	Zeiger auf den Snapshot
+ * \param size		Groesse des Snapshots in Byte, inkl. CRC
+ * \return			CRC ueber alle Bytes vor der CRC
+ */
+static uint16_t snapshot_crc(const void * p_data, uint8_t size) {
+	const uint8_t * ptr = p_data;
+	uint16_t crc = CRC_INITIALIZER;
+	uint8_t i;
+	for (i = 0; i < size - sizeof(uint16_t); ++i) {
+		crc = calc_crc_update(crc, ptr[i]);
+	}
+	return crc;
+}
+
+/**
+ * Liest die Payload eines empfangenen Snapshot-Kommandos ein und prueft Version und CRC.
+ * Die Payload wird in jedem Fall komplett gelesen, damit der Datenstrom synchron bleibt.
+ * \param *p_data	Zeiger auf den Puffer fuer den Snapshot
+ * \param size		Groesse des erwarteten Snapshots in Byte
+ * \return			0, falls der Snapshot gueltig ist
+ */
+static int8_t snapshot_receive(void * p_data, uint8_t size) {
+	uint8_t * ptr = p_data;
+	const uint8_t payload = received_command.payload;
+#ifdef MCU
+	const uint16_t ticks = TIMER_GET_TICKCOUNT_16;
+	while (uart_data_available() < (payload < size ? payload : size) && (uint16_t) (TIMER_GET_TICKCOUNT_16 - ticks) < MS_TO_TICKS(COMMAND_TIMEOUT)) {}
+#endif // MCU
+	if (payload == size) {
+		uint8_t n = 0;
+		while (n < size) {
+			const int16_t r = cmd_functions.read(ptr + n, (int16_t) (size - n));
+			if (r <= 0) {
+				LOG_ERROR("snapshot_receive(): error while receiving snapshot, n=%u", n);
+				return -1;
+			}
+			n = (uint8_t) (n + r);
+		}
+	} else {
+		/* unbekanntes Layout, Daten verwerfen */
+		uint8_t i;
+		for (i = 0; i < payload; ++i) {
+#ifdef MCU
+			while (uart_data_available() < 1 && (uint16_t) (TIMER_GET_TICKCOUNT_16 - ticks) < MS_TO_TICKS(COMMAND_TIMEOUT)) {}
+#endif
+			uint8_t tmp;
+			if (cmd_functions.read(&tmp, 1) != 1) {
+				break;
+			}
+		}
+		LOG_ERROR("snapshot_receive(): invalid size %u, expected %u", payload, size);
+		return -2;
+	}
+
+	if (ptr[0] != CMD_SNAPSHOT_VERSION) {
+		LOG_ERROR("snapshot_receive(): version %u not supported", ptr[0]);
+		return -3;
+	}
+	uint16_t crc;
+	memcpy(&crc, ptr + size - sizeof(crc), sizeof(crc));
+	if (crc != snapshot_crc(ptr, size)) {
+		LOG_ERROR("snapshot_receive(): CRC falsch");
+		return -4;
+	}
+	return 0;
+}
+
+#ifdef PC
+/**
+ * Bietet der Gegenstelle Snapshot-Kommandos an, diese antwortet mit CMD_SETTINGS / SUB_SETTINGS_SNAPSHOT
+ */
+void command_offer_snapshot(void) {
+	cmd_snapshot_active = 0;
+	command_write(CMD_SETTINGS, SUB_SETTINGS_SNAPSHOT, CMD_SNAPSHOT_VERSION, 0, 0);
+}
+
+/**
+ * Beendet einen Zyklus mit CMD_DONE / SUB_DONE_SNAPSHOT und allen Aktuatorwerten als Payload
+ * \param data_l	Daten fuer den linken Kanal (wie bei CMD_DONE)
+ * \param data_r	Daten fuer den rechten Kanal (wie bei CMD_DONE)
+ */
+void command_write_akt_snapshot(int16_t data_l, int16_t data_r) {
+	cmd_snapshot_akt_t snapshot;
+	snapshot.version = CMD_SNAPSHOT_VERSION;
+	snapshot.motor_l = motor_left;
+	snapshot.motor_r = motor_right;
+	snapshot.servo1 = servo_active[0] ? servo_pos[0] : SERVO_OFF;
+	snapshot.servo2 = servo_active[1] ? servo_pos[1] : SERVO_OFF;
+#ifndef ARM_LINUX_BOARD
+	snapshot.servo1 /= 8; // wie servo_low()
+#endif
+#ifdef LED_AVAILABLE
+	snapshot.led = LED_get();
+#else
+	snapshot.led = 0;
+#endif
+	snapshot.crc = snapshot_crc(&snapshot, sizeof(snapshot));
+
+	os_enterCS();
+	if (! command_write_to_internal(CMD_DONE, SUB_DONE_SNAPSHOT, CMD_SIM_ADDR, data_l, data_r, sizeof(snapshot))) {
+		cmd_functions.write(&snapshot, sizeof(snapshot));
+	}
+	flushSendBuffer(); // Flushen hier, bevor das Mutex freigegeben wird!
+	os_exitCS();
+}
+
+/**
+ * Uebernimmt die Werte eines Sensor-Snapshots, wie bei den einzelnen CMD_SENS_* Kommandos
+ * \param *p_snapshot Zeiger auf den (gueltigen) Snapshot
+ */
+static void snapshot_apply_sens(const cmd_snapshot_sens_t * p_snapshot) {
+	(*sensor_update_distance)(&sensDistL, &sensDistLToggle, sensDistDataL, p_snapshot->dist_l);
+	(*sensor_update_distance)(&sensDistR, &sensDistRToggle, sensDistDataR, p_snapshot->dist_r);
+#ifdef ARM_LINUX_BOARD
+	sensEncL = p_snapshot->enc_l;
+	sensEncR = p_snapshot->enc_r;
+#else
+	sensEncL += p_snapshot->enc_l;
+	sensEncR += p_snapshot->enc_r;
+#endif // ARM_LINUX_BOARD
+	sensBorderL = p_snapshot->border_l;
+	sensBorderR = p_snapshot->border_r;
+	sensLineL = p_snapshot->line_l;
+	sensLineR = p_snapshot->line_r;
+	sensLDRL = p_snapshot->ldr_l;
+	sensLDRR = p_snapshot->ldr_r;
+	sensTrans = p_snapshot->trans;
+	sensDoor = p_snapshot->door;
+	sensError = p_snapshot->error;
+#ifdef BPS_AVAILABLE
+	sensBPS = p_snapshot->bps;
+#endif
+#ifdef MOUSE_AVAILABLE
+	sensMouseDX = p_snapshot->mouse_dx;
+	sensMouseDY = p_snapshot->mouse_dy;
+#endif
+#ifdef RC5_AVAILABLE
+	rc5_ir_data.ir_data = p_snapshot->rc5
+#ifndef ARM_LINUX_BOARD
+		| (RC5_Last_Toggle & RC5_TOGGLE)
+#endif
+		;
+	if (p_snapshot->rc5 != 0) {
+		RC5_Last_Toggle = 0xffff ^ (RC5_Last_Toggle & RC5_TOGGLE);
+	}
+#endif // RC5_AVAILABLE
+}
+#endif // PC
+
+#ifdef BOT_2_RPI_AVAILABLE
+/**
+ * Beendet einen Zyklus mit CMD_DONE / SUB_DONE_SNAPSHOT und allen Sensorwerten als Payload
+ * \param data_l	Daten fuer den linken Kanal (wie bei CMD_DONE)
+ * \param data_r	Daten fuer den rechten Kanal (wie bei CMD_DONE)
+ */
+void command_write_sens_snapshot(int16_t data_l, int16_t data_r) {
+	cmd_snapshot_sens_t snapshot;
+	snapshot.version = CMD_SNAPSHOT_VERSION;
+	snapshot.dist_l = sensDistL;
+	snapshot.dist_r = sensDistR;
+	snapshot.enc_l = sensEncL;
+	snapshot.enc_r = sensEncR;
+	snapshot.border_l = sensBorderL;
+	snapshot.border_r = sensBorderR;
+	snapshot.line_l = sensLineL;
+	snapshot.line_r = sensLineR;
+	snapshot.ldr_l = sensLDRL;
+	snapshot.ldr_r = sensLDRR;
+#ifdef BPS_AVAILABLE
+	snapshot.bps = sensBPS;
+#else
+	snapshot.bps = BPS_NO_DATA;
+#endif
+	snapshot.rc5 = RC5_Code;
+	snapshot.trans = sensTrans;
+	snapshot.door = sensDoor;
+	snapshot.error = sensError;
+#ifdef MOUSE_AVAILABLE
+	snapshot.mouse_dx = sensMouseDX;
+	snapshot.mouse_dy = sensMouseDY;
+#else
+	snapshot.mouse_dx = 0;
+	snapshot.mouse_dy = 0;
+#endif
+	snapshot.crc = snapshot_crc(&snapshot, sizeof(snapshot));
+
+	command_write_rawdata_to(CMD_DONE, SUB_DONE_SNAPSHOT, CMD_IGNORE_ADDR, data_l, data_r, sizeof(snapshot), &snapshot);
+}
+
+/**
+ * Uebernimmt die Werte eines Aktuator-Snapshots, wie bei den einzelnen CMD_AKT_* Kommandos.
+ * Servos und LEDs werden nur bei Aenderungen gestellt.
+ * \param *p_snapshot Zeiger auf den (gueltigen) Snapshot
+ */
+static void snapshot_apply_akt(const cmd_snapshot_akt_t * p_snapshot) {
+	static uint8_t last_servo[2] = {SERVO_OFF, SERVO_OFF};
+	static uint8_t last_led = 0;
+
+	motor_set(p_snapshot->motor_l, p_snapshot->motor_r);
+	if (p_snapshot->servo1 != last_servo[0]) {
+		last_servo[0] = p_snapshot->servo1;
+		servo_set(SERVO1, p_snapshot->servo1);
+	}
+	if (p_snapshot->servo2 != last_servo[1]) {
+		last_servo[1] = p_snapshot->servo2;
+		servo_set(SERVO2, p_snapshot->servo2);
+	}
+	if (p_snapshot->led != last_led) {
+		last_led = p_snapshot->led;
+		uint8_t led_ = LED_get() & LED_TUERKIS;
+		led_ = (uint8_t) (led_ | (p_snapshot->led & ~LED_TUERKIS)); // LED_TUERKIS wird fuer Fehleranzeige auf ATmega-Seite verwendet
+		LED_set(led_);
+	}
+}
+#endif // BOT_2_RPI_AVAILABLE
+#endif // CMD_SNAPSHOT_AVAILABLE
+
 /**
  * Wertet das Kommando im Puffer aus
  * \return 1, wenn Kommando schon bearbeitet wurde, 0 sonst
  */
 int8_t command_evaluate(void) {
-#ifdef RC5_AVAILABLE
-	static uint16_t RC5_Last_Toggle = 0xffff;
-#endif
 #if defined BEHAVIOUR_UBASIC_AVAILABLE || defined BEHAVIOUR_ABL_AVAILABLE
 #ifdef SDFAT_AVAILABLE
 	static pFatFile prog_file;
@@ -991,6 +1288,20 @@ int8_t command_evaluate(void) {
 			break;
 #endif // BPS_AVAILABLE
 		case CMD_DONE: {
+#ifdef CMD_SNAPSHOT_AVAILABLE
+			if (received_command.request.subcommand == SUB_DONE_SNAPSHOT) {
+				cmd_snapshot_sens_t snapshot;
+				if (snapshot_receive(&snapshot, sizeof(snapshot)) == 0) {
+					snapshot_apply_sens(&snapshot);
+				}
+			}
+#ifdef ARM_LINUX_BOARD
+			else if (cmd_snapshot_active) {
+				/* ATmega sendet wieder einzelne Kommandos (Timeout oder Reset), Snapshots neu aushandeln */
+				command_offer_snapshot();
+			}
+#endif // ARM_LINUX_BOARD
+#endif // CMD_SNAPSHOT_AVAILABLE
 #ifdef ARM_LINUX_BOARD
 			static uint32_t last = 0;
 			static uint32_t sum = 0;
@@ -1027,8 +1338,20 @@ int8_t command_evaluate(void) {
 			simultime = received_command.data_l;
 			system_time_isr(); // Einmal pro Update-Zyklus aktualisieren wir die Systemzeit
 #endif // ARM_LINUX_BOARD
+#ifdef OS_AVAILABLE
+			os_thread_wakeup(); // Threads in os_thread_sleep() pruefen, ob ihre Zeit abgelaufen ist
+#endif
 			break;
 		}
+#ifdef CMD_SNAPSHOT_AVAILABLE
+		case CMD_SETTINGS:
+			if (received_command.request.subcommand == SUB_SETTINGS_SNAPSHOT) {
+				/* Antwort der Gegenstelle auf command_offer_snapshot() */
+				cmd_snapshot_active = received_command.data_l == CMD_SNAPSHOT_VERSION && received_command.data_r == 1;
+				LOG_INFO("Snapshot-Kommandos (Version %d) %s", received_command.data_l, cmd_snapshot_active ? "aktiv" : "abgelehnt");
+			}
+			break;
+#endif // CMD_SNAPSHOT_AVAILABLE
 #endif // PC
 
 		case CMD_AKT_LCD: {
@@ -1146,8 +1469,25 @@ int8_t command_evaluate(void) {
 					sensor_update_distance = sensor_dist_lookup;
 				}
 				break;
+#ifdef CMD_SNAPSHOT_AVAILABLE
+			case SUB_SETTINGS_SNAPSHOT:
+				/* Linux-Board bietet Snapshots an, Version pruefen und antworten */
+				cmd_snapshot_active = received_command.data_l == CMD_SNAPSHOT_VERSION;
+				command_write_to(CMD_SETTINGS, SUB_SETTINGS_SNAPSHOT, CMD_IGNORE_ADDR, CMD_SNAPSHOT_VERSION, cmd_snapshot_active ? 1 : 2, 0);
+				break;
+#endif // CMD_SNAPSHOT_AVAILABLE
+			}
+			break;
+#ifdef CMD_SNAPSHOT_AVAILABLE
+		case CMD_DONE:
+			if (received_command.request.subcommand == SUB_DONE_SNAPSHOT) {
+				cmd_snapshot_akt_t snapshot;
+				if (snapshot_receive(&snapshot, sizeof(snapshot)) == 0) {
+					snapshot_apply_akt(&snapshot);
+				}
 			}
 			break;
+#endif // CMD_SNAPSHOT_AVAILABLE
 #endif // BOT_2_RPI_AVAILABLE
 
 		default:
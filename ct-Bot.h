@@ -39,7 +39,7 @@
 #define LOG_STDOUT_AVAILABLE 				/**< Logging-Ausgabe auf die Konsole, von der der Bot gestartet wurde (nur fuer PC) */
 //#define LOG_MMC_AVAILABLE					/**< Logging in eine txt-Datei auf MMC */
 #define USE_MINILOG							/**< schaltet auf schlankes Logging um */
-//#define CREATE_TRACEFILE_AVAILABLE			/**< Aktiviert das Schreiben einer Trace-Datei (nur PC) */
+//#define CREATE_TRACEFILE_AVAILABLE			/**< Aktiviert das Schreiben einer binaeren Trace-Datei und das Replay (-r) (nur PC) */
 
 
 /* Kommunikation */
@@ -99,6 +99,9 @@
 //#define BOOTLOADER_AVAILABLE				/**< Aktiviert den Bootloadercode - das ist nur noetig fuer die einmalige "Installation" des Bootloaders */
 #define ARM_LINUX_BOARD						/**< Code fuer ARM-Linux Board aktivieren, wenn ein ARM-Linux-* Target ausgewaehlt wurde. Fuehrt den high-level Code und die Verhalten aus */
 //#define BOT_2_RPI_AVAILABLE				/**< Kommunikation von ATmega mit einem Linux-Board (z.B. Raspberry Pi) aktivieren. Fuehrt auf dem ATmega den low-level Code aus */
+//#define CMD_SNAPSHOT_AVAILABLE			/**< Sensor- bzw. Aktuatorwerte eines Zyklus als ein Snapshot-Kommando uebertragen, sofern die Gegenstelle (ATmega, Linux-Board oder Sim) das unterstuetzt */
+//#define NEURALNET_FIXED_AVAILABLE			/**< Neuronales Netz nur als offline trainiertes Festkomma-Netz aus bot-logic/neuralnet_fixed_data.inc (erzeugt mit "ct-Bot -Q FILE"), kein Training und kein Lernen neuer Patterns auf dem Bot; spart die float-Gewichte und die Sigmoid-Tabelle (8 KB); die Eingaben bleiben float, die float-Bibliothek wird weiter gebraucht */
+//#define BOT_2_SIM_ASYNC_AVAILABLE		/**< PC: Daten vom Sim in eigenem Thread empfangen, die Verhaltensschleife wartet nicht blockierend auf jeden Sim-Zyklus (aendert das Timing gegenueber dem Lock-Step, strikter Lock-Step dann per Kommandozeile -L) */
 
 
 
@@ -224,6 +227,14 @@
 #undef ADJUST_PID_PARAMS
 #endif
 
+#if ! defined COMMAND_AVAILABLE || ! (defined PC || defined BOT_2_RPI_AVAILABLE)
+#undef CMD_SNAPSHOT_AVAILABLE
+#endif
+
+#if ! defined PC || ! defined BOT_2_SIM_AVAILABLE || defined ARM_LINUX_BOARD || defined WIN32
+#undef BOT_2_SIM_ASYNC_AVAILABLE
+#endif
+
 #ifndef MMC_AVAILABLE
 #ifdef MCU
 #undef MAP_AVAILABLE // Map geht auf dem MCU nur mit MMC
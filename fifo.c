@@ -28,6 +28,7 @@
 
 #include "ct-Bot.h"
 #include "fifo.h"
+#include <string.h>
 
 /**
  * Initialisiert die FIFO, setzt Lese- und Schreibzeiger, etc.
@@ -35,12 +36,19 @@
  * \param *buffer	Zeiger auf den Puffer der Groesse size fuer die FIFO
  * \param size		Anzahl der Bytes, die die FIFO speichern soll	.
  */
-void fifo_init(fifo_t * f, void * buffer, const uint8_t size) {
+void fifo_init(fifo_t * f, void * buffer, const fifo_size_t size) {
 	f->count = 0;
 	f->pread = f->pwrite = buffer;
 	f->read2end = f->write2end = f->size = size;
 #ifdef FIFO_STATS_ENABLED
 	f->written = 0;
+#ifdef PC
+	f->wakeups = 0;
+	f->waits = 0;
+#endif
+#endif // FIFO_STATS_ENABLED
+#ifdef FIFO_LOCKFREE_AVAILABLE
+	f->waiting = 0;
 #endif
 #ifdef OS_AVAILABLE
 	f->signal.value = 0; // Fifo leer
@@ -56,6 +64,105 @@ void fifo_init(fifo_t * f, void * buffer, const uint8_t size) {
 	LOG_DEBUG_FIFO("Fifo 0x%08x initialisiert", (unsigned int) f);
 }
 
+/**
+ * Gibt length neu geschriebene Bytes fuer den Consumer frei und weckt ihn
+ * \param *f		Zeiger auf FIFO-Datenstruktur
+ * \param length	Anzahl der geschriebenen Bytes
+ */
+static void put_done(fifo_t * f, fifo_size_t length) {
+#ifdef FIFO_STATS_ENABLED
+	f->written += length;
+#endif
+
+#ifdef FIFO_LOCKFREE_AVAILABLE
+	fifo_lockfree_commit_put(f, length);
+#else
+#ifdef MCU
+	uint8_t sreg = SREG;
+	__builtin_avr_cli();
+#else
+	pthread_mutex_lock(&f->signal.mutex);
+#endif
+	f->count = (fifo_size_t) (f->count + length);
+#ifdef MCU
+	SREG = sreg;
+#else
+	pthread_mutex_unlock(&f->signal.mutex);
+#endif
+#ifdef OS_AVAILABLE
+	/* Consumer aufwecken */
+	os_signal_unlock(&f->signal);
+#if defined FIFO_STATS_ENABLED && defined PC
+	++f->wakeups;
+#endif
+#endif // OS_AVAILABLE
+#endif // FIFO_LOCKFREE_AVAILABLE
+}
+
+/**
+ * Gibt length gelesene Bytes fuer den Producer frei
+ * \param *f		Zeiger auf FIFO-Datenstruktur
+ * \param length	Anzahl der gelesenen Bytes
+ */
+static void get_done(fifo_t * f, fifo_size_t length) {
+#ifdef FIFO_LOCKFREE_AVAILABLE
+	fifo_lockfree_commit_get(f, length);
+#else
+#ifdef MCU
+	uint8_t sreg = SREG;
+	__builtin_avr_cli();
+#else
+	pthread_mutex_lock(&f->signal.mutex);
+#endif
+	f->count = (fifo_size_t) (f->count - length);
+#ifdef MCU
+	SREG = sreg;
+#else
+	pthread_mutex_unlock(&f->signal.mutex);
+#endif
+#endif // FIFO_LOCKFREE_AVAILABLE
+}
+
+/**
+ * Liefert die Anzahl der Bytes in der FIFO, wenn OS_AVAILABLE, wird blockiert, bis mindestens length Bytes da sind
+ * \param *f		Zeiger auf FIFO-Datenstruktur
+ * \param length	Anzahl der benoetigten Bytes
+ * \return			Anzahl der Bytes in der FIFO
+ */
+static fifo_size_t wait_data(fifo_t * f, fifo_size_t length) {
+#ifdef FIFO_LOCKFREE_AVAILABLE
+	fifo_size_t count = fifo_lockfree_count(f);
+#ifdef OS_AVAILABLE
+	if (count < length) {
+		/* blockieren */
+		fifo_lockfree_wait(f, length);
+		count = fifo_lockfree_count(f);
+	}
+#endif
+#else
+	fifo_size_t count = f->count;
+#ifdef OS_AVAILABLE
+	while (count < length) {
+		/* blockieren */
+		LOG_DEBUG_FIFO("Fifo 0x%08x ist leer, blockiere", (unsigned int) f);
+#if defined FIFO_STATS_ENABLED && defined PC
+		++f->waits;
+#endif
+		os_signal_lock(&f->signal);
+		if (f->count < length) { // sonst hat der Producer schon vor os_signal_lock() geweckt
+			os_signal_set(&f->signal);
+			LOG_DEBUG_FIFO("Fifo 0x%08x enthaelt wieder Daten, weiter geht's", (unsigned int) f);
+			os_signal_release(&f->signal);
+		}
+		count = f->count;
+	}
+#else
+	(void) length;
+#endif // OS_AVAILABLE
+#endif // FIFO_LOCKFREE_AVAILABLE
+	return count;
+}
+
 /**
  * Schreibt length Byte in die FIFO.
  * \param *f		Zeiger auf FIFO-Datenstruktur
@@ -64,13 +171,17 @@ void fifo_init(fifo_t * f, void * buffer, const uint8_t size) {
  * \param block		Flag, ob die Funktion blockieren soll, wenn der freie Platz nicht ausreicht
  * \return			Fehlercode, 0 falls kein Fehler
  */
-uint8_t fifo_put_data(fifo_t * f, const void * data, uint8_t length, const uint8_t block) {
+uint8_t fifo_put_data(fifo_t * f, const void * data, fifo_size_t length, const uint8_t block) {
 	if (length == 0) {
 		return 1;
 	}
-	uint8_t space;
-	if (length > (space = (uint8_t) (f->size - f->count))) {
-		/* nicht genug Platz -> alte Daten rauswerfen */
+#ifdef FIFO_LOCKFREE_AVAILABLE
+	const fifo_size_t count = fifo_lockfree_count(f);
+#else
+	const fifo_size_t count = f->count;
+#endif
+	if (length > (fifo_size_t) (f->size - count)) {
+		/* nicht genug Platz -> neue Daten verwerfen */
 		f->overflow = 1;
 		LOG_DEBUG_FIFO("FIFO 0x%08x overflow, size=%u", (unsigned int) f, f->size);
 		while (block && f->locked) {
@@ -78,77 +189,29 @@ uint8_t fifo_put_data(fifo_t * f, const void * data, uint8_t length, const uint8
 			os_thread_yield();
 #endif
 		}
-
 		return 2;
-
-		uint8_t to_discard = (uint8_t) (length - space);
-		LOG_DEBUG_FIFO("verwerfe %u Bytes in Fifo 0x%08x", to_discard, (unsigned int) f);
-		LOG_DEBUG_FIFO(" size=%u, count=%u, length=%u", f->size, f->count, length);
-		uint8_t read2end = f->read2end;
-		uint8_t * pread = f->pread;
-		if (to_discard > read2end) {
-			/* Ueberlauf */
-			read2end = (uint8_t) (read2end + f->size);
-			pread -= f->size;
-		}
-		read2end = (uint8_t) (read2end - to_discard);
-		pread += to_discard;
-		f->read2end = read2end;
-		f->pread = pread;
-
-#ifdef MCU
-		uint8_t sreg = SREG;
-		__builtin_avr_cli();
-#else
-		pthread_mutex_lock(&f->signal.mutex);
-#endif
-		f->count = (uint8_t) (f->count - to_discard);
-#ifdef MCU
-		SREG = sreg;
-#else
-		pthread_mutex_unlock(&f->signal.mutex);
-#endif
 	}
 	const uint8_t * src = data;
 	uint8_t * pwrite = f->pwrite;
-	uint8_t write2end = f->write2end;
-	uint8_t n = length > write2end ? write2end : length;
-	uint8_t i, j;
+	fifo_size_t write2end = f->write2end;
+	fifo_size_t n = length > write2end ? write2end : length;
+	uint8_t j;
 	for (j = 0; j < 2; ++j) {
-		for (i = 0; i < n; ++i) {
-			*(pwrite++) = *(src++);
-		}
+		memcpy(pwrite, src, n);
+		pwrite += n;
+		src += n;
 
-		write2end = (uint8_t) (write2end - n);
+		write2end = (fifo_size_t) (write2end - n);
 		if (write2end == 0) {
 			write2end = f->size;
 			pwrite -= write2end;
 		}
-		n = (uint8_t) (length - n);
+		n = (fifo_size_t) (length - n);
 	}
 
 	f->write2end = write2end;
 	f->pwrite = pwrite;
-#ifdef FIFO_STATS_ENABLED
-	f->written += length;
-#endif
-
-#ifdef MCU
-	uint8_t sreg = SREG;
-	__builtin_avr_cli();
-#else
-	pthread_mutex_lock(&f->signal.mutex);
-#endif
-	f->count = (uint8_t) (f->count + length);
-#ifdef MCU
-	SREG = sreg;
-#else
-	pthread_mutex_unlock(&f->signal.mutex);
-#endif
-#ifdef OS_AVAILABLE
-	/* Consumer aufwecken */
-	os_signal_unlock(&f->signal);
-#endif // OS_AVAILABLE
+	put_done(f, length);
 	return 0;
 }
 
@@ -161,61 +224,216 @@ uint8_t fifo_put_data(fifo_t * f, const void * data, uint8_t length, const uint8
  * \return			Anzahl der tatsaechlich gelieferten Bytes
  */
 int16_t fifo_get_data(fifo_t * f, void * data, int16_t length) {
-	uint8_t l = (uint8_t) (length <= 255 ? length : 255);
-	if (l == 0) {
+	if (length <= 0) {
 		return 0;
 	}
-	uint8_t count = f->count;
-#ifdef OS_AVAILABLE
-	while (count < l) {
-		/* blockieren */
-		LOG_DEBUG_FIFO("Fifo 0x%08x ist leer, blockiere", (unsigned int) f);
-		os_signal_lock(&f->signal);
-		os_signal_set(&f->signal);
-		LOG_DEBUG_FIFO("Fifo 0x%08x enthaelt wieder Daten, weiter geht's", (unsigned int) f);
-		os_signal_release(&f->signal);
-		count = f->count;
-	}
-#else
-	(void) count;
-#endif // OS_AVAILABLE
-//	if (count < l) {
-//		l = count;
-//	}
+	const fifo_size_t l = (fifo_size_t) ((uint32_t) length <= FIFO_SIZE_MAX ? (uint32_t) length : FIFO_SIZE_MAX);
+	wait_data(f, l);
 	f->locked = 1;
-	uint8_t* pread = f->pread;
-	uint8_t read2end = f->read2end;
-	uint8_t n = l > read2end ? read2end : l;
+	uint8_t * pread = f->pread;
+	fifo_size_t read2end = f->read2end;
+	fifo_size_t n = l > read2end ? read2end : l;
 	uint8_t * dest = data;
-	uint8_t i,j;
+	uint8_t j;
 	for (j = 0; j < 2; ++j) {
-		for (i = 0; i < n; ++i) {
-			*(dest++) = *(pread++);
-		}
-		read2end = (uint8_t) (read2end - n);
+		memcpy(dest, pread, n);
+		dest += n;
+		pread += n;
+		read2end = (fifo_size_t) (read2end - n);
 		if (read2end == 0) {
 			read2end = f->size;
 			pread -= read2end;
 		}
-		n = (uint8_t) (l - n);
+		n = (fifo_size_t) (l - n);
 	}
 
 	f->pread = pread;
 	f->read2end = read2end;
+	get_done(f, l);
+	f->locked = 0;
 
-#ifdef MCU
-	uint8_t sreg = SREG;
-	__builtin_avr_cli();
+	return (int16_t) l;
+}
+
+/**
+ * Liefert den freien Speicher der FIFO, damit ein Producer seine Daten ohne Kopie direkt dort ablegen kann.
+ * Sichtbar fuer den Consumer werden die Daten erst mit fifo_put_commit().
+ * \param *f	Zeiger auf FIFO-Datenstruktur
+ * \param **ptr	Zeiger auf den freien Speicher
+ * \return		Anzahl der Bytes, die ab *ptr am Stueck geschrieben werden koennen
+ */
+fifo_size_t fifo_put_peek(fifo_t * f, void ** ptr) {
+#ifdef FIFO_LOCKFREE_AVAILABLE
+	const fifo_size_t space = (fifo_size_t) (f->size - fifo_lockfree_count(f));
 #else
-	pthread_mutex_lock(&f->signal.mutex);
+	const fifo_size_t space = (fifo_size_t) (f->size - f->count);
 #endif
-	f->count = (uint8_t) (f->count - l);
-#ifdef MCU
-	SREG = sreg;
+	*ptr = f->pwrite;
+	return space < f->write2end ? space : f->write2end;
+}
+
+/**
+ * Gibt length Bytes, die nach fifo_put_peek() direkt in die FIFO geschrieben wurden, fuer den Consumer frei
+ * \param *f		Zeiger auf FIFO-Datenstruktur
+ * \param length	Anzahl der geschriebenen Bytes, hoechstens der Rueckgabewert von fifo_put_peek()
+ */
+void fifo_put_commit(fifo_t * f, fifo_size_t length) {
+	if (length == 0) {
+		return;
+	}
+	fifo_size_t write2end = (fifo_size_t) (f->write2end - length);
+	uint8_t * pwrite = f->pwrite + length;
+	if (write2end == 0) {
+		write2end = f->size;
+		pwrite -= write2end;
+	}
+	f->write2end = write2end;
+	f->pwrite = pwrite;
+	put_done(f, length);
+}
+
+/**
+ * Liefert die Daten am Anfang der FIFO, ohne sie zu kopieren oder zu entnehmen.
+ * Wenn OS_AVAILABLE, blockierend, falls Fifo leer.
+ * \param *f	Zeiger auf FIFO-Datenstruktur
+ * \param **ptr	Zeiger auf die Daten
+ * \return		Anzahl der Bytes, die ab *ptr am Stueck gelesen werden koennen
+ */
+fifo_size_t fifo_get_peek(fifo_t * f, const void ** ptr) {
+	const fifo_size_t count = wait_data(f, 1);
+	*ptr = f->pread;
+	return count < f->read2end ? count : f->read2end;
+}
+
+/**
+ * Entnimmt length Bytes, die nach fifo_get_peek() direkt gelesen wurden, aus der FIFO
+ * \param *f		Zeiger auf FIFO-Datenstruktur
+ * \param length	Anzahl der gelesenen Bytes, hoechstens der Rueckgabewert von fifo_get_peek()
+ */
+void fifo_get_commit(fifo_t * f, fifo_size_t length) {
+	if (length == 0) {
+		return;
+	}
+	fifo_size_t read2end = (fifo_size_t) (f->read2end - length);
+	uint8_t * pread = f->pread + length;
+	if (read2end == 0) {
+		read2end = f->size;
+		pread -= read2end;
+	}
+	f->read2end = read2end;
+	f->pread = pread;
+	get_done(f, length);
+}
+
+#if defined PC && defined OS_AVAILABLE
+#include <stdio.h>
+#include <sys/time.h>
+
+#define FIFO_BENCHMARK_CHUNK_MAX	1024	/**< Groesste Blockgroesse in fifo_benchmark() [Byte] */
+
+/** Daten fuer den Producer-Thread von fifo_benchmark() */
+typedef struct {
+	fifo_t * fifo;		/**< zu testende FIFO */
+	uint32_t bytes;		/**< Anzahl zu schreibender Bytes */
+	fifo_size_t chunk;	/**< Bytes pro fifo_put_data(), 1: _inline_fifo_put() */
+} fifo_benchmark_t;
+
+/**
+ * Liefert die Anzahl der Bytes in der FIFO fuer den Producer von fifo_benchmark()
+ * \param *f	Zeiger auf FIFO-Datenstruktur
+ * \return		Anzahl der Bytes in der FIFO
+ */
+static fifo_size_t fifo_benchmark_count(fifo_t * f) {
+#ifdef FIFO_LOCKFREE_AVAILABLE
+	return fifo_lockfree_count(f);
 #else
-	pthread_mutex_unlock(&f->signal.mutex);
+	return f->count;
 #endif
-	f->locked = 0;
+}
 
-	return l;
+/**
+ * Producer-Thread fuer fifo_benchmark(), schreibt eine fortlaufende Bytefolge in die FIFO
+ * und wartet (ohne Daten zu verwerfen), solange nicht genug Platz frei ist
+ * \param *arg	Zeiger auf fifo_benchmark_t
+ * \return		NULL
+ */
+static void * fifo_benchmark_producer(void * arg) {
+	fifo_benchmark_t * bench = arg;
+	fifo_t * f = bench->fifo;
+	const fifo_size_t chunk = bench->chunk;
+	uint8_t data[FIFO_BENCHMARK_CHUNK_MAX];
+	uint8_t seq = 0;
+	uint32_t sent;
+	for (sent = 0; sent < bench->bytes; sent += chunk) {
+		fifo_size_t i;
+		for (i = 0; i < chunk; ++i) {
+			data[i] = seq++;
+		}
+		while ((fifo_size_t) (f->size - fifo_benchmark_count(f)) < chunk) {
+			sched_yield();
+		}
+		if (chunk == 1) {
+			_inline_fifo_put(f, data[0], False);
+		} else {
+			fifo_put_data(f, data, chunk, False);
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Misst den Durchsatz der FIFO mit je einem Producer- und Consumer-Thread fuer verschiedene
+ * Blockgroessen und gibt Bytes/s sowie Weckvorgaenge und Wartevorgaenge des Consumers pro
+ * Sekunde aus. Zum Vergleich mit der Mutex-Implementierung FIFO_LOCKFREE_AVAILABLE in fifo.h
+ * abschalten.
+ * \param bytes	Anzahl der Bytes pro Blockgroesse
+ */
+void fifo_benchmark(uint32_t bytes) {
+	static const struct {
+		fifo_size_t size;
+		fifo_size_t chunk;
+	} tests[] = { { 255, 1 }, { 255, 4 }, { 255, 16 }, { 255, 64 }, { 16384, 256 }, { 16384, FIFO_BENCHMARK_CHUNK_MAX } };
+#ifdef FIFO_LOCKFREE_AVAILABLE
+	printf("FIFO (lock-frei, 1 Producer / 1 Consumer): %" PRIu32 " Bytes pro Test\n", bytes);
+#else
+	printf("FIFO (Mutex): %" PRIu32 " Bytes pro Test\n", bytes);
+#endif
+	uint8_t t;
+	for (t = 0; t < sizeof(tests) / sizeof(tests[0]); ++t) {
+		static uint8_t buffer[16384];
+		fifo_t fifo;
+		fifo_init(&fifo, buffer, tests[t].size);
+		fifo_benchmark_t bench = { &fifo, bytes - bytes % tests[t].chunk, tests[t].chunk };
+
+		struct timeval start, end;
+		gettimeofday(&start, NULL);
+		pthread_t producer;
+		if (pthread_create(&producer, NULL, fifo_benchmark_producer, &bench) != 0) {
+			return;
+		}
+		uint8_t data[FIFO_BENCHMARK_CHUNK_MAX];
+		uint8_t seq = 0;
+		uint32_t errors = 0;
+		uint32_t received;
+		for (received = 0; received < bench.bytes; received += bench.chunk) {
+			if (bench.chunk == 1) {
+				data[0] = _inline_fifo_get(&fifo, False);
+			} else {
+				fifo_get_data(&fifo, data, (int16_t) bench.chunk);
+			}
+			fifo_size_t i;
+			for (i = 0; i < bench.chunk; ++i) {
+				if (data[i] != seq++) {
+					++errors;
+				}
+			}
+		}
+		pthread_join(producer, NULL);
+		gettimeofday(&end, NULL);
+
+		const double s = (double) (end.tv_sec - start.tv_sec) + (double) (end.tv_usec - start.tv_usec) / 1e6;
+		printf("FIFO %5u Byte, Block %4u Byte: %8.2f MB/s, %10.0f Weckvorgaenge/s, %10.0f Wartevorgaenge/s, %" PRIu32 " Fehler\n",
+			fifo.size, bench.chunk, (double) bench.bytes / s / 1e6, (double) fifo.wakeups / s, (double) fifo.waits / s, errors);
+	}
 }
+#endif // PC && OS_AVAILABLE
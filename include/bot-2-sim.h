@@ -43,6 +43,17 @@ void bot_2_sim_init(void);
  */
 void bot_2_sim_listen(void);
 
+#ifdef BOT_2_SIM_ASYNC_AVAILABLE
+extern uint8_t bot_2_sim_lockstep; /**< 1: strikter Lock-Step mit dem Sim, jeder Durchlauf wartet auf CMD_DONE */
+
+/**
+ * Gibt an, ob der Sim auf das Done-Token dieses Durchlaufs wartet, weil seit dem letzten Aufruf
+ * ein CMD_DONE vom Sim ausgewertet wurde. Im Lock-Step-Modus immer der Fall.
+ * \return	1, falls CMD_DONE an den Sim zu senden ist
+ */
+uint8_t bot_2_sim_done_pending(void);
+#endif // BOT_2_SIM_ASYNC_AVAILABLE
+
 #ifdef MCU
 /**
  * Diese Funktion informiert den Sim ueber alle Sensor und Aktuator-Werte
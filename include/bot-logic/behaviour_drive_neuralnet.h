@@ -60,6 +60,7 @@ void bot_check_sector_behaviour(Behaviour_t * data);
  */
 void bot_check_sectors(Behaviour_t * caller);
 
+#ifndef NEURALNET_FIXED_AVAILABLE
 /**
  * Verhalten analog oben, jedoch zusaetzliche Parameter mitgegeben zum Ausfuehren und Speichern eines Patterns
  * der Wunschaktion im neur. Netz
@@ -69,6 +70,7 @@ void bot_check_sectors(Behaviour_t * caller);
  * \param wishaction  nach Sectorcheck soll der Bot diese Aktion ausfuehren, was den Werten in out0 out1 entspricht
  */
 void bot_check_sectors_savepattern(Behaviour_t * caller, uint8_t out0, uint8_t out1, uint8_t wishaction );
+#endif // ! NEURALNET_FIXED_AVAILABLE
 
 /**
  * das Fahrverhalten wird nur mit einer bestimmten Wunschaktion gestartet und dann beendet ohne weiterzufahren;
@@ -42,6 +42,20 @@
 #define MAX_TRAINING_DEF 1500	/**< max. Anzahl Iterationen zum Lernen pro Lernaufruf */
 #define ERROR_THRESHOLD 0.0003f	/**< Ende der Lernschleife bei Erreichen dieser Fehlergrenze */
 
+#if defined PC && ! defined NEURALNET_FIXED_AVAILABLE
+/**
+ * bot_neuralnet_multi() trainiert auf dem PC (auch ARM-Linux-Board) mehrere zufaellig initialisierte Netze parallel
+ * in eigenen Threads per Batch-Training ueber alle Patterns und uebernimmt das Netz mit dem kleinsten Fehler;
+ * bot_neuralnet() trainiert weiterhin je Verhaltensdurchlauf eine Epoche
+ */
+#define NEURALNET_PARALLEL_AVAILABLE
+#endif
+
+#define NEURALNET_PARALLEL_STARTS	16		/**< Anzahl der Netze (Zufallsstartwerte) je paralleles Training */
+#define NEURALNET_PARALLEL_THREADS	4		/**< Anzahl der Threads fuer das parallele Training */
+#define NEURALNET_PARALLEL_EPOCHS	20000	/**< max. Anzahl Epochen je Netz beim parallelen Training */
+
+#ifndef NEURALNET_FIXED_AVAILABLE
 extern float total_error;	/**< Gesamtfehler des Netzes */
 
 extern uint16_t no_of_pairs;	/**< Anzahl der im Array vorhandenen gueltigen Lernpatterns */
@@ -63,6 +77,14 @@ void bot_neuralnet_behaviour(Behaviour_t * data);
  */
 void bot_neuralnet(Behaviour_t * caller);
 
+#ifdef NEURALNET_PARALLEL_AVAILABLE
+/**
+ * Rufe das neuralnet-Verhalten auf, das Netz wird im Hintergrund per Multi-Start-Training in Threads trainiert
+ * \param *caller	Verhaltensdatensatz
+ */
+void bot_neuralnet_multi(Behaviour_t * caller);
+#endif
+
 /**
  * Rufe das neuralnet-Verhalten auf, wobei das Netz nur 1x durchlaufen wird zur Fehlerermittlung
  * \param *caller	Der obligatorische Verhaltensdatensatz des Aufrufers
@@ -74,11 +96,6 @@ void net_check_one_step(Behaviour_t * caller);
  */
 void set_init_patterns_in_array(void);
 
-/**
- *  Testen des Netzes mit der aktuellen Sektorbelegung
- */
-void test_net(float *sectorarray);
-
 /**
  * das Array der sector-Belegungen mit den gewuenschten Outputs wird eingetragen im Array an der Stelle index,
  * also Teachin- und Output wird gefuellt
@@ -90,6 +107,17 @@ void test_net(float *sectorarray);
  */
 void fill_pattern_in_lernarray(float *sectorarray, uint16_t index, uint8_t out0, uint8_t out1);
 
+/**
+ *  Setzen der zufaelligen Verbindungsgewichte
+ */
+void net_set_rnd_weights(void);
+#endif // ! NEURALNET_FIXED_AVAILABLE
+
+/**
+ *  Testen des Netzes mit der aktuellen Sektorbelegung
+ */
+void test_net(float *sectorarray);
+
 /**
  * Auslesen der Output-Neuronen aus dem Netz
  * \param *out1        Output-Neuron 1
@@ -97,10 +125,30 @@ void fill_pattern_in_lernarray(float *sectorarray, uint16_t index, uint8_t out0,
  */
 void net_get_test_out(uint8_t *out1, uint8_t *out2);
 
+#ifdef PC
 /**
- *  Setzen der zufaelligen Verbindungsgewichte
+ * Misst die Trainingsgeschwindigkeit mit den vordefinierten Patterns in Epochen pro Sekunde
+ * \param epochs	Anzahl der Epochen je Netz und Variante
  */
-void net_set_rnd_weights(void);
+void neuralnet_benchmark(uint32_t epochs);
+
+/**
+ * Prueft das Festkomma-Netz (neuralnet_fixed.h) gegen das float-Netz: trainiert Netze mit den vordefinierten
+ * Patterns, speichert sie mit net_bsave(), quantisiert sie mit nnq_load_bsave() und vergleicht die Entscheidungen;
+ * prueft die Ausgaben des Netzes aus neuralnet_fixed_data.inc gegen Referenzwerte und misst die Inferenzzeit
+ * \param runs	Anzahl der Durchlaeufe ueber alle Patterns fuer die Zeitmessung
+ * \return		0 falls alles OK, 1 falls Fehler
+ */
+int8_t neuralnet_fixed_benchmark(uint32_t runs);
+
+#ifdef NEURALNET_PARALLEL_AVAILABLE
+/**
+ * Misst das parallele Training mit den vordefinierten Patterns mit einem und mit NEURALNET_PARALLEL_THREADS
+ * Threads und vergleicht es mit dem Training des Verhaltens nach jedem Pattern
+ */
+void neuralnet_parallel_benchmark(void);
+#endif
+#endif // PC
 
 /**
  * Display zum Start / Anzeigen der NN-Routinen/ Daten
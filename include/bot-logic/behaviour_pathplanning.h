@@ -19,12 +19,14 @@
 
 /*!
  * \file 	behaviour_pathplanning.h
- * \brief   Wave-Pfadplanungsverhalten
+ * \brief   Pfadplanungsverhalten (A* oder Welle)
  *
  * Eine niedrigaufloesende Map wird ueber die hochaufloesende gelegt und auf dieser folgende Schritte ausgefuehrt:
  * -Innerhalb des wirklich benutzten Mappenbereiches wird jede Zelle durchlaufen und falls der Durchschnittswert
  * der Hochaufloesenden Map < 0 ist (Hinderniswert) hier eingetragen mit Wert 1
- * -anzufahrende Zielposition erhaelt Mapwert 2
+ * -A* (Standard): ausgehend von der Zielposition wird mit Octile-Heuristik bis zur Botposition gesucht, anschliessend
+ * wird der Pfad von der Botposition aus zurueckverfolgt und auf den Stack gelegt
+ * -Welle (PATHPLANNING_USE_WAVE): anzufahrende Zielposition erhaelt Mapwert 2
  * -ausgehend von Zielposition laeuft eine Welle los bis zum Bot-Ausgangspunkt, d.h. von 2 beginnend erhaelt jede Nachbarzelle
  * den naechst hoeheren Zellenwert
  * -wird als ein Nachbar die Botposition erreicht, wird der Pfad zurueckverfolgt und immer die Zelle mit kleinerem Wert gewaehlt;
@@ -60,8 +62,8 @@ void bot_calc_wave(Behaviour_t * caller, int16_t dest_x, int16_t dest_y, int8_t
 void bot_do_calc_wave(Behaviour_t * caller, int8_t map_compare);
 
 /*!
- * Wave-Verhalten; berechnet die Welle ausgehend vom Zielpunkt bis zur Botposition; dann wird diese zurueckverfolgt und sich der Pfad
- * auf dem Stack gemerkt und anschliessend das Stack-Fahrverhalten aufgerufen
+ * Pfadplanungs-Verhalten; sucht per A* (bzw. Welle) ausgehend vom Zielpunkt einen Weg bis zur Botposition; dann wird dieser
+ * zurueckverfolgt und sich der Pfad auf dem Stack gemerkt und anschliessend das Stack-Fahrverhalten aufgerufen
  * \param *data	Zeiger auf Verhaltensdatensatz
  */
 void bot_calc_wave_behaviour(Behaviour_t *data);
@@ -76,6 +76,15 @@ void bot_remotecall_behaviour(Behaviour_t * data);
  */
 int8_t bot_remotecall(Behaviour_t * caller, const char * func, const remote_call_data_t * data);
 
+/**
+ * Fuehrt einen RemoteCall aus
+ * \param *caller	Zeiger auf das aufrufende Verhalten
+ * \param id	 	ID des Verhaltens (Index in der Liste, siehe get_remotecall_id())
+ * \param *data		Zeiger auf die Daten
+ * \return 			Fehlercode (0: RemoteCall gestartet, -1: noch ein RC aktiv, -2: Funktion nicht gefunden)
+ */
+int8_t bot_remotecall_from_id(Behaviour_t * caller, const uint8_t id, const remote_call_data_t * data);
+
 /**
  * Fuehrt einen RemoteCall aus. Es gibt KEIN aufrufendes Verhalten!
  * \param *data Zeiger die Payload eines Kommandos. Dort muss zuerst ein String mit dem Fkt-Namen stehen.
@@ -55,6 +55,7 @@ typedef union {
 #ifdef BEHAVIOUR_SCAN_AVAILABLE
 
 extern scan_mode_t scan_otf_modes;	/**< Modi des Verhaltens */
+extern uint16_t scan_otf_halt_count;	/**< Anzahl, wie oft der Bot angehalten wurde, weil der Map-Cache voll war */
 
 /**
  * Schaltet Grundflaechen-Update an oder aus
@@ -87,5 +87,14 @@ void bot_ubasic_load_file(char* filename, pFatFile* file);
  */
 void ubasic_display(void);
 
+#ifdef PC
+/**
+ * Misst die Ausfuehrungsgeschwindigkeit des Interpreters mit den Beispielprogrammen
+ * aus bot-logic/basic, einmal direkt aus dem Quelltext und einmal als Token-Code
+ * \param lines	Anzahl der auszufuehrenden Zeilen je Programm und Variante
+ */
+void bot_ubasic_benchmark(uint32_t lines);
+#endif // PC
+
 #endif // BEHAVIOUR_UBASIC_AVAILABLE
 #endif // BEHAVIOUR_UBASIC_H_
@@ -10,16 +10,17 @@
 
 #include <stdio.h>
 
+/* All values of a layer are stored in contiguous arrays. output and error
+ * hold no_of_neurons + 1 entries, the last one belongs to the bias neuron.
+ * weight and delta are row-major matrices with one row of
+ * (no_of_neurons of the previous layer + 1) entries per neuron, they are
+ * NULL for the input layer. */
 typedef struct {
-  float output;
-  float error;
+  int no_of_neurons;
+  float *output;
+  float *error;
   float *weight;
   float *delta;
-} neuron_t;
-
-typedef struct {
-  int no_of_neurons;
-  neuron_t *neuron;
 } layer_t;
 
 typedef struct {
@@ -0,0 +1,104 @@
+/*
+ * c't-Bot
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ * This program is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307, USA.
+ *
+ */
+
+/**
+ * \file 	neuralnet_fixed.h
+ * \brief 	Festkomma-Inferenz fuer offline trainierte neuronale Netze (lwneuralnet)
+ *
+ * Das Netz liegt als ein Byte-Array im Flash: Anzahl der Schichten L, die Neuronen je Schicht (L Bytes),
+ * je Schicht ab der zweiten die Anzahl der Nachkommabits der Gewichte (L - 1 Bytes) und dann alle Gewichte
+ * als int8_t, Schicht fuer Schicht mit einer Zeile je Neuron und dem Bias-Gewicht am Ende jeder Zeile
+ * (wie bei net_bsave()). Aktivierungen sind uint8_t mit NNQ_ONE als 1.0, die Sigmoid-Funktion ist eine
+ * stueckweise lineare Tabelle mit 17 Stuetzstellen im Flash. Die Rechnung verwendet nur Ganzzahlen mit
+ * fester Breite und liefert daher auf PC und MCU bitgenau dieselben Ergebnisse.
+ *
+ * \author 	c't-Bot-Team
+ * \date 	18.10.2026
+ */
+
+#ifndef NEURALNET_FIXED_H_
+#define NEURALNET_FIXED_H_
+
+#if defined BEHAVIOUR_NEURALNET_AVAILABLE && (defined PC || defined NEURALNET_FIXED_AVAILABLE)
+#define NNQ_ONE			128	/**< Wert einer Aktivierung von 1.0 */
+#define NNQ_MAX_LAYERS	4	/**< Maximale Anzahl an Schichten */
+#define NNQ_MAX_NEURONS	32	/**< Maximale Anzahl an Neuronen je Schicht (ohne Bias) */
+/** Maximale Groesse eines quantisierten Netzes [Byte] */
+#define NNQ_MAX_SIZE	(1 + 2 * NNQ_MAX_LAYERS + (NNQ_MAX_LAYERS - 1) * NNQ_MAX_NEURONS * (NNQ_MAX_NEURONS + 1))
+
+extern const uint8_t nnq_net_data[];	/**< Netz aus neuralnet_fixed_data.inc im Flash */
+
+/**
+ * Rechnet einen Eingabewert im Bereich 0 bis 1 in eine Festkomma-Aktivierung um
+ * \param x	Eingabewert, wird auf [0; 1] begrenzt
+ * \return	Aktivierung mit NNQ_ONE als 1.0
+ */
+static inline uint8_t nnq_from_float(float x) {
+	if (x <= 0.f) {
+		return 0;
+	}
+	if (x >= 1.f) {
+		return NNQ_ONE;
+	}
+	return (uint8_t) (x * NNQ_ONE + 0.5f);
+}
+
+/**
+ * Berechnet die Ausgaben eines quantisierten Netzes
+ * \param *net		Netz im Flash (z.B. nnq_net_data), auf dem PC auch im RAM
+ * \param *input	Eingaben (Anzahl wie Neuronen der ersten Schicht) mit NNQ_ONE als 1.0
+ * \param *output	Puffer fuer die Ausgaben (Anzahl wie Neuronen der letzten Schicht) mit NNQ_ONE als 1.0
+ */
+void nnq_compute(const uint8_t * net, const uint8_t * input, uint8_t * output);
+
+#ifdef PC
+#include "lwneuralnet.h"
+
+/**
+ * Quantisiert ein Netz fuer nnq_compute(). Die Nachkommabits der Gewichte werden je Schicht so gewaehlt,
+ * dass das betragsgroesste Gewicht gerade noch in einen int8_t passt.
+ * \param *net		Netz
+ * \param *buffer	Puffer fuer das quantisierte Netz
+ * \param size		Groesse des Puffers [Byte]
+ * \return			Groesse des quantisierten Netzes [Byte]; -1 zu viele Schichten oder Neuronen, -2 Puffer zu klein
+ */
+int16_t nnq_quantize(const network_t * net, uint8_t * buffer, uint16_t size);
+
+/**
+ * Liest ein mit net_bsave() gespeichertes Netz ein und quantisiert es
+ * \param *filename	Name der Datei von net_bsave()
+ * \param *buffer	Puffer fuer das quantisierte Netz
+ * \param size		Groesse des Puffers [Byte]
+ * \return			Groesse des quantisierten Netzes [Byte]; -1 zu viele Schichten oder Neuronen, -2 Puffer zu klein,
+ * 					-3 Datei nicht lesbar
+ */
+int16_t nnq_load_bsave(const char * filename, uint8_t * buffer, uint16_t size);
+
+/**
+ * Konvertiert ein mit net_bsave() gespeichertes Netz in eine Include-Datei mit nnq_net_data fuer den Flash
+ * (Ersatz fuer bot-logic/neuralnet_fixed_data.inc)
+ * \param *bsave_file	Name der Datei von net_bsave()
+ * \param *inc_file		Name der zu schreibenden Include-Datei
+ * \return				0, falls alles OK; Fehlercode von nnq_load_bsave() oder -4 Include-Datei nicht schreibbar
+ */
+int8_t nnq_convert(const char * bsave_file, const char * inc_file);
+#endif // PC
+
+#endif // BEHAVIOUR_NEURALNET_AVAILABLE && (PC || NEURALNET_FIXED_AVAILABLE)
+#endif // NEURALNET_FIXED_H_
@@ -74,4 +74,43 @@ void jump_to_prog_text_pointer(PTR_TYPE jump_ptr);
 void jump_to_next_linenum(void);
 void skip_all_whitespaces(void);
 
+#if UBASIC_BYTECODE
+#define TOKENIZER_NO_LINE	((PTR_TYPE) 0xffff)
+#define TOKENIZER_NO_CACHE	0xff
+
+/**
+ * Uebersetzt das aktuelle Programm in Token-Code; alle weiteren Zugriffe
+ * des Tokenizers laufen danach ueber den Token-Code statt ueber den Text
+ * \param program	Anfang des Programmtextes
+ * \return			0, falls erfolgreich; -1, falls das Programm nicht in
+ * 					UBASIC_BYTECODE_SIZE / UBASIC_BYTECODE_LINES passt
+ */
+int8_t tokenizer_compile(PTR_TYPE program);
+
+/**
+ * Schaltet zurueck auf die Interpretation des Programmtextes
+ */
+void tokenizer_discard_bytecode(void);
+
+/**
+ * \return	1, falls der Tokenizer Token-Code abarbeitet
+ */
+uint8_t tokenizer_is_compiled(void);
+
+/**
+ * Liefert das Cache-Byte des zuletzt gelesenen Strings im Token-Code, in dem der
+ * Aufrufer z.B. den aufgeloesten Tabellenindex eines call()-Namens ablegen kann
+ * \return	Zeiger auf das Cache-Byte (anfangs TOKENIZER_NO_CACHE) oder NULL,
+ * 			falls kein Token-Code aktiv ist
+ */
+uint8_t * tokenizer_string_cache(void);
+
+/**
+ * Sucht eine Zeilennummer in der Sprungtabelle des Token-Codes
+ * \param linenum	Zeilennummer
+ * \return			Offset des Zeilenanfangs oder TOKENIZER_NO_LINE
+ */
+PTR_TYPE tokenizer_find_linenum(int16_t linenum);
+#endif // UBASIC_BYTECODE
+
 #endif /* __TOKENIZER_H__ */
@@ -81,6 +81,22 @@
 // max. Anzahl der gebufferten Zeilennummern
 #define MAX_LINENUM_CACHE_DEPTH	8
 
+// Programme beim Laden in kompakten Token-Code uebersetzen (Sprungziele
+// aufgeloest, Zahlen und Variablen vorab dekodiert); braucht Platz fuer
+// das komplette uebersetzte Programm im RAM, daher nur auf PC
+#ifdef PC
+	#define UBASIC_BYTECODE			1
+#else
+	#define UBASIC_BYTECODE			0
+#endif
+
+// max. Groesse des uebersetzten Programms in Byte (groessere Programme
+// werden weiterhin direkt aus dem Quelltext interpretiert)
+#define UBASIC_BYTECODE_SIZE	8192
+
+// max. Anzahl Zeilennummern/Labels in der Sprungtabelle des Token-Codes
+#define UBASIC_BYTECODE_LINES	128
+
 // max. Anzahl Variablen (Basic)
 #define MAX_VARNUM 26
 
@@ -28,6 +28,8 @@
 #define CMD_TOOLS_H_
 
 #ifdef PC
+extern uint8_t ctbot_instance; /**< Nummer der Bot-Instanz, falls mehrere Bots in einem Prozess laufen (ct-Bot-fleet), sonst 0 */
+
 /**
  * Behandelt die Kommandozeilen-Argumente
  * \param argc	Anzahl der Argumente
@@ -40,5 +42,11 @@ void hand_cmd_args(int argc, char * argv[]);	// explizit ** int **
  */
 void cmd_init(void);
 
+/**
+ * Startet einen RemoteCall aus einer Eingabezeile wie "bot_turn(90)" bzw. "turn(90)" (nur mit BEHAVIOUR_REMOTECALL_AVAILABLE)
+ * \param *input	Eingabezeile, wird veraendert
+ */
+void cmd_remotecall(char * input);
+
 #endif // PC
 #endif // CMD_TOOLS_H_
@@ -59,8 +59,10 @@
 
 #define CMD_SETTINGS	's'		/**< Einstellungen uebertragen */
 #define SUB_SETTINGS_DISTSENS	'e'	/**< Auswertung der Sensordaten (L: Rohwerte 0 / vorverarbeitet 1) */
+#define SUB_SETTINGS_SNAPSHOT	'p'	/**< Snapshot-Kommandos aushandeln (L: Version, R: 0 Angebot / 1 akzeptiert / 2 abgelehnt) */
 
 #define CMD_DONE        'X'    	/**< Markiert das Ende einer Uebertragung */
+#define SUB_DONE_SNAPSHOT	'S'		/**< Ende einer Uebertragung mit allen Sensor- bzw. Aktuatorwerten des Zyklus als Payload (cmd_snapshot_sens_t bzw. cmd_snapshot_akt_t) */
 
 #define CMD_ID			'A'		/**< Adressverwaltung */
 #define SUB_ID_REQUEST	'R'		/**< Fordere eine Adresse an */
@@ -100,6 +102,7 @@
 #define SUB_MAP_CIRCLE		'C'	/**< Kreis zeichnen */
 #define SUB_MAP_CLEAR_LINES	'X'	/**< Linien loeschen */
 #define SUB_MAP_CLEAR_CIRCLES	'Y' /**< Kreise loeschen */
+#define SUB_MAP_DELTA		'U'	/**< Geaenderte Felder eines Map-Blocks (data_l: Block, data_r: erstes Feld), Payload: Bot-Position (x, y, heading je int16) und Eintraege [uebersprungene Felder, Anzahl n, n Feldwerte] mit je 8 Bit; Format siehe MAP_2_SIM_DELTA_AVAILABLE in map.h */
 
 #define CMD_SHUTDOWN		'q' /**< Kommando zum Herunterfahren */
 
@@ -158,6 +161,10 @@ typedef int16_t (* read_func_t)(void * data, int16_t length); /**< Funktion zum
 typedef int16_t (* write_func_t)(const void * data, int16_t length); /**< Funktion zum Schreiben von Daten einer Verbindung */
 typedef uint8_t (* check_crc_func_t)(command_t * cmd); /**< Funktion zum Ueberpruefen der CRC Checksumme */
 typedef void (* calc_crc_func_t)(command_t * cmd); /**< Funktion zum Berechnen der CRC Checksumme */
+#ifdef PC
+typedef void * (* peek_func_t)(int16_t length); /**< Funktion, die length Bytes am Stueck im Empfangspuffer bereitstellt, ohne sie zu entnehmen */
+typedef void (* consume_func_t)(int16_t length); /**< Funktion, die length Bytes aus dem Empfangspuffer entnimmt */
+#endif
 
 /** Verbindungsabhaengige Funktionen zur Kommandoverarbeitung */
 typedef struct {
@@ -165,10 +172,60 @@ typedef struct {
 	write_func_t write; /**< Daten auf die Verbindung schreiben */
 	check_crc_func_t crc_check; /**< CRC Checksumme ueberpruefen */
 	calc_crc_func_t crc_calc; /**< CRC Checksumme berechnen und ins Kommando schreiben */
+#ifdef PC
+	peek_func_t peek; /**< Daten im Empfangspuffer ansehen, NULL falls die Verbindung keinen hat */
+	consume_func_t consume; /**< Daten aus dem Empfangspuffer entnehmen */
+#endif
 } cmd_func_t;
 
 extern cmd_func_t cmd_functions; /**< Funktionspointer fuer Kommandoverarbeitung */
 
+#ifdef CMD_SNAPSHOT_AVAILABLE
+#define CMD_SNAPSHOT_VERSION	1	/**< Version des Snapshot-Layouts, bei jeder Aenderung an cmd_snapshot_sens_t oder cmd_snapshot_akt_t erhoehen */
+
+/**
+ * Sensorwerte eines Zyklus (ATmega -> Linux-Board bzw. Sim -> Bot), Payload von CMD_DONE / SUB_DONE_SNAPSHOT.
+ * data_l und data_r des Kommandos enthalten dieselben Werte wie bei einem normalen CMD_DONE.
+ */
+typedef struct {
+	uint8_t version;	/**< CMD_SNAPSHOT_VERSION */
+	int16_t dist_l;		/**< CMD_SENS_IR links */
+	int16_t dist_r;		/**< CMD_SENS_IR rechts */
+	int16_t enc_l;		/**< CMD_SENS_ENC links */
+	int16_t enc_r;		/**< CMD_SENS_ENC rechts */
+	int16_t border_l;	/**< CMD_SENS_BORDER links */
+	int16_t border_r;	/**< CMD_SENS_BORDER rechts */
+	int16_t line_l;		/**< CMD_SENS_LINE links */
+	int16_t line_r;		/**< CMD_SENS_LINE rechts */
+	int16_t ldr_l;		/**< CMD_SENS_LDR links */
+	int16_t ldr_r;		/**< CMD_SENS_LDR rechts */
+	uint16_t bps;		/**< CMD_SENS_BPS, BPS_NO_DATA ohne BPS-Sensor */
+	uint16_t rc5;		/**< CMD_SENS_RC5 */
+	uint8_t trans;		/**< CMD_SENS_TRANS */
+	uint8_t door;		/**< CMD_SENS_DOOR */
+	uint8_t error;		/**< CMD_SENS_ERROR */
+	int8_t mouse_dx;	/**< CMD_SENS_MOUSE X, 0 ohne Maussensor */
+	int8_t mouse_dy;	/**< CMD_SENS_MOUSE Y, 0 ohne Maussensor */
+	uint16_t crc;		/**< CRC ueber alle vorherigen Bytes */
+} PACKED_FORCE cmd_snapshot_sens_t;
+
+/**
+ * Aktuatorwerte eines Zyklus (Linux-Board -> ATmega bzw. Bot -> Sim), Payload von CMD_DONE / SUB_DONE_SNAPSHOT
+ */
+typedef struct {
+	uint8_t version;	/**< CMD_SNAPSHOT_VERSION */
+	int16_t motor_l;	/**< CMD_AKT_MOT links */
+	int16_t motor_r;	/**< CMD_AKT_MOT rechts */
+	uint8_t servo1;		/**< CMD_AKT_SERVO links */
+	uint8_t servo2;		/**< CMD_AKT_SERVO rechts */
+	uint8_t led;		/**< CMD_AKT_LED */
+	uint16_t crc;		/**< CRC ueber alle vorherigen Bytes */
+} PACKED_FORCE cmd_snapshot_akt_t;
+
+/** Gegenstelle akzeptiert Snapshots (ATmega auf dem Linux-Board, Linux-Board auf dem ATmega, Sim auf dem PC) */
+extern uint8_t cmd_snapshot_active;
+#endif // CMD_SNAPSHOT_AVAILABLE
+
 
 /**
  * Initialisiert die (High-Level-)Kommunikation
@@ -266,6 +323,31 @@ int8_t command_evaluate(void);
  */
 void command_display(command_t * command);
 
+#ifdef CMD_SNAPSHOT_AVAILABLE
+#ifdef PC
+/**
+ * Bietet der Gegenstelle Snapshot-Kommandos an, diese antwortet mit CMD_SETTINGS / SUB_SETTINGS_SNAPSHOT
+ */
+void command_offer_snapshot(void);
+
+/**
+ * Beendet einen Zyklus mit CMD_DONE / SUB_DONE_SNAPSHOT und allen Aktuatorwerten als Payload
+ * \param data_l	Daten fuer den linken Kanal (wie bei CMD_DONE)
+ * \param data_r	Daten fuer den rechten Kanal (wie bei CMD_DONE)
+ */
+void command_write_akt_snapshot(int16_t data_l, int16_t data_r);
+#endif // PC
+
+#ifdef BOT_2_RPI_AVAILABLE
+/**
+ * Beendet einen Zyklus mit CMD_DONE / SUB_DONE_SNAPSHOT und allen Sensorwerten als Payload
+ * \param data_l	Daten fuer den linken Kanal (wie bei CMD_DONE)
+ * \param data_r	Daten fuer den rechten Kanal (wie bei CMD_DONE)
+ */
+void command_write_sens_snapshot(int16_t data_l, int16_t data_r);
+#endif // BOT_2_RPI_AVAILABLE
+#endif // CMD_SNAPSHOT_AVAILABLE
+
 #ifdef BOT_2_SIM_AVAILABLE
 /**
  * Registriert den Bot beim Sim und teilt diesem dabei mit, welche
@@ -31,11 +31,18 @@
 
 //#define DEBUG_FIFO		/**< Schalter fuer Debug-Ausgaben */
 #define FIFO_STATS_ENABLED	/**< Speichert, wie viel Daten seit Initialisierung ins Fifo geschrieben wurden */
+#define FIFO_LOCKFREE_AVAILABLE	/**< PC und ARM-Linux: lock-freie Implementierung fuer genau einen Producer und einen Consumer (mehrere Producer muessen sich selbst gegenseitig ausschliessen, siehe fifo_t), der Consumer wird nur geweckt, wenn er wartet */
 
 #include "ct-Bot.h"
 #include "os_thread.h"
 #include "log.h"
 
+#ifndef PC
+#undef FIFO_LOCKFREE_AVAILABLE
+#endif
+
+#define FIFO_LOCKFREE_SPIN	16	/**< Anzahl sched_yield(), bevor sich der Consumer einer lock-freien FIFO schlafen legt */
+
 #ifndef LOG_AVAILABLE
 #undef DEBUG_FIFO
 #endif
@@ -45,18 +52,37 @@
 #define LOG_DEBUG_FIFO LOG_DEBUG
 #endif
 
-/** FIFO-Datentyp */
+#ifdef MCU
+typedef uint8_t fifo_size_t;	/**< Datentyp fuer Groesse und Fuellstand einer FIFO, auf dem MCU max. 255 Byte */
+#else
+typedef uint16_t fifo_size_t;	/**< Datentyp fuer Groesse und Fuellstand einer FIFO, auf PC und ARM-Linux max. 65535 Byte */
+#endif
+#define FIFO_SIZE_MAX	((fifo_size_t) ~(fifo_size_t) 0)	/**< Maximale Groesse einer FIFO [Byte] */
+
+/**
+ * FIFO-Datentyp. Jede FIFO hat genau einen Schreiber (Producer) und einen Leser (Consumer), auch mit
+ * FIFO_LOCKFREE_AVAILABLE. Schreiben mehrere Threads in dieselbe FIFO, muessen sie sich selbst gegenseitig
+ * ausschliessen, so dass zu jedem Zeitpunkt hoechstens einer schreibt (trace_fifo per trace_mutex,
+ * map_2_sim_fifo per lock_signal der Map); fuer mehrere Leser gilt dasselbe.
+ */
 typedef struct {
-	uint8_t volatile count;		/**< # Zeichen im Puffer */
-	uint8_t size;				/**< Puffer-Grosse */
+	fifo_size_t volatile count;	/**< # Zeichen im Puffer */
+	fifo_size_t size;			/**< Puffer-Grosse */
 	uint8_t * pread;				/**< Lesezeiger */
 	uint8_t * pwrite;			/**< Schreibzeiger */
-	uint8_t read2end;			/**< # Zeichen bis zum Ueberlauf Lesezeiger */
-	uint8_t write2end;			/**< # Zeichen bis zum Ueberlauf Schreibzeiger */
+	fifo_size_t read2end;		/**< # Zeichen bis zum Ueberlauf Lesezeiger */
+	fifo_size_t write2end;		/**< # Zeichen bis zum Ueberlauf Schreibzeiger */
 	uint8_t volatile overflow;	/**< 1, falls die Fifo mal uebergelaufen ist */
 	uint8_t volatile locked;		/**< 1, falls die Fifo gesperrt ist */
 #ifdef FIFO_STATS_ENABLED
 	uint32_t written;			/**< Anzahl an Bytes, die ins Fifo geschrieben wurden seit Initialisierung */
+#ifdef PC
+	uint32_t wakeups;			/**< Anzahl, wie oft der Producer den Consumer geweckt hat */
+	uint32_t waits;				/**< Anzahl, wie oft der Consumer auf Daten gewartet hat */
+#endif
+#endif // FIFO_STATS_ENABLED
+#ifdef FIFO_LOCKFREE_AVAILABLE
+	uint8_t volatile waiting;	/**< 1, falls der Consumer auf Daten wartet */
 #endif
 #ifdef OS_AVAILABLE
 	os_signal_t signal;			/**< Signal das den Fifo-Status meldet */
@@ -69,13 +95,88 @@ typedef struct {
 #endif // OS_AVAILABLE
 } fifo_t;
 
+#ifdef FIFO_LOCKFREE_AVAILABLE
+/**
+ * Liefert die Anzahl der Bytes in der FIFO. Alles, was der Producer vor dem Eintragen
+ * dieser Bytes geschrieben bzw. der Consumer vor dem Entnehmen gelesen hat, ist danach sichtbar.
+ * \param *f	Zeiger auf FIFO-Datenstruktur
+ * \return		Anzahl der Bytes in der FIFO
+ */
+static inline fifo_size_t fifo_lockfree_count(fifo_t * f) {
+	return __atomic_load_n(&f->count, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Gibt length geschriebene Bytes fuer den Consumer frei und weckt ihn, falls er wartet
+ * \param *f		Zeiger auf FIFO-Datenstruktur
+ * \param length	Anzahl der geschriebenen Bytes
+ */
+static inline void fifo_lockfree_commit_put(fifo_t * f, fifo_size_t length) {
+	__atomic_fetch_add(&f->count, length, __ATOMIC_SEQ_CST);
+#ifdef OS_AVAILABLE
+	/* passt zu fifo_lockfree_wait(): entweder sieht der Consumer den neuen count oder wir sehen waiting */
+	if (__atomic_exchange_n(&f->waiting, 0, __ATOMIC_SEQ_CST)) {
+		pthread_mutex_lock(&f->signal.mutex);
+		pthread_cond_signal(&f->signal.cond);
+		pthread_mutex_unlock(&f->signal.mutex);
+#ifdef FIFO_STATS_ENABLED
+		++f->wakeups;
+#endif
+	}
+#endif // OS_AVAILABLE
+}
+
+/**
+ * Gibt length gelesene Bytes fuer den Producer frei
+ * \param *f		Zeiger auf FIFO-Datenstruktur
+ * \param length	Anzahl der gelesenen Bytes
+ */
+static inline void fifo_lockfree_commit_get(fifo_t * f, fifo_size_t length) {
+	__atomic_fetch_sub(&f->count, length, __ATOMIC_RELEASE);
+}
+
+#ifdef OS_AVAILABLE
+/**
+ * Blockiert den Consumer, bis mindestens length Bytes in der FIFO sind
+ * \param *f		Zeiger auf FIFO-Datenstruktur
+ * \param length	Anzahl der benoetigten Bytes
+ */
+static inline void fifo_lockfree_wait(fifo_t * f, fifo_size_t length) {
+	/* erst kurz dem Producer den Vortritt lassen, Schlafenlegen und Wecken kostet je einen Systemaufruf */
+	uint8_t i;
+	for (i = 0; i < FIFO_LOCKFREE_SPIN; ++i) {
+		sched_yield();
+		if (fifo_lockfree_count(f) >= length) {
+			return;
+		}
+	}
+
+	pthread_mutex_lock(&f->signal.mutex);
+	while (1) {
+		/* der Producer setzt waiting zurueck, wenn er uns weckt */
+		__atomic_store_n(&f->waiting, 1, __ATOMIC_SEQ_CST);
+		if (__atomic_load_n(&f->count, __ATOMIC_SEQ_CST) >= length) {
+			break;
+		}
+		LOG_DEBUG_FIFO("Fifo 0x%08x ist leer, blockiere", (unsigned int) f);
+#ifdef FIFO_STATS_ENABLED
+		++f->waits;
+#endif
+		pthread_cond_wait(&f->signal.cond, &f->signal.mutex);
+	}
+	__atomic_store_n(&f->waiting, 0, __ATOMIC_RELAXED);
+	pthread_mutex_unlock(&f->signal.mutex);
+}
+#endif // OS_AVAILABLE
+#endif // FIFO_LOCKFREE_AVAILABLE
+
 /**
  * Initialisiert die FIFO, setzt Lese- und Schreibzeiger, etc.
  * \param *f			Zeiger auf FIFO-Datenstruktur
  * \param *buffer	Zeiger auf den Puffer der Groesse size fuer die FIFO
  * \param size		Anzahl der Bytes, die die FIFO speichern soll	.
  */
-void fifo_init(fifo_t * f, void * buffer, const uint8_t size);
+void fifo_init(fifo_t * f, void * buffer, const fifo_size_t size);
 
 /**
  * Schreibt length Byte in die FIFO.
@@ -85,7 +186,7 @@ void fifo_init(fifo_t * f, void * buffer, const uint8_t size);
  * \param block		Flag, ob die Funktion blockieren soll, wenn der freie Platz nicht ausreicht
  * \return			Fehlercode, 0 falls kein Fehler
  */
-uint8_t fifo_put_data(fifo_t * f, const void * data, uint8_t length, const uint8_t block);
+uint8_t fifo_put_data(fifo_t * f, const void * data, fifo_size_t length, const uint8_t block);
 
 /**
  * Liefert length Bytes aus der FIFO.
@@ -97,6 +198,48 @@ uint8_t fifo_put_data(fifo_t * f, const void * data, uint8_t length, const uint8
  */
 int16_t fifo_get_data(fifo_t * f, void * data, int16_t length);
 
+/**
+ * Liefert den freien Speicher der FIFO, damit ein Producer seine Daten ohne Kopie direkt dort ablegen kann.
+ * Sichtbar fuer den Consumer werden die Daten erst mit fifo_put_commit().
+ * \param *f	Zeiger auf FIFO-Datenstruktur
+ * \param **ptr	Zeiger auf den freien Speicher
+ * \return		Anzahl der Bytes, die ab *ptr am Stueck geschrieben werden koennen
+ */
+fifo_size_t fifo_put_peek(fifo_t * f, void ** ptr);
+
+/**
+ * Gibt length Bytes, die nach fifo_put_peek() direkt in die FIFO geschrieben wurden, fuer den Consumer frei
+ * \param *f		Zeiger auf FIFO-Datenstruktur
+ * \param length	Anzahl der geschriebenen Bytes, hoechstens der Rueckgabewert von fifo_put_peek()
+ */
+void fifo_put_commit(fifo_t * f, fifo_size_t length);
+
+/**
+ * Liefert die Daten am Anfang der FIFO, ohne sie zu kopieren oder zu entnehmen.
+ * Wenn OS_AVAILABLE, blockierend, falls Fifo leer.
+ * \param *f	Zeiger auf FIFO-Datenstruktur
+ * \param **ptr	Zeiger auf die Daten
+ * \return		Anzahl der Bytes, die ab *ptr am Stueck gelesen werden koennen
+ */
+fifo_size_t fifo_get_peek(fifo_t * f, const void ** ptr);
+
+/**
+ * Entnimmt length Bytes, die nach fifo_get_peek() direkt gelesen wurden, aus der FIFO
+ * \param *f		Zeiger auf FIFO-Datenstruktur
+ * \param length	Anzahl der gelesenen Bytes, hoechstens der Rueckgabewert von fifo_get_peek()
+ */
+void fifo_get_commit(fifo_t * f, fifo_size_t length);
+
+#if defined PC && defined OS_AVAILABLE
+/**
+ * Misst den Durchsatz der FIFO mit je einem Producer- und Consumer-Thread fuer verschiedene
+ * Blockgroessen und gibt Bytes/s sowie Weckvorgaenge und Wartevorgaenge des Consumers pro
+ * Sekunde aus
+ * \param bytes	Anzahl der Bytes pro Blockgroesse
+ */
+void fifo_benchmark(uint32_t bytes);
+#endif // PC && OS_AVAILABLE
+
 /**
  * Schreibt ein Byte in die FIFO.
  * \param *f	Zeiger auf FIFO-Datenstruktur
@@ -104,6 +247,13 @@ int16_t fifo_get_data(fifo_t * f, void * data, int16_t length);
  * \param isr	wird die Funktion von einer ISR aus aufgerufen?
  */
 static inline void _inline_fifo_put(fifo_t * f, const uint8_t data, uint8_t isr) {
+#ifdef FIFO_LOCKFREE_AVAILABLE
+	if (fifo_lockfree_count(f) == f->size) {
+		/* voll */
+		f->overflow = 1;
+		return;
+	}
+#else
 	if (f->count == f->size) {
 		f->overflow = 1;
 		/* voll */
@@ -114,10 +264,11 @@ static inline void _inline_fifo_put(fifo_t * f, const uint8_t data, uint8_t isr)
 #endif // OS_AVAILABLE
 		return;
 	}
+#endif // FIFO_LOCKFREE_AVAILABLE
 	uint8_t * pwrite = f->pwrite;
 	*(pwrite++) = data;
 
-	uint8_t write2end = f->write2end;
+	fifo_size_t write2end = f->write2end;
 	if (--write2end == 0) {
 		write2end = f->size;
 		pwrite -= write2end;
@@ -128,6 +279,10 @@ static inline void _inline_fifo_put(fifo_t * f, const uint8_t data, uint8_t isr)
 #ifdef FIFO_STATS_ENABLED
 	++f->written;
 #endif
+#ifdef FIFO_LOCKFREE_AVAILABLE
+	(void) isr;
+	fifo_lockfree_commit_put(f, 1);
+#else
 	if (isr) {
 		f->count++;
 #ifdef OS_AVAILABLE
@@ -150,8 +305,12 @@ static inline void _inline_fifo_put(fifo_t * f, const uint8_t data, uint8_t isr)
 #ifdef OS_AVAILABLE
 		/* Consumer aufwecken */
 		os_signal_unlock(&f->signal);
+#if defined FIFO_STATS_ENABLED && defined PC
+		++f->wakeups;
+#endif
 #endif // OS_AVAILABLE
 	}
+#endif // FIFO_LOCKFREE_AVAILABLE
 }
 
 /**
@@ -162,23 +321,36 @@ static inline void _inline_fifo_put(fifo_t * f, const uint8_t data, uint8_t isr)
  * \return		Das Byte aus der FIFO
  */
 static inline uint8_t _inline_fifo_get(fifo_t * f, uint8_t isr) {
+#ifdef FIFO_LOCKFREE_AVAILABLE
+	(void) isr;
+	if (fifo_lockfree_count(f) == 0) {
 #ifdef OS_AVAILABLE
+		fifo_lockfree_wait(f, 1);
+#endif
+	}
+#elif defined OS_AVAILABLE
 	if (! isr) {
-		uint8_t count = f->count;
-		if (count == 0) {
+		fifo_size_t count = f->count;
+		while (count == 0) { // Wecken fuer bereits gelesene Daten moeglich, daher erneut pruefen
 			/* blockieren */
 			LOG_DEBUG_FIFO("Fifo 0x%08x ist leer, blockiere", (unsigned int) f);
+#if defined FIFO_STATS_ENABLED && defined PC
+			++f->waits;
+#endif
 			os_signal_lock(&f->signal);
-			os_signal_set(&f->signal);
-			LOG_DEBUG_FIFO("Fifo 0x%08x enthaelt wieder Daten, weiter geht's", (unsigned int) f);
-			os_signal_release(&f->signal);
+			if (f->count == 0) { // sonst hat der Producer schon vor os_signal_lock() geweckt
+				os_signal_set(&f->signal);
+				LOG_DEBUG_FIFO("Fifo 0x%08x enthaelt wieder Daten, weiter geht's", (unsigned int) f);
+				os_signal_release(&f->signal);
+			}
+			count = f->count;
 		}
 	}
-#endif // OS_AVAILABLE
+#endif // FIFO_LOCKFREE_AVAILABLE
 
 	uint8_t* pread = f->pread;
 	uint8_t data = *(pread++);
-	uint8_t read2end = f->read2end;
+	fifo_size_t read2end = f->read2end;
 
 	if (--read2end == 0) {
 		read2end = f->size;
@@ -187,6 +359,9 @@ static inline uint8_t _inline_fifo_get(fifo_t * f, uint8_t isr) {
 
 	f->pread = pread;
 	f->read2end = read2end;
+#ifdef FIFO_LOCKFREE_AVAILABLE
+	fifo_lockfree_commit_get(f, 1);
+#else
 	if (isr) {
 		f->count--;
 	} else {
@@ -203,6 +378,7 @@ static inline uint8_t _inline_fifo_get(fifo_t * f, uint8_t isr) {
 		pthread_mutex_unlock(&f->signal.mutex);
 #endif
 	}
+#endif // FIFO_LOCKFREE_AVAILABLE
 
 	return data;
 }
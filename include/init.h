@@ -32,6 +32,7 @@
 #include "bot-logic.h"
 #include "sensor-low.h"
 #include "sdfat_fs.h"
+#include "map.h"
 
 extern uint8_t EEPROM resetsEEPROM;	/**< Reset-Counter im EEPROM */
 
@@ -40,7 +41,7 @@ extern uint8_t EEPROM resetsEEPROM;	/**< Reset-Counter im EEPROM */
 typedef union {
 	struct {
 #ifdef MAP_AVAILABLE
-		uint8_t map_buffer[512]; /**< Map-Puffer */
+		uint8_t map_buffer[MAP_BLOCK_CACHE_SIZE * 512]; /**< Map-Puffer (Block-Cache) */
 #else
 		uint8_t map_buffer[0]; /**< Map-Puffer inaktiv */
 #endif // MAP_AVAILABLE
@@ -0,0 +1,45 @@
+/*
+ * c't-Bot
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ * This program is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307, USA.
+ *
+ */
+
+/**
+ * \file 	map-benchmark.h
+ * \brief 	Benchmarks fuer die Karte auf dem PC
+ * \author 	c't-Bot-Team
+ * \date 	18.10.2026
+ */
+
+#ifndef MAP_BENCHMARK_H_
+#define MAP_BENCHMARK_H_
+
+#if defined PC && defined MAP_AVAILABLE
+/**
+ * Vergleicht die Strahl-Eintragung mit float- und mit Festkomma-Trigonometrie und gibt
+ * die erreichten Strahlen pro Sekunde aus
+ * \param count	Anzahl der Messungen (je zwei Strahlen)
+ */
+void map_benchmark_rays(uint32_t count);
+
+/**
+ * Misst Export, Import und Loeschen der Karte fuer verschieden grosse erkundete Bereiche
+ * \param *file	Name der Datei fuer Export und Import
+ */
+void map_benchmark_file(const char* file);
+#endif // PC && MAP_AVAILABLE
+
+#endif // MAP_BENCHMARK_H_
@@ -33,7 +33,6 @@
 #include "os_thread.h"
 
 #define MAP_CLEAR_ON_INIT	/**< Leert die Karte, wenn der Bot gebootet wird */
-#define MAP_USE_TRIG_CACHE	/**< Sollen sin(heading) und cos(heading) mit gecachet werden? */
 
 /* Geomtrie der Karte - Achtung, nur aendern, wenn man die Konsequenzen genau kennt! */
 #define MAP_SIZE_MM			12288L	/**< Kantenlaenge der Karte in mm. Zentrum ist der Startplatz des Bots. Achtung, MAP_SIZE_MM * MAP_RESOLUTION / 1000 muss ganzzahliges Vielfaches von MACRO_BLOCK_LENGTH sein! */
@@ -47,11 +46,67 @@
 #undef MAP_UPDATE_STACK_SIZE
 #define MAP_UPDATE_STACK_SIZE	220
 #endif
-#define MAP_UPDATE_CACHE_SIZE	16	/**< Groesse des Map-Caches [# Eintraege] */
+#define MAP_UPDATE_CACHE_SIZE	30	/**< Groesse des Map-Caches [# Eintraege], jeder Eintrag belegt 8 Byte RAM */
 #define MAP_2_SIM_STACK_SIZE		256	/**< Groesse des Map-2-Sim-Thread-Stacks [Byte] */
 
 #define MAP_2_SIM_BUFFER_SIZE	32	/**< Anzahl der Bloecke, die fuer Map-2-Sim gecached werden koennen */
 
+/*
+ * Format von SUB_MAP_DELTA (CMD_MAP):
+ * - data_l: Blocknummer wie bei SUB_MAP_DATA_1..4, data_r: Index (0..MAP_BLOCK_SIZE - 1) des Felds, ab dem die Eintraege zaehlen
+ * - Payload (hoechstens 128 Byte): x, y und heading der Bot-Position als int16 in Byte-Reihenfolge des Bots (wie data_r bei
+ *   SUB_MAP_DATA_1..3), danach Eintraege [skip (uint8), n (uint8), n Feldwerte (int8)]
+ * - Der Empfaenger beginnt bei Feld data_r, ueberspringt skip unveraenderte Felder und ersetzt die folgenden n Felder
+ *   durch die Feldwerte; der naechste Eintrag zaehlt ab dem Feld danach. n = 0 ist zulaessig (lange Luecken).
+ * - Felder hinter dem letzten Eintrag bleiben unveraendert. Passt ein Block nicht in ein Kommando, folgen weitere
+ *   SUB_MAP_DELTA-Kommandos mit eigenem data_r.
+ * - Die Feldindizes entsprechen der Lage in den 512 Byte von SUB_MAP_DATA_1..4.
+ * - Deltas beziehen sich immer auf den zuletzt an den Empfaenger gesendeten Inhalt des Blocks. Vor SUB_MAP_REQUEST
+ *   muss der Empfaenger seine Karte leeren, leere Bloecke werden dann nicht uebertragen.
+ * ct-Sim hat dafuer noch keinen Empfaenger, daher ist der Schalter standardmaessig aus.
+ */
+//#define MAP_2_SIM_DELTA_AVAILABLE	/**< Map-2-Sim sendet von geaenderten Bloecken nur die Felder, die sich seit der letzten Uebertragung geaendert haben (SUB_MAP_DELTA, ct-Sim muss das unterstuetzen, bisher nicht der Fall) */
+
+/* Anzahl der zuletzt gesendeten Bloecke, die fuer Map-2-Sim-Deltas vorgehalten werden, jeder Eintrag belegt MAP_BLOCK_SIZE Byte RAM */
+#ifdef PC
+#define MAP_2_SIM_SHADOW_SIZE	32	/**< Anzahl der Bloecke, gegen die Deltas gebildet werden koennen */
+#elif defined __AVR_ATmega1284P__
+#define MAP_2_SIM_SHADOW_SIZE	2	/**< Anzahl der Bloecke, gegen die Deltas gebildet werden koennen */
+#else
+#define MAP_2_SIM_SHADOW_SIZE	1	/**< Anzahl der Bloecke, gegen die Deltas gebildet werden koennen */
+#endif
+
+/* Groesse des Block-Caches der Karte (LRU, write-back), jeder Eintrag belegt MAP_BLOCK_SIZE Byte RAM */
+#ifdef PC
+#define MAP_BLOCK_CACHE_SIZE	64	/**< Anzahl der Bloecke, die gleichzeitig im RAM gehalten werden */
+#elif defined __AVR_ATmega1284P__
+#define MAP_BLOCK_CACHE_SIZE	2	/**< Anzahl der Bloecke, die gleichzeitig im RAM gehalten werden */
+#else
+#define MAP_BLOCK_CACHE_SIZE	1	/**< Anzahl der Bloecke, die gleichzeitig im RAM gehalten werden */
+#endif
+
+#if MAP_BLOCK_CACHE_SIZE < 1 || MAP_BLOCK_CACHE_SIZE > 255
+#error "MAP_BLOCK_CACHE_SIZE muss zwischen 1 und 255 liegen"
+#endif
+
+#if defined PC && ! defined WIN32
+#define MAP_MMAP_AVAILABLE	/**< Kartendatei per mmap() einblenden, der Block-Cache verwaltet dann nur noch veraenderte Bloecke (PC und ARM-Linux) */
+#endif
+
+#ifdef PC
+#define MAP_UPDATE_BATCH_AVAILABLE	/**< Update-Thread sammelt die Feld-Updates eines Durchlaufs und traegt sie blockweise ein (braucht ca. 40 KB RAM) */
+#endif
+
+#ifdef PC
+#define MAP_SUMMARY_AVAILABLE	/**< Min- / Max-Zusammenfassung je Section und Makroblock fuer map_get_ratio() (braucht ca. 27 KB RAM) */
+#endif
+
+#define MAP_CACHE_STATS_AVAILABLE	/**< Zaehlt Treffer, Fehlzugriffe und Verdraengungen des Block-Caches */
+
+#ifdef PC
+#define MAP_CHANGE_HANDLER_AVAILABLE	/**< Update-Thread meldet nach jedem Durchlauf den Bereich der Felder mit geaendertem Wert an einen registrierten Handler (nur fuer die Neuplanung von behaviour_pathplanning auf dem PC) */
+#endif
+
 #define MAP_OBSTACLE_THRESHOLD	-20	/**< Schwellwert, ab dem ein Feld als Hindernis gilt */
 #define MAP_DRIVEN_THRESHOLD	1	/**< Schwellwert, ab dem ein Feld als befahren gilt */
 
@@ -65,21 +120,19 @@ extern int16_t map_max_x;		/**< belegter Bereich der Karte [Kartenindex]: groess
 extern int16_t map_min_y;		/**< belegter Bereich der Karte [Kartenindex]: kleinste Y-Koordinate */
 extern int16_t map_max_y;		/**< belegter Bereich der Karte [Kartenindex]: groesste Y-Koordinate */
 
-/** Map-Cache-Eintrag */
+/** Map-Cache-Eintrag, Blickrichtung als Ganzzahl, sin / cos berechnet der Update-Thread per Tabelle in Festkomma */
 typedef struct {
-	int16_t x_pos;		/**< X-Komponente der Position [mm] */
-	int16_t y_pos;		/**< Y-Komponente der Position [mm] */
-#ifdef MAP_USE_TRIG_CACHE
-	float sin;			/**< sin(heading) */
-	float cos;			/**< cos(heading) */
-#else
-	int16_t heading;	/**< Blickrichtung [1/10 Grad] */
-#endif // MAP_USE_TRIG_CACHE
-	uint8_t dataL;		/**< Entfernung linker Distanzsensor [5 mm] aber auch BorderSensor [0/1] */
-	uint8_t dataR;		/**< Entfernung rechter Distanzsensor [5 mm] aber auch BorderSensor [0/1] */
-	scan_mode_t mode;	/**< Was soll aktualisiert werden */
+	int16_t x_pos;			/**< X-Komponente der Position [mm] */
+	int16_t y_pos;			/**< Y-Komponente der Position [mm] */
+	uint16_t heading:12;	/**< Blickrichtung [1/10 Grad], 0 bis 3599 */
+	uint16_t location:1;	/**< Grundflaeche aktualisieren */
+	uint16_t distance:1;	/**< Distanzsensoren aktualisieren */
+	uint16_t border:1;		/**< Abgrundsensoren aktualisieren */
+	uint16_t unused:1;		/**< derzeit unbenutzt */
+	uint8_t dataL;			/**< Entfernung linker Distanzsensor [5 mm] aber auch BorderSensor [0/1] */
+	uint8_t dataR;			/**< Entfernung rechter Distanzsensor [5 mm] aber auch BorderSensor [0/1] */
 #ifdef MEASURE_POSITION_ERRORS_AVAILABLE
-	uint8_t loc_prob;	/**< gibt an, wie sicher wir ueber die Position sind [0; 255] */
+	uint8_t loc_prob;		/**< gibt an, wie sicher wir ueber die Position sind [0; 255] */
 #endif
 } PACKED map_cache_t;
 
@@ -91,10 +144,24 @@ typedef struct {
 	int16_t map_max_x;			/**< belegter Bereich der Karte [Kartenindex]: groesste X-Koordinate */
 	int16_t map_min_y;			/**< belegter Bereich der Karte [Kartenindex]: kleinste Y-Koordinate */
 	int16_t map_max_y;			/**< belegter Bereich der Karte [Kartenindex]: groesste Y-Koordinate */
-	uint8_t dummy[MAP_BLOCK_SIZE - 10];
+	uint32_t magic;				/**< MAP_SPARSE_MAGIC bei exportierten Karten im Sparse-Format, sonst 0 (immer bei der Arbeitsdatei, die bleibt voll) */
+	uint16_t blocks;			/**< Sparse-Format: Anzahl der folgenden Bloecke, jeweils mit vorangestellter Blocknummer (uint16_t) */
+	uint8_t dummy[MAP_BLOCK_SIZE - 16];
 } PACKED_FORCE map_header_t;
 #endif // SDFAT_AVAILABLE
 
+#ifdef MAP_CACHE_STATS_AVAILABLE
+/** Statistikdaten des Block-Caches der Karte */
+typedef struct {
+	uint32_t hits;			/**< Anzahl der Zugriffe auf Bloecke, die bereits im Cache lagen */
+	uint32_t misses;		/**< Anzahl der Zugriffe, fuer die ein Block von der SD-Karte geladen werden musste */
+	uint32_t evictions;		/**< Anzahl der Bloecke, die aus dem Cache verdraengt wurden */
+	uint32_t writebacks;	/**< Anzahl der veraenderten Bloecke, die auf die SD-Karte zurueckgeschrieben wurden */
+} map_cache_stats_t;
+
+extern map_cache_stats_t map_cache_stats; /**< Statistikdaten des Block-Caches */
+#endif // MAP_CACHE_STATS_AVAILABLE
+
 extern fifo_t map_update_fifo;			/**< Fifo fuer Cache */
 extern map_cache_t map_update_cache[];	/**< Map-Cache */
 extern uint8_t map_update_stack[];		/**< Stack des Update-Threads */
@@ -162,10 +229,16 @@ uint8_t map_get_ratio(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t wi
 uint8_t map_way_free(int16_t from_x, int16_t from_y, int16_t to_x, int16_t to_y, uint8_t margin);
 
 /**
- * Haelt den Bot an und schreibt den Map-Update-Cache komplett zurueck
+ * Haelt den Bot an, wartet auf das Ende des laufenden Map-Updates und schreibt alle
+ * veraenderten Bloecke des Block-Caches gesammelt zurueck
  */
 void map_flush_cache(void);
 
+/**
+ * Schreibt alle veraenderten Bloecke zurueck und hebt die Einblendung der Kartendatei auf (beim Herunterfahren)
+ */
+void map_close(void);
+
 /**
  * Zeigt die Karte an
  */
@@ -210,19 +283,40 @@ static inline int16_t map_to_world(int16_t map_koord) {
 #define map_get_max_y() map_to_world(map_max_y)		/**< Maximum in Y-Richtung */
 
 /**
- * Kopiert die aktuelle Karte in eine BotFS-Datei
+ * Kopiert die aktuelle Karte in eine BotFS-Datei. Die Datei hat das Sparse-Format: Header und danach
+ * nur die nicht leeren Bloecke des belegten Bereichs, jeweils mit ihrer Blocknummer.
  * \param *file Name der Zieldatei (wird geloescht, falls sie schon existiert)
  * \return 0 falls kein Fehler, sonst Fehlercode
  */
 int8_t map_save_to_file(const char* file);
 
 /**
- * Laedt die Karte aus einer BotFS-Datei, aktuelle Karte wird dadurch geloescht
+ * Laedt die Karte aus einer BotFS-Datei, aktuelle Karte wird dadurch geloescht.
+ * Versteht das Sparse-Format und vollstaendige Kartendateien (alte Exporte, ctbot.map).
  * \param *file Name der zu ladenden BotFS-Datei
  * \return 0 falls kein Fehler, sonst Fehlercode
  */
 int8_t map_load_from_file(const char* file);
 
+#ifdef MAP_CHANGE_HANDLER_AVAILABLE
+/**
+ * Handler fuer veraenderte Kartenbereiche; wird im Kontext des Update-Threads bei gesperrter Karte aufgerufen,
+ * darf also nicht auf die Karte zugreifen und sollte sich nur den Bereich merken
+ * \param min_x	kleinste X-Koordinate der veraenderten Felder [mm]
+ * \param min_y	kleinste Y-Koordinate der veraenderten Felder [mm]
+ * \param max_x	groesste X-Koordinate der veraenderten Felder [mm]
+ * \param max_y	groesste Y-Koordinate der veraenderten Felder [mm]
+ */
+typedef void (* map_change_handler_t)(int16_t min_x, int16_t min_y, int16_t max_x, int16_t max_y);
+
+/**
+ * Registriert einen Handler, der nach jedem Durchlauf des Update-Threads mit dem Rechteck aller dabei veraenderten Felder
+ * aufgerufen wird. Es gibt nur einen Handler, ein neuer ersetzt den alten.
+ * \param handler	Handler oder NULL zum Abmelden
+ */
+void map_set_change_handler(map_change_handler_t handler);
+#endif // MAP_CHANGE_HANDLER_AVAILABLE
+
 #ifdef MAP_2_SIM_AVAILABLE
 /**
  * Uebertraegt die komplette Karte an den Sim
@@ -275,6 +369,40 @@ void map_draw_circle_world(position_t center, int16_t radius, uint8_t color);
 #ifdef PC
 extern char* map_file; /**< Dateiname fuer Ex- / Import */
 
+/**
+ * Loescht die komplette Karte
+ */
+void map_delete(void);
+
+/**
+ * Setzt den Wert eines Feldes der Karte
+ * \param x		X-Ordinate der Karte
+ * \param y		Y-Ordinate der Karte
+ * \param value	Neuer Wert des Feldes (> 0 heisst frei, <0 heisst belegt)
+ */
+void map_set_field(int16_t x, int16_t y, int8_t value);
+
+/**
+ * Traegt die Messung beider Distanzsensoren wie der Map-Update-Thread in die Karte ein
+ * \param x			X-Achse der Position in Weltkoordinaten
+ * \param y			Y-Achse der Position in Weltkoordinaten
+ * \param sin_head	sin(Blickrichtung) in Q1.14
+ * \param cos_head	cos(Blickrichtung) in Q1.14
+ * \param distL		Sensorwert links
+ * \param distR		Sensorwert rechts
+ */
+void map_update_sensor_distance(int16_t x, int16_t y, int16_t sin_head, int16_t cos_head, int16_t distL, int16_t distR);
+
+/**
+ * Traegt einen Sensorstrahl mit bereits berechneten Endpunkten in die Karte ein
+ * \param x		X-Achse der Position des Sensors in Weltkoordinaten
+ * \param y		Y-Achse der Position des Sensors in Weltkoordinaten
+ * \param end_x	X-Achse des Strahlendes in Weltkoordinaten
+ * \param end_y	Y-Achse des Strahlendes in Weltkoordinaten
+ * \param dist	Sensorwert
+ */
+void map_update_sensor_ray(int16_t x, int16_t y, int16_t end_x, int16_t end_y, int16_t dist);
+
 /**
  * Schreibt einbe Karte in eine PGM-Datei
  * \param filename	Zieldatei
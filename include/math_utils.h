@@ -233,6 +233,34 @@ int32_t get_dist(int16_t x1, int16_t y1, int16_t x2, int16_t y2);
  */
 position_t calc_point_in_distance(float alpha, int16_t dx, int16_t dy);
 
+#define FIX_TRIG_SHIFT	14	/**< Nachkommabits der Festkomma-Winkelfunktionen (Q1.14, 1.0 = 16384) */
+
+/**
+ * Sinus in Festkomma-Darstellung per Tabelle (1 Grad Stuetzstellen, linear interpoliert)
+ * \param angle	Winkel [1/10 Grad], beliebiger Wertebereich
+ * \return		sin(angle) in Q1.14
+ */
+int16_t sin_fix(int16_t angle);
+
+/**
+ * Cosinus in Festkomma-Darstellung per Tabelle
+ * \param angle	Winkel [1/10 Grad], beliebiger Wertebereich
+ * \return		cos(angle) in Q1.14
+ */
+static inline int16_t cos_fix(int16_t angle) {
+	return sin_fix((int16_t) (angle + 900));
+}
+
+/**
+ * Multipliziert einen Integer-Wert mit einem Q1.14-Faktor und rundet das Ergebnis
+ * \param a	Faktor 1 (z.B. Strecke [mm])
+ * \param q	Faktor 2 in Q1.14 (z.B. Ergebnis von sin_fix())
+ * \return	a * q, gerundet
+ */
+static inline int16_t mul_fix(int16_t a, int16_t q) {
+	return (int16_t) (((int32_t) a * q + (1L << (FIX_TRIG_SHIFT - 1))) >> FIX_TRIG_SHIFT);
+}
+
 /**
  * Multipliziert zwei vorzeichenbehaftete 8 Bit Werte
  * \param a	Faktor 1 (8 Bit signed)
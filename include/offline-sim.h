@@ -0,0 +1,59 @@
+/*
+ * c't-Bot
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ * This program is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307, USA.
+ *
+ */
+
+/**
+ * \file 	offline-sim.h
+ * \brief 	Minimaler Welt-Simulator im Bot-Prozess, ersetzt ct-Sim fuer Benchmarks und Tests
+ * \author 	c't-Bot-Team
+ * \date 	18.10.2026
+ */
+
+#ifndef OFFLINE_SIM_H_
+#define OFFLINE_SIM_H_
+
+#if defined PC && defined BOT_2_SIM_AVAILABLE && ! defined ARM_LINUX_BOARD
+#define OFFLINE_SIM_ARENA		"arena"	/**< Name der eingebauten Welt fuer offline_sim_init() */
+#define OFFLINE_SIM_CELL_SIZE	8		/**< Kantenlaenge einer Zelle der Welt [mm], wie ein Pixel von map_to_pgm() */
+
+/**
+ * Schaltet auf den Offline-Sim um: Die Sensordaten werden danach im Bot-Prozess berechnet statt vom Sim empfangen.
+ * Die Welt ist eine PGM-Datei (P5) mit OFFLINE_SIM_CELL_SIZE mm pro Pixel, der Bot startet in der Mitte mit
+ * Blickrichtung nach rechts. Grauwerte: 0-63 Wand, 64-95 Abgrund, 96-127 Linie, 128-255 freie Flaeche.
+ * \param *world		Name der PGM-Datei oder OFFLINE_SIM_ARENA
+ * \param ticks			Anzahl der zu simulierenden Zyklen (je 10 ms), danach wird das Programm beendet
+ * \param *remotecall	RemoteCall, der im ersten Zyklus gestartet wird (z.B. "bot_drive_distance(0,150,100)"), oder NULL
+ * \return				0, falls alles OK; -1 Datei nicht lesbar, -2 keine gueltige PGM-Datei, -3 kein Speicher
+ */
+int8_t offline_sim_init(const char * world, uint32_t ticks, const char * remotecall);
+
+/**
+ * Prueft, ob der Offline-Sim aktiv ist
+ * \return	1, falls die Sensordaten vom Offline-Sim kommen, sonst 0
+ */
+uint8_t offline_sim_active(void);
+
+/**
+ * Simuliert einen Zyklus (10 ms) mit den aktuellen Motorwerten und setzt die Sensordaten wie nach einem
+ * CMD_DONE vom Sim (Ersatz fuer bot_2_sim_listen()). Nach der gewuenschten Anzahl an Zyklen werden
+ * Statistiken ausgegeben und das Programm beendet.
+ */
+void offline_sim_step(void);
+#endif // PC && BOT_2_SIM_AVAILABLE && ! ARM_LINUX_BOARD
+
+#endif // OFFLINE_SIM_H_
@@ -275,6 +275,12 @@ extern pthread_mutex_t os_enterCS_mutex; /**< Mutex fuer os_enterCS() / os_exitC
  */
 void os_thread_sleep(uint32_t sleep);
 
+/**
+ * Weckt die Threads, die in os_thread_sleep() auf die Systemzeit warten.
+ * Wird nach jeder Aktualisierung der Systemzeit (CMD_DONE vom Sim) aufgerufen.
+ */
+void os_thread_wakeup(void);
+
 /**
  * Entfernt ein Signal vom aktuellen Thread
  */
@@ -253,6 +253,30 @@ uint32_t sdfat_get_filesize(pFatFile p_file); /**< \see FatFileWrapper::get_file
 uint8_t sdfat_get_filename(pFatFile p_file, char* p_name, uint16_t size); /**< \see FatFileWrapper::get_filename() */
 uint8_t sdfat_sync_vol(pSdFat p_instance); /**< \see SdFatWrapper::sync_vol() */
 
+/**
+ * Maps the first length bytes of a file into memory (shared, read / write)
+ * \param p_file Pointer to file, all buffered data is flushed before mapping
+ * \param length Number of bytes to map, the file has to be at least this large
+ * \return Address of the mapping or NULL, if mmap() is not supported or failed
+ */
+void* sdfat_mmap(pFatFile p_file, uint32_t length);
+
+/**
+ * Schedules writing of modified pages of a mapping created by sdfat_mmap() to the file
+ * \param p_addr Address of the mapping
+ * \param length Length of the mapping in byte
+ * \return Error code: 0 for success, 1 for error of msync()
+ */
+uint8_t sdfat_msync(void* p_addr, uint32_t length);
+
+/**
+ * Removes a mapping created by sdfat_mmap(), modified pages are still written to the file
+ * \param p_addr Address of the mapping
+ * \param length Length of the mapping in byte
+ * \return Error code: 0 for success, 1 for error of munmap()
+ */
+uint8_t sdfat_munmap(void* p_addr, uint32_t length);
+
 /**
  * Simple test code for SD Fat library
  * \return 1 in case of success, 0 otherwise
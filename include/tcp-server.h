@@ -33,8 +33,22 @@
 void tcp_server_init(void);
 
 /**
- * Hauptschleife des TCP-Servers
- * \param runs	Anzahl der Durchlaeufe
+ * Setzt den Frame-Mix fuer tcp_server_run()
+ * \param *mix	Mix als "typ[:anzahl],...", Typen: sens, map, log, rc; z.B. "sens,map:2,log:4"
+ * \return		0, falls der Mix gueltig war
+ */
+int8_t tcp_server_set_mix(const char * mix);
+
+/**
+ * Schaltet die Ausgabe der Benchmark-Zusammenfassung als CSV an oder aus
+ * \param csv	1: CSV, 0: Text
+ */
+void tcp_server_set_csv(uint8_t csv);
+
+/**
+ * Hauptschleife des TCP-Servers. Sendet pro Tick die Kommandos gemaess Mix (tcp_server_set_mix()),
+ * wartet auf das Echo des Test-Clients und gibt am Ende Latenz-Perzentile und Durchsatz aus.
+ * \param runs	Anzahl der Durchlaeufe (Ticks)
  */
 void tcp_server_run(int runs);
 
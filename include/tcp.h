@@ -55,6 +55,38 @@ int16_t tcp_write(const void * data, int16_t length);
  */
 int16_t tcp_read(void * data, int16_t length);
 
+/**
+ * Stellt length Bytes am Stueck aus dem Empfangspuffer bereit, ohne sie zu entnehmen.
+ * Achtung: blockierend, bis genug Daten empfangen wurden!
+ * \param length	Anzahl der Bytes, maximal MAX_PAYLOAD + sizeof(command_t)
+ * \return			Zeiger auf die Daten, gueltig bis zum naechsten tcp_peek() / tcp_read()
+ */
+void * tcp_peek(int16_t length);
+
+/**
+ * Entnimmt Daten aus dem Empfangspuffer, die per tcp_peek() gelesen wurden
+ * \param length	Anzahl der Bytes
+ */
+void tcp_consume(int16_t length);
+
+extern uint32_t tcp_recv_calls; /**< Anzahl der recv()-Aufrufe seit Programmstart */
+
+#ifdef BOT_2_SIM_ASYNC_AVAILABLE
+/**
+ * Startet den Empfangs-Thread fuer die bestehende Verbindung. Danach liefern tcp_read(),
+ * tcp_peek() und tcp_consume() die Daten aus der Frame-Queue des Threads.
+ */
+void tcp_start_receiver(void);
+
+/**
+ * Ermittelt die Anzahl der empfangenen, noch nicht (vollstaendig) gelesenen Kommandos.
+ * Wartet hoechstens timeout_ms Millisekunden, falls noch keines vorliegt.
+ * \param timeout_ms	Maximale Wartezeit / ms, 0 fuer sofortige Rueckkehr
+ * \return				Anzahl der Kommandos in der Queue
+ */
+uint16_t tcp_frames_available(uint16_t timeout_ms);
+#endif // BOT_2_SIM_ASYNC_AVAILABLE
+
 /**
  * Oeffnet eine TCP-Verbindung zum Server
  * \param *hostname	Symbolischer Name des Host, auf dem ct-Sim laeuft
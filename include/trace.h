@@ -30,11 +30,88 @@
 #ifdef CREATE_TRACEFILE_AVAILABLE
 #include "bot-logic/bot-logic.h"
 
+/*
+ * Binaeres Trace-Format (trace.bin):
+ * Kopf aus TRACE_MAGIC und TRACE_VERSION, danach Eintraege aus Typ (uint8_t), Laenge der
+ * Nutzdaten (uint8_t) und Nutzdaten (eine der trace_rec_*_t-Strukturen, Host-Byte-Order).
+ * Unbekannte Typen werden beim Lesen ueber die Laenge uebersprungen.
+ */
+#define TRACE_MAGIC		"ctBT"	/**< Kennung am Anfang einer binaeren Trace-Datei */
+#define TRACE_VERSION	1		/**< Version des Formats, bei jeder Aenderung an den trace_rec_*_t-Strukturen erhoehen */
+
+#define TRACE_REC_INPUT		'I'	/**< Eingangsdaten eines Zyklus vor bot_sens(), trace_rec_input_t */
+#define TRACE_REC_SENSORS	'S'	/**< Sensordaten nach dem Verhaltenscode, trace_rec_sensors_t */
+#define TRACE_REC_ACTUATORS	'A'	/**< Aktuatordaten und aktive Verhalten, trace_rec_actuators_t */
+#define TRACE_REC_REMOTECALL 'R'	/**< RemoteCall-Aufruf, trace_rec_remotecall_t */
+
+#define TRACE_SENSORS_BPS	1	/**< Flag in trace_rec_sensors_t: bps ist gueltig */
+#define TRACE_REMOTECALL_EXT 1	/**< Flag in trace_rec_remotecall_t: Aufruf kam von aussen (Sim oder Konsole) */
+
+/** Rohe Sensordaten eines Zyklus, wie sie der Sim liefert; genuegen fuer ein Replay */
+typedef struct {
+	int16_t simultime;		/**< Simulationszeit aus CMD_DONE */
+	int16_t enc_l;			/**< sensEncL */
+	int16_t enc_r;			/**< sensEncR */
+	int16_t dist_l;			/**< sensDistL */
+	int16_t dist_r;			/**< sensDistR */
+	uint8_t dist_l_toggle;	/**< sensDistLToggle */
+	uint8_t dist_r_toggle;	/**< sensDistRToggle */
+	int16_t border_l;		/**< sensBorderL */
+	int16_t border_r;		/**< sensBorderR */
+	int16_t line_l;			/**< sensLineL */
+	int16_t line_r;			/**< sensLineR */
+	int16_t ldr_l;			/**< sensLDRL */
+	int16_t ldr_r;			/**< sensLDRR */
+	uint16_t bps;			/**< sensBPS */
+	uint16_t rc5;			/**< empfangener RC5-Code (rc5_ir_data) */
+	uint8_t trans;			/**< sensTrans */
+	uint8_t door;			/**< sensDoor */
+	uint8_t error;			/**< sensError */
+	int8_t mouse_dx;		/**< sensMouseDX */
+	int8_t mouse_dy;		/**< sensMouseDY */
+} PACKED_FORCE trace_rec_input_t;
+
+/** Sensordaten und Position nach dem Verhaltenscode (Textformat: Zeile mit encL=) */
+typedef struct {
+	int32_t time;		/**< Zeit [ms] */
+	int16_t enc_l;		/**< sensEncL */
+	int16_t enc_r;		/**< sensEncR */
+	int16_t dist_l;		/**< sensDistL */
+	int16_t dist_r;		/**< sensDistR */
+	uint16_t rc5;		/**< RC5_Code */
+	uint16_t bps;		/**< sensBPS */
+	uint8_t flags;		/**< TRACE_SENSORS_BPS */
+	float heading;		/**< heading */
+	float x_enc;		/**< x_enc */
+	float y_enc;		/**< y_enc */
+	int16_t x_pos;		/**< x_pos */
+	int16_t y_pos;		/**< y_pos */
+} PACKED_FORCE trace_rec_sensors_t;
+
+/** Aktuatordaten (Textformat: Zeile mit motorL=), danach die Prioritaeten der aktiven Verhalten je als uint8_t */
+typedef struct {
+	int32_t time;		/**< Zeit [ms] */
+	int16_t motor_l;	/**< motor_left */
+	int16_t motor_r;	/**< motor_right */
+} PACKED_FORCE trace_rec_actuators_t;
+
+/** RemoteCall (Textformat: Zeile mit RemoteCall=), danach param_count Parameter je als uint32_t und der Funktionsname ohne 0 */
+typedef struct {
+	int32_t time;			/**< Zeit [ms] */
+	uint8_t flags;			/**< TRACE_REMOTECALL_EXT */
+	uint8_t param_count;	/**< Anzahl der Parameter */
+} PACKED_FORCE trace_rec_remotecall_t;
+
 /**
  * Initialisiert das Trace-System
  */
 void trace_init(void);
 
+/**
+ * Fuegt dem Trace-Puffer die rohen Sensordaten des aktuellen Zyklus hinzu (vor bot_sens())
+ */
+void trace_add_inputs(void);
+
 /**
  * Fuegt dem Trace-Puffer die aktuellen Sensordaten hinzu
  */
@@ -51,9 +128,37 @@ void trace_add_actuators(void);
  * \param *fkt_name		Funktionsname des RemoteCalls
  * \param param_count	Anzahl der RemoteCall-Parameter
  * \param *params		Zeiger auf RemoteCall-Parameterdaten
+ * \param external		1, falls der RemoteCall von aussen (Sim oder Konsole) kommt
  */
-void trace_add_remotecall(const char * fkt_name, uint8_t param_count, remote_call_data_t * params);
+void trace_add_remotecall(const char * fkt_name, uint8_t param_count, remote_call_data_t * params, uint8_t external);
 #endif // BEHAVIOUR_REMOTECALL_AVAILABLE
 
+/**
+ * Wandelt eine binaere Trace-Datei in das Textformat um
+ * \param *from	Name der binaeren Trace-Datei
+ * \param *to	Name der Textdatei
+ * \return		0, falls alles OK; -1 Datei nicht lesbar, -2 keine Trace-Datei, -3 Ausgabe fehlgeschlagen
+ */
+int8_t trace_convert(const char * from, const char * to);
+
+/**
+ * Schaltet auf Replay um: Die Sensordaten kommen danach aus einer binaeren Trace-Datei statt vom Sim
+ * \param *file	Name der binaeren Trace-Datei
+ * \return		0, falls alles OK; -1 Datei nicht lesbar, -2 keine Trace-Datei
+ */
+int8_t trace_replay_open(const char * file);
+
+/**
+ * Prueft, ob ein Replay laeuft
+ * \return	1, falls die Sensordaten aus einer Trace-Datei kommen, sonst 0
+ */
+uint8_t trace_replay_active(void);
+
+/**
+ * Uebernimmt die Sensordaten des naechsten Zyklus aus der Trace-Datei (Ersatz fuer bot_2_sim_listen()).
+ * Am Ende der Datei werden Statistiken ausgegeben und das Programm beendet.
+ */
+void trace_replay_step(void);
+
 #endif // CREATE_TRACEFILE_AVAILABLE
 #endif // TRACE_H_
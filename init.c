@@ -47,6 +47,8 @@
 #include "ir-rc5.h"
 #include "sdfat_fs.h"
 #include "sp03.h"
+#include "trace.h"
+#include "offline-sim.h"
 #include <stdlib.h>
 
 
@@ -70,6 +72,12 @@ void ctbot_init(int argc, char * argv[]) {	// explizit ** int **
 	}
 #endif // ARM_LINUX_BOARD
 #if defined PC && defined BOT_2_SIM_AVAILABLE
+#ifndef ARM_LINUX_BOARD
+	if (! offline_sim_active()) // Offline-Sim braucht keinen Sim
+#endif
+#ifdef CREATE_TRACEFILE_AVAILABLE
+	if (! trace_replay_active()) // Replay braucht keinen Sim
+#endif
 	tcp_init();
 #endif
 #ifdef COMMAND_AVAILABLE
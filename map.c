@@ -47,6 +47,9 @@
 #include "motor.h"
 #include "init.h"
 #include "uart.h"
+#ifdef PC
+#include "cmd_tools.h"
+#endif
 
 #if !defined MMC_AVAILABLE && defined MCU
 #error "Map geht auf dem MCU nicht ohne MMC"
@@ -143,8 +146,20 @@
 #define MAP_FILE_SIZE	((uint16_t) ((uint32_t) ((uint32_t) MAP_SECTION_POINTS * MAP_SECTION_POINTS) * MAP_SECTIONS * MAP_SECTIONS \
 						/ MAP_BLOCK_SIZE)) /**< Dateigroesse der Map in Bloecken */
 #define MAP_ALIGNMENT_MASK	(2UL * MACRO_BLOCK_LENGTH * MACRO_BLOCK_LENGTH / MAP_BLOCK_SIZE - 1) /**< fuer die Ausrichtung der Karte an einer Sektorgrenze zu Optimierungszwecken */
+/**
+ * Kennung exportierter Karten im Sparse-Format ("ctBM"), siehe map_header_t.
+ * Nur map_save_to_file() schreibt dieses Format und nur map_load_from_file() liest es. Die Arbeitsdatei der Karte
+ * (MAP_FILENAME) bleibt eine volle Datei mit MAP_FILE_SIZE Bloecken, weil der Block-Cache (und unter MAP_MMAP_AVAILABLE
+ * das Mapping) jeden Block direkt ueber seine Blocknummer adressiert.
+ */
+#define MAP_SPARSE_MAGIC	0x4d426374UL
 
+#ifdef PC
+static char map_filename[20] = "ctbot.map"; /**< Dateiname der Karte, bei mehreren Bot-Instanzen in einem Prozess mit Instanznummer */
+#define MAP_FILENAME			map_filename /**< Dateiname der Karte */
+#else
 #define MAP_FILENAME			"ctbot.map" /**< Dateiname der Karte */
+#endif
 #define MAP_FILE_ALIGNMENT	(512UL * 1024UL / MAP_BLOCK_SIZE) /**< Alingment der Map-Datei (512 KB) */
 
 int16_t map_min_x = MAP_SIZE * MAP_RESOLUTION / 2; /**< belegter Bereich der Karte [Kartenindex]: kleinste X-Koordinate */
@@ -171,15 +186,59 @@ static os_signal_t lock_signal = OS_SIGNAL_INITIALIZER; /**< Signal zur Synchron
 
 void map_update_main(void) OS_TASK_ATTR;
 
-#define map_buffer GET_MMC_BUFFER(map_buffer)	/**< Map-Puffer */
-static map_section_t* map[2];					/**< Array mit den Zeigern auf die Elemente, es passen immer 2 Sektionen in den Puffer */
+#define map_buffer GET_MMC_BUFFER(map_buffer)	/**< Map-Puffer, enthaelt die Daten aller Bloecke des Block-Caches */
 
-static struct {
-	uint16_t block;		/**< Block, der aktuell im Puffer steht. Nur bis 32 MByte adressierbar */
-	uint8_t updated;		/**< markiert, ob der aktuelle Block gegenueber der MMC-Karte veraendert wurde */
+#define MAP_CACHE_BLOCK_INVALID	0xffff	/**< Kennung fuer einen unbenutzten Eintrag im Block-Cache */
+
+/** Verwaltungsdaten eines Eintrags im Block-Cache */
+typedef struct {
+	uint16_t block;		/**< Block, der in diesem Eintrag steht. Nur bis 32 MByte adressierbar; MAP_CACHE_BLOCK_INVALID, falls unbenutzt */
+	uint8_t updated;	/**< markiert, ob der Block gegenueber der MMC-Karte veraendert wurde */
+#ifdef MAP_2_SIM_AVAILABLE
+	uint8_t sim_pending;	/**< markiert, ob der Block seit der letzten Meldung an den Map-2-Sim-Thread veraendert wurde */
+#endif
 	int16_t x;			/**< X-Koordinate des Blocks */
 	int16_t y;			/**< Y-Koordinate des Blocks */
-} map_current_block = { 0, False, 0, 0 }; /**< Daten des aktuellen Blocks */
+} map_block_cache_t;
+
+static map_block_cache_t map_block_cache[MAP_BLOCK_CACHE_SIZE]; /**< Verwaltungsdaten des Block-Caches, die Daten selbst liegen in map_buffer bzw. in map_mmap */
+static uint8_t map_block_lru[MAP_BLOCK_CACHE_SIZE]; /**< Indizes der Cache-Eintraege, sortiert nach letzter Verwendung ([0]: zuletzt benutzt) */
+static map_block_cache_t* map_current_block = &map_block_cache[0]; /**< zuletzt benutzter Eintrag des Block-Caches */
+
+#ifdef MAP_CACHE_STATS_AVAILABLE
+map_cache_stats_t map_cache_stats; /**< Statistikdaten des Block-Caches */
+#define MAP_CACHE_STAT_INC(x) ++map_cache_stats.x /**< Erhoeht einen Zaehler der Cache-Statistik */
+#else
+#define MAP_CACHE_STAT_INC(x) /**< Dummy ohne Cache-Statistik */
+#endif // MAP_CACHE_STATS_AVAILABLE
+
+#ifdef MAP_MMAP_AVAILABLE
+static uint8_t* map_mmap = NULL; /**< eingeblendete Kartendatei (Header und Daten) oder NULL, falls ueber sdfat_read() / sdfat_write() zugegriffen wird */
+static uint32_t map_mmap_size; /**< Groesse der eingeblendeten Kartendatei in Byte */
+#endif // MAP_MMAP_AVAILABLE
+
+#ifdef MAP_CHANGE_HANDLER_AVAILABLE
+static map_change_handler_t map_change_handler = NULL; /**< Handler fuer veraenderte Kartenbereiche */
+/** Rechteck der im aktuellen Update-Durchlauf veraenderten Felder [Kartenindex], leer falls min_x > max_x */
+static struct {
+	int16_t min_x;
+	int16_t min_y;
+	int16_t max_x;
+	int16_t max_y;
+} map_changed = { INT16_MAX, INT16_MAX, INT16_MIN, INT16_MIN };
+#endif // MAP_CHANGE_HANDLER_AVAILABLE
+
+#ifdef MAP_SUMMARY_AVAILABLE
+/** Zusammenfassung der Feldwerte eines Kartenbereichs */
+typedef struct {
+	int8_t min;		/**< kleinster Feldwert des Bereichs */
+	int8_t max;		/**< groesster Feldwert des Bereichs */
+	uint8_t stale;	/**< True, falls sich Felder seit der letzten Berechnung geaendert haben */
+} map_summary_t;
+
+static map_summary_t map_summary_sections[MAP_SECTIONS][MAP_SECTIONS]; /**< Zusammenfassung je Section ([x][y]) */
+static map_summary_t map_summary_macroblocks[MAP_LENGTH_IN_MACRO_BLOCKS][MAP_LENGTH_IN_MACRO_BLOCKS]; /**< Zusammenfassung je Makroblock ([x][y]) */
+#endif // MAP_SUMMARY_AVAILABLE
 
 static uint8_t init_state = 0; /**< Status der Initialisierung (0 (nicht initialisiert), 1 (alles OK)) */
 
@@ -205,6 +264,27 @@ uint8_t map_2_sim_worker_stack[MAP_2_SIM_STACK_SIZE]; /**< Stack des Map-2-Sim-T
 static pFatFile map_2_sim_file_desc; /**< File-Deskriptor fuer Map-2-Sim */
 static uint8_t map_2_sim_buffer[512]; /**< Puffer fuer zur Map-2-Sim-Kommunikation */
 static os_signal_t map_2_sim_signal = OS_SIGNAL_INITIALIZER; /**< Signal, um gleichzeitiges Senden von Map-Daten zu verhindern */
+
+#ifdef MAP_2_SIM_DELTA_AVAILABLE
+#if MAP_2_SIM_SHADOW_SIZE < 1 || MAP_2_SIM_SHADOW_SIZE > 255
+#error "MAP_2_SIM_SHADOW_SIZE muss zwischen 1 und 255 liegen"
+#endif
+#define MAP_2_SIM_FRAME_SIZE	128	/**< maximale Payload eines Map-Kommandos [Byte] */
+#define MAP_2_SIM_DELTA_HEADER	6	/**< Bot-Position und -Ausrichtung am Anfang jedes Delta-Kommandos [Byte] */
+
+static uint8_t map_2_sim_shadow[MAP_2_SIM_SHADOW_SIZE][MAP_BLOCK_SIZE]; /**< Version der Bloecke, die der Sim zuletzt erhalten hat */
+static uint16_t map_2_sim_shadow_block[MAP_2_SIM_SHADOW_SIZE]; /**< Bloecke in map_2_sim_shadow, MAP_CACHE_BLOCK_INVALID falls unbenutzt */
+static uint8_t map_2_sim_shadow_lru[MAP_2_SIM_SHADOW_SIZE]; /**< Indizes fuer map_2_sim_shadow, sortiert nach letzter Verwendung ([0]: zuletzt benutzt) */
+static volatile uint8_t map_2_sim_shadow_reset = True; /**< True, falls der Sim die komplette Karte neu erhalten hat und alle Deltas ungueltig sind */
+static uint8_t map_2_sim_frame[MAP_2_SIM_FRAME_SIZE]; /**< Puffer fuer ein Delta-Kommando */
+
+/** Statistikdaten der Map-2-Sim-Uebertragung */
+static struct {
+	uint32_t full;	/**< Anzahl der komplett gesendeten Bloecke */
+	uint32_t delta;	/**< Anzahl der als Delta gesendeten Bloecke */
+	uint32_t bytes;	/**< gesendete Payload [Byte] */
+} map_2_sim_stats;
+#endif // MAP_2_SIM_DELTA_AVAILABLE
 #endif // MAP_2_SIM_AVAILABLE
 
 #ifdef PC
@@ -212,6 +292,54 @@ char* map_file = "sim.map"; /**< Dateiname fuer Ex- / Import */
 #endif // PC
 
 
+#ifdef MAP_SUMMARY_AVAILABLE
+/**
+ * Markiert alle Zusammenfassungen als veraltet, sie werden bei Bedarf neu berechnet
+ */
+static void summary_reset(void) {
+	map_summary_t* p_summary = &map_summary_sections[0][0];
+	uint16_t i;
+	for (i = 0; i < MAP_SECTIONS * MAP_SECTIONS; ++i, ++p_summary) {
+		p_summary->min = -128;
+		p_summary->max = 127;
+		p_summary->stale = True;
+	}
+	p_summary = &map_summary_macroblocks[0][0];
+	for (i = 0; i < MAP_LENGTH_IN_MACRO_BLOCKS * MAP_LENGTH_IN_MACRO_BLOCKS; ++i, ++p_summary) {
+		p_summary->min = -128;
+		p_summary->max = 127;
+		p_summary->stale = True;
+	}
+}
+
+/**
+ * Markiert die Zusammenfassungen von Section und Makroblock eines Feldes als veraltet
+ * \param x	X-Ordinate der Karte (gueltig)
+ * \param y	Y-Ordinate der Karte (gueltig)
+ */
+static inline void summary_invalidate(int16_t x, int16_t y) {
+	map_summary_sections[(uint16_t) x / MAP_SECTION_POINTS][(uint16_t) y / MAP_SECTION_POINTS].stale = True;
+	map_summary_macroblocks[(uint16_t) x / MACRO_BLOCK_LENGTH][(uint16_t) y / MACRO_BLOCK_LENGTH].stale = True;
+}
+
+/**
+ * Prueft, ob alle oder keine Werte eines Bereichs zwischen min_val und max_val liegen
+ * \param *p_summary	Zeiger auf die Zusammenfassung des Bereichs
+ * \param min_val		minimaler Feldwert
+ * \param max_val		maximaler Feldwert
+ * \return				1: alle Felder liegen im Intervall, 0: keines, -1: unbekannt
+ */
+static inline int8_t summary_test(const map_summary_t* p_summary, int8_t min_val, int8_t max_val) {
+	if (p_summary->min >= min_val && p_summary->max <= max_val) {
+		return 1;
+	}
+	if (p_summary->max < min_val || p_summary->min > max_val) {
+		return 0;
+	}
+	return -1;
+}
+#endif // MAP_SUMMARY_AVAILABLE
+
 static uint16_t get_block(int16_t x, int16_t y) {
 	/* Sicherheitscheck */
 	if (((uint16_t) x >= (uint16_t) (MAP_SIZE * MAP_RESOLUTION)) || ((uint16_t) y >= (uint16_t) (MAP_SIZE * MAP_RESOLUTION))) {
@@ -248,6 +376,239 @@ static uint16_t get_block(int16_t x, int16_t y) {
 	return block;
 }
 
+/**
+ * Liefert die Daten eines Eintrags im Block-Cache. Ist die Kartendatei eingeblendet,
+ * liegen diese direkt im Mapping, sonst im Puffer des Eintrags.
+ * \param *p_entry	Zeiger auf den Cache-Eintrag
+ * \return			Zeiger auf die MAP_BLOCK_SIZE Byte Daten des Eintrags
+ */
+static inline uint8_t* get_block_data(const map_block_cache_t* p_entry) {
+#ifdef MAP_MMAP_AVAILABLE
+	if (map_mmap) {
+		return &map_mmap[(uint32_t) (p_entry->block + alignment_offset) * MAP_BLOCK_SIZE + sizeof(map_header_t)];
+	}
+#endif // MAP_MMAP_AVAILABLE
+	return &map_buffer[(uint16_t) (p_entry - map_block_cache) * MAP_BLOCK_SIZE];
+}
+
+/**
+ * Markiert alle Eintraege des Block-Caches als unbenutzt, veraenderte Daten werden verworfen
+ */
+static void invalidate_cache(void) {
+	uint8_t i;
+	for (i = 0; i < MAP_BLOCK_CACHE_SIZE; ++i) {
+		map_block_cache[i].block = MAP_CACHE_BLOCK_INVALID;
+		map_block_cache[i].updated = False;
+#ifdef MAP_2_SIM_AVAILABLE
+		map_block_cache[i].sim_pending = False;
+#endif
+		map_block_lru[i] = i;
+	}
+	map_current_block = &map_block_cache[0];
+}
+
+/**
+ * Markiert den zuletzt benutzten Block des Caches als veraendert
+ */
+static inline void current_block_updated(void) {
+	map_current_block->updated = True;
+#ifdef MAP_2_SIM_AVAILABLE
+	map_current_block->sim_pending = True;
+#endif
+}
+
+#ifdef MAP_2_SIM_AVAILABLE
+/**
+ * Meldet einen Block des Caches an den Map-2-Sim-Thread, falls er seit der letzten Meldung veraendert wurde.
+ * Der Thread liest die Daten selbst ueber den Cache, der Block muss dafuer nicht zurueckgeschrieben werden.
+ * \param *p_entry	Zeiger auf den Cache-Eintrag
+ */
+static void map_2_sim_notify(map_block_cache_t* p_entry) {
+	if (p_entry->sim_pending != True) {
+		return;
+	}
+
+	map_2_sim_data.pos.x = world_to_map(x_pos);
+	map_2_sim_data.pos.y = world_to_map(y_pos);
+	map_2_sim_data.heading = heading_int;
+#ifdef MEASURE_POSITION_ERRORS_AVAILABLE
+	map_2_sim_data.error = pos_error_radius / (1000 / MAP_RESOLUTION) + (BOT_DIAMETER / 2 / (1000 / MAP_RESOLUTION));
+#endif
+	if (fifo_put_data(&map_2_sim_fifo, &p_entry->block, sizeof(p_entry->block), True) == 0) {
+		p_entry->sim_pending = False; // sonst beim naechsten Durchlauf erneut versuchen
+	}
+}
+#endif // MAP_2_SIM_AVAILABLE
+
+/**
+ * Schreibt einen Block des Caches auf die MMC-Karte zurueck, falls er veraendert wurde
+ * \param *p_entry	Zeiger auf den Cache-Eintrag
+ * \return			0 falls kein Fehler, sonst Fehlercode
+ */
+static uint8_t write_back_block(map_block_cache_t* p_entry) {
+	if (p_entry->updated != True) {
+		return 0;
+	}
+	p_entry->updated = False;
+#ifdef MAP_2_SIM_AVAILABLE
+	/* ausstehende Aenderungen vor dem Zurueckschreiben melden, der Thread liest den Block erst nach Freigabe der Sperre */
+	map_2_sim_notify(p_entry);
+#endif
+
+	/* Shrinking */
+	if (p_entry->x < map_min_x) {
+		map_min_x = p_entry->x;
+		min_max_updated = True;
+	} else if (p_entry->x > map_max_x) {
+		map_max_x = p_entry->x + ((MAP_SECTION_POINTS * 2) - 1);
+		min_max_updated = True;
+	}
+	if (p_entry->y < map_min_y) {
+		map_min_y = p_entry->y;
+		min_max_updated = True;
+	} else if (p_entry->y > map_max_y) {
+		map_max_y = p_entry->y + (MAP_SECTION_POINTS - 1);
+		min_max_updated = True;
+	}
+
+#ifdef DEBUG_MAP_TIMES
+	LOG_INFO("writing block 0%x", p_entry->block + alignment_offset);
+	uint16_t start_ticks = TIMER_GET_TICKCOUNT_16;
+#endif
+#ifdef MAP_MMAP_AVAILABLE
+	/* eingeblendete Daten stehen bereits in der Datei */
+	if (! map_mmap)
+#endif
+	{
+		if (sdfat_seek(map_file_desc, (int32_t) ((p_entry->block + alignment_offset) * MAP_BLOCK_SIZE) + sizeof(map_header_t), SEEK_SET)) {
+			LOG_DEBUG("map::write_back_block(): sdfat_seek(0x%x) failed", p_entry->block + alignment_offset);
+			return 1;
+		}
+		if (sdfat_write(map_file_desc, get_block_data(p_entry), MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
+			LOG_DEBUG("map::write_back_block(): sdfat_write(0x%x) failed", p_entry->block + alignment_offset);
+			return 2;
+		}
+	}
+	MAP_CACHE_STAT_INC(writebacks);
+
+#ifdef DEBUG_MAP_TIMES
+	uint16_t end_ticks = TIMER_GET_TICKCOUNT_16;
+	LOG_INFO("swapout took %u ms", (end_ticks - start_ticks) * 176 / 1000);
+	(void) start_ticks;
+	(void) end_ticks;
+#endif
+	return 0;
+}
+
+/**
+ * Schreibt alle veraenderten Bloecke des Caches in aufsteigender Blockreihenfolge zurueck,
+ * damit die MMC-Karte moeglichst sequentiell beschrieben wird
+ * \return	Anzahl der zurueckgeschriebenen Bloecke
+ */
+static uint8_t write_back_cache(void) {
+	uint8_t count = 0;
+	while (1) {
+		map_block_cache_t* p_next = NULL;
+		uint8_t i;
+		for (i = 0; i < MAP_BLOCK_CACHE_SIZE; ++i) {
+			map_block_cache_t* p_entry = &map_block_cache[i];
+			if (p_entry->updated == True && (p_next == NULL || p_entry->block < p_next->block)) {
+				p_next = p_entry;
+			}
+		}
+		if (p_next == NULL) {
+			return count;
+		}
+		write_back_block(p_next); // setzt updated zurueck, auch im Fehlerfall
+		++count;
+	}
+}
+
+/**
+ * Schreibt die Min- / Max-Werte in den Header der Map-Datei
+ * \return 0 falls kein Fehler, sonst Fehlercode
+ */
+static uint8_t write_header(void) {
+	/* entspricht dem Anfang von map_header_t, der Rest des Headers bleibt unveraendert */
+	struct {
+		uint16_t alignment_offset;
+		int16_t map_min_x;
+		int16_t map_max_x;
+		int16_t map_min_y;
+		int16_t map_max_y;
+	} PACKED_FORCE head = { alignment_offset, map_min_x, map_max_x, map_min_y, map_max_y };
+
+#ifdef MAP_MMAP_AVAILABLE
+	if (map_mmap) {
+		memcpy(map_mmap, &head, sizeof(head));
+		return 0;
+	}
+#endif // MAP_MMAP_AVAILABLE
+	sdfat_rewind(map_file_desc);
+	if (sdfat_write(map_file_desc, &head, sizeof(head)) != sizeof(head)) {
+		LOG_DEBUG("map::write_header(): sdfat_write(head) failed");
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * Setzt alle Bloecke, die den belegten Bereich der Karte ueberdecken, in der Map-Datei auf 0.
+ * Die Bloecke werden in Speicherreihenfolge geschrieben, gesucht wird nur zwischen nicht
+ * aufeinanderfolgenden Bloecken. Der Block-Cache wird nicht benutzt, map_buffer wird ueberschrieben.
+ * \return 0 falls kein Fehler, sonst Fehlercode
+ */
+static uint8_t clear_used_blocks(void) {
+	memset(map_buffer, 0, MAP_BLOCK_SIZE);
+	uint16_t next = MAP_CACHE_BLOCK_INVALID;
+	int16_t x, y;
+	for (y = map_min_y & ~(MAP_SECTION_POINTS - 1); y <= map_max_y; y += MAP_SECTION_POINTS) {
+		for (x = map_min_x & ~(MAP_SECTION_POINTS * 2 - 1); x <= map_max_x; x += MAP_SECTION_POINTS * 2) {
+			const uint16_t block = get_block(x, y);
+			if (block == 0xffff) {
+				return 1;
+			}
+			if (block != next && sdfat_seek(map_file_desc, (int32_t) ((block + alignment_offset) * MAP_BLOCK_SIZE) + sizeof(map_header_t), SEEK_SET)) {
+				LOG_DEBUG("map::clear_used_blocks(): sdfat_seek(0x%x) failed", block + alignment_offset);
+				return 2;
+			}
+			if (sdfat_write(map_file_desc, map_buffer, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
+				LOG_DEBUG("map::clear_used_blocks(): sdfat_write(0x%x) failed", block + alignment_offset);
+				return 3;
+			}
+			next = block + 1;
+		}
+	}
+	return 0;
+}
+
+#ifdef MAP_MMAP_AVAILABLE
+/**
+ * Blendet die Kartendatei ein, Bloecke muessen dann nicht mehr kopiert werden
+ */
+static void mmap_open(void) {
+	map_mmap_size = (uint32_t) (MAP_FILE_SIZE + alignment_offset) * MAP_BLOCK_SIZE + sizeof(map_header_t);
+	map_mmap = sdfat_mmap(map_file_desc, map_mmap_size);
+	if (! map_mmap) {
+		LOG_ERROR("map::mmap_open(): sdfat_mmap() failed, verwende sdfat_read() / sdfat_write()");
+	}
+}
+
+/**
+ * Hebt die Einblendung der Kartendatei auf, danach wird ueber sdfat_read() / sdfat_write() zugegriffen.
+ * Veraenderte Bloecke muessen vorher zurueckgeschrieben sein, der Block-Cache wird geleert.
+ */
+static void mmap_close(void) {
+	if (map_mmap) {
+		if (sdfat_munmap(map_mmap, map_mmap_size)) {
+			LOG_ERROR("map::mmap_close(): sdfat_munmap() failed");
+		}
+		map_mmap = NULL;
+		invalidate_cache();
+	}
+}
+#endif // MAP_MMAP_AVAILABLE
+
 /**
  * Initialisiert die Karte
  * \param clean_map True: Karte wird geloescht, False: Karte bleibt erhalten
@@ -269,12 +630,18 @@ static int8_t init(uint8_t clean_map) {
 	display_cursor(3, 1);
 	display_printf("initialisiert.");
 
-	// Die Karte auf den Puffer biegen
-	map[0] = (map_section_t*) map_buffer;
-	map[1] = (map_section_t*) (map_buffer + sizeof(map_section_t));
-
-	map_current_block.updated = 0xff; // Die MMC-Karte ist erstmal nicht verfuegbar
+	/* Block-Cache leeren, die MMC-Karte ist erstmal nicht verfuegbar */
+	invalidate_cache();
+#ifdef MAP_MMAP_AVAILABLE
+	/* Einblendung eines frueheren Versuchs aufheben, die Datei wird neu geoeffnet */
+	mmap_close();
+#endif
 
+#ifdef PC
+	if (ctbot_instance) {
+		snprintf(map_filename, sizeof(map_filename), "ctbot-%u.map", ctbot_instance);
+	}
+#endif
 	LOG_DEBUG("map::init(): sdfat_open(\"%s\")...", MAP_FILENAME);
 
 	const uint8_t mode = SDFAT_O_RDWR | SDFAT_O_CREAT;
@@ -297,6 +664,7 @@ static int8_t init(uint8_t clean_map) {
 	LOG_INFO("map::init(): map_offset=0x%x%04x byte", (uint16_t) (map_offset >> 16), (uint16_t) map_offset);
 
 	map_header_t* p_head_data = (map_header_t*) map_buffer;
+	memset(p_head_data, 0, sizeof(map_header_t));
 	/* Min- / Max-Werte initialisieren */
 	p_head_data->map_min_x = 0;
 	p_head_data->map_max_x = MAP_SIZE * MAP_RESOLUTION - 1;
@@ -304,7 +672,8 @@ static int8_t init(uint8_t clean_map) {
 	p_head_data->map_max_y = MAP_SIZE * MAP_RESOLUTION - 1;
 	p_head_data->alignment_offset = alignment_offset;
 
-	if (sdfat_get_filesize(map_file_desc) < ((uint32_t) (MAP_FILE_SIZE + alignment_offset) * MAP_BLOCK_SIZE + sizeof(map_header_t))) {
+	const uint8_t new_file = sdfat_get_filesize(map_file_desc) < ((uint32_t) (MAP_FILE_SIZE + alignment_offset) * MAP_BLOCK_SIZE + sizeof(map_header_t));
+	if (new_file) {
 		LOG_DEBUG("map::init(): Datei zu klein, neu initialisieren");
 		clean_map = True;
 	} else {
@@ -334,6 +703,8 @@ static int8_t init(uint8_t clean_map) {
 		p_head_data->map_min_y = MAP_SIZE * MAP_RESOLUTION / 2;
 		p_head_data->map_max_y = MAP_SIZE * MAP_RESOLUTION / 2;
 		p_head_data->alignment_offset = alignment_offset;
+		p_head_data->magic = 0;
+		p_head_data->blocks = 0;
 
 		sdfat_rewind(map_file_desc);
 		if (sdfat_write(map_file_desc, map_buffer, sizeof(map_header_t)) != sizeof(map_header_t)) {
@@ -341,22 +712,28 @@ static int8_t init(uint8_t clean_map) {
 			return 6;
 		}
 
-		memset(map_buffer, 0, MAP_BLOCK_SIZE);
-		const uint16_t min_block = sdfat_get_filesize(map_file_desc) / MAP_BLOCK_SIZE < alignment_offset ? 0 : get_block(map_min_x, map_min_y) + alignment_offset;
-		const uint16_t max_block = get_block(map_max_x, map_max_y) + alignment_offset;
-		LOG_DEBUG("map::init(): min_block=%u max_block=%u", min_block, max_block);
+		if (new_file) {
+			/* Datei auf volle Groesse bringen */
+			memset(map_buffer, 0, MAP_BLOCK_SIZE);
+			const uint16_t min_block = sdfat_get_filesize(map_file_desc) / MAP_BLOCK_SIZE < alignment_offset ? 0 : get_block(map_min_x, map_min_y) + alignment_offset;
+			const uint16_t max_block = get_block(map_max_x, map_max_y) + alignment_offset;
+			LOG_DEBUG("map::init(): min_block=%u max_block=%u", min_block, max_block);
 
-		if (sdfat_seek(map_file_desc, (int32_t) (min_block * MAP_BLOCK_SIZE) + sizeof(map_header_t), SEEK_SET)) {
-			LOG_DEBUG("map::init(): sdfat_seek(0x%ld) failed", min_block * MAP_BLOCK_SIZE);
-			return 7;
-		}
+			if (sdfat_seek(map_file_desc, (int32_t) (min_block * MAP_BLOCK_SIZE) + sizeof(map_header_t), SEEK_SET)) {
+				LOG_DEBUG("map::init(): sdfat_seek(0x%ld) failed", min_block * MAP_BLOCK_SIZE);
+				return 7;
+			}
 
-		uint16_t i;
-		for (i = min_block; i <= max_block; ++i) {
-			if (sdfat_write(map_file_desc, map_buffer, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
-				LOG_DEBUG("map::init(): sdfat_write(0x%x) failed", i);
-				return 8;
+			uint16_t i;
+			for (i = min_block; i <= max_block; ++i) {
+				if (sdfat_write(map_file_desc, map_buffer, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
+					LOG_DEBUG("map::init(): sdfat_write(0x%x) failed", i);
+					return 8;
+				}
 			}
+		} else if (clear_used_blocks()) {
+			/* ausserhalb des belegten Bereichs ist die Karte bereits leer */
+			return 8;
 		}
 
 		p_head_data->map_min_x = MAP_SIZE * MAP_RESOLUTION / 2;
@@ -375,6 +752,10 @@ static int8_t init(uint8_t clean_map) {
 	LOG_DEBUG("map::init(): map_min_x=0x%x, map_max_x=0x%x, map_min_y=0x%x, map_max_y=0x%x\n", map_min_x, map_max_x, map_min_y, map_max_y);
 #endif
 
+#ifdef MAP_MMAP_AVAILABLE
+	mmap_open();
+#endif // MAP_MMAP_AVAILABLE
+
 #ifdef MAP_2_SIM_AVAILABLE
 	if (sdfat_open(MAP_FILENAME, &map_2_sim_file_desc, SDFAT_O_READ)) {
 		LOG_DEBUG("map::init(): Mapdatei konnte nicht fuer Map-2-Sim geoeffnet werden");
@@ -382,22 +763,11 @@ static int8_t init(uint8_t clean_map) {
 	}
 #endif // MAP_2_SIM_AVAILABLE
 
-	map_current_block.updated = False;
-	map_current_block.block = 0;
-
-	if (clean_map) {
-		memset(map_buffer, 0, sizeof(map_buffer));
-	} else {
-		/* Block 0 laden */
-		if (sdfat_seek(map_file_desc, (int32_t) ((map_current_block.block + alignment_offset) * MAP_BLOCK_SIZE) + sizeof(map_header_t), SEEK_SET)) {
-			LOG_DEBUG("map::init(): sdfat_seek(0x%x) failed", map_current_block.block + alignment_offset);
-			return 10;
-		}
-		if (sdfat_read(map_file_desc, map_buffer, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
-			LOG_DEBUG("map::init(): sdfat_read(0x%x) failed", map_current_block.block + alignment_offset);
-			return 11;
-		}
-	}
+	/* map_buffer wurde als Zwischenspeicher benutzt, Bloecke werden bei Bedarf neu geladen */
+	invalidate_cache();
+#ifdef MAP_SUMMARY_AVAILABLE
+	summary_reset();
+#endif
 
 	/* Thread-Setup */
 	if (init_state == 0) {
@@ -440,7 +810,8 @@ int8_t map_init(void) {
 }
 
 /**
- * Haelt den Bot an und schreibt den Map-Update-Cache komplett zurueck
+ * Haelt den Bot an, wartet auf das Ende des laufenden Map-Updates und schreibt alle
+ * veraenderten Bloecke des Block-Caches gesammelt zurueck
  */
 void map_flush_cache(void) {
 #ifdef MCU
@@ -450,35 +821,42 @@ void map_flush_cache(void) {
 #endif // MCU
 	/* Warten, bis Update fertig */
 	os_signal_set(&lock_signal);
-	/* Sperre sofort wieder freigeben */
 	os_signal_release(&lock_signal);
+	os_signal_lock(&lock_signal);
 
-	sdfat_rewind(map_file_desc);
-	if (sdfat_read(map_file_desc, map_buffer, sizeof(map_header_t)) != sizeof(map_header_t)) {
-		LOG_ERROR("map_flush_cache(): sdfat_read(head) failed");
-		return;
-	}
-
-	map_header_t* p_head_data = (map_header_t*) map_buffer;
-	p_head_data->map_min_x = map_min_x;
-	p_head_data->map_max_x = map_max_x;
-	p_head_data->map_min_y = map_min_y;
-	p_head_data->map_max_y = map_max_y;
+	uint8_t written = write_back_cache();
 
-	sdfat_rewind(map_file_desc);
-	if (sdfat_write(map_file_desc, p_head_data, sizeof(map_header_t)) != sizeof(map_header_t)) {
-		LOG_ERROR("map_flush_cache(): sdfat_write(head) failed");
+	if (min_max_updated == True) {
+		min_max_updated = False;
+		++written;
+		if (write_header()) {
+			LOG_ERROR("map_flush_cache(): write_header() failed");
+		}
 	}
 
-	if (sdfat_seek(map_file_desc, (int32_t) ((map_current_block.block + alignment_offset) * MAP_BLOCK_SIZE) + sizeof(map_header_t), SEEK_SET)) {
-		LOG_ERROR("map_flush_cache(): sdfat_seek(0x%x) failed", map_current_block.block + alignment_offset);
-		return;
-	}
-	if (sdfat_read(map_file_desc, map_buffer, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
-		LOG_ERROR("map_flush_cache(): sdfat_read(0x%x) failed", map_current_block.block + alignment_offset);
+	sdfat_flush(map_file_desc);
+#ifdef MAP_MMAP_AVAILABLE
+	/* nur, wenn sich etwas geaendert hat; Leser sehen die Daten im Mapping ohnehin */
+	if (map_mmap && written) {
+		sdfat_msync(map_mmap, map_mmap_size);
 	}
+#else
+	(void) written;
+#endif // MAP_MMAP_AVAILABLE
 
-	sdfat_flush(map_file_desc);
+	os_signal_unlock(&lock_signal);
+}
+
+/**
+ * Schreibt alle veraenderten Bloecke zurueck und hebt die Einblendung der Kartendatei auf (beim Herunterfahren)
+ */
+void map_close(void) {
+	map_flush_cache();
+#ifdef MAP_MMAP_AVAILABLE
+	os_signal_lock(&lock_signal);
+	mmap_close();
+	os_signal_unlock(&lock_signal);
+#endif // MAP_MMAP_AVAILABLE
 }
 
 /**
@@ -513,7 +891,8 @@ int16_t world_to_map(int16_t koord) {
 
 /**
  * Liefert einen Zeiger auf die Section zurueck, in der der Punkt liegt.
- * Auf dem MCU kuemmert sie sich darum, die entsprechende Karte aus der MMC-Karte zu laden
+ * Kuemmert sich darum, den entsprechenden Block aus der MMC-Karte in den Block-Cache zu laden und
+ * verdraengt dafuer bei Bedarf den am laengsten nicht benutzten Block.
  * \param x	X-Ordinate der Karte (nicht der Welt!!!)
  * \param y	Y-Ordinate der Karte (nicht der Welt!!!)
  * \return	Zeiger auf die Section
@@ -528,87 +907,79 @@ static map_section_t* get_section(int16_t x, int16_t y) {
 	const uint8_t index = (uint8_t) ((x / MAP_SECTION_POINTS) & 0x1);
 
 	/* Ist der Block schon geladen? */
-	if (map_current_block.block == block) {
+	if (map_current_block->block == block) {
 #ifdef DEBUG_STORAGE
 		LOG_DEBUG("ist noch im Puffer");
 #endif
-		return map[index];
+		MAP_CACHE_STAT_INC(hits);
+		return (map_section_t*) (get_block_data(map_current_block) + index * sizeof(map_section_t));
 	}
 
-	/* Block ist also nicht im Puffer */
+	uint8_t i;
+	for (i = 1; i < MAP_BLOCK_CACHE_SIZE; ++i) {
+		const uint8_t n = map_block_lru[i];
+		if (map_block_cache[n].block == block) {
 #ifdef DEBUG_STORAGE
-	LOG_DEBUG("ist nicht im Puffer");
+			LOG_DEBUG("ist im Cache");
 #endif
-
-	/* Wurde der Block im RAM veraendert? */
-	if (map_current_block.updated == True) {
-		/* Shrinking */
-		if (map_current_block.x < map_min_x) {
-			map_min_x = map_current_block.x;
-			min_max_updated = True;
-		} else if (map_current_block.x > map_max_x) {
-			map_max_x = map_current_block.x + ((MAP_SECTION_POINTS * 2) - 1);
-			min_max_updated = True;
-		}
-		if (map_current_block.y < map_min_y) {
-			map_min_y = map_current_block.y;
-			min_max_updated = True;
-		} else if (map_current_block.y > map_max_y) {
-			map_max_y = map_current_block.y + (MAP_SECTION_POINTS - 1);
-			min_max_updated = True;
+			/* Eintrag an den Anfang der LRU-Liste setzen */
+			memmove(&map_block_lru[1], &map_block_lru[0], i);
+			map_block_lru[0] = n;
+			map_current_block = &map_block_cache[n];
+			MAP_CACHE_STAT_INC(hits);
+			return (map_section_t*) (get_block_data(map_current_block) + index * sizeof(map_section_t));
 		}
+	}
 
-		/* Dann erstmal sichern */
-#ifdef DEBUG_MAP_TIMES
-		LOG_INFO("writing block 0%x", map_current_block.block + alignment_offset);
-		uint16_t start_ticks = TIMER_GET_TICKCOUNT_16;
+	/* Block ist also nicht im Cache, den am laengsten nicht benutzten Eintrag ersetzen */
+#ifdef DEBUG_STORAGE
+	LOG_DEBUG("ist nicht im Puffer");
 #endif
-		if (sdfat_seek(map_file_desc, (int32_t) ((map_current_block.block + alignment_offset) * MAP_BLOCK_SIZE) + sizeof(map_header_t), SEEK_SET)) {
-			LOG_DEBUG("map::get_section(): sdfat_seek(0x%x) failed", map_current_block.block + alignment_offset);
-			map_current_block.updated = False;
-			return NULL;
-		}
-		if (sdfat_write(map_file_desc, map_buffer, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
-			LOG_DEBUG("map::get_section(): sdfat_write(0x%x) failed", map_current_block.block + alignment_offset);
-			map_current_block.updated = False;
+	MAP_CACHE_STAT_INC(misses);
+	const uint8_t victim = map_block_lru[MAP_BLOCK_CACHE_SIZE - 1];
+	memmove(&map_block_lru[1], &map_block_lru[0], MAP_BLOCK_CACHE_SIZE - 1);
+	map_block_lru[0] = victim;
+	map_current_block = &map_block_cache[victim];
+
+	if (map_current_block->block != MAP_CACHE_BLOCK_INVALID) {
+		MAP_CACHE_STAT_INC(evictions);
+		/* Wurde der Block im RAM veraendert? Dann erstmal sichern */
+		if (write_back_block(map_current_block)) {
+			map_current_block->block = MAP_CACHE_BLOCK_INVALID;
 			return NULL;
 		}
+	}
 
+	/* Statusvariablen anpassen */
+	map_current_block->block = block;
+	map_current_block->x = x & ~((MAP_SECTION_POINTS * 2) - 1); // 32 Einheiten in X-Richtung und
+	map_current_block->y = y & ~(MAP_SECTION_POINTS - 1); // 16 Einheiten in Y-Richtung pro Block
+	map_current_block->updated = False;
 #ifdef MAP_2_SIM_AVAILABLE
-		map_2_sim_data.pos.x = world_to_map(x_pos);
-		map_2_sim_data.pos.y = world_to_map(y_pos);
-		map_2_sim_data.heading = heading_int;
-#ifdef MEASURE_POSITION_ERRORS_AVAILABLE
-		map_2_sim_data.error = pos_error_radius / (1000 / MAP_RESOLUTION) + (BOT_DIAMETER / 2 / (1000 / MAP_RESOLUTION));
+	map_current_block->sim_pending = False;
 #endif
-		fifo_put_data(&map_2_sim_fifo, &map_current_block.block, sizeof(map_current_block.block), True);
-#endif // MAP_2_SIM_AVAILABLE
 
-#ifdef DEBUG_MAP_TIMES
-		uint16_t end_ticks = TIMER_GET_TICKCOUNT_16;
-		LOG_INFO("swapout took %u ms", (end_ticks - start_ticks) * 176 / 1000);
-		(void) start_ticks;
-		(void) end_ticks;
-#endif
+#ifdef MAP_MMAP_AVAILABLE
+	if (map_mmap) {
+		/* Block liegt im Mapping, nichts zu laden */
+		return (map_section_t*) (get_block_data(map_current_block) + index * sizeof(map_section_t));
 	}
-
-	/* Statusvariablen anpassen */
-	map_current_block.block = block;
-	map_current_block.x = x & ~((MAP_SECTION_POINTS * 2) - 1); // 32 Einheiten in X-Richtung und
-	map_current_block.y = y & ~(MAP_SECTION_POINTS - 1); // 16 Einheiten in Y-Richtung pro Block
-	map_current_block.updated = False;
+#endif // MAP_MMAP_AVAILABLE
 
 	/* Lade den neuen Block */
 #ifdef DEBUG_MAP_TIMES
 	LOG_INFO("reading block 0x%x", block + alignment_offset);
 	uint16_t start_ticks = TIMER_GET_TICKCOUNT_16;
 #endif
+	uint8_t* p_buffer = get_block_data(map_current_block);
 	if (sdfat_seek(map_file_desc, (int32_t) ((block + alignment_offset) * MAP_BLOCK_SIZE) + sizeof(map_header_t), SEEK_SET)) {
 		LOG_DEBUG("map::get_section(): sdfat_seek(0x%x) failed", block + alignment_offset);
+		map_current_block->block = MAP_CACHE_BLOCK_INVALID;
 		return NULL;
 	}
-	if (sdfat_read(map_file_desc, map_buffer, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
+	if (sdfat_read(map_file_desc, p_buffer, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
 		LOG_DEBUG("map::get_section(): sdfat_read(0x%x) failed", block + alignment_offset);
+		map_current_block->block = MAP_CACHE_BLOCK_INVALID;
 		return NULL;
 	}
 #ifdef DEBUG_MAP_TIMES
@@ -618,7 +989,7 @@ static map_section_t* get_section(int16_t x, int16_t y) {
 	(void) end_ticks;
 #endif
 
-	return map[index];
+	return (map_section_t*) (p_buffer + index * sizeof(map_section_t));
 }
 
 /**
@@ -652,12 +1023,183 @@ static int8_t access_field(int16_t x, int16_t y, int8_t value, uint8_t set) {
 	int8_t* data = &p_section->section[index_x][index_y];
 
 	if (set) {
+#ifdef MAP_SUMMARY_AVAILABLE
+		summary_invalidate(x, y);
+#endif
 		*data = value;
-		map_current_block.updated = True;
+		current_block_updated();
 	}
 	return *data;
 }
 
+/**
+ * Setzt die Felder aller Sections zurueck, die den belegten Bereich der Karte ueberdecken.
+ * Die Sections werden in Speicherreihenfolge bearbeitet, so wird jeder Block nur einmal geladen.
+ * Die Karte muss gesperrt sein.
+ * \param only_free	True: nur freie Felder (> 0) auf 0 setzen, False: alle Felder
+ */
+static void clear_sections(uint8_t only_free) {
+	int16_t x, y;
+	for (y = map_min_y & ~(MAP_SECTION_POINTS - 1); y <= map_max_y; y += MAP_SECTION_POINTS) {
+		for (x = map_min_x & ~(MAP_SECTION_POINTS - 1); x <= map_max_x; x += MAP_SECTION_POINTS) {
+			map_section_t* p_section = get_section(x, y);
+			if (! p_section) {
+				continue;
+			}
+			int8_t* p_data = &p_section->section[0][0];
+			if (only_free) {
+				uint16_t i;
+				for (i = 0; i < sizeof(map_section_t); ++i) {
+					if (p_data[i] > 0) {
+						p_data[i] = 0;
+					}
+				}
+			} else {
+				memset(p_data, 0, sizeof(map_section_t));
+			}
+			current_block_updated();
+#ifdef MAP_SUMMARY_AVAILABLE
+			summary_invalidate(x, y);
+#endif
+		}
+	}
+}
+
+#ifdef MAP_SUMMARY_AVAILABLE
+/**
+ * Berechnet die Zusammenfassung einer Section aus ihren Feldern neu
+ * \param x	X-Ordinate eines Feldes der Section
+ * \param y	Y-Ordinate eines Feldes der Section
+ */
+static void summary_refresh_section(int16_t x, int16_t y) {
+	map_summary_t* p_summary = &map_summary_sections[(uint16_t) x / MAP_SECTION_POINTS][(uint16_t) y / MAP_SECTION_POINTS];
+	const map_section_t* p_section = get_section(x, y);
+	if (! p_section) {
+		/* nichts bekannt, Felder werden einzeln geprueft */
+		p_summary->min = -128;
+		p_summary->max = 127;
+		return;
+	}
+	const int8_t* p_data = &p_section->section[0][0];
+	int8_t min = 127, max = -128;
+	uint16_t i;
+	for (i = 0; i < MAP_SECTION_POINTS * MAP_SECTION_POINTS; ++i) {
+		const int8_t value = p_data[i];
+		if (value < min) {
+			min = value;
+		}
+		if (value > max) {
+			max = value;
+		}
+	}
+	p_summary->min = min;
+	p_summary->max = max;
+	p_summary->stale = False;
+}
+
+/**
+ * Berechnet die Zusammenfassung eines Makroblocks aus denen seiner Sections neu,
+ * veraltete Sections werden dabei ebenfalls neu berechnet
+ * \param mx	X-Index des Makroblocks
+ * \param my	Y-Index des Makroblocks
+ */
+static void summary_refresh_macroblock(uint8_t mx, uint8_t my) {
+	const uint16_t sections = MACRO_BLOCK_LENGTH / MAP_SECTION_POINTS;
+	int8_t min = 127, max = -128;
+	uint16_t sx, sy;
+	for (sy = my * sections; sy < (my + 1) * sections; ++sy) {
+		for (sx = mx * sections; sx < (mx + 1) * sections; ++sx) {
+			const map_summary_t* p_summary = &map_summary_sections[sx][sy];
+			if (p_summary->stale) {
+				summary_refresh_section((int16_t) (sx * MAP_SECTION_POINTS), (int16_t) (sy * MAP_SECTION_POINTS));
+			}
+			if (p_summary->min < min) {
+				min = p_summary->min;
+			}
+			if (p_summary->max > max) {
+				max = p_summary->max;
+			}
+		}
+	}
+	map_summary_macroblocks[mx][my].min = min;
+	map_summary_macroblocks[mx][my].max = max;
+	map_summary_macroblocks[mx][my].stale = False;
+}
+
+/**
+ * Prueft anhand der Zusammenfassungen, ob alle oder keine Felder der Section von (x|y) zwischen
+ * min_val und max_val liegen. Veraltete Zusammenfassungen werden dafuer vorher neu berechnet.
+ * \param x			X-Ordinate der Karte
+ * \param y			Y-Ordinate der Karte
+ * \param min_val	minimaler Feldwert
+ * \param max_val	maximaler Feldwert
+ * \return			1: alle Felder liegen im Intervall, 0: keines, -1: Felder muessen einzeln geprueft werden
+ */
+static int8_t summary_classify(int16_t x, int16_t y, int8_t min_val, int8_t max_val) {
+	if (((uint16_t) x >= (uint16_t) (MAP_SIZE * MAP_RESOLUTION)) || ((uint16_t) y >= (uint16_t) (MAP_SIZE * MAP_RESOLUTION))) {
+		return -1;
+	}
+
+	const uint8_t mx = (uint8_t) ((uint16_t) x / MACRO_BLOCK_LENGTH);
+	const uint8_t my = (uint8_t) ((uint16_t) y / MACRO_BLOCK_LENGTH);
+	if (map_summary_macroblocks[mx][my].stale) {
+		summary_refresh_macroblock(mx, my);
+	}
+	int8_t result = summary_test(&map_summary_macroblocks[mx][my], min_val, max_val);
+	if (result >= 0) {
+		return result;
+	}
+
+	const map_summary_t* p_summary = &map_summary_sections[(uint16_t) x / MAP_SECTION_POINTS][(uint16_t) y / MAP_SECTION_POINTS];
+	return summary_test(p_summary, min_val, max_val); // aktuell, seit summary_refresh_macroblock()
+}
+
+/**
+ * Zaehlt die Felder einer Zeile oder Spalte, deren Werte zwischen min_val und max_val liegen.
+ * Abschnitte, die innerhalb einer Section liegen, werden moeglichst anhand der Zusammenfassung
+ * komplett angenommen oder verworfen.
+ * \param x			X-Ordinate des ersten Feldes
+ * \param y			Y-Ordinate des ersten Feldes
+ * \param vertical	True: Spalte (y laeuft), False: Zeile (x laeuft)
+ * \param length	Anzahl der Felder
+ * \param min_val	minimaler Feldwert
+ * \param max_val	maximaler Feldwert
+ * \return			Anzahl der Felder im Intervall
+ */
+static uint16_t summary_count_strip(int16_t x, int16_t y, uint8_t vertical, int16_t length, int8_t min_val, int8_t max_val) {
+	uint16_t count = 0;
+	while (length > 0) {
+		/* Laenge des Abschnitts bis zur naechsten Section-Grenze */
+		const int16_t pos = vertical ? y : x;
+		int16_t n = (int16_t) (MAP_SECTION_POINTS - (pos & (MAP_SECTION_POINTS - 1)));
+		if (n > length) {
+			n = length;
+		}
+
+		const int8_t result = summary_classify(x, y, min_val, max_val);
+		if (result == 1) {
+			count += n;
+		} else if (result < 0) {
+			int16_t k;
+			for (k = 0; k < n; ++k) {
+				const int8_t field = vertical ? access_field(x, y + k, 0, 0) : access_field(x + k, y, 0, 0);
+				if (field >= min_val && field <= max_val) {
+					count++;
+				}
+			}
+		}
+
+		if (vertical) {
+			y += n;
+		} else {
+			x += n;
+		}
+		length -= n;
+	}
+	return count;
+}
+#endif // MAP_SUMMARY_AVAILABLE
+
 /**
  * liefert den Durschnittswert um einen Punkt der Karte herum
  * \param x 		x-Ordinate der Karte
@@ -719,27 +1261,23 @@ int8_t map_get_average(int16_t x, int16_t y, int16_t radius) {
 	int16_t Y = world_to_map(y);
 	int8_t R = (int8_t) (radius / (1000 / MAP_RESOLUTION));
 
-	/* warten bis Karte frei ist */
-	map_flush_cache();
+	/* warten bis Karte frei ist; gelesen wird ueber den Block-Cache, zurueckgeschrieben wird dafuer nichts */
+	os_signal_lock(&lock_signal);
 
 	int8_t result = get_average_fields(X, Y, R);
 
+	os_signal_unlock(&lock_signal);
+
 	return result;
 }
 
 /**
- * Aendert den Wert eines Feldes um den angegebenen Betrag
- * \param x		x-Ordinate der Karte (nicht der Welt!!!)
- * \param y		y-Ordinate der Karte (nicht der Welt!!!)
+ * Addiert einen Betrag saturierend zu einem Feldwert
+ * \param tmp		aktueller Wert des Feldes
  * \param value	Betrag um den das Feld veraendert wird (>0 heisst freier, <0 heisst belegter)
+ * \return		neuer Wert des Feldes
  */
-static void update_field(int16_t x, int16_t y, int8_t value) {
-	int8_t tmp = access_field(x, y, 0, 0);
-	if (tmp == -128) {
-		// Nicht aktualiseren, wenn es sich um ein Loch handelt
-		return;
-	}
-
+static inline int8_t add_field_value(int8_t tmp, int8_t value) {
 	int8_t new_value = (int8_t) (tmp + value);
 	/* Saturation */
 	if (value > 0) {
@@ -751,8 +1289,275 @@ static void update_field(int16_t x, int16_t y, int8_t value) {
 			new_value = -127;
 		}
 	}
+	return new_value;
+}
+
+#ifdef MAP_CHANGE_HANDLER_AVAILABLE
+/**
+ * Vermerkt ein Feld, dessen Wert sich geaendert hat, fuer den Change-Handler
+ * \param x		x-Ordinate der Karte (nicht der Welt!!!)
+ * \param y		y-Ordinate der Karte (nicht der Welt!!!)
+ */
+static inline void changed_add(int16_t x, int16_t y) {
+	if (x < map_changed.min_x) {
+		map_changed.min_x = x;
+	}
+	if (x > map_changed.max_x) {
+		map_changed.max_x = x;
+	}
+	if (y < map_changed.min_y) {
+		map_changed.min_y = y;
+	}
+	if (y > map_changed.max_y) {
+		map_changed.max_y = y;
+	}
+}
+
+/**
+ * Meldet das Rechteck der veraenderten Felder an den Change-Handler und setzt es zurueck
+ */
+static void changed_notify(void) {
+	const map_change_handler_t handler = map_change_handler;
+	if (handler && map_changed.min_x <= map_changed.max_x) {
+		handler(map_to_world(map_changed.min_x), map_to_world(map_changed.min_y), map_to_world(map_changed.max_x),
+			map_to_world(map_changed.max_y));
+	}
+	map_changed.min_x = INT16_MAX;
+	map_changed.min_y = INT16_MAX;
+	map_changed.max_x = INT16_MIN;
+	map_changed.max_y = INT16_MIN;
+}
+
+void map_set_change_handler(map_change_handler_t handler) {
+	os_enterCS();
+	map_change_handler = handler;
+	os_exitCS();
+}
+#endif // MAP_CHANGE_HANDLER_AVAILABLE
+
+/**
+ * Aendert den Wert eines Feldes um den angegebenen Betrag
+ * \param x		x-Ordinate der Karte (nicht der Welt!!!)
+ * \param y		y-Ordinate der Karte (nicht der Welt!!!)
+ * \param value	Betrag um den das Feld veraendert wird (>0 heisst freier, <0 heisst belegter)
+ */
+static void write_field_add(int16_t x, int16_t y, int8_t value) {
+	int8_t tmp = access_field(x, y, 0, 0);
+	if (tmp == -128) {
+		// Nicht aktualiseren, wenn es sich um ein Loch handelt
+		return;
+	}
 
+	const int8_t new_value = add_field_value(tmp, value);
+	if (new_value == tmp) {
+		return; // saturiert
+	}
 	access_field(x, y, new_value, 1);
+#ifdef MAP_CHANGE_HANDLER_AVAILABLE
+	changed_add(x, y);
+#endif
+}
+
+/**
+ * Setzt ein Feld auf den angegebenen Wert, falls dieser kleiner (belegter) ist als der aktuelle
+ * \param x		x-Ordinate der Karte (nicht der Welt!!!)
+ * \param y		y-Ordinate der Karte (nicht der Welt!!!)
+ * \param value	neuer Wert des Feldes
+ */
+static void write_field_min(int16_t x, int16_t y, int8_t value) {
+	if (access_field(x, y, 0, 0) > value) {
+		// Mapwert hoeher Richtung frei
+		access_field(x, y, value, 1); // dann Wert eintragen
+#ifdef MAP_CHANGE_HANDLER_AVAILABLE
+		changed_add(x, y);
+#endif
+	}
+}
+
+#ifdef MAP_UPDATE_BATCH_AVAILABLE
+#define MAP_BATCH_OPS		4096	/**< maximale Anzahl gesammelter Feld-Updates */
+#define MAP_BATCH_BLOCKS	128		/**< maximale Anzahl verschiedener Bloecke pro Durchlauf */
+#define MAP_BATCH_END		0xffff	/**< Ende einer Liste von Feld-Updates */
+
+#define MAP_FIELD_ADD		0		/**< Feld-Update: Betrag saturierend addieren, siehe write_field_add() */
+#define MAP_FIELD_MIN		1		/**< Feld-Update: Wert setzen, falls kleiner, siehe write_field_min() */
+
+/** Gesammeltes Feld-Update */
+typedef struct {
+	int16_t x;		/**< x-Ordinate der Karte */
+	int16_t y;		/**< y-Ordinate der Karte */
+	int8_t value;	/**< Betrag bzw. Wert */
+	uint8_t op;		/**< MAP_FIELD_ADD oder MAP_FIELD_MIN */
+	uint16_t next;	/**< Index des naechsten Updates im selben Block oder MAP_BATCH_END */
+} map_field_update_t;
+
+/** Liste der gesammelten Feld-Updates eines Blocks */
+typedef struct {
+	uint16_t block;	/**< Blocknummer */
+	uint16_t first;	/**< Index des ersten Updates */
+	uint16_t last;	/**< Index des letzten Updates */
+} map_batch_block_t;
+
+/** Feld-Updates des Update-Threads, nach Bloecken verkettet */
+static struct {
+	map_field_update_t ops[MAP_BATCH_OPS];		/**< Feld-Updates in Eingangsreihenfolge */
+	map_batch_block_t blocks[MAP_BATCH_BLOCKS];	/**< Bloecke, die von den Updates betroffen sind */
+	uint16_t n_ops;								/**< Anzahl der Feld-Updates */
+	uint8_t n_blocks;							/**< Anzahl der Bloecke */
+	uint8_t last;								/**< zuletzt benutzter Eintrag in blocks */
+	uint8_t active;								/**< True, falls Feld-Updates gesammelt statt sofort eingetragen werden */
+} map_batch;
+
+/**
+ * Traegt alle gesammelten Feld-Updates in aufsteigender Blockreihenfolge in die Karte ein, jeder
+ * Block wird dafuer nur einmal geladen. Innerhalb eines Blocks bleibt die Reihenfolge erhalten, das Ergebnis ist also dasselbe wie
+ * beim sofortigen Eintragen.
+ */
+static void batch_apply(void) {
+	/* Bloecke sortieren (Insertion-Sort, es sind nur wenige) */
+	uint8_t i;
+	for (i = 1; i < map_batch.n_blocks; ++i) {
+		const map_batch_block_t tmp = map_batch.blocks[i];
+		uint8_t j = i;
+		while (j > 0 && map_batch.blocks[j - 1].block > tmp.block) {
+			map_batch.blocks[j] = map_batch.blocks[j - 1];
+			--j;
+		}
+		map_batch.blocks[j] = tmp;
+	}
+
+	for (i = 0; i < map_batch.n_blocks; ++i) {
+		/* Block einmal laden, dann alle Updates direkt auf den Daten ausfuehren */
+		uint16_t k = map_batch.blocks[i].first;
+		if (! get_section(map_batch.ops[k].x, map_batch.ops[k].y)) {
+			continue;
+		}
+		map_section_t* p_sections = (map_section_t*) get_block_data(map_current_block);
+		uint8_t updated = False;
+		for (; k != MAP_BATCH_END; k = map_batch.ops[k].next) {
+			const map_field_update_t* p_op = &map_batch.ops[k];
+			const uint8_t index = (uint8_t) ((p_op->x / MAP_SECTION_POINTS) & 0x1);
+			int8_t* p_field = &p_sections[index].section[(uint16_t) p_op->x % MAP_SECTION_POINTS][(uint16_t) p_op->y % MAP_SECTION_POINTS];
+			const int8_t tmp = *p_field;
+			int8_t new_value;
+			if (p_op->op == MAP_FIELD_ADD) {
+				if (tmp == -128) { // Loecher bleiben unveraendert
+					continue;
+				}
+				new_value = add_field_value(tmp, p_op->value);
+				if (new_value == tmp) { // saturiert
+					continue;
+				}
+			} else if (tmp > p_op->value) {
+				new_value = p_op->value;
+			} else {
+				continue;
+			}
+			*p_field = new_value;
+			updated = True;
+#ifdef MAP_CHANGE_HANDLER_AVAILABLE
+			changed_add(p_op->x, p_op->y);
+#endif
+		}
+		if (updated) {
+			current_block_updated();
+#ifdef MAP_SUMMARY_AVAILABLE
+			/* ein Block enthaelt zwei in X-Richtung benachbarte Sections desselben Makroblocks */
+			summary_invalidate(map_current_block->x, map_current_block->y);
+			summary_invalidate(map_current_block->x + MAP_SECTION_POINTS, map_current_block->y);
+#endif // MAP_SUMMARY_AVAILABLE
+		}
+	}
+
+	map_batch.n_ops = 0;
+	map_batch.n_blocks = 0;
+	map_batch.last = 0;
+}
+
+/**
+ * Merkt ein Feld-Update vor; ist der Puffer voll, wird vorher alles Gesammelte eingetragen
+ * \param x		x-Ordinate der Karte (nicht der Welt!!!)
+ * \param y		y-Ordinate der Karte (nicht der Welt!!!)
+ * \param value	Betrag bzw. Wert
+ * \param op		MAP_FIELD_ADD oder MAP_FIELD_MIN
+ */
+static void batch_add(int16_t x, int16_t y, int8_t value, uint8_t op) {
+	const uint16_t block = get_block(x, y);
+	if (block == 0xffff) {
+		return;
+	}
+	if (map_batch.n_ops == MAP_BATCH_OPS) {
+		batch_apply();
+	}
+
+	/* Liste des Blocks suchen, meistens ist es dieselbe wie beim letzten Mal */
+	uint8_t b = map_batch.last;
+	if (b >= map_batch.n_blocks || map_batch.blocks[b].block != block) {
+		for (b = 0; b < map_batch.n_blocks; ++b) {
+			if (map_batch.blocks[b].block == block) {
+				break;
+			}
+		}
+		if (b == MAP_BATCH_BLOCKS) {
+			batch_apply();
+			b = 0;
+		}
+		map_batch.last = b;
+	}
+
+	const uint16_t n = map_batch.n_ops;
+	if (b == map_batch.n_blocks) {
+		/* neuer Block */
+		map_batch.blocks[b].block = block;
+		map_batch.blocks[b].first = n;
+		++map_batch.n_blocks;
+	} else {
+		map_batch.ops[map_batch.blocks[b].last].next = n;
+	}
+	map_batch.blocks[b].last = n;
+
+	map_field_update_t* p_op = &map_batch.ops[n];
+	p_op->x = x;
+	p_op->y = y;
+	p_op->value = value;
+	p_op->op = op;
+	p_op->next = MAP_BATCH_END;
+	map_batch.n_ops = n + 1;
+}
+#endif // MAP_UPDATE_BATCH_AVAILABLE
+
+/**
+ * Aendert den Wert eines Feldes um den angegebenen Betrag, waehrend eines Update-Durchlaufs
+ * erst beim Eintragen des Batches
+ * \param x		x-Ordinate der Karte (nicht der Welt!!!)
+ * \param y		y-Ordinate der Karte (nicht der Welt!!!)
+ * \param value	Betrag um den das Feld veraendert wird (>0 heisst freier, <0 heisst belegter)
+ */
+static inline void update_field(int16_t x, int16_t y, int8_t value) {
+#ifdef MAP_UPDATE_BATCH_AVAILABLE
+	if (map_batch.active) {
+		batch_add(x, y, value, MAP_FIELD_ADD);
+		return;
+	}
+#endif // MAP_UPDATE_BATCH_AVAILABLE
+	write_field_add(x, y, value);
+}
+
+/**
+ * Setzt ein Feld auf den angegebenen Wert, falls dieser kleiner ist als der aktuelle; waehrend
+ * eines Update-Durchlaufs erst beim Eintragen des Batches
+ * \param x		x-Ordinate der Karte (nicht der Welt!!!)
+ * \param y		y-Ordinate der Karte (nicht der Welt!!!)
+ * \param value	neuer Wert des Feldes
+ */
+static inline void update_field_min(int16_t x, int16_t y, int8_t value) {
+#ifdef MAP_UPDATE_BATCH_AVAILABLE
+	if (map_batch.active) {
+		batch_add(x, y, value, MAP_FIELD_MIN);
+		return;
+	}
+#endif // MAP_UPDATE_BATCH_AVAILABLE
+	write_field_min(x, y, value);
 }
 
 /**
@@ -862,12 +1667,7 @@ static void set_value_field_circle(int16_t x, int16_t y, int8_t radius, int8_t v
 		for (dY = (int8_t) -radius; dY <= radius; dY++) {
 			if (dX2 + muls8(dY, dY) <= h) {
 				// nur innerhalb des Umkreises
-				const int16_t x_tmp = x + dX;
-				const int16_t y_tmp = y + dY;
-				if (access_field(x_tmp, y_tmp, 0, 0) > value) {
-					// Mapwert hoeher Richtung frei
-					access_field (x_tmp, y_tmp, value, 1); // dann Wert eintragen
-				}
+				update_field_min(x + dX, y + dY, value);
 			}
 		}
 	}
@@ -889,30 +1689,16 @@ static void set_value_occupied(int16_t x, int16_t y, int8_t val) {
 }
 
 /**
- * Aktualisiert die Karte mit den Daten eines Distanz-Sensors
- * \param x		X-Achse der Position des Sensors
- * \param y 	Y-Achse der Position des Sensors
- * \param h_sin sin(Blickrichtung)
- * \param h_cos	cos(Blickrichtung)
- * \param dist 	Sensorwert
+ * Traegt einen Sensorstrahl in die Karte ein: alle Felder vom Sensor bis vor das Strahlende werden
+ * als frei markiert, das Strahlende als Hindernis, falls der Sensor etwas gesehen hat
+ * \param X		X-Achse der Position des Sensors [Kartenkoordinaten]
+ * \param Y		Y-Achse der Position des Sensors [Kartenkoordinaten]
+ * \param PH_X	X-Achse des Strahlendes [Kartenkoordinaten]
+ * \param PH_Y	Y-Achse des Strahlendes [Kartenkoordinaten]
+ * \param dist	Sensorwert
  * \param location_prob Gibt an, wie sicher wir ueber die Position sind [0; 255]
  */
-static void update_sensor_distance(int16_t x, int16_t y, float h_sin, float h_cos, int16_t dist, uint8_t location_prob) {
-	// Ort des Sensors in Kartenkoordinaten
-	int16_t X = world_to_map(x);
-	int16_t Y = world_to_map(y);
-
-	int16_t d;
-	if (dist == SENS_IR_INFINITE) {
-		d = SENS_IR_MAX_DIST;
-	} else {
-		d = dist;
-	}
-
-	// liefert die Mapkoordinaten des Hindernisses / Ende des Frei-Strahls
-	int16_t PH_X = world_to_map(x + (int16_t) (d * h_cos));
-	int16_t PH_Y = world_to_map(y + (int16_t) (d * h_sin));
-
+static void update_sensor_ray(int16_t X, int16_t Y, int16_t PH_X, int16_t PH_Y, int16_t dist, uint8_t location_prob) {
 	// Nun markiere alle Felder vor dem Hindernis als frei
 	int8_t i;
 
@@ -963,24 +1749,48 @@ static void update_sensor_distance(int16_t x, int16_t y, float h_sin, float h_co
 	}
 }
 
+/**
+ * Aktualisiert die Karte mit den Daten eines Distanz-Sensors
+ * \param x		X-Achse der Position des Sensors
+ * \param y 	Y-Achse der Position des Sensors
+ * \param h_sin sin(Blickrichtung) in Q1.14
+ * \param h_cos	cos(Blickrichtung) in Q1.14
+ * \param dist 	Sensorwert
+ * \param location_prob Gibt an, wie sicher wir ueber die Position sind [0; 255]
+ */
+static void update_sensor_distance(int16_t x, int16_t y, int16_t h_sin, int16_t h_cos, int16_t dist, uint8_t location_prob) {
+	const int16_t d = dist == SENS_IR_INFINITE ? SENS_IR_MAX_DIST : dist;
+
+	// liefert die Mapkoordinaten des Hindernisses / Ende des Frei-Strahls
+	const int16_t PH_X = world_to_map((int16_t) (x + mul_fix(d, h_cos)));
+	const int16_t PH_Y = world_to_map((int16_t) (y + mul_fix(d, h_sin)));
+
+	update_sensor_ray(world_to_map(x), world_to_map(y), PH_X, PH_Y, dist, location_prob);
+}
+
 /**
  * Aktualisiert die interne Karte anhand der Sensordaten
  * \param x			X-Achse der Position in Weltkoordinaten
  * \param y			Y-Achse der Position in Weltkoordinaten
- * \param sin_head	sin(Blickrichtung)
- * \param cos_head	cos(Blickrichtung)
+ * \param sin_head	sin(Blickrichtung) in Q1.14
+ * \param cos_head	cos(Blickrichtung) in Q1.14
  * \param distL		Sensorwert links
  * \param distR		Sensorwert rechts
  * \param location_prob Gibt an, wie sicher wir ueber die Position sind [0; 255]
  */
-static void update_distance(int16_t x, int16_t y, float sin_head, float cos_head, int16_t distL, int16_t distR, uint8_t location_prob) {
+static void update_distance(int16_t x, int16_t y, int16_t sin_head, int16_t cos_head, int16_t distL, int16_t distR, uint8_t location_prob) {
+	const int16_t sw_sin = mul_fix(DISTSENSOR_POS_SW, sin_head);
+	const int16_t sw_cos = mul_fix(DISTSENSOR_POS_SW, cos_head);
+	const int16_t fw_sin = mul_fix(DISTSENSOR_POS_FW, sin_head);
+	const int16_t fw_cos = mul_fix(DISTSENSOR_POS_FW, cos_head);
+
 	// Ort des rechten Sensors in Weltkoordinaten
-	int16_t Pr_x = x + (int16_t)(DISTSENSOR_POS_SW * sin_head + DISTSENSOR_POS_FW * cos_head);
-	int16_t Pr_y = y - (int16_t)(DISTSENSOR_POS_SW * cos_head - DISTSENSOR_POS_FW * sin_head);
+	const int16_t Pr_x = (int16_t) (x + sw_sin + fw_cos);
+	const int16_t Pr_y = (int16_t) (y - sw_cos + fw_sin);
 
 	// Ort des linken Sensors in Weltkoordinaten
-	int16_t Pl_x = x - (int16_t)(DISTSENSOR_POS_SW * sin_head - DISTSENSOR_POS_FW * cos_head);
-	int16_t Pl_y = y + (int16_t)(DISTSENSOR_POS_SW * cos_head + DISTSENSOR_POS_FW * sin_head);
+	const int16_t Pl_x = (int16_t) (x - sw_sin + fw_cos);
+	const int16_t Pl_y = (int16_t) (y + sw_cos + fw_sin);
 
 	update_sensor_distance(Pl_x, Pl_y, sin_head, cos_head, distL, location_prob);
 	update_sensor_distance(Pr_x, Pr_y, sin_head, cos_head, distR, location_prob);
@@ -1005,23 +1815,27 @@ static void update_location(int16_t x, int16_t y, uint8_t location_prob) {
  * Aktualisiert die interne Karte anhand der Abgrund-Sensordaten
  * \param x			X-Achse der Position in Weltkoordinaten
  * \param y			Y-Achse der Position in Weltkoordinaten
- * \param sin_head	sin(Blickrichtung [Grad])
- * \param cos_head	cos(Blickrichtung [Grad])
+ * \param sin_head	sin(Blickrichtung) in Q1.14
+ * \param cos_head	cos(Blickrichtung) in Q1.14
  * \param borderL	Sensor links 1= abgrund 0 = frei
  * \param borderR	Sensor rechts 1= abgrund 0 = frei
  */
-static void update_border(int16_t x, int16_t y, float sin_head, float cos_head, uint8_t borderL, uint8_t borderR) {
+static void update_border(int16_t x, int16_t y, int16_t sin_head, int16_t cos_head, uint8_t borderL, uint8_t borderR) {
+	const int16_t sw_sin = mul_fix(BORDERSENSOR_POS_SW, sin_head);
+	const int16_t sw_cos = mul_fix(BORDERSENSOR_POS_SW, cos_head);
+	const int16_t fw_sin = mul_fix(BORDERSENSOR_POS_FW, sin_head);
+	const int16_t fw_cos = mul_fix(BORDERSENSOR_POS_FW, cos_head);
+
 	if (borderR > 0) {
 		// Ort des rechten Sensors in Mapkoordinaten
-		int16_t x_map = world_to_map(x + (int16_t) (BORDERSENSOR_POS_SW * sin_head + BORDERSENSOR_POS_FW * cos_head));
-		int16_t y_map = world_to_map(y - (int16_t) (BORDERSENSOR_POS_SW * cos_head - BORDERSENSOR_POS_FW * sin_head));
+		int16_t x_map = world_to_map((int16_t) (x + sw_sin + fw_cos));
+		int16_t y_map = world_to_map((int16_t) (y - sw_cos + fw_sin));
 		set_value_occupied(x_map, y_map, -128);
 	}
 
 	if (borderL > 0) {
-		int16_t x_map = world_to_map(x - (int16_t)(BORDERSENSOR_POS_SW * sin_head - BORDERSENSOR_POS_FW * cos_head));
-
-		int16_t y_map = world_to_map(y + (int16_t)(BORDERSENSOR_POS_SW * cos_head + BORDERSENSOR_POS_FW * sin_head));
+		int16_t x_map = world_to_map((int16_t) (x - sw_sin + fw_cos));
+		int16_t y_map = world_to_map((int16_t) (y + sw_cos + fw_sin));
 		set_value_occupied(x_map, y_map, -128);
 	}
 }
@@ -1072,6 +1886,10 @@ static uint8_t get_ratio(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t
 	if (dX >= dY) {
 		int16_t lh = dX / 2;
 		for (i = 0; i < dX; i++) {
+#if defined MAP_SUMMARY_AVAILABLE && ! defined DEBUG_GET_RATIO_VERBOSE
+			count += summary_count_strip(lX + i * sX, lY - width, True, width * 2 + corr, min_val, max_val);
+			(void) w;
+#else
 			for (w = -width; w < width + corr; w++) {
 				int8_t field = access_field(lX + i * sX, lY + w, 0, 0);
 				if (field >= min_val && field <= max_val) {
@@ -1089,6 +1907,7 @@ static uint8_t get_ratio(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t
 #endif // DEBUG_GET_RATIO_VERBOSE
 				}
 			}
+#endif // MAP_SUMMARY_AVAILABLE && ! DEBUG_GET_RATIO_VERBOSE
 
 			lh += dY;
 			if (lh >= dX) {
@@ -1099,6 +1918,9 @@ static uint8_t get_ratio(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t
 	} else {
 		int16_t lh = dY / 2;
 		for (i = 0; i < dY; i++) {
+#if defined MAP_SUMMARY_AVAILABLE && ! defined DEBUG_GET_RATIO_VERBOSE
+			count += summary_count_strip(lX - width, lY + i * sY, False, width * 2 + corr, min_val, max_val);
+#else
 			for (w = -width; w < width + corr; w++) {
 				int8_t field = access_field(lX + w, lY + i * sY, 0, 0);
 				if (field >= min_val && field <= max_val) {
@@ -1116,6 +1938,7 @@ static uint8_t get_ratio(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t
 #endif // DEBUG_GET_RATIO_VERBOSE
 				}
 			}
+#endif // MAP_SUMMARY_AVAILABLE && ! DEBUG_GET_RATIO_VERBOSE
 
 			lh += dX;
 			if (lh >= dY) {
@@ -1168,12 +1991,14 @@ static uint8_t get_ratio(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t
  * 					MAP_RATIO_FULL	-> alle Felder liegen im gewuenschten Bereich
  */
 uint8_t map_get_ratio(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t width, int8_t min_val, int8_t max_val) {
-	/* warten bis Karte frei ist */
-	map_flush_cache();
+	/* warten bis Karte frei ist; gelesen wird ueber den Block-Cache, zurueckgeschrieben wird dafuer nichts */
+	os_signal_lock(&lock_signal);
 
 	/* Ergebnis berechnen */
 	uint8_t result = get_ratio(world_to_map(x1), world_to_map(y1), world_to_map(x2), world_to_map(y2), width / (1000 / MAP_RESOLUTION), min_val, max_val);
 
+	os_signal_unlock(&lock_signal);
+
 	return result;
 }
 
@@ -1295,7 +2120,54 @@ void map_draw_circle_world(position_t center, int16_t radius, uint8_t color) {
 
 
 /**
- * Main-Funktion des Map-Update-Threads
+ * Traegt einen Eintrag des Map-Caches in die Karte ein, die Karte muss dafuer gesperrt sein
+ * \param *cache_tmp	Zeiger auf den Cache-Eintrag
+ */
+static void update_map(map_cache_t* cache_tmp) {
+#ifdef DEBUG_SCAN_OTF
+	LOG_DEBUG("lese Cache: x= %d y= %d distance= %d loaction=%d border=%d", cache_tmp->x_pos, cache_tmp->y_pos, cache_tmp->distance,
+		cache_tmp->location, cache_tmp->border);
+
+	if ((cache_tmp->distance || cache_tmp->location || cache_tmp->border) == 0)
+	LOG_DEBUG("Achtung: Dieser Eintrag ergibt keinen Sinn, kein einziges mode-bit gesetzt");
+#endif
+
+#ifdef MEASURE_POSITION_ERRORS_AVAILABLE
+	const uint8_t location_prob = cache_tmp->loc_prob;
+#else
+	const uint8_t location_prob = 255;
+#endif
+
+	/* Grundflaeche updaten, falls location-mode */
+	if (cache_tmp->location) {
+		update_location(cache_tmp->x_pos, cache_tmp->y_pos, location_prob);
+	}
+
+	if (! cache_tmp->border && ! cache_tmp->distance) {
+		return;
+	}
+
+	const int16_t sin_head = sin_fix((int16_t) cache_tmp->heading);
+	const int16_t cos_head = cos_fix((int16_t) cache_tmp->heading);
+
+	/* Abgrundsensoren updaten, falls border-mode */
+	if (cache_tmp->border) {
+		update_border(cache_tmp->x_pos, cache_tmp->y_pos, sin_head, cos_head, cache_tmp->dataL, cache_tmp->dataR);
+	}
+
+	else // border-mode schliesst distance-mode aus, weil Felder der Struktur gemeinsam verwendet werden
+
+	/* Strahlen updaten, falls distance-mode und der aktuelle Eintrag Daten dazu hat */
+	if (cache_tmp->distance) {
+		update_distance(cache_tmp->x_pos, cache_tmp->y_pos, sin_head, cos_head, cache_tmp->dataL * 5, cache_tmp->dataR * 5, location_prob);
+	}
+}
+
+/**
+ * Main-Funktion des Map-Update-Threads.
+ * Arbeitet alle anstehenden Cache-Eintraege unter einer Sperre ab; mit MAP_UPDATE_BATCH_AVAILABLE werden
+ * die Feld-Updates gesammelt und blockweise eingetragen, so dass jeder Block pro Durchlauf nur einmal geladen wird.
+ * Mit MAP_CHANGE_HANDLER_AVAILABLE wird danach der veraenderte Bereich an den registrierten Handler gemeldet.
  */
 void map_update_main(void) {
 	/* Endlosschleife -> Thread wird vom OS blockiert / gibt die Kontrolle ab,
@@ -1304,100 +2176,244 @@ void map_update_main(void) {
 		/* Cache-Eintrag holen
 		 * Thread blockiert hier, falls Fifo leer */
 		uint8_t index = _inline_fifo_get(&map_update_fifo, False);
-		map_cache_t* cache_tmp = &map_update_cache[index];
 
+		/* warten, falls die Karte gerade gelesen wird */
+		os_signal_set(&lock_signal);
+		os_signal_release(&lock_signal);
 		os_signal_lock(&lock_signal); // Zugriff auf die Map sperren
-#ifdef DEBUG_SCAN_OTF
-		LOG_DEBUG("lese Cache: x= %d y= %d distance= %d loaction=%d border=%d", cache_tmp->x_pos, cache_tmp->y_pos, cache_tmp->mode.data.distance,
-			cache_tmp->mode.data.location, cache_tmp->mode.data.border);
 
-		if ((cache_tmp->mode.data.distance || cache_tmp->mode.data.location || cache_tmp->mode.data.border) == 0)
-		LOG_DEBUG("Achtung: Dieser Eintrag ergibt keinen Sinn, kein einziges mode-bit gesetzt");
+#ifdef MAP_UPDATE_BATCH_AVAILABLE
+		map_batch.active = True;
 #endif
-
-#ifdef MEASURE_POSITION_ERRORS_AVAILABLE
-		const uint8_t location_prob = cache_tmp->loc_prob;
-#else
-		const uint8_t location_prob = 255;
+		/* alle anstehenden Eintraege abarbeiten, hoechstens aber einmal die Fifo-Groesse, damit Leser nicht verhungern */
+		uint8_t n;
+		for (n = MAP_UPDATE_CACHE_SIZE; n > 0; --n) {
+			update_map(&map_update_cache[index]);
+			if (map_update_fifo.count == 0 || n == 1) {
+				break;
+			}
+			index = _inline_fifo_get(&map_update_fifo, False);
+		}
+#ifdef MAP_UPDATE_BATCH_AVAILABLE
+		map_batch.active = False;
+		batch_apply();
+#endif
+#ifdef MAP_CHANGE_HANDLER_AVAILABLE
+		changed_notify();
 #endif
 
-		/* Grundflaeche updaten, falls location-mode */
-		if (cache_tmp->mode.data.location) {
-			update_location(cache_tmp->x_pos, cache_tmp->y_pos, location_prob);
+		/* Falls Fifo leer, Header aktualisieren und Sperre aufheben */
+		if (map_update_fifo.count == 0) {
+#ifdef MAP_2_SIM_AVAILABLE
+			/* veraenderte Bloecke an den Sim melden, zurueckgeschrieben werden sie erst beim Verdraengen */
+			uint8_t i;
+			for (i = 0; i < MAP_BLOCK_CACHE_SIZE; ++i) {
+				map_2_sim_notify(&map_block_cache[i]);
+			}
+#endif
+			if (min_max_updated == True) {
+				min_max_updated = False;
+				/* Min- / Max-Werte speichern */
+				if (write_header()) {
+					LOG_DEBUG("map_update_main(): write_header() failed");
+				}
+			}
 		}
+		os_signal_unlock(&lock_signal); // Zugriff auf Map wieder freigeben
+	}
+}
 
-#ifdef MAP_USE_TRIG_CACHE
-		float* sin_head = &cache_tmp->sin;
-		float* cos_head = &cache_tmp->cos;
+//#define MAP_2_SIM_DEBUG
+#ifdef MAP_2_SIM_AVAILABLE
+/**
+ * Wartet auf dem MCU, bis der UART-Puffer Platz fuer ein Kommando hat
+ * \param payload	Groesse der Payload des Kommandos [Byte]
+ */
+static void map_2_sim_wait_uart(uint8_t payload) {
+#ifdef MCU
+	while (uart_outfifo.size - uart_outfifo.count < (uint8_t) (payload + sizeof(command_t))) {
+		os_thread_sleep(12);
+	}
 #else
-		float* sin_head = NULL;
-		float* cos_head = NULL;
-		if (cache_tmp->mode.data.border || cache_tmp->mode.data.distance) {
-			const float head = rad(cache_tmp->heading / 10.f);
-			float sin_tmp = sinf(head);
-			float cos_tmp = cosf(head);
-			sin_head = &sin_tmp;
-			cos_head = &cos_tmp;
+	(void) payload;
+#endif // MCU
+}
+
+#ifdef MAP_2_SIM_DELTA_AVAILABLE
+/**
+ * Sucht die zuletzt gesendete Version eines Blocks
+ * \param block		Blocknummer
+ * \param create	True: Eintrag anlegen (und dafuer den am laengsten nicht benutzten verdraengen), falls der Block fehlt
+ * \return			Zeiger auf die Daten des Blocks oder NULL, falls nicht vorhanden
+ */
+static uint8_t* map_2_sim_shadow_get(uint16_t block, uint8_t create) {
+	uint8_t i;
+	if (map_2_sim_shadow_reset) {
+		map_2_sim_shadow_reset = False;
+		for (i = 0; i < MAP_2_SIM_SHADOW_SIZE; ++i) {
+			map_2_sim_shadow_block[i] = MAP_CACHE_BLOCK_INVALID;
+			map_2_sim_shadow_lru[i] = i;
 		}
-#endif // MAP_USE_TRIG_CACHE
+	}
 
-		/* Abgrundsensoren updaten, falls border-mode */
-		if (cache_tmp->mode.data.border) {
-			update_border(cache_tmp->x_pos, cache_tmp->y_pos, *sin_head, *cos_head, cache_tmp->dataL, cache_tmp->dataR);
+	for (i = 0; i < MAP_2_SIM_SHADOW_SIZE; ++i) {
+		const uint8_t n = map_2_sim_shadow_lru[i];
+		if (map_2_sim_shadow_block[n] == block) {
+			memmove(&map_2_sim_shadow_lru[1], &map_2_sim_shadow_lru[0], i);
+			map_2_sim_shadow_lru[0] = n;
+			return map_2_sim_shadow[n];
 		}
+	}
+	if (! create) {
+		return NULL;
+	}
+
+	const uint8_t victim = map_2_sim_shadow_lru[MAP_2_SIM_SHADOW_SIZE - 1];
+	memmove(&map_2_sim_shadow_lru[1], &map_2_sim_shadow_lru[0], MAP_2_SIM_SHADOW_SIZE - 1);
+	map_2_sim_shadow_lru[0] = victim;
+	map_2_sim_shadow_block[victim] = block;
+	return map_2_sim_shadow[victim];
+}
 
-		else // border-mode schliesst distance-mode aus, weil Felder der Struktur gemeinsam verwendet werden
+/**
+ * Kodiert die Aenderungen eines Blocks ab Feld from in ein Delta-Kommando.
+ * Die Payload besteht aus MAP_2_SIM_DELTA_HEADER Byte (Bot-Position und -Ausrichtung) und Eintraegen der
+ * Form [skip, n, n Feldwerte]: skip Felder bleiben unveraendert, die folgenden n Felder erhalten die neuen Werte.
+ * Kurze unveraenderte Luecken werden mitgesendet, weil ein neuer Eintrag zwei Byte kostet.
+ * \param *p_new	aktueller Inhalt des Blocks
+ * \param *p_old	Inhalt des Blocks, den der Empfaenger hat
+ * \param from		erstes zu pruefendes Feld
+ * \param *p_start	Ausgabe: erstes Feld des Kommandos (-> data_r)
+ * \param *p_next	Ausgabe: erstes Feld, das nicht mehr in das Kommando gepasst hat
+ * \param *p_out	Puffer fuer die Payload (MAP_2_SIM_FRAME_SIZE Byte) oder NULL, um nur die Groesse zu ermitteln
+ * \return			Laenge der Payload [Byte], 0 falls ab from keine Aenderungen mehr vorliegen
+ */
+static uint8_t map_2_sim_delta_encode(const uint8_t* p_new, const uint8_t* p_old, uint16_t from, uint16_t* p_start, uint16_t* p_next,
+	uint8_t* p_out) {
+	uint16_t pos = from;
+	while (pos < MAP_BLOCK_SIZE && p_new[pos] == p_old[pos]) {
+		++pos;
+	}
+	*p_start = pos;
+	*p_next = MAP_BLOCK_SIZE;
+	if (pos == MAP_BLOCK_SIZE) {
+		return 0;
+	}
 
-		/* Strahlen updaten, falls distance-mode und der aktuelle Eintrag Daten dazu hat */
-		if (cache_tmp->mode.data.distance) {
-			update_distance(cache_tmp->x_pos, cache_tmp->y_pos, *sin_head, *cos_head, cache_tmp->dataL * 5, cache_tmp->dataR * 5, location_prob);
+	uint8_t length = MAP_2_SIM_DELTA_HEADER;
+	while (pos < MAP_BLOCK_SIZE) {
+		if (length > MAP_2_SIM_FRAME_SIZE - 3) {
+			*p_next = pos; // Kommando voll
+			break;
 		}
 
-		/* Falls Fifo leer, used-blocks zurueckschreiben und Sperre aufheben */
-		if (map_update_fifo.count == 0) {
-			if (min_max_updated == True) {
-				if (map_current_block.updated == True) {
-					/* letzten Block sichern */
-					if (sdfat_seek(map_file_desc, (int32_t) ((map_current_block.block + alignment_offset) * MAP_BLOCK_SIZE) + sizeof(map_header_t), SEEK_SET)) {
-						LOG_DEBUG("map_update_main(): sdfat_seek(0x%x) failed", map_current_block.block + alignment_offset);
-					}
-					if (sdfat_write(map_file_desc, map_buffer, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
-						LOG_DEBUG("map_update_main(): sdfat_write(0x%x) failed", map_current_block.block + alignment_offset);
-					}
-					map_current_block.updated = False;
-				}
+		/* unveraenderte Felder */
+		const uint16_t start = pos;
+		while (pos < MAP_BLOCK_SIZE && p_new[pos] == p_old[pos] && pos - start < 255) {
+			++pos;
+		}
+		if (pos == MAP_BLOCK_SIZE) {
+			break; // Rest unveraendert
+		}
+		const uint8_t skip = (uint8_t) (pos - start);
+
+		/* geaenderte Felder, Luecken bis zu 2 Feldern zaehlen mit */
+		const uint8_t max_count = (uint8_t) (MAP_2_SIM_FRAME_SIZE - 2 - length);
+		uint8_t count = 0;
+		uint8_t last_changed = 0;
+		while (pos + count < MAP_BLOCK_SIZE && count < max_count) {
+			if (p_new[pos + count] != p_old[pos + count]) {
+				last_changed = (uint8_t) (count + 1);
+			} else if (count >= last_changed + 2) {
+				break;
+			}
+			++count;
+		}
 
-				min_max_updated = False;
-				map_header_t* p_head_data = (map_header_t*) map_buffer;
-				sdfat_rewind(map_file_desc);
-				if (sdfat_read(map_file_desc, p_head_data, sizeof(map_header_t)) != sizeof(map_header_t)) {
-					LOG_DEBUG("map_update_main(): sdfat_read(header) failed");
-				}
-				/* Min- / Max-Werte speichern */
-				p_head_data->map_min_x = map_min_x;
-				p_head_data->map_max_x = map_max_x;
-				p_head_data->map_min_y = map_min_y;
-				p_head_data->map_max_y = map_max_y;
-				sdfat_rewind(map_file_desc);
-				if (sdfat_write(map_file_desc, p_head_data, sizeof(map_header_t)) != sizeof(map_header_t)) {
-					LOG_DEBUG("map_update_main(): sdfat_write(header) failed");
-				}
+		if (p_out) {
+			p_out[length] = skip;
+			p_out[length + 1] = last_changed;
+			memcpy(&p_out[length + 2], &p_new[pos], last_changed);
+		}
+		length = (uint8_t) (length + 2 + last_changed);
+		pos = (uint16_t) (pos + last_changed);
+	}
+	return length;
+}
 
-				/* letzen Block wieder laden */
-				if (sdfat_seek(map_file_desc, (int32_t) ((map_current_block.block + alignment_offset) * MAP_BLOCK_SIZE) + sizeof(map_header_t), SEEK_SET)) {
-					LOG_DEBUG("map_update_main(): sdfat_seek(0x%x) failed", map_current_block.block + alignment_offset);
-				}
-				if (sdfat_read(map_file_desc, map_buffer, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
-					LOG_DEBUG("map_update_main(): sdfat_read(0x%x) failed", map_current_block.block + alignment_offset);
-				}
-			}
+/**
+ * Sendet einen Block als Delta zur zuletzt gesendeten Version, falls das weniger Daten als der komplette Block sind
+ * \param block		Blocknummer
+ * \param *p_data	aktueller Inhalt des Blocks
+ * \return			True, falls das Delta gesendet wurde; False, falls der komplette Block gesendet werden muss
+ */
+static uint8_t map_2_sim_send_delta(uint16_t block, const uint8_t* p_data) {
+	uint8_t* p_old = map_2_sim_shadow_get(block, False);
+	if (! p_old) {
+		return False;
+	}
+
+	/* Groesse des Deltas ermitteln */
+	uint16_t size = 0;
+	uint16_t start, next = 0;
+	uint8_t length;
+	while ((length = map_2_sim_delta_encode(p_data, p_old, next, &start, &next, NULL)) > 0) {
+		size = (uint16_t) (size + length + sizeof(command_t));
+	}
+	if (size >= 4 * (MAP_2_SIM_FRAME_SIZE + sizeof(command_t))) {
+		return False;
+	}
+
+	next = 0;
+	while ((length = map_2_sim_delta_encode(p_data, p_old, next, &start, &next, map_2_sim_frame)) > 0) {
+		memcpy(&map_2_sim_frame[0], &map_2_sim_data.pos.x, sizeof(int16_t));
+		memcpy(&map_2_sim_frame[2], &map_2_sim_data.pos.y, sizeof(int16_t));
+		memcpy(&map_2_sim_frame[4], &map_2_sim_data.heading, sizeof(int16_t));
+		map_2_sim_wait_uart(length);
+		command_write_rawdata(CMD_MAP, SUB_MAP_DELTA, (int16_t) block, (int16_t) start, length, map_2_sim_frame);
+		map_2_sim_stats.bytes += length;
+	}
+	memcpy(p_old, p_data, MAP_BLOCK_SIZE);
+	++map_2_sim_stats.delta;
+	return True;
+}
+#endif // MAP_2_SIM_DELTA_AVAILABLE
+
+/**
+ * Kopiert den aktuellen Inhalt eines Blocks nach map_2_sim_buffer: aus dem Block-Cache, falls der Block dort steht,
+ * sonst aus der Kartendatei (verdraengte Bloecke sind dort bereits zurueckgeschrieben)
+ * \param block	Blocknummer
+ * \return		0 falls kein Fehler, sonst Fehlercode
+ */
+static uint8_t map_2_sim_read_block(uint16_t block) {
+	uint8_t result = 0;
+	os_signal_lock(&lock_signal);
+	const map_block_cache_t* p_entry = NULL;
+	uint8_t i;
+	for (i = 0; i < MAP_BLOCK_CACHE_SIZE; ++i) {
+		if (map_block_cache[i].block == block) {
+			p_entry = &map_block_cache[i];
+			break;
 		}
-		os_signal_unlock(&lock_signal); // Zugriff auf Map wieder freigeben
 	}
+#ifdef MAP_MMAP_AVAILABLE
+	if (map_mmap) {
+		memcpy(map_2_sim_buffer, &map_mmap[((uint32_t) block + alignment_offset) * MAP_BLOCK_SIZE + sizeof(map_header_t)], MAP_BLOCK_SIZE);
+	} else
+#endif // MAP_MMAP_AVAILABLE
+	if (p_entry) {
+		memcpy(map_2_sim_buffer, get_block_data(p_entry), MAP_BLOCK_SIZE);
+	} else if (sdfat_seek(map_2_sim_file_desc, ((int32_t) block + (int32_t) alignment_offset) * MAP_BLOCK_SIZE + sizeof(map_header_t), SEEK_SET)) {
+		LOG_DEBUG("map_2_sim_read_block(): sdfat_seek(0x%x) failed", block + alignment_offset);
+		result = 1;
+	} else if (sdfat_read(map_2_sim_file_desc, map_2_sim_buffer, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
+		LOG_DEBUG("map_2_sim_read_block(): sdfat_read(0x%x) failed", block + alignment_offset);
+		result = 2;
+	}
+	os_signal_unlock(&lock_signal);
+	return result;
 }
 
-//#define MAP_2_SIM_DEBUG
-#ifdef MAP_2_SIM_AVAILABLE
 /**
  * Main-Funktion des Map-2-Sim-Threads
  */
@@ -1443,42 +2459,30 @@ void map_2_sim_main(void) {
 				}
 				/* Block nicht gefunden -> wurde noch nicht gesendet, also jetzt senden */
 //				printf("sende Block %u\n", block);
-				if (sdfat_seek(map_2_sim_file_desc, ((int32_t) block + (int32_t) alignment_offset) * MAP_BLOCK_SIZE + sizeof(map_header_t), SEEK_SET)) {
-					LOG_DEBUG("map_2_sim_main(): sdfat_seek(0x%x) failed", block + alignment_offset);
+				if (map_2_sim_read_block((uint16_t) block)) {
 					continue;
 				}
-				if (sdfat_read(map_2_sim_file_desc, map_2_sim_buffer, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
-					LOG_DEBUG("map_2_sim_main(): sdfat_read(0x%x) failed", block + alignment_offset);
+
+#ifdef MAP_2_SIM_DELTA_AVAILABLE
+				if (map_2_sim_send_delta((uint16_t) block, map_2_sim_buffer)) {
 					continue;
 				}
+#endif // MAP_2_SIM_DELTA_AVAILABLE
 
-#ifdef MCU
-				while (uart_outfifo.size - uart_outfifo.count < (uint8_t) (128U + sizeof(command_t))) {
-					os_thread_sleep(12);
-				}
-#endif
+				map_2_sim_wait_uart(128);
 				command_write_rawdata(CMD_MAP, SUB_MAP_DATA_1, block, map_2_sim_data.pos.x, 128, map_2_sim_buffer);
-
-#ifdef MCU
-				while (uart_outfifo.size - uart_outfifo.count < (uint8_t) (128U + sizeof(command_t))) {
-					os_thread_sleep(12);
-				}
-#endif
+				map_2_sim_wait_uart(128);
 				command_write_rawdata(CMD_MAP, SUB_MAP_DATA_2, block, map_2_sim_data.pos.y, 128, &map_2_sim_buffer[128]);
-
-#ifdef MCU
-				while (uart_outfifo.size - uart_outfifo.count < (uint8_t) (128U + sizeof(command_t))) {
-					os_thread_sleep(12);
-				}
-#endif
+				map_2_sim_wait_uart(128);
 				command_write_rawdata(CMD_MAP, SUB_MAP_DATA_3, block, map_2_sim_data.heading, 128, &map_2_sim_buffer[256]);
-
-#ifdef MCU
-				while (uart_outfifo.size - uart_outfifo.count < (uint8_t) (128U + sizeof(command_t))) {
-					os_thread_sleep(12);
-				}
-#endif
+				map_2_sim_wait_uart(128);
 				command_write_rawdata(CMD_MAP, SUB_MAP_DATA_4, block, 0, 128, &map_2_sim_buffer[384]);
+
+#ifdef MAP_2_SIM_DELTA_AVAILABLE
+				memcpy(map_2_sim_shadow_get((uint16_t) block, True), map_2_sim_buffer, MAP_BLOCK_SIZE);
+				map_2_sim_stats.bytes += 4 * 128;
+				++map_2_sim_stats.full;
+#endif // MAP_2_SIM_DELTA_AVAILABLE
 			}
 		}
 #ifdef MEASURE_POSITION_ERRORS_AVAILABLE
@@ -1497,6 +2501,10 @@ void map_2_sim_send(void) {
 	map_flush_cache();
 	os_signal_lock(&lock_signal);
 	os_signal_lock(&map_2_sim_signal);
+#ifdef MAP_2_SIM_DELTA_AVAILABLE
+	/* Deltas der vorherigen Uebertragungen passen nicht mehr zur neuen Karte des Sim */
+	map_2_sim_shadow_reset = True;
+#endif
 
 	/* Belegte Bloecke uebertragen */
 	int16_t x, y;
@@ -1506,12 +2514,23 @@ void map_2_sim_send(void) {
 	}
 	for (x = map_min_x; x < max_x; x += MAP_SECTION_POINTS * 2) { // in einem Block liegen 2 Sections in x-Richtung aneinander
 		for (y = map_min_y; y <= map_max_y; y += MAP_SECTION_POINTS) {
-			access_field(x, y, 0, 0); // Block in Puffer laden
-			const int16_t block = (int16_t) map_current_block.block;
-			command_write_rawdata(CMD_MAP, SUB_MAP_DATA_1, block, map_2_sim_data.pos.x, 128, map_buffer);
-			command_write_rawdata(CMD_MAP, SUB_MAP_DATA_2, block, map_2_sim_data.pos.y, 128, &map_buffer[128]);
-			command_write_rawdata(CMD_MAP, SUB_MAP_DATA_3, block, map_2_sim_data.heading, 128, &map_buffer[256]);
-			command_write_rawdata(CMD_MAP, SUB_MAP_DATA_4, block, 0, 128, &map_buffer[384]);
+			if (! get_section(x, y)) { // Block in Cache laden
+				continue;
+			}
+			const int16_t block = (int16_t) map_current_block->block;
+			const uint8_t* p_buffer = get_block_data(map_current_block);
+#ifdef MAP_2_SIM_DELTA_AVAILABLE
+			/* der Sim hat seine Karte geleert, leere Bloecke muessen nicht uebertragen werden */
+			uint16_t i;
+			for (i = 0; i < MAP_BLOCK_SIZE && p_buffer[i] == 0; ++i) {}
+			if (i == MAP_BLOCK_SIZE) {
+				continue;
+			}
+#endif // MAP_2_SIM_DELTA_AVAILABLE
+			command_write_rawdata(CMD_MAP, SUB_MAP_DATA_1, block, map_2_sim_data.pos.x, 128, p_buffer);
+			command_write_rawdata(CMD_MAP, SUB_MAP_DATA_2, block, map_2_sim_data.pos.y, 128, &p_buffer[128]);
+			command_write_rawdata(CMD_MAP, SUB_MAP_DATA_3, block, map_2_sim_data.heading, 128, &p_buffer[256]);
+			command_write_rawdata(CMD_MAP, SUB_MAP_DATA_4, block, 0, 128, &p_buffer[384]);
 		}
 	}
 
@@ -1539,12 +2558,7 @@ static void delete(void) {
 	os_signal_lock(&lock_signal);
 
 	/* alle Felder zuruecksetzen */
-	int16_t x, y;
-	for (x = map_min_x; x < map_max_x; ++x) {
-		for (y = map_min_y; y < map_max_y; ++y) {
-			access_field(x, y, 0, 1);
-		}
-	}
+	clear_sections(False);
 
 	/* Groesse neu initialisieren */
 	map_min_x = (int16_t) (MAP_SIZE * MAP_RESOLUTION / 2);
@@ -1570,15 +2584,7 @@ void map_clean(void) {
 	os_signal_lock(&lock_signal);
 
 	/* Alle positiven Werte auf 0 setzen */
-	int16_t x, y;
-	for (x = map_min_x; x < map_max_x; ++x) {
-		for (y = map_min_y; y < map_max_y; ++y) {
-			int8_t tmp = access_field(x, y, 0, 0);
-			if (tmp > 0) {
-				access_field(x, y, 0, 1);
-			}
-		}
-	}
+	clear_sections(True);
 
 	os_signal_unlock(&lock_signal);
 
@@ -1588,7 +2594,7 @@ void map_clean(void) {
 }
 
 /**
- * Exportiert die aktuelle Karte in eine Datei
+ * Exportiert die aktuelle Karte in eine Datei im Sparse-Format (siehe map_header_t)
  * \param *file Name der Zieldatei (wird geloescht, falls sie schon existiert)
  * \return 0 falls kein Fehler, sonst Fehlercode
  */
@@ -1610,27 +2616,62 @@ int8_t map_save_to_file(const char* file) {
 		return 1;
 	}
 
-	const uint32_t size = sdfat_get_filesize(map_file_desc) / MAP_BLOCK_SIZE;
-	LOG_INFO("map_save_to_file(): size=0x%" PRIx32 " blocks", (uint32_t) (size - alignment_offset - sizeof(map_header_t) / MAP_BLOCK_SIZE));
-	sdfat_rewind(map_file_desc);
-	uint32_t i;
-	for (i = 0; i < size; ++i) {
-		if (sdfat_read(map_file_desc, map_buffer, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
-			LOG_ERROR("map_save_to_file(): sdfat_read() failed, i=0x%" PRIx32, i);
-			return 2;
-		}
-		if (sdfat_write(dest, map_buffer, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
-			LOG_ERROR("map_save_to_file(): sdfat_write() failed, i=0x%" PRIx32, i);
-			return 3;
+	/* map_buffer wird als Zwischenspeicher benutzt; seit map_flush_cache() veraenderte Bloecke vorher zurueckschreiben */
+	os_signal_lock(&lock_signal);
+	write_back_cache();
+	invalidate_cache();
+
+	map_header_t* p_head_buffer = (map_header_t*) map_buffer;
+	memset(p_head_buffer, 0, sizeof(map_header_t));
+	p_head_buffer->map_min_x = map_min_x;
+	p_head_buffer->map_max_x = map_max_x;
+	p_head_buffer->map_min_y = map_min_y;
+	p_head_buffer->map_max_y = map_max_y;
+	p_head_buffer->magic = MAP_SPARSE_MAGIC;
+	if (sdfat_write(dest, p_head_buffer, sizeof(map_header_t)) != sizeof(map_header_t)) {
+		LOG_ERROR("map_save_to_file(): sdfat_write(head) failed");
+		sdfat_close(dest);
+		os_signal_unlock(&lock_signal);
+		return 2;
+	}
+
+	/* nicht leere Bloecke des belegten Bereichs in Speicherreihenfolge mit ihrer Blocknummer schreiben */
+	uint16_t blocks = 0;
+	int16_t x, y;
+	for (y = map_min_y & ~(MAP_SECTION_POINTS - 1); y <= map_max_y; y += MAP_SECTION_POINTS) {
+		for (x = map_min_x & ~(MAP_SECTION_POINTS * 2 - 1); x <= map_max_x; x += MAP_SECTION_POINTS * 2) {
+			const uint8_t* p_data = (const uint8_t*) get_section(x, y); // erste Section des Blocks
+			if (! p_data) {
+				continue;
+			}
+			uint16_t i;
+			for (i = 0; i < MAP_BLOCK_SIZE && p_data[i] == 0; ++i) {}
+			if (i == MAP_BLOCK_SIZE) {
+				continue; // leer
+			}
+			const uint16_t block = get_block(x, y);
+			if (sdfat_write(dest, &block, sizeof(block)) != sizeof(block) || sdfat_write(dest, p_data, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
+				LOG_ERROR("map_save_to_file(): sdfat_write() failed, block=0x%x", block);
+				sdfat_close(dest);
+				os_signal_unlock(&lock_signal);
+				return 3;
+			}
+			++blocks;
 		}
 	}
+	invalidate_cache();
+	os_signal_unlock(&lock_signal);
+	LOG_INFO("map_save_to_file(): %u Bloecke geschrieben", blocks);
 
-	/* aktuellen Block wieder laden */
-	if (sdfat_seek(map_file_desc, (int32_t) ((map_current_block.block + alignment_offset) * MAP_BLOCK_SIZE) + sizeof(map_header_t), SEEK_SET)) {
-		LOG_DEBUG("map_load_from_file(): sdfat_seek(0x%x) failed", map_current_block.block + alignment_offset);
+	/* Anzahl der Bloecke im Header nachtragen */
+	if (sdfat_seek(dest, (int32_t) offsetof(map_header_t, blocks), SEEK_SET) || sdfat_write(dest, &blocks, sizeof(blocks)) != sizeof(blocks)) {
+		LOG_ERROR("map_save_to_file(): sdfat_write(blocks) failed");
+		sdfat_close(dest);
+		return 3;
 	}
-	if (sdfat_read(map_file_desc, map_buffer, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
-		LOG_DEBUG("map_load_from_file(): sdfat_read(0x%x) failed", map_current_block.block + alignment_offset);
+
+	if (sdfat_close(dest)) {
+		LOG_ERROR("map_save_to_file(): sdfat_close() failed");
 		return 4;
 	}
 
@@ -1638,44 +2679,21 @@ int8_t map_save_to_file(const char* file) {
 }
 
 /**
- * Laedt die Karte aus einer Datei, die aktuelle Karte wird dadurch geloescht
- * \param *file Name der zu ladenden Datei
- * \return 0 falls kein Fehler, sonst Fehlercode
+ * Kopiert eine Kartendatei in die Map-Datei, die Karte muss gesperrt und der Block-Cache leer sein
+ * \param src_file	Quelldatei, im Sparse-Format oder als vollstaendige Kartendatei
+ * \return			0 falls kein Fehler, sonst Fehlercode von map_load_from_file()
  */
-int8_t map_load_from_file(const char* file) {
-	LOG_INFO("map_load_from_file(): Lese Karte aus Datei \"%s\" ein...", file);
-
-	if (strcmp(file, MAP_FILENAME) == 0) {
-		return 0;
-	}
-
-	/* warten bis Karte frei ist */
-	LOG_DEBUG("map_load_from_file(): waiting for lock...");
-	map_flush_cache();
-	LOG_DEBUG("map_load_from_file(): map_flush_cache() done.");
-
-	/* Quelldatei oeffnen */
-	pFatFile src_file;
-	uint8_t res = sdfat_open(file, &src_file, SDFAT_O_READ);
-	if (res) {
-		LOG_DEBUG("map_load_from_file(): sdfat_open(\"%s\")=%u", file, res);
-		LOG_ERROR("map_load_from_file(): sdfat_open() failed");
-		return 1;
-	}
-
-	/* Map loeschen */
-	delete();
-
-	os_signal_lock(&lock_signal);
+static int8_t copy_from_file(pFatFile src_file) {
 	map_header_t* p_head_buffer = (map_header_t*) map_buffer;
 	if (sdfat_read(src_file, p_head_buffer, sizeof(map_header_t)) != sizeof(map_header_t)) {
 		LOG_ERROR("map_load_from_file(): sdfat_read(head) failed");
-		sdfat_close(src_file);
 		return 3;
 	}
 
+	const uint8_t sparse = p_head_buffer->magic == MAP_SPARSE_MAGIC;
+	const uint16_t sparse_blocks = p_head_buffer->blocks;
 	uint16_t src_alignment_offset = p_head_buffer->alignment_offset;
-	LOG_INFO("map_load_from_file(): src_alignment_offset=0x%x", src_alignment_offset);
+	LOG_INFO("map_load_from_file(): sparse=%u, src_alignment_offset=0x%x", sparse, src_alignment_offset);
 
 	/* Groesse aus Quelle initialisieren */
 	map_min_x = p_head_buffer->map_min_x;
@@ -1685,67 +2703,118 @@ int8_t map_load_from_file(const char* file) {
 	LOG_INFO("map_load_from_file(): min_x=%u, max_x=%u, min_y=%u, max_y=%u", map_min_x, map_max_x, map_min_y, map_max_y);
 
 	p_head_buffer->alignment_offset = alignment_offset;
+	p_head_buffer->magic = 0;
+	p_head_buffer->blocks = 0;
 	sdfat_rewind(map_file_desc);
 	if (sdfat_write(map_file_desc, p_head_buffer, sizeof(map_header_t)) != sizeof(map_header_t)) {
 		LOG_ERROR("map_load_from_file(): sdfat_write(head) failed");
-		sdfat_close(src_file);
-		os_signal_unlock(&lock_signal);
 		return 4;
 	}
 	min_max_updated = False;
 
-	/* Quelldatei nach Map-Datei kopieren */
-	const uint32_t size = sdfat_get_filesize(src_file) / MAP_BLOCK_SIZE - src_alignment_offset - sizeof(map_header_t) / MAP_BLOCK_SIZE;
+	uint32_t i;
+	if (sparse) {
+		/* nur die gespeicherten Bloecke schreiben, alle anderen sind leer */
+		for (i = 0; i < sparse_blocks; ++i) {
+			uint16_t block;
+			if (sdfat_read(src_file, &block, sizeof(block)) != sizeof(block) || sdfat_read(src_file, map_buffer, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
+				LOG_ERROR("map_load_from_file(): sdfat_read() failed, i=0x%" PRIx32, i);
+				return 7;
+			}
+			if (block >= MAP_FILE_SIZE) {
+				LOG_ERROR("map_load_from_file(): ungueltiger Block 0x%x", block);
+				return 9;
+			}
+			if (sdfat_seek(map_file_desc, (int32_t) ((block + alignment_offset) * MAP_BLOCK_SIZE) + sizeof(map_header_t), SEEK_SET)
+				|| sdfat_write(map_file_desc, map_buffer, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
+				LOG_ERROR("map_load_from_file(): sdfat_write() failed, block=0x%x", block);
+				return 8;
+			}
+		}
+		LOG_INFO("map_load_from_file(): %u Bloecke gelesen", sparse_blocks);
+	} else {
+		/* vollstaendige Kartendatei: Quelldatei nach Map-Datei kopieren */
+		const uint32_t size = sdfat_get_filesize(src_file) / MAP_BLOCK_SIZE - src_alignment_offset - sizeof(map_header_t) / MAP_BLOCK_SIZE;
 
-	if (sdfat_seek(src_file, src_alignment_offset * MAP_BLOCK_SIZE + sizeof(map_header_t), SEEK_SET)) {
-		LOG_ERROR("map_load_from_file(): sdfat_seek(0x%" PRIx32 ") failed", (uint32_t) (src_alignment_offset * MAP_BLOCK_SIZE + sizeof(map_header_t)));
-		sdfat_close(src_file);
-		os_signal_unlock(&lock_signal);
-		return 5;
-	}
+		if (sdfat_seek(src_file, src_alignment_offset * MAP_BLOCK_SIZE + sizeof(map_header_t), SEEK_SET)) {
+			LOG_ERROR("map_load_from_file(): sdfat_seek(0x%" PRIx32 ") failed", (uint32_t) (src_alignment_offset * MAP_BLOCK_SIZE + sizeof(map_header_t)));
+			return 5;
+		}
 
-	if (sdfat_seek(map_file_desc, alignment_offset * MAP_BLOCK_SIZE + sizeof(map_header_t), SEEK_SET)) {
-		LOG_ERROR("map_load_from_file(): sdfat_seek(0x%" PRIx32 ") failed", (uint32_t) (alignment_offset * MAP_BLOCK_SIZE + sizeof(map_header_t)));
-		sdfat_close(src_file);
-		os_signal_unlock(&lock_signal);
-		return 6;
-	}
+		if (sdfat_seek(map_file_desc, alignment_offset * MAP_BLOCK_SIZE + sizeof(map_header_t), SEEK_SET)) {
+			LOG_ERROR("map_load_from_file(): sdfat_seek(0x%" PRIx32 ") failed", (uint32_t) (alignment_offset * MAP_BLOCK_SIZE + sizeof(map_header_t)));
+			return 6;
+		}
 
-	uint32_t i;
-	for (i = 0; i < size; ++i) {
-		if (sdfat_read(src_file, map_buffer, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
-			LOG_ERROR("map_load_from_file(): sdfat_read() failed, i=0x%" PRIx32, i);
-			sdfat_close(src_file);
-			os_signal_unlock(&lock_signal);
-			return 7;
-		}
-		if (sdfat_write(map_file_desc, map_buffer, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
-			LOG_ERROR("map_load_from_file(): sdfat_write() failed, i=0x%" PRIx32, i);
-			sdfat_close(src_file);
-			os_signal_unlock(&lock_signal);
-			return 8;
+		for (i = 0; i < size; ++i) {
+			if (sdfat_read(src_file, map_buffer, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
+				LOG_ERROR("map_load_from_file(): sdfat_read() failed, i=0x%" PRIx32, i);
+				return 7;
+			}
+			if (sdfat_write(map_file_desc, map_buffer, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
+				LOG_ERROR("map_load_from_file(): sdfat_write() failed, i=0x%" PRIx32, i);
+				return 8;
+			}
 		}
+		LOG_INFO("map_load_from_file(): filesize=0x%" PRIx32 " blocks", size);
 	}
+	return 0;
+}
 
-	LOG_INFO("map_load_from_file(): filesize=0x%" PRIx32 " blocks", size);
-	sdfat_close(src_file);
-
-	map_current_block.updated = False;
-	map_current_block.block = 0;
+/**
+ * Laedt die Karte aus einer Datei, die aktuelle Karte wird dadurch geloescht
+ * \param *file Name der zu ladenden Datei, im Sparse-Format oder als vollstaendige Kartendatei
+ * \return 0 falls kein Fehler, sonst Fehlercode
+ */
+int8_t map_load_from_file(const char* file) {
+	LOG_INFO("map_load_from_file(): Lese Karte aus Datei \"%s\" ein...", file);
 
-	/* Block 0 laden */
-	if (sdfat_seek(map_file_desc, (int32_t) ((map_current_block.block + alignment_offset) * MAP_BLOCK_SIZE) + sizeof(map_header_t), SEEK_SET)) {
-		LOG_DEBUG("map_load_from_file(): sdfat_seek(0x%x) failed", map_current_block.block + alignment_offset);
-		os_signal_unlock(&lock_signal);
-		return 9;
+	if (strcmp(file, MAP_FILENAME) == 0) {
+		return 0;
 	}
-	if (sdfat_read(map_file_desc, map_buffer, MAP_BLOCK_SIZE) != MAP_BLOCK_SIZE) {
-		LOG_ERROR("map_load_from_file(): sdfat_read(0x%x) failed", map_current_block.block + alignment_offset);
-		os_signal_unlock(&lock_signal);
-		return 10;
+
+	/* warten bis Karte frei ist */
+	LOG_DEBUG("map_load_from_file(): waiting for lock...");
+	map_flush_cache();
+	LOG_DEBUG("map_load_from_file(): map_flush_cache() done.");
+
+	/* Quelldatei oeffnen */
+	pFatFile src_file;
+	uint8_t res = sdfat_open(file, &src_file, SDFAT_O_READ);
+	if (res) {
+		LOG_DEBUG("map_load_from_file(): sdfat_open(\"%s\")=%u", file, res);
+		LOG_ERROR("map_load_from_file(): sdfat_open() failed");
+		return 1;
 	}
 
+	/* Map loeschen, ausserhalb des belegten Bereichs ist sie danach leer */
+	delete();
+
+	os_signal_lock(&lock_signal);
+	/* map_buffer wird als Zwischenspeicher benutzt, Inhalt des Caches wird ohnehin ersetzt */
+	write_back_cache();
+	invalidate_cache();
+#ifdef MAP_MMAP_AVAILABLE
+	/* Map-Datei wird per sdfat_write() ersetzt, danach neu einblenden */
+	mmap_close();
+#endif
+	const int8_t result = copy_from_file(src_file);
+	sdfat_close(src_file);
+	sdfat_flush(map_file_desc); // Mapping sieht die Daten erst nach dem Flush
+#ifdef MAP_MMAP_AVAILABLE
+	mmap_open();
+#endif
+
+	/* Bloecke werden bei Bedarf aus der neuen Karte geladen */
+	invalidate_cache();
+#ifdef MAP_SUMMARY_AVAILABLE
+	summary_reset();
+#endif
+
 	os_signal_unlock(&lock_signal);
+	if (result) {
+		return result;
+	}
 
 #if defined PC && defined MAP_2_SIM_AVAILABLE
 	map_2_sim_send();
@@ -1878,7 +2947,10 @@ void shrink(int16_t* min_x, int16_t* max_x, int16_t* min_y, int16_t* max_y) {
 }
 
 /**
- * Schreibt eine Karte in eine PGM-Datei
+ * Schreibt eine Karte in eine PGM-Datei.
+ * Die Karte wird in Speicherreihenfolge gelesen: fuer jedes Band aus MAP_SECTION_POINTS Zeilen
+ * werden die (spaltenweise abgelegten) Sections nacheinander in einen Zeilenpuffer transponiert,
+ * der dann mit einem fwrite() an seine Position in der Datei geschrieben wird.
  * \param *filename Zieldatei
  */
 void map_to_pgm(const char* filename) {
@@ -1899,52 +2971,120 @@ void map_to_pgm(const char* filename) {
 	int16_t map_size_y = max_y - min_y;
 #ifdef MAP_PRINT_SCALE
 	fprintf(fp, "P5 %d %d 255 ", map_size_x + 10, map_size_y + 10);
+	const size_t row_len = (size_t) map_size_x + 10;
 #else
 	fprintf(fp,"P5 %d %d 255 ", map_size_x, map_size_y);
+	const size_t row_len = (size_t) map_size_x;
 #endif // MAP_PRINT_SCALE
 	LOG_INFO("map_to_pgm(): Karte beginnt bei X=%d,Y=%d und geht bis X=%d,Y=%d (%d * %d Punkte)", min_x, min_y, max_x, max_y, map_size_x, map_size_y);
+	const long data_start = ftell(fp);
+
+	/* Zeilenpuffer fuer ein Band, Zeile 0 ist die oberste */
+	uint8_t* tile = malloc(MAP_SECTION_POINTS * row_len);
+	if (tile == NULL) {
+		LOG_ERROR("map_to_pgm(): Kein Speicher fuer Zeilenpuffer, Abbruch");
+		fclose(fp);
+		return;
+	}
 
 	/* warten bis Karte frei ist */
 	map_flush_cache();
 	os_signal_lock(&lock_signal);
 
-	uint8_t tmp;
-	int16_t x, y;
-	for (y = max_y; y > min_y; y--) {
-		for (x = min_x; x < max_x; ++x) {
-			tmp = (uint8_t) (access_field(x, y - 1, 0, 0) + 128);
-			fwrite(&tmp, 1, 1, fp);
+	int16_t x, y, band;
+	for (band = min_y & ~(MAP_SECTION_POINTS - 1); band < max_y; band += MAP_SECTION_POINTS) {
+		const int16_t y_lo = band < min_y ? min_y : band;
+		const int16_t y_hi = band + MAP_SECTION_POINTS < max_y ? band + MAP_SECTION_POINTS : max_y; // exklusiv
+
+		/* Sections von links nach rechts, immer zwei hintereinander liegen im selben Block */
+		for (x = min_x & ~(MAP_SECTION_POINTS - 1); x < max_x; x += MAP_SECTION_POINTS) {
+			const map_section_t* p_section = get_section(x, band);
+			const int16_t x_lo = x < min_x ? min_x : x;
+			const int16_t x_hi = x + MAP_SECTION_POINTS < max_x ? x + MAP_SECTION_POINTS : max_x; // exklusiv
+			int16_t i;
+			for (i = x_lo; i < x_hi; ++i) {
+				const int8_t* p_column = p_section ? p_section->section[(uint16_t) i % MAP_SECTION_POINTS] : NULL;
+				uint8_t* p_dest = &tile[(size_t) (y_hi - 1 - y_lo) * row_len + (size_t) (i - min_x)];
+				for (y = y_lo; y < y_hi; ++y) {
+					*p_dest = (uint8_t) ((p_column ? p_column[(uint16_t) y % MAP_SECTION_POINTS] : 0) + 128);
+					p_dest -= row_len;
+				}
+			}
 		}
 
 #ifdef MAP_PRINT_SCALE
 		// und noch schnell ne Skala basteln
-		for (x = 0; x < 10; ++x) {
-			if (y % MAP_SCALE == 0) {
-				tmp = 0;
-			} else {
-				tmp = 255;
-			}
-			fwrite(&tmp, 1, 1, fp);
+		for (y = y_lo; y < y_hi; ++y) {
+			memset(&tile[(size_t) (y_hi - 1 - y) * row_len + (size_t) map_size_x], (y + 1) % MAP_SCALE == 0 ? 0 : 255, 10);
 		}
 #endif // MAP_PRINT_SCALE
+
+		fseek(fp, data_start + (long) (max_y - y_hi) * (long) row_len, SEEK_SET);
+		fwrite(tile, row_len, (size_t) (y_hi - y_lo), fp);
 	}
 	os_signal_unlock(&lock_signal);
 
 #ifdef MAP_PRINT_SCALE
+	fseek(fp, data_start + (long) map_size_y * (long) row_len, SEEK_SET);
+	for (x = min_x; x < max_x + 10; ++x) {
+		tile[x - min_x] = x % MAP_SCALE == 0 ? 0 : 255;
+	}
 	for (y = 0; y < 10; ++y) {
-		for (x = min_x; x < max_x + 10; ++x) {
-			if (x % MAP_SCALE == 0) {
-				tmp = 0;
-			} else {
-				tmp = 255;
-			}
-			fwrite(&tmp, 1, 1, fp);
-		}
+		fwrite(tile, row_len, 1, fp);
 	}
 #endif // MAP_PRINT_SCALE
+	free(tile);
 	fclose(fp);
 }
 
+/**
+ * Loescht die komplette Karte
+ */
+void map_delete(void) {
+	delete();
+}
+
+/**
+ * Setzt den Wert eines Feldes der Karte
+ * \param x		X-Ordinate der Karte
+ * \param y		Y-Ordinate der Karte
+ * \param value	Neuer Wert des Feldes (> 0 heisst frei, <0 heisst belegt)
+ */
+void map_set_field(int16_t x, int16_t y, int8_t value) {
+	os_signal_lock(&lock_signal);
+	access_field(x, y, value, 1);
+	os_signal_unlock(&lock_signal);
+}
+
+/**
+ * Traegt die Messung beider Distanzsensoren wie der Map-Update-Thread in die Karte ein
+ * \param x			X-Achse der Position in Weltkoordinaten
+ * \param y			Y-Achse der Position in Weltkoordinaten
+ * \param sin_head	sin(Blickrichtung) in Q1.14
+ * \param cos_head	cos(Blickrichtung) in Q1.14
+ * \param distL		Sensorwert links
+ * \param distR		Sensorwert rechts
+ */
+void map_update_sensor_distance(int16_t x, int16_t y, int16_t sin_head, int16_t cos_head, int16_t distL, int16_t distR) {
+	os_signal_lock(&lock_signal);
+	update_distance(x, y, sin_head, cos_head, distL, distR, 255);
+	os_signal_unlock(&lock_signal);
+}
+
+/**
+ * Traegt einen Sensorstrahl mit bereits berechneten Endpunkten in die Karte ein
+ * \param x		X-Achse der Position des Sensors in Weltkoordinaten
+ * \param y		Y-Achse der Position des Sensors in Weltkoordinaten
+ * \param end_x	X-Achse des Strahlendes in Weltkoordinaten
+ * \param end_y	Y-Achse des Strahlendes in Weltkoordinaten
+ * \param dist	Sensorwert
+ */
+void map_update_sensor_ray(int16_t x, int16_t y, int16_t end_x, int16_t end_y, int16_t dist) {
+	os_signal_lock(&lock_signal);
+	update_sensor_ray(world_to_map(x), world_to_map(y), world_to_map(end_x), world_to_map(end_y), dist, 255);
+	os_signal_unlock(&lock_signal);
+}
+
 #ifdef MAP_TESTS_AVAILABLE
 /**
  * Testet die Funktion map_get_ratio()
@@ -2063,6 +3203,25 @@ static void info(void) {
 	LOG_INFO("%u\t Laenge eine Macroblocks in Punkten (MACRO_BLOCK_LENGTH)", MACRO_BLOCK_LENGTH);
 	LOG_INFO("%u\t Anzahl der Macroblocks in einer Zeile (MAP_LENGTH_IN_MACRO_BLOCKS)", MAP_LENGTH_IN_MACRO_BLOCKS);
 	LOG_INFO("alignment_offset=0x%" PRIx16, alignment_offset);
+
+	LOG_INFO("%u\t Bloecke im Block-Cache (MAP_BLOCK_CACHE_SIZE)", MAP_BLOCK_CACHE_SIZE);
+#ifdef MAP_MMAP_AVAILABLE
+	LOG_INFO("Kartendatei %s eingeblendet", map_mmap ? "ist" : "ist nicht");
+#endif
+#ifdef MAP_CACHE_STATS_AVAILABLE
+	LOG_INFO("%" PRIu32 "\t Treffer im Block-Cache", map_cache_stats.hits);
+	LOG_INFO("%" PRIu32 "\t Fehlzugriffe im Block-Cache", map_cache_stats.misses);
+	LOG_INFO("%" PRIu32 "\t verdraengte Bloecke", map_cache_stats.evictions);
+	LOG_INFO("%" PRIu32 "\t zurueckgeschriebene Bloecke", map_cache_stats.writebacks);
+#endif // MAP_CACHE_STATS_AVAILABLE
+#ifdef BEHAVIOUR_SCAN_AVAILABLE
+	LOG_INFO("%u\t mal angehalten wegen vollem Map-Cache", scan_otf_halt_count);
+#endif
+#ifdef MAP_2_SIM_DELTA_AVAILABLE
+	LOG_INFO("%" PRIu32 "\t Bloecke komplett an den Sim gesendet", map_2_sim_stats.full);
+	LOG_INFO("%" PRIu32 "\t Bloecke als Delta an den Sim gesendet", map_2_sim_stats.delta);
+	LOG_INFO("%" PRIu32 "\t Byte Map-Daten an den Sim gesendet", map_2_sim_stats.bytes);
+#endif
 }
 #endif // MAP_INFO_AVAILABLE
 
@@ -93,6 +93,50 @@ int32_t get_dist(int16_t x1, int16_t y1, int16_t x2, int16_t y2) {
 	return (int32_t) ((int32_t) xt * (int32_t) xt) + (int32_t) ((int32_t) yt * (int32_t) yt);
 }
 
+/** sin(0..90 Grad) in 1 Grad Schritten, Q1.14 */
+static const int16_t sin_table[91] PROGMEM = {
+	    0,   286,   572,   857,  1143,  1428,  1713,  1997,  2280,  2563,
+	 2845,  3126,  3406,  3686,  3964,  4240,  4516,  4790,  5063,  5334,
+	 5604,  5872,  6138,  6402,  6664,  6924,  7182,  7438,  7692,  7943,
+	 8192,  8438,  8682,  8923,  9162,  9397,  9630,  9860, 10087, 10311,
+	10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982, 12176, 12365,
+	12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894, 14044,
+	14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296,
+	15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083,
+	16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382,
+	16384
+};
+
+/**
+ * Sinus in Festkomma-Darstellung per Tabelle (1 Grad Stuetzstellen, linear interpoliert)
+ * \param angle	Winkel [1/10 Grad], beliebiger Wertebereich
+ * \return		sin(angle) in Q1.14
+ */
+int16_t sin_fix(int16_t angle) {
+	/* auf [0; 3600) normieren und auf den ersten Quadranten abbilden */
+	angle = (int16_t) (angle % 3600);
+	if (angle < 0) {
+		angle = (int16_t) (angle + 3600);
+	}
+	uint8_t negative = 0;
+	if (angle >= 1800) {
+		angle = (int16_t) (angle - 1800);
+		negative = 1;
+	}
+	if (angle > 900) {
+		angle = (int16_t) (1800 - angle);
+	}
+
+	const uint8_t index = (uint8_t) (angle / 10);
+	const uint8_t frac = (uint8_t) (angle % 10);
+	int16_t result = (int16_t) pgm_read_word(&sin_table[index]);
+	if (frac) {
+		const int16_t next = (int16_t) pgm_read_word(&sin_table[index + 1]);
+		result = (int16_t) (result + (next - result) * frac / 10);
+	}
+	return negative ? (int16_t) -result : result;
+}
+
 /**
  * Ermittelt die Koordinaten eines Punktes, der um dx mm in x- und
  * dy mm in y-Richtung gegenueber der aktuellen Bot-Position verschoben ist.
@@ -126,12 +126,26 @@ void bot_2_linux_listen(void) {
 	}
 	last_uart_timeout = now;
 	LED_on(LED_TUERKIS);
+#ifdef CMD_SNAPSHOT_AVAILABLE
+	/* zurueck zu den einzelnen Kommandos, bis das Linux-Board Snapshots erneut anbietet */
+	cmd_snapshot_active = 0;
+#endif
+
 }
 
 /**
  * Diese Funktion informiert den Steuercode auf dem Linux-Board ueber alle Sensor- und Aktuator-Werte
  */
 void bot_2_linux_inform(void) {
+#ifdef CMD_SNAPSHOT_AVAILABLE
+	if (cmd_snapshot_active) {
+		/* alle Sensordaten in einem Kommando */
+		const uint32_t now = timer_get_tickcount_32();
+		command_write_sens_snapshot((int16_t) (uint16_t) now, (int16_t) (uint16_t) (now >> 16));
+		return;
+	}
+#endif // CMD_SNAPSHOT_AVAILABLE
+
 	command_write_to(CMD_SENS_IR, SUB_CMD_NORM, CMD_IGNORE_ADDR, sensDistL, sensDistR, 0);
 	command_write_to(CMD_SENS_ENC, SUB_CMD_NORM, CMD_IGNORE_ADDR, sensEncL, sensEncR, 0);
 	command_write_to(CMD_SENS_BORDER, SUB_CMD_NORM, CMD_IGNORE_ADDR, sensBorderL, sensBorderR, 0);
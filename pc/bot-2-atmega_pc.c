@@ -155,6 +155,8 @@ void set_bot_2_atmega(void) {
 	cmd_functions.read = uart_read;
 	cmd_functions.crc_check = uart_check_crc;
 	cmd_functions.crc_calc = uart_calc_crc;
+	cmd_functions.peek = NULL;
+	cmd_functions.consume = NULL;
 }
 
 /**
@@ -172,6 +174,10 @@ void bot_2_atmega_listen(void) {
 		const uint64_t t = (now.tv_sec - start.tv_sec) * 1000000UL + now.tv_usec - start.tv_usec;
 		if (t > UART_TIMEOUT * 1000UL) {
 			LOG_ERROR("bot_2_atmega_listen(): Timeout, t = %llu us", t);
+#ifdef CMD_SNAPSHOT_AVAILABLE
+			/* ATmega hat Snapshots nach dem Timeout abgeschaltet, neu aushandeln */
+			command_offer_snapshot();
+#endif
 			break;
 		}
 	}
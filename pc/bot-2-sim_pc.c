@@ -47,6 +47,8 @@
 #include "bot-2-atmega.h"
 #include "log.h"
 #include "led.h"
+#include "trace.h"
+#include "offline-sim.h"
 
 
 //#define DEBUG_BOT_2_SIM       // Schalter, um auf einmal alle Debugs an oder aus zu machen
@@ -93,13 +95,60 @@ void gettimeofday_win(struct timeval * p, void * tz /* IGNORED */) {
 }
 #endif // WIN32
 
+#ifdef BOT_2_SIM_ASYNC_AVAILABLE
+#define BOT_2_SIM_ASYNC_WAIT_MS 10	/**< Maximale Wartezeit auf Daten vom Sim pro Durchlauf der Verhaltensschleife / ms */
+
+uint8_t bot_2_sim_lockstep = 0;		/**< 1: strikter Lock-Step mit dem Sim, jeder Durchlauf wartet auf CMD_DONE */
+static uint8_t sim_done_received = 0;	/**< Seit dem letzten bot_2_sim_done_pending() wurde ein CMD_DONE vom Sim ausgewertet */
+
+/**
+ * Gibt an, ob der Sim auf das Done-Token dieses Durchlaufs wartet, weil seit dem letzten Aufruf
+ * ein CMD_DONE vom Sim ausgewertet wurde. Im Lock-Step-Modus immer der Fall.
+ * \return	1, falls CMD_DONE an den Sim zu senden ist
+ */
+uint8_t bot_2_sim_done_pending(void) {
+	const uint8_t done = bot_2_sim_lockstep || sim_done_received;
+	sim_done_received = 0;
+	return done;
+}
+#endif // BOT_2_SIM_ASYNC_AVAILABLE
+
 /**
  * Empfaengt alle Kommondos vom Sim
  */
 void bot_2_sim_listen(void) {
 	set_bot_2_sim();
 
+#ifdef CREATE_TRACEFILE_AVAILABLE
+	if (trace_replay_active()) {
+		/* Sensordaten aus der Trace-Datei statt vom Sim */
+		trace_replay_step();
+		return;
+	}
+#endif // CREATE_TRACEFILE_AVAILABLE
+
 #ifndef ARM_LINUX_BOARD
+	if (offline_sim_active()) {
+		/* Sensordaten vom Offline-Sim statt vom Sim */
+		offline_sim_step();
+		return;
+	}
+
+#ifdef BOT_2_SIM_ASYNC_AVAILABLE
+	if (! bot_2_sim_lockstep) {
+		/* Kommandos auswerten, bis CMD_DONE kommt oder der Sim BOT_2_SIM_ASYNC_WAIT_MS lang nichts mehr schickt */
+		while (tcp_frames_available(BOT_2_SIM_ASYNC_WAIT_MS) > 0) {
+			if (command_read() == 0) {
+				command_evaluate();
+				if (received_command.request.command == CMD_DONE) {
+					sim_done_received = 1;
+					return;
+				}
+			}
+		}
+		return;
+	}
+#endif // BOT_2_SIM_ASYNC_AVAILABLE
 	while (receive_until_frame(CMD_DONE) != 0) {}
 #else
 	if (tcp_client_connected() && tcp_data_available() >= (int) sizeof(command_t)) {
@@ -120,18 +169,33 @@ void set_bot_2_sim(void) {
 	cmd_functions.read = tcp_read;
 	cmd_functions.crc_check = tcp_check_crc;
 	cmd_functions.crc_calc = tcp_calc_crc;
+	cmd_functions.peek = tcp_peek;
+	cmd_functions.consume = tcp_consume;
 }
 
 /**
  * Initialisiert die Kommunikation mit dem Sim
  */
 void bot_2_sim_init(void) {
+#ifdef CREATE_TRACEFILE_AVAILABLE
+	if (trace_replay_active()) {
+		return; // kein Sim
+	}
+#endif // CREATE_TRACEFILE_AVAILABLE
+#ifndef ARM_LINUX_BOARD
+	if (offline_sim_active()) {
+		return; // kein Sim
+	}
+#endif // ARM_LINUX_BOARD
 	/* Bot beim Sim anmelden */
 #ifdef ARM_LINUX_BOARD
 	if (! tcp_client_connected()) {
 		return;
 	}
 #endif // ARM_LINUX_BOARD
+#ifdef BOT_2_SIM_ASYNC_AVAILABLE
+	tcp_start_receiver();
+#endif
 	register_bot();
 	flushSendBuffer();
 
@@ -32,9 +32,15 @@
 #include "eeprom.h"
 #include "command.h"
 #include "tcp.h"
+#include "bot-2-sim.h"
 #include "bot-logic.h"
 #include "sensor-low.h"
 #include "uart.h"
+#include "fifo.h"
+#include "trace.h"
+#include "offline-sim.h"
+#include "map-benchmark.h"
+#include "neuralnet_fixed.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -45,6 +51,8 @@
 
 //#define DEBUG
 
+uint8_t ctbot_instance = 0; /**< Nummer der Bot-Instanz, falls mehrere Bots in einem Prozess laufen (ct-Bot-fleet), sonst 0 */
+
 #ifdef BEHAVIOUR_REMOTECALL_AVAILABLE
 static pthread_t cmd_thread; /**< Thread fuer die RemoteCall-Auswertung per Kommandozeile */
 #endif // BEHAVIOUR_REMOTECALL_AVAILABLE
@@ -53,11 +61,18 @@ static pthread_t cmd_thread; /**< Thread fuer die RemoteCall-Auswertung per Komm
  * Zeigt Informationen zu den moeglichen Kommandozeilenargumenten an.
  */
 static void usage(void) {
-	puts("USAGE: ct-Bot [-t host] [-a address] [-T] [-s] [-u RUNS] [-M FILE] [-m FILE] [-h]");
+	puts("USAGE: ct-Bot [-t host] [-a address] [-I NUM] [-L] [-T] [-s] [-n TICKS] [-x MIX] [-C] [-u RUNS] [-M FILE] [-m FILE] [-r FILE] [-P FILE] [-w WORLD] [-R CALL] [-Q FILE] [-b TEST] [-h]");
 	puts("\t-t\tHostname oder IP Adresse zu der verbunden werden soll");
 	puts("\t-a\tAdresse des Bots (fuer Bot-2-Bot-Kommunikation), default: 0");
+#ifdef BOT_2_SIM_ASYNC_AVAILABLE
+	puts("\t-L\tStrikter Lock-Step mit dem Sim: jeder Durchlauf der Verhaltensschleife wartet auf das Done-Token des Sims");
+#endif
+	puts("\t-I NUM\tNummer der Bot-Instanz, wird von ct-Bot-fleet gesetzt (eigene Map- und Trace-Datei)");
 	puts("\t-T\tTestClient");
-	puts("\t-s\tServermodus");
+	puts("\t-s\tServermodus, Latenz-/Durchsatz-Benchmark gegen den TestClient");
+	puts("\t-n TICKS\tAnzahl der Ticks fuer -s / -T bzw. der Zyklen fuer -w (0: unbegrenzt), default: 1000");
+	puts("\t-x MIX\tFrame-Mix pro Tick fuer -s als \"typ[:anzahl],...\" mit typ aus sens, map, log, rc; default: sens:1");
+	puts("\t-C\tBenchmark-Ergebnis von -s als CSV ausgeben");
 #ifdef ARM_LINUX_BOARD
 	puts("\t-u RUNS\tUART-Test");
 #endif
@@ -66,6 +81,33 @@ static void usage(void) {
 	puts("\t-m FILE\tGibt den Pfad zu einer Datei FILE an, die vom Map-Code verwendet wird (Ex- und Import)");
 #else
 	puts("\t\tACHTUNG, das Programm wurde ohne MAP_AVAILABLE uebersetzt, die Optionen -M / -m stehen derzeit also NICHT zur Verfuegung");
+#endif
+#ifdef CREATE_TRACEFILE_AVAILABLE
+	puts("\t-r FILE\tReplay: Sensordaten aus der binaeren Trace-Datei FILE statt vom Sim, neuer Trace nach replay.bin");
+	puts("\t-P FILE\tKonvertiert die binaere Trace-Datei FILE in die Textdatei trace.txt");
+#endif
+	puts("\t-w WORLD\tOffline-Sim statt ct-Sim: Welt aus PGM-Datei WORLD (8 mm pro Pixel) oder \"arena\" fuer die eingebaute Welt");
+	puts("\t-R CALL\tRemoteCall fuer -w, der im ersten Zyklus gestartet wird, z.B. \"bot_drive_distance(0,150,100)\"");
+#ifdef BEHAVIOUR_NEURALNET_AVAILABLE
+	puts("\t-Q FILE\tKonvertiert ein mit net_bsave() gespeichertes Netz FILE fuer die Festkomma-Inferenz in neuralnet_fixed_data.inc");
+#endif
+	puts("\t-b TEST\tFuehrt den Benchmark TEST aus und beendet das Programm:");
+#ifdef MAP_AVAILABLE
+	puts("\t\tmap-rays\tStrahl-Eintragung der Karte, float vs. Festkomma");
+	puts("\t\tmap-file\tExport, Import und Loeschen der Karte");
+#endif
+#ifdef BEHAVIOUR_UBASIC_AVAILABLE
+	puts("\t\tubasic\t\tuBasic-Beispielprogramme, Quelltext vs. Token-Code");
+#endif
+#ifdef BEHAVIOUR_NEURALNET_AVAILABLE
+	puts("\t\tneuralnet\tTraining des neuronalen Netzes in Epochen/s");
+	puts("\t\tneuralnet-fixed\tFestkomma-Netz: Entscheidungen und Inferenzzeit gegen das float-Netz");
+#ifdef NEURALNET_PARALLEL_AVAILABLE
+	puts("\t\tneuralnet-parallel\tParalleles Training mehrerer Netze in Threads gegen das Training des Verhaltens");
+#endif
+#endif
+#ifdef OS_AVAILABLE
+	puts("\t\tfifo\t\tFIFO-Durchsatz zwischen zwei Threads");
 #endif
 	puts("\t-h\tZeigt diese Hilfe an");
 }
@@ -85,36 +127,64 @@ void hand_cmd_args(int argc, char * argv[]) {	// explizit ** int **
 	strcpy(tcp_hostname, IP);
 
 	int ch;	// explizit ** int **
+	char tcp_mode = 0;
+	int tcp_runs = 1000;
+	char * offline_world = NULL;
+	char * offline_remotecall = NULL;
 	/* Die Kommandozeilenargumente komplett verarbeiten */
-	while ((ch = getopt(argc, argv, "hsTu:Et:M:m:c:l:e:d:a:i:fk:o:F:")) != -1) {
-		argc -= optind;
-		argv += optind;
-
+	while ((ch = getopt(argc, argv, "hsTn:x:CLI:u:Et:M:m:r:P:w:R:Q:b:c:l:e:d:a:i:fk:o:F:")) != -1) {
 		switch (ch) {
-		case 's': {
+		case 's':
+			/* Servermodus [-s] wird verlangt, Start nach Auswertung aller Argumente */
+			tcp_mode = 's';
+			break;
+
+		case 'T':
+			/* Testclient starten, Start nach Auswertung aller Argumente */
+			tcp_mode = 'T';
+			break;
+
+		case 'L':
+#ifdef BOT_2_SIM_ASYNC_AVAILABLE
+			/* Lock-Step mit dem Sim */
+			bot_2_sim_lockstep = 1;
+#endif
+			break;
+
+		case 'I':
+		{
+			/* Bot-Instanz in ct-Bot-fleet */
+			char * end;
+			const long num = strtol(optarg, &end, 10);
+			if (*optarg == '\0' || *end != '\0' || num < 1 || num > UINT8_MAX) {
+				printf("Ungueltige Instanznummer \"%s\", erlaubt sind 1 bis %u\n", optarg, UINT8_MAX);
+				usage();
+				exit(1);
+			}
+			ctbot_instance = (uint8_t) num;
+			break;
+		}
+
+		case 'n':
+			/* Anzahl der Ticks fuer Server / Testclient / Offline-Sim */
+			tcp_runs = atoi(optarg);
+			break;
+
+		case 'x':
+			/* Frame-Mix fuer den Server */
 #ifdef BOT_2_SIM_AVAILABLE
-			/* Servermodus [-s] wird verlangt */
-			printf("ARGV[0]= %s\n", argv[0]);
-			tcp_server_init();
-			tcp_server_run(1000); // beendet per exit()
-#else
-			puts("Fehler, Binary wurde ohne BOT_2_SIM_AVAILABLE compiliert!");
-			exit(1);
+			if (tcp_server_set_mix(optarg) != 0) {
+				usage();
+				exit(1);
+			}
 #endif // BOT_2_SIM_AVAILABLE
 			break;
-		}
 
-		case 'T': {
+		case 'C':
 #ifdef BOT_2_SIM_AVAILABLE
-			/* Testclient starten */
-			tcp_test_client_init();
-			tcp_test_client_run(1000); // beendet per exit()
-#else
-			puts("Fehler, Binary wurde ohne BOT_2_SIM_AVAILABLE compiliert!");
-			exit(1);
+			tcp_server_set_csv(1);
 #endif // BOT_2_SIM_AVAILABLE
 			break;
-		}
 
 		case 'u': {
 #ifdef ARM_LINUX_BOARD
@@ -195,6 +265,105 @@ void hand_cmd_args(int argc, char * argv[]) {	// explizit ** int **
 			break;
 		}
 
+		case 'r':
+		case 'P': {
+#if ! defined CREATE_TRACEFILE_AVAILABLE || ! defined BOT_2_SIM_AVAILABLE
+			puts("ACHTUNG, das Programm wurde ohne CREATE_TRACEFILE_AVAILABLE uebersetzt, die Optionen -r / -P stehen derzeit also NICHT zur Verfuegung.");
+			exit(1);
+#else
+			int8_t res;
+			if (ch == 'P') {
+				/* binaeren Trace in Text konvertieren */
+				printf("Konvertiere Trace \"%s\" in \"%s\"\n", optarg, "trace.txt");
+				res = trace_convert(optarg, "trace.txt");
+			} else {
+				/* Replay, Start nach der Initialisierung */
+				printf("Replay von Trace \"%s\"\n", optarg);
+				res = trace_replay_open(optarg);
+			}
+			if (res != 0) {
+				printf("Fehler %d beim Lesen von \"%s\"\n", res, optarg);
+				exit(1);
+			}
+			if (ch == 'P') {
+				exit(0);
+			}
+#endif // CREATE_TRACEFILE_AVAILABLE && BOT_2_SIM_AVAILABLE
+			break;
+		}
+
+		case 'w':
+			/* Welt fuer den Offline-Sim, Start nach Auswertung aller Argumente */
+			offline_world = optarg;
+			break;
+
+		case 'R':
+			/* RemoteCall fuer den Offline-Sim */
+			offline_remotecall = optarg;
+			break;
+
+		case 'Q': {
+#ifndef BEHAVIOUR_NEURALNET_AVAILABLE
+			puts("ACHTUNG, das Programm wurde ohne BEHAVIOUR_NEURALNET_AVAILABLE uebersetzt, die Option -Q steht derzeit also NICHT zur Verfuegung.");
+			exit(1);
+#else
+			/* Netz fuer die Festkomma-Inferenz konvertieren */
+			printf("Konvertiere Netz \"%s\" in \"%s\"\n", optarg, "neuralnet_fixed_data.inc");
+			const int8_t res = nnq_convert(optarg, "neuralnet_fixed_data.inc");
+			if (res != 0) {
+				printf("Fehler %d beim Konvertieren von \"%s\"\n", res, optarg);
+				exit(1);
+			}
+			exit(0);
+#endif // BEHAVIOUR_NEURALNET_AVAILABLE
+		}
+
+		case 'b': {
+			/* Benchmark ausfuehren */
+#ifdef MAP_AVAILABLE
+			if (strcmp(optarg, "map-rays") == 0) {
+				map_init();
+				map_benchmark_rays(100000);
+				exit(0);
+			}
+			if (strcmp(optarg, "map-file") == 0) {
+				map_init();
+				map_benchmark_file("map-bench.map");
+				exit(0);
+			}
+#endif // MAP_AVAILABLE
+#ifdef BEHAVIOUR_UBASIC_AVAILABLE
+			if (strcmp(optarg, "ubasic") == 0) {
+				bot_ubasic_benchmark(200000);
+				exit(0);
+			}
+#endif // BEHAVIOUR_UBASIC_AVAILABLE
+#ifdef BEHAVIOUR_NEURALNET_AVAILABLE
+			if (strcmp(optarg, "neuralnet") == 0) {
+				neuralnet_benchmark(20000);
+				exit(0);
+			}
+			if (strcmp(optarg, "neuralnet-fixed") == 0) {
+				exit(neuralnet_fixed_benchmark(200000));
+			}
+#ifdef NEURALNET_PARALLEL_AVAILABLE
+			if (strcmp(optarg, "neuralnet-parallel") == 0) {
+				neuralnet_parallel_benchmark();
+				exit(0);
+			}
+#endif
+#endif // BEHAVIOUR_NEURALNET_AVAILABLE
+#ifdef OS_AVAILABLE
+			if (strcmp(optarg, "fifo") == 0) {
+				fifo_benchmark(20000000);
+				exit(0);
+			}
+#endif // OS_AVAILABLE
+			printf("Unbekannter Benchmark \"%s\"\n", optarg);
+			usage();
+			exit(1);
+		}
+
 		case 'h':
 		default:
 			/* -h oder falscher Parameter, Usage anzeigen */
@@ -202,9 +371,91 @@ void hand_cmd_args(int argc, char * argv[]) {	// explizit ** int **
 			exit(0);
 		}
 	}
+
+	if (tcp_mode) {
+#ifdef BOT_2_SIM_AVAILABLE
+		if (tcp_mode == 's') {
+			tcp_server_init();
+			tcp_server_run(tcp_runs); // beendet per exit()
+		} else {
+			tcp_test_client_init();
+			tcp_test_client_run(tcp_runs); // beendet per exit()
+		}
+#else
+		puts("Fehler, Binary wurde ohne BOT_2_SIM_AVAILABLE compiliert!");
+		exit(1);
+#endif // BOT_2_SIM_AVAILABLE
+	}
+
+	if (offline_world) {
+#if defined BOT_2_SIM_AVAILABLE && ! defined ARM_LINUX_BOARD
+		printf("Offline-Sim mit Welt \"%s\", %d Zyklen\n", offline_world, tcp_runs);
+		const int8_t res = offline_sim_init(offline_world, (uint32_t) (tcp_runs > 0 ? tcp_runs : 0), offline_remotecall);
+		if (res != 0) {
+			printf("Fehler %d beim Laden der Welt \"%s\"\n", res, offline_world);
+			exit(1);
+		}
+#else
+		puts("Fehler, Binary wurde ohne BOT_2_SIM_AVAILABLE compiliert!");
+		exit(1);
+#endif // BOT_2_SIM_AVAILABLE && ! ARM_LINUX_BOARD
+	} else if (offline_remotecall) {
+		puts("-R geht nur zusammen mit -w");
+		usage();
+		exit(1);
+	}
 }
 
 #ifdef BEHAVIOUR_REMOTECALL_AVAILABLE
+/**
+ * Startet einen RemoteCall aus einer Eingabezeile wie "bot_turn(90)" bzw. "turn(90)"
+ * \param *input	Eingabezeile, wird veraendert
+ */
+void cmd_remotecall(char * input) {
+	char * function = strtok(input, "(\n");
+	if (function == NULL || *function == '\n') {
+		return;
+	}
+	char * param[REMOTE_CALL_MAX_PARAM] = {NULL};
+	remote_call_data_t params[REMOTE_CALL_MAX_PARAM] = {{0}};
+	int16_t i;
+	for (i = 0; i < REMOTE_CALL_MAX_PARAM; ++i) {
+		param[i] = strtok(NULL, ",)");
+		if (param[i] != NULL && *param[i] != '\n') {
+			params[i].s32 = atoi(param[i]);
+		}
+	}
+
+#ifdef DEBUG
+	printf("function=\"%s\"\n", function);
+#endif // DEBUG
+
+	for (i = 0; i < REMOTE_CALL_MAX_PARAM; ++i) {
+		if (param[i] != NULL && *param[i] != '\n') {
+#ifdef DEBUG
+			printf("param[%d]=\"%s\"\n", i, param[i]);
+			printf("params[%d].s32=%d\tparams[%d].u32=0x%x\n", i, params[0].s32, i, params[0].u32);
+#endif // DEBUG
+		}
+	}
+
+	int8_t result = bot_remotecall(NULL, function, params);
+	if (result == 0) {
+		printf("RemoteCall \"%s(%d,%d,%d)\" gestartet\n", function, params[0].s32, params[1].s32, params[2].s32);
+	} else if (result == -1) {
+		puts("Es ist bereits ein RemoteCall aktiv!");
+	} else if (result == -2) {
+		char func[255] = "bot_";
+		strncpy(func + strlen(func), function, sizeof(func) - strlen(func));
+		result = bot_remotecall(NULL, func, params);
+		if (result == 0) {
+			printf("RemoteCall \"%s(%d,%d,%d)\" gestartet\n", func, params[0].s32, params[1].s32, params[2].s32);
+		} else {
+			printf("RemoteCall \"%s(%d,%d,%d)\" nicht vorhanden\n", function, params[0].s32, params[1].s32, params[2].s32);
+		}
+	}
+}
+
 /**
  * Liest RemoteCall-Commands von stdin ein
  */
@@ -216,6 +467,10 @@ static void read_command_thread(void) {
 		if (fgets(input, sizeof(input) - 1, stdin) == NULL) {
 #ifdef WIN32
 			usleep(10000); // Workaround fuer non-blocking stdin unter mingw, falls von Java aus gestartet
+#else
+			if (feof(stdin)) {
+				return; // keine Konsole (z.B. < /dev/null), nicht endlos pollen
+			}
 #endif
 			continue;
 		}
@@ -232,48 +487,7 @@ static void read_command_thread(void) {
 			continue;
 		}
 
-		char * function = strtok(input, "(\n");
-		if (function == NULL || *function == '\n') {
-			continue;
-		}
-		char * param[REMOTE_CALL_MAX_PARAM] = {NULL};
-		remote_call_data_t params[REMOTE_CALL_MAX_PARAM] = {{0}};
-		int16_t i;
-		for (i = 0; i < REMOTE_CALL_MAX_PARAM; ++i) {
-			param[i] = strtok(NULL, ",)");
-			if (param[i] != NULL && *param[i] != '\n') {
-				params[i].s32 = atoi(param[i]);
-			}
-		}
-
-#ifdef DEBUG
-		printf("function=\"%s\"\n", function);
-#endif // DEBUG
-
-		for (i = 0; i < REMOTE_CALL_MAX_PARAM; ++i) {
-			if (param[i] != NULL && *param[i] != '\n') {
-#ifdef DEBUG
-				printf("param[%d]=\"%s\"\n", i, param[i]);
-				printf("params[%d].s32=%d\tparams[%d].u32=0x%x\n", i, params[0].s32, i, params[0].u32);
-#endif // DEBUG
-			}
-		}
-
-		int8_t result = bot_remotecall(NULL, function, params);
-		if (result == 0) {
-			printf("RemoteCall \"%s(%d,%d,%d)\" gestartet\n", function, params[0].s32, params[1].s32, params[2].s32);
-		} else if (result == -1) {
-			puts("Es ist bereits ein RemoteCall aktiv!");
-		} else if (result == -2) {
-			char func[255] = "bot_";
-			strncpy(func + strlen(func), function, sizeof(func) - strlen(func));
-			result = bot_remotecall(NULL, func, params);
-			if (result == 0) {
-				printf("RemoteCall \"%s(%d,%d,%d)\" gestartet\n", func, params[0].s32, params[1].s32, params[2].s32);
-			} else {
-				printf("RemoteCall \"%s(%d,%d,%d)\" nicht vorhanden\n", function, params[0].s32, params[1].s32, params[2].s32);
-			}
-		}
+		cmd_remotecall(input);
 	}
 }
 #endif // BEHAVIOUR_REMOTECALL_AVAILABLE
@@ -283,7 +497,9 @@ static void read_command_thread(void) {
  */
 void cmd_init(void) {
 #ifdef BEHAVIOUR_REMOTECALL_AVAILABLE
-	pthread_create(&cmd_thread, NULL, (void * (*)(void *)) read_command_thread, NULL);
+	if (ctbot_instance <= 1) { // stdin gehoert bei mehreren Instanzen der ersten
+		pthread_create(&cmd_thread, NULL, (void * (*)(void *)) read_command_thread, NULL);
+	}
 #endif // BEHAVIOUR_REMOTECALL_AVAILABLE
 }
 
@@ -0,0 +1,272 @@
+/*
+ * c't-Bot
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ * This program is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307, USA.
+ *
+ */
+
+/**
+ * \file 	fleet-host_pc.c
+ * \brief 	ct-Bot-fleet: startet mehrere simulierte Bots in einem Prozess
+ *
+ * Jede Bot-Instanz ist eine eigene Kopie von ct-Bot.so (make DEVICE=PC FLEET=1), so hat jeder Bot
+ * seinen eigenen Satz globaler Variablen, laeuft aber als Thread in diesem Prozess und hat wie
+ * bisher eine eigene Verbindung zum Sim. Die Instanzen werden nacheinander initialisiert, weil
+ * die Auswertung der Kommandozeile (getopt) prozessweiten Zustand hat.
+ * Gespart werden damit nur die Prozesse: Die Verbindungen zum Sim werden nicht gebuendelt und auch
+ * nur lesbare Tabellen liegen in jeder Kopie der Bibliothek einzeln im Speicher.
+ * Ruft eine Instanz exit() auf, landet das per "-Wl,--wrap=exit" in ctbot_fleet_instance_exit():
+ * Der aufrufende Thread endet, die uebrigen Instanzen laufen weiter. Weitere Threads der beendeten
+ * Instanz werden nicht abgebrochen, ihre Ressourcen gibt erst das Ende des Prozesses frei.
+ *
+ * \author 	c't-Bot-Team
+ * \date 	18.10.2026
+ */
+
+#if defined PC && defined __linux__
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <dlfcn.h>
+#include <libgen.h>
+
+#define FLEET_MAX_INSTANCES 250 /**< Maximale Anzahl an Bot-Instanzen, die Instanznummer wird als uint8_t uebergeben */
+
+/** Daten einer Bot-Instanz */
+typedef struct {
+	int (* main)(int, char **);	/**< main() der Instanz */
+	int argc;					/**< Anzahl der Argumente fuer main() */
+	char ** argv;				/**< Argumente fuer main() */
+	pthread_t thread;			/**< Thread der Instanz */
+	uint8_t ready;				/**< Initialisierung abgeschlossen */
+	uint8_t done;				/**< Instanz hat sich beendet */
+	int status;					/**< Exit-Code der Instanz */
+} fleet_instance_t;
+
+static fleet_instance_t * instances = NULL;	/**< Alle Bot-Instanzen */
+static int instance_count = 0;					/**< Anzahl der gestarteten Bot-Instanzen */
+static pthread_mutex_t instance_mutex = PTHREAD_MUTEX_INITIALIZER; /**< Schuetzt ready, done und status */
+static sem_t instance_ready; /**< Wird gesetzt, sobald eine Instanz mit ihrer Initialisierung fertig ist oder sich dabei beendet hat */
+static sem_t instance_done; /**< Wird gesetzt, sobald sich eine Instanz beendet hat */
+
+void ctbot_fleet_instance_ready(void);
+void ctbot_fleet_instance_exit(uint8_t instance, int status) __attribute__((noreturn));
+
+/**
+ * Wird von jeder Bot-Instanz am Ende ihrer Initialisierung aufgerufen (siehe ctbot_init_low_last())
+ */
+void ctbot_fleet_instance_ready(void) {
+	pthread_mutex_lock(&instance_mutex);
+	instances[instance_count - 1].ready = 1; // Instanzen werden nacheinander initialisiert
+	pthread_mutex_unlock(&instance_mutex);
+	sem_post(&instance_ready);
+}
+
+/**
+ * Ersetzt exit() in den Bot-Instanzen (siehe __wrap_exit() in init-low_pc.c): Beendet den aufrufenden
+ * Thread und meldet beim ersten Aufruf einer Instanz deren Ende, kehrt nicht zurueck.
+ * \param instance	Nummer der Bot-Instanz (1 bis instance_count)
+ * \param status	Exit-Code
+ */
+void ctbot_fleet_instance_exit(uint8_t instance, int status) {
+	pthread_mutex_lock(&instance_mutex);
+	if (instance == 0 && ! instances[instance_count - 1].ready) {
+		instance = (uint8_t) instance_count; // exit() vor der Auswertung von -I
+	}
+	if (instance >= 1 && instance <= instance_count && ! instances[instance - 1].done) {
+		fleet_instance_t * p_instance = &instances[instance - 1];
+		p_instance->done = 1;
+		p_instance->status = status;
+		printf("ct-Bot-fleet: Instanz %u beendet (%d)\n", instance, status);
+		if (! p_instance->ready) {
+			sem_post(&instance_ready);
+		}
+		sem_post(&instance_done);
+	}
+	pthread_mutex_unlock(&instance_mutex);
+	pthread_exit(NULL);
+}
+
+/**
+ * Zeigt Informationen zu den moeglichen Kommandozeilenargumenten an
+ */
+static void usage(void) {
+	puts("USAGE: ct-Bot-fleet [-n COUNT] [-l LIB] [-h] [-- BOT-ARGS]");
+	puts("\t-n COUNT\tAnzahl der Bot-Instanzen, default: 2");
+	puts("\t-l LIB\tPfad zu ct-Bot.so, default: ct-Bot.so im Verzeichnis von ct-Bot-fleet");
+	puts("\t-h\tZeigt diese Hilfe an");
+	puts("\tBOT-ARGS werden an jede Instanz weitergegeben, z.B. -- -t host");
+}
+
+/**
+ * Laedt eine eigene Kopie der Bot-Bibliothek. dlopen() liefert fuer dieselbe Datei immer dasselbe
+ * Handle, daher wird die Bibliothek fuer jede Instanz in eine temporaere Datei kopiert.
+ * \param *lib	Pfad zu ct-Bot.so
+ * \return		Handle der geladenen Kopie oder NULL
+ */
+static void * load_copy(const char * lib) {
+	FILE * src = fopen(lib, "rb");
+	if (! src) {
+		perror(lib);
+		return NULL;
+	}
+	char path[] = "/tmp/ct-Bot-fleet-XXXXXX";
+	const int fd = mkstemp(path);
+	FILE * dest = fd >= 0 ? fdopen(fd, "wb") : NULL;
+	if (! dest) {
+		perror("mkstemp()");
+		fclose(src);
+		return NULL;
+	}
+	char buffer[16384];
+	size_t n;
+	while ((n = fread(buffer, 1, sizeof(buffer), src)) > 0) {
+		if (fwrite(buffer, 1, n, dest) != n) {
+			perror("fwrite()");
+			break;
+		}
+	}
+	fclose(src);
+	fclose(dest);
+
+	void * handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+	unlink(path); // bleibt gemappt, solange sie geladen ist
+	if (! handle) {
+		printf("dlopen() failed: %s\n", dlerror());
+	}
+	return handle;
+}
+
+/**
+ * Thread einer Bot-Instanz
+ * \param *data	Zeiger auf fleet_instance_t
+ * \return		NULL, kehrt normalerweise nicht zurueck
+ */
+static void * instance_thread(void * data) {
+	fleet_instance_t * instance = data;
+	const int status = instance->main(instance->argc, instance->argv);
+	ctbot_fleet_instance_exit((uint8_t) (instance - instances + 1), status);
+}
+
+/**
+ * Startet COUNT Bot-Instanzen und wartet auf deren Ende
+ * \return	Groesster Exit-Code aller Instanzen
+ */
+int main(int argc, char * argv[]) {
+	int count = 2;
+	char * lib = NULL;
+	int ch;
+	while ((ch = getopt(argc, argv, "n:l:h")) != -1) {
+		switch (ch) {
+		case 'n':
+			count = atoi(optarg);
+			break;
+
+		case 'l':
+			lib = optarg;
+			break;
+
+		case 'h':
+		default:
+			usage();
+			exit(ch == 'h' ? 0 : 1);
+		}
+	}
+	if (count < 1 || count > FLEET_MAX_INSTANCES) {
+		printf("COUNT muss zwischen 1 und %d liegen\n", FLEET_MAX_INSTANCES);
+		exit(1);
+	}
+
+	char default_lib[4096];
+	if (! lib) {
+		char tmp[4096];
+		snprintf(tmp, sizeof(tmp), "%s", argv[0]);
+		snprintf(default_lib, sizeof(default_lib), "%s/ct-Bot.so", dirname(tmp));
+		lib = default_lib;
+	}
+
+	/* restliche Argumente gehen an die Instanzen; optind wird unten fuer deren getopt() zurueckgesetzt */
+	const int first_bot_arg = optind;
+	const int bot_args = argc - first_bot_arg;
+	instances = calloc((size_t) count, sizeof(fleet_instance_t));
+	if (! instances) {
+		exit(1);
+	}
+	sem_init(&instance_ready, 0, 0);
+	sem_init(&instance_done, 0, 0);
+
+	int i;
+	for (i = 0; i < count; ++i) {
+		void * handle = load_copy(lib);
+		if (! handle) {
+			exit(1);
+		}
+		fleet_instance_t * instance = &instances[i];
+		*(void **) &instance->main = dlsym(handle, "main");
+		if (! instance->main) {
+			printf("dlsym(\"main\") failed: %s\n", dlerror());
+			exit(1);
+		}
+
+		/* ct-Bot -I NUM [BOT-ARGS] */
+		instance->argc = bot_args + 3;
+		instance->argv = calloc((size_t) instance->argc + 1, sizeof(char *));
+		char * num = malloc(4);
+		if (! instance->argv || ! num) {
+			exit(1);
+		}
+		snprintf(num, 4, "%d", i + 1);
+		instance->argv[0] = "ct-Bot";
+		instance->argv[1] = "-I";
+		instance->argv[2] = num;
+		memcpy(&instance->argv[3], &argv[first_bot_arg], (size_t) bot_args * sizeof(char *));
+
+		printf("ct-Bot-fleet: starte Instanz %d von %d\n", i + 1, count);
+		optind = 0; // getopt() fuer die neue Instanz komplett zuruecksetzen
+		pthread_mutex_lock(&instance_mutex);
+		instance_count = i + 1;
+		pthread_mutex_unlock(&instance_mutex);
+		if (pthread_create(&instance->thread, NULL, instance_thread, instance) != 0) {
+			perror("pthread_create()");
+			exit(1);
+		}
+		while (sem_wait(&instance_ready) != 0) {}
+		pthread_mutex_lock(&instance_mutex);
+		const uint8_t ready = instance->ready;
+		pthread_mutex_unlock(&instance_mutex);
+		if (! ready) {
+			/* Fehler bei der Initialisierung, z.B. ungueltige BOT-ARGS; die weiteren Instanzen scheitern genauso */
+			exit(instance->status ? instance->status : 1);
+		}
+	}
+	printf("ct-Bot-fleet: %d Instanzen laufen\n", count);
+
+	int status = 0;
+	for (i = 0; i < count; ++i) {
+		while (sem_wait(&instance_done) != 0) {}
+	}
+	for (i = 0; i < count; ++i) {
+		if (instances[i].status > status) {
+			status = instances[i].status;
+		}
+	}
+	return status;
+}
+#endif // PC && __linux__
@@ -52,6 +52,39 @@ void sig_handler(int signum) {	// ** int ** wird vom System uebergeben
 }
 #endif // ! __WIN32__
 
+#ifdef __linux__
+/**
+ * Wird von ct-Bot-fleet bereitgestellt und meldet, dass eine Bot-Instanz initialisiert ist.
+ * Im normalen ct-Bot-Binary nicht vorhanden (weak).
+ */
+extern void ctbot_fleet_instance_ready(void) __attribute__((weak));
+
+/**
+ * Wird von ct-Bot-fleet bereitgestellt und beendet nur die Bot-Instanz des Aufrufers, kehrt nicht zurueck.
+ * Im normalen ct-Bot-Binary nicht vorhanden (weak).
+ * \param instance	Nummer der Bot-Instanz
+ * \param status	Exit-Code
+ */
+extern void ctbot_fleet_instance_exit(uint8_t instance, int status) __attribute__((weak, noreturn));
+
+#ifdef FLEET_BUILD
+void __real_exit(int status) __attribute__((noreturn));
+void __wrap_exit(int status) __attribute__((noreturn));
+
+/**
+ * Ersetzt im FLEET-Build alle Aufrufe von exit() (per "-Wl,--wrap=exit"). Unter ct-Bot-fleet endet
+ * damit nur diese Bot-Instanz, als eigenstaendiges ct-Bot wie bisher der Prozess.
+ * \param status	Exit-Code
+ */
+void __wrap_exit(int status) {
+	if (ctbot_fleet_instance_exit) {
+		ctbot_fleet_instance_exit(ctbot_instance, status);
+	}
+	__real_exit(status);
+}
+#endif // FLEET_BUILD
+#endif // __linux__
+
 
 //#define DEBUG_INIT_LOW_PC       // Schalter, um auf einmal alle Debugs an oder aus zu machen
 
@@ -92,6 +125,13 @@ void ctbot_init_low_last(void) {
 	LOG_DEBUG("ctbot_init_low_last(): Sending CMD_DONE to ATmega...");
 	command_write(CMD_DONE, SUB_CMD_NORM, simultime, 0, 0);
 #endif // ARM_LINUX_BOARD
+
+#ifdef __linux__
+	if (ctbot_fleet_instance_ready) {
+		/* ct-Bot-fleet kann die naechste Instanz starten */
+		ctbot_fleet_instance_ready();
+	}
+#endif // __linux__
 }
 
 /**
@@ -72,6 +72,11 @@ void LED_off(uint8_t LED) {
  */
 void LED_set(uint8_t LED) {
 	led = LED;
+#ifdef CMD_SNAPSHOT_AVAILABLE
+	if (cmd_snapshot_active) {
+		return; // mit dem naechsten Snapshot
+	}
+#endif
 	command_write(CMD_AKT_LED, SUB_CMD_NORM, led, 0, 0);
 }
 
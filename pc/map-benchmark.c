@@ -0,0 +1,227 @@
+/*
+ * c't-Bot
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ * This program is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307, USA.
+ *
+ */
+
+/**
+ * \file 	map-benchmark.c
+ * \brief 	Benchmarks fuer die Karte auf dem PC
+ *
+ * Die Karte wird ueber die PC-Funktionen aus map.h gefuellt, die dieselben Routinen wie der
+ * Map-Update-Thread aufrufen. Die float-Referenz rundet wie mul_fix() jeden Summanden einzeln.
+ *
+ * \author 	c't-Bot-Team
+ * \date 	18.10.2026
+ */
+
+#ifdef PC
+
+#include "ct-Bot.h"
+
+#ifdef MAP_AVAILABLE
+#include "map-benchmark.h"
+#include "map.h"
+#include "sensor.h"
+#include "math_utils.h"
+#include <stdio.h>
+#include <math.h>
+#include <inttypes.h>
+#include <sys/time.h>
+
+/**
+ * Liefert die seit start vergangene Zeit
+ * \param *start	Startzeitpunkt
+ * \return			Zeit seit start [us]
+ */
+static uint64_t benchmark_elapsed_us(const struct timeval* start) {
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return (uint64_t) (now.tv_sec - start->tv_sec) * 1000000ULL + (uint64_t) now.tv_usec - (uint64_t) start->tv_usec;
+}
+
+/**
+ * Einfacher Pseudo-Zufallsgenerator, damit beide Durchlaeufe dieselben Eingaben erhalten
+ * \param *state	Zustand des Generators
+ * \return			Zufallszahl
+ */
+static uint16_t benchmark_rand(uint32_t* state) {
+	*state = *state * 1103515245UL + 12345UL;
+	return (uint16_t) (*state >> 16);
+}
+
+/**
+ * Referenzimplementierung von map_update_sensor_distance() mit float-Trigonometrie
+ * \param x			X-Achse der Position in Weltkoordinaten
+ * \param y			Y-Achse der Position in Weltkoordinaten
+ * \param head_10	Blickrichtung [1/10 Grad]
+ * \param distL		Sensorwert links
+ * \param distR		Sensorwert rechts
+ */
+static void update_distance_float(int16_t x, int16_t y, int16_t head_10, int16_t distL, int16_t distR) {
+	const float head = rad(head_10 / 10.f);
+	const float sin_head = sinf(head);
+	const float cos_head = cosf(head);
+	const int16_t sw_sin = iroundf(DISTSENSOR_POS_SW * sin_head);
+	const int16_t sw_cos = iroundf(DISTSENSOR_POS_SW * cos_head);
+	const int16_t fw_sin = iroundf(DISTSENSOR_POS_FW * sin_head);
+	const int16_t fw_cos = iroundf(DISTSENSOR_POS_FW * cos_head);
+
+	// Ort des rechten und linken Sensors in Weltkoordinaten
+	const int16_t Pr_x = (int16_t) (x + sw_sin + fw_cos);
+	const int16_t Pr_y = (int16_t) (y - sw_cos + fw_sin);
+	const int16_t Pl_x = (int16_t) (x - sw_sin + fw_cos);
+	const int16_t Pl_y = (int16_t) (y + sw_cos + fw_sin);
+
+	const int16_t dL = distL == SENS_IR_INFINITE ? SENS_IR_MAX_DIST : distL;
+	const int16_t dR = distR == SENS_IR_INFINITE ? SENS_IR_MAX_DIST : distR;
+	map_update_sensor_ray(Pl_x, Pl_y, (int16_t) (Pl_x + iroundf(dL * cos_head)), (int16_t) (Pl_y + iroundf(dL * sin_head)), distL);
+	map_update_sensor_ray(Pr_x, Pr_y, (int16_t) (Pr_x + iroundf(dR * cos_head)), (int16_t) (Pr_y + iroundf(dR * sin_head)), distR);
+}
+
+/**
+ * Vergleicht die Strahl-Eintragung mit float- und mit Festkomma-Trigonometrie und gibt
+ * die erreichten Strahlen pro Sekunde aus
+ * \param count	Anzahl der Messungen (je zwei Strahlen)
+ */
+void map_benchmark_rays(uint32_t count) {
+	if (count == 0) {
+		return;
+	}
+	printf("Map-Strahlen: %" PRIu32 " Messungen mit je 2 Strahlen, map_cache_t belegt %u Byte\n", count, (unsigned) sizeof(map_cache_t));
+
+	/* 1. nur Geometrie: Strahlenden in Kartenkoordinaten berechnen */
+	uint64_t t_us[2];
+	uint8_t fixed;
+	uint32_t differ = 0;
+	for (fixed = 0; fixed < 2; ++fixed) {
+		uint32_t seed = 42;
+		volatile int16_t sink = 0;
+		struct timeval start;
+		gettimeofday(&start, NULL);
+		uint32_t i;
+		for (i = 0; i < count; ++i) {
+			const int16_t x = (int16_t) (benchmark_rand(&seed) % 4000 - 2000);
+			const int16_t y = (int16_t) (benchmark_rand(&seed) % 4000 - 2000);
+			const int16_t head_10 = (int16_t) (benchmark_rand(&seed) % 3600);
+			const int16_t dist = (int16_t) (benchmark_rand(&seed) % (SENS_IR_MAX_DIST / 5 + 20) * 5);
+			benchmark_rand(&seed);
+			if (fixed) {
+				sink = (int16_t) (world_to_map((int16_t) (x + mul_fix(dist, cos_fix(head_10))))
+					+ world_to_map((int16_t) (y + mul_fix(dist, sin_fix(head_10)))));
+			} else {
+				const float head = rad(head_10 / 10.f);
+				sink = (int16_t) (world_to_map(x + iroundf(dist * cosf(head))) + world_to_map(y + iroundf(dist * sinf(head))));
+			}
+		}
+		t_us[fixed] = benchmark_elapsed_us(&start);
+		(void) sink;
+	}
+	printf("Geometrie:  float %8llu us, Festkomma %8llu us, Beschleunigung %.2f\n", (unsigned long long) t_us[0],
+		(unsigned long long) t_us[1], (double) t_us[0] / (double) (t_us[1] ? t_us[1] : 1));
+
+	/* Abweichung der Strahlenden gegenueber gerundeter float-Rechnung */
+	uint32_t seed = 42;
+	uint32_t i;
+	for (i = 0; i < count; ++i) {
+		const int16_t x = (int16_t) (benchmark_rand(&seed) % 4000 - 2000);
+		const int16_t y = (int16_t) (benchmark_rand(&seed) % 4000 - 2000);
+		const int16_t head_10 = (int16_t) (benchmark_rand(&seed) % 3600);
+		const int16_t dist = (int16_t) (benchmark_rand(&seed) % (SENS_IR_MAX_DIST / 5 + 20) * 5);
+		benchmark_rand(&seed);
+		const float head = rad(head_10 / 10.f);
+		if (world_to_map(x + iroundf(dist * cosf(head))) != world_to_map((int16_t) (x + mul_fix(dist, cos_fix(head_10))))
+			|| world_to_map(y + iroundf(dist * sinf(head))) != world_to_map((int16_t) (y + mul_fix(dist, sin_fix(head_10))))) {
+			++differ;
+		}
+	}
+	printf("Abweichende Strahlenden: %" PRIu32 " von %" PRIu32 "\n", differ, count);
+
+	/* 2. komplette Eintragung in die Karte */
+	for (fixed = 0; fixed < 2; ++fixed) {
+		seed = 42;
+		map_delete();
+		struct timeval start;
+		gettimeofday(&start, NULL);
+		for (i = 0; i < count; ++i) {
+			const int16_t x = (int16_t) (benchmark_rand(&seed) % 4000 - 2000);
+			const int16_t y = (int16_t) (benchmark_rand(&seed) % 4000 - 2000);
+			const int16_t head_10 = (int16_t) (benchmark_rand(&seed) % 3600);
+			const int16_t distL = (int16_t) (benchmark_rand(&seed) % (SENS_IR_MAX_DIST / 5 + 20) * 5);
+			const int16_t distR = (int16_t) (benchmark_rand(&seed) % (SENS_IR_MAX_DIST / 5 + 20) * 5);
+			if (fixed) {
+				map_update_sensor_distance(x, y, sin_fix(head_10), cos_fix(head_10), distL, distR);
+			} else {
+				update_distance_float(x, y, head_10, distL, distR);
+			}
+		}
+		t_us[fixed] = benchmark_elapsed_us(&start);
+		if (t_us[fixed] == 0) {
+			t_us[fixed] = 1;
+		}
+		printf("Eintragen %-10s %8llu us, %10.0f Strahlen/s\n", fixed ? "Festkomma:" : "float:", (unsigned long long) t_us[fixed],
+			2.0 * count * 1000000.0 / (double) t_us[fixed]);
+	}
+	printf("Beschleunigung: %.2f\n", (double) t_us[0] / (double) t_us[1]);
+	map_delete();
+}
+
+/**
+ * Misst Export, Import und Loeschen der Karte fuer verschieden grosse erkundete Bereiche
+ * \param *file	Name der Datei fuer Export und Import
+ */
+void map_benchmark_file(const char* file) {
+	static const int16_t sizes[] = { 1000, 3000, MAP_SIZE_MM - 100 }; // Kantenlaenge des erkundeten Bereichs [mm]
+	uint8_t i;
+	for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+		map_delete();
+
+		/* Bereich um den Startplatz mit einem Muster fuellen */
+		const int16_t from_x = world_to_map((int16_t) -sizes[i] / 2);
+		const int16_t to_x = world_to_map((int16_t) sizes[i] / 2);
+		int16_t x, y;
+		for (y = from_x; y < to_x; ++y) {
+			for (x = from_x; x < to_x; ++x) {
+				map_set_field(x, y, (int8_t) ((x ^ y) % 200 - 100));
+			}
+		}
+		map_flush_cache();
+
+		struct timeval start;
+		gettimeofday(&start, NULL);
+		const int8_t res_save = map_save_to_file(file);
+		const uint64_t t_save = benchmark_elapsed_us(&start);
+		FILE* fp = fopen(file, "rb");
+		long size = -1;
+		if (fp) {
+			fseek(fp, 0, SEEK_END);
+			size = ftell(fp);
+			fclose(fp);
+		}
+		gettimeofday(&start, NULL);
+		const int8_t res_load = map_load_from_file(file);
+		const uint64_t t_load = benchmark_elapsed_us(&start);
+		gettimeofday(&start, NULL);
+		map_delete();
+		map_flush_cache();
+		const uint64_t t_delete = benchmark_elapsed_us(&start);
+		printf("Bereich %5d mm: Export %7llu us (%d), Datei %8ld Byte, Import %7llu us (%d), Loeschen %7llu us\n", sizes[i],
+			(unsigned long long) t_save, res_save, size, (unsigned long long) t_load, res_load, (unsigned long long) t_delete);
+	}
+	remove(file);
+}
+#endif // MAP_AVAILABLE
+#endif // PC
@@ -50,7 +50,13 @@ void motor_low_init() {
  * \param right PWM rechts
 */
 void bot_motor(int16_t left, int16_t right) {
+#ifdef CMD_SNAPSHOT_AVAILABLE
+	if (! cmd_snapshot_active) { // sonst mit dem naechsten Snapshot
+		command_write(CMD_AKT_MOT, SUB_CMD_NORM, left, right, 0);
+	}
+#else
 	command_write(CMD_AKT_MOT, SUB_CMD_NORM, left, right, 0);
+#endif // CMD_SNAPSHOT_AVAILABLE
 
 	if (right < 0) {
 		direction.right = DIRECTION_BACKWARD;
@@ -82,6 +88,11 @@ void servo_low(uint8_t servo, uint8_t pos) {
 
 	values[servo - 1] = pos;
 //	LOG_DEBUG("servo_low(): command_write(CMD_AKT_SERVO, SUB_CMD_NORM, %u, %u, 0)", values[0], values[1]);
+#ifdef CMD_SNAPSHOT_AVAILABLE
+	if (cmd_snapshot_active) {
+		return; // mit dem naechsten Snapshot
+	}
+#endif
 #ifndef ARM_LINUX_BOARD
 	command_write(CMD_AKT_SERVO, SUB_CMD_NORM, values[0] / 8, values[1], 0);
 #else
@@ -0,0 +1,434 @@
+/*
+ * c't-Bot
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ * This program is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307, USA.
+ *
+ */
+
+/**
+ * \file 	offline-sim.c
+ * \brief 	Minimaler Welt-Simulator im Bot-Prozess, ersetzt ct-Sim fuer Benchmarks und Tests
+ *
+ * Differentialantrieb mit den Radmassen aus bot-local.h, die Welt ist ein Raster aus Wand, Abgrund,
+ * Linie und freier Flaeche. Die IR-Sensoren messen per Strahlverfolgung, die Entfernung wird ueber
+ * die Kennlinien in sensDistData in eine Spannung umgerechnet und wie ein Wert vom Sim ausgewertet.
+ * Ein Zyklus entspricht 10 ms Simulationszeit und wird so schnell wie moeglich gerechnet.
+ * Nicht simuliert werden Maussensor, BPS, Fernbedienung, Klappe und Transportfach.
+ *
+ * \author 	c't-Bot-Team
+ * \date 	18.10.2026
+ */
+
+#ifdef PC
+
+#include "ct-Bot.h"
+
+#if defined BOT_2_SIM_AVAILABLE && ! defined ARM_LINUX_BOARD
+#include "offline-sim.h"
+#include "sensor.h"
+#include "sensor_correction.h"
+#include "motor.h"
+#include "timer.h"
+#include "eeprom.h"
+#include "os_thread.h"
+#include "botcontrol.h"
+#include "cmd_tools.h"
+#include "bot-2-sim.h"
+#include "bot-logic.h"
+#include "log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+
+#define OFFLINE_SIM_STEP_MS		10		/**< Simulationszeit pro Zyklus [ms] */
+#define OFFLINE_SIM_ARENA_SIZE	4096	/**< Kantenlaenge der eingebauten Welt [mm] */
+#define OFFLINE_SIM_IR_RANGE	(SENS_IR_MAX_DIST + 100)	/**< Reichweite der Strahlverfolgung fuer die IR-Sensoren [mm] */
+#define OFFLINE_SIM_LINE_POS_SW	10		/**< Abstand der Liniensensoren von der Mittelachse [mm], sie liegen vorn zwischen den Abgrundsensoren */
+#define OFFLINE_SIM_DARK		0x3ff	/**< Abgrund- bzw. Liniensensor ueber Abgrund oder Linie */
+#define OFFLINE_SIM_BRIGHT		0x050	/**< Abgrund- bzw. Liniensensor ueber freier Flaeche */
+
+/* Grauwerte der Welt, jeweils Obergrenze (exklusiv) */
+#define WORLD_WALL		64		/**< Wand */
+#define WORLD_HOLE		96		/**< Abgrund */
+#define WORLD_LINE		128		/**< Linie auf dem Boden */
+#define WORLD_FREE		255		/**< freie Flaeche (Wert fuer die eingebaute Welt) */
+
+/** Anzahl der Wertepaare einer IR-Kennlinie */
+#define IR_DATA_COUNT	(sizeof((distSens_t[]) SENSDIST_DATA_LEFT) / sizeof(distSens_t))
+
+static uint8_t * world = NULL;	/**< Zellen der Welt, Zeile 0 ist oben (wie PGM) */
+static int16_t world_width;		/**< Breite der Welt [Zellen] */
+static int16_t world_height;	/**< Hoehe der Welt [Zellen] */
+
+static float sim_x;				/**< X-Position des Bots in der Welt [mm] */
+static float sim_y;				/**< Y-Position des Bots in der Welt [mm] */
+static float sim_heading;		/**< Blickrichtung des Bots in der Welt [rad] */
+static float enc_rest_l;		/**< noch nicht als Encoder-Tick gemeldeter Weg links [Ticks] */
+static float enc_rest_r;		/**< noch nicht als Encoder-Tick gemeldeter Weg rechts [Ticks] */
+
+static uint32_t sim_ticks;		/**< Anzahl der simulierten Zyklen */
+static uint32_t sim_ticks_max;	/**< Anzahl der zu simulierenden Zyklen, 0: unbegrenzt */
+static uint32_t sim_collisions;	/**< Anzahl der Zyklen, in denen der Bot blockiert war */
+static char * sim_remotecall;	/**< RemoteCall fuer den ersten Zyklus oder NULL */
+static struct timeval sim_start;	/**< Startzeit (erster Zyklus) */
+
+/**
+ * Liefert die Zelle der Welt an einer Position
+ * \param x	X-Koordinate [mm]
+ * \param y	Y-Koordinate [mm]
+ * \return	Zeiger auf die Zelle oder NULL ausserhalb der Welt
+ */
+static uint8_t * world_cell(float x, float y) {
+	const int32_t col = (int32_t) floorf(x / OFFLINE_SIM_CELL_SIZE) + world_width / 2;
+	const int32_t row = world_height / 2 - 1 - (int32_t) floorf(y / OFFLINE_SIM_CELL_SIZE);
+	if (col < 0 || col >= world_width || row < 0 || row >= world_height) {
+		return NULL;
+	}
+	return &world[row * world_width + col];
+}
+
+/**
+ * Liefert den Grauwert der Welt an einer Position
+ * \param x	X-Koordinate [mm]
+ * \param y	Y-Koordinate [mm]
+ * \return	Grauwert, ausserhalb der Welt 0 (Wand)
+ */
+static uint8_t world_get(float x, float y) {
+	const uint8_t * cell = world_cell(x, y);
+	return cell ? *cell : 0;
+}
+
+/**
+ * Setzt ein Rechteck der Welt auf einen Grauwert
+ * \param x1	X-Koordinate der linken unteren Ecke [mm]
+ * \param y1	Y-Koordinate der linken unteren Ecke [mm]
+ * \param x2	X-Koordinate der rechten oberen Ecke [mm] (exklusiv)
+ * \param y2	Y-Koordinate der rechten oberen Ecke [mm] (exklusiv)
+ * \param value	Grauwert
+ */
+static void world_fill(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t value) {
+	int16_t y, x;
+	for (y = y1; y < y2; y += OFFLINE_SIM_CELL_SIZE) {
+		for (x = x1; x < x2; x += OFFLINE_SIM_CELL_SIZE) {
+			uint8_t * cell = world_cell(x, y);
+			if (cell) {
+				*cell = value;
+			}
+		}
+	}
+}
+
+/**
+ * Legt die eingebaute Welt an: ummauerte Flaeche mit Saeule, Wandstueck, Abgrund und Linie
+ * \return	0, falls alles OK; -3 kein Speicher
+ */
+static int8_t world_arena(void) {
+	world_width = world_height = OFFLINE_SIM_ARENA_SIZE / OFFLINE_SIM_CELL_SIZE;
+	world = malloc((size_t) world_width * (size_t) world_height);
+	if (world == NULL) {
+		return -3;
+	}
+	const int16_t max = OFFLINE_SIM_ARENA_SIZE / 2;
+	world_fill(-max, -max, max, max, WORLD_FREE);
+	world_fill(-max, -max, max, -max + 40, 0);
+	world_fill(-max, max - 40, max, max, 0);
+	world_fill(-max, -max, -max + 40, max, 0);
+	world_fill(max - 40, -max, max, max, 0);
+	world_fill(800, 400, 1200, 800, 0); // Saeule
+	world_fill(-1600, 600, -400, 640, 0); // Wandstueck
+	world_fill(-1400, -1400, -1000, -1000, WORLD_WALL + 16); // Abgrund
+	world_fill(-1800, 1500, 1800, 1520, WORLD_HOLE + 16); // Linie
+	return 0;
+}
+
+/**
+ * Liest das naechste Feld des PGM-Kopfs, Kommentare werden uebersprungen
+ * \param *file	PGM-Datei
+ * \return		Wert des Felds oder -1 bei Fehlern
+ */
+static int32_t pgm_header_field(FILE * file) {
+	int ch;
+	while ((ch = fgetc(file)) != EOF) {
+		if (ch == '#') {
+			while ((ch = fgetc(file)) != EOF && ch != '\n') {}
+		} else if (ch != ' ' && ch != '\t' && ch != '\r' && ch != '\n') {
+			break;
+		}
+	}
+	int32_t value = 0;
+	if (ch < '0' || ch > '9') {
+		return -1;
+	}
+	while (ch >= '0' && ch <= '9') {
+		value = value * 10 + (ch - '0');
+		ch = fgetc(file); // genau ein Trennzeichen nach dem letzten Feld
+	}
+	return value;
+}
+
+/**
+ * Laedt die Welt aus einer PGM-Datei (P5, 8 Bit)
+ * \param *name	Dateiname
+ * \return		0, falls alles OK; -1 Datei nicht lesbar, -2 keine gueltige PGM-Datei, -3 kein Speicher
+ */
+static int8_t world_load(const char * name) {
+	FILE * file = fopen(name, "rb");
+	if (file == NULL) {
+		return -1;
+	}
+	int8_t res = -2;
+	char magic[2];
+	if (fread(magic, sizeof(magic), 1, file) == 1 && magic[0] == 'P' && magic[1] == '5') {
+		const int32_t width = pgm_header_field(file);
+		const int32_t height = pgm_header_field(file);
+		const int32_t maxval = pgm_header_field(file);
+		if (width > 0 && width <= INT16_MAX && height > 0 && height <= INT16_MAX && maxval > 0 && maxval < 256) {
+			world_width = (int16_t) width;
+			world_height = (int16_t) height;
+			world = malloc((size_t) width * (size_t) height);
+			if (world == NULL) {
+				res = -3;
+			} else if (fread(world, (size_t) width * (size_t) height, 1, file) == 1) {
+				res = 0;
+			}
+		}
+	}
+	fclose(file);
+	return res;
+}
+
+/**
+ * Schaltet auf den Offline-Sim um: Die Sensordaten werden danach im Bot-Prozess berechnet statt vom Sim empfangen.
+ * \param *world		Name der PGM-Datei oder OFFLINE_SIM_ARENA
+ * \param ticks			Anzahl der zu simulierenden Zyklen (je 10 ms), danach wird das Programm beendet
+ * \param *remotecall	RemoteCall, der im ersten Zyklus gestartet wird, oder NULL
+ * \return				0, falls alles OK; -1 Datei nicht lesbar, -2 keine gueltige PGM-Datei, -3 kein Speicher
+ */
+int8_t offline_sim_init(const char * world_name, uint32_t ticks, const char * remotecall) {
+	const int8_t res = strcmp(world_name, OFFLINE_SIM_ARENA) == 0 ? world_arena() : world_load(world_name);
+	if (res != 0) {
+		free(world);
+		world = NULL;
+		return res;
+	}
+	sim_x = sim_y = sim_heading = 0.f;
+	enc_rest_l = enc_rest_r = 0.f;
+	sim_ticks = 0;
+	sim_ticks_max = ticks;
+	sim_collisions = 0;
+	sim_remotecall = remotecall ? strdup(remotecall) : NULL;
+	return 0;
+}
+
+/**
+ * Prueft, ob der Offline-Sim aktiv ist
+ * \return	1, falls die Sensordaten vom Offline-Sim kommen, sonst 0
+ */
+uint8_t offline_sim_active(void) {
+	return world != NULL;
+}
+
+/**
+ * Prueft, ob der Bot an einer Position mit einer Wand ueberlappt oder mit der Mitte ueber einem Abgrund steht
+ * \param x	X-Koordinate der Botmitte [mm]
+ * \param y	Y-Koordinate der Botmitte [mm]
+ * \return	1 bei Kollision, sonst 0
+ */
+static uint8_t collides(float x, float y) {
+	const uint8_t center = world_get(x, y);
+	if (center >= WORLD_WALL && center < WORLD_HOLE) {
+		return 1;
+	}
+	const int16_t r = BOT_DIAMETER / 2;
+	int16_t dx, dy;
+	for (dy = -r; dy <= r; dy += OFFLINE_SIM_CELL_SIZE / 2) {
+		for (dx = -r; dx <= r; dx += OFFLINE_SIM_CELL_SIZE / 2) {
+			if (dx * dx + dy * dy <= r * r && world_get(x + dx, y + dy) < WORLD_WALL) {
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+/**
+ * Rechnet eine Position im Bot-Koordinatensystem in Weltkoordinaten um
+ * \param fw	Abstand nach vorn [mm]
+ * \param sw	Abstand nach links [mm]
+ * \param *p_x	Zeiger auf X-Koordinate [mm]
+ * \param *p_y	Zeiger auf Y-Koordinate [mm]
+ */
+static void bot_to_world(float fw, float sw, float * p_x, float * p_y) {
+	const float c = cosf(sim_heading);
+	const float s = sinf(sim_heading);
+	*p_x = sim_x + fw * c - sw * s;
+	*p_y = sim_y + fw * s + sw * c;
+}
+
+/**
+ * Misst per Strahlverfolgung die Entfernung eines IR-Sensors zur naechsten Wand in Blickrichtung
+ * \param sw	Abstand des Sensors von der Mittelachse nach links [mm]
+ * \return		Entfernung [mm], OFFLINE_SIM_IR_RANGE falls keine Wand in Reichweite
+ */
+static int16_t ir_distance(float sw) {
+	float x, y;
+	bot_to_world(DISTSENSOR_POS_FW, sw, &x, &y);
+	const float c = cosf(sim_heading);
+	const float s = sinf(sim_heading);
+	int16_t d;
+	for (d = 0; d < OFFLINE_SIM_IR_RANGE; d += OFFLINE_SIM_CELL_SIZE / 2) {
+		if (world_get(x + d * c, y + d * s) < WORLD_WALL) {
+			break;
+		}
+	}
+	return d;
+}
+
+/**
+ * Rechnet eine Entfernung ueber die Kennlinie eines IR-Sensors in die Spannung um, die der Sim liefern wuerde
+ * \param *data	Kennlinie (sensDistDataL oder sensDistDataR), nach Entfernung aufsteigend
+ * \param dist	Entfernung [mm]
+ * \return		Spannung wie in der Kennlinie, 1023 unterhalb und 0 oberhalb des Messbereichs
+ */
+static uint16_t ir_voltage(const distSens_t * data, int16_t dist) {
+	uint16_t d0 = ctbot_eeprom_read_word(&data[0].dist);
+	uint16_t v0 = ctbot_eeprom_read_word(&data[0].voltage);
+	if (dist <= (int16_t) d0) {
+		return 1023;
+	}
+	uint8_t i;
+	for (i = 1; i < IR_DATA_COUNT; ++i) {
+		const uint16_t d1 = ctbot_eeprom_read_word(&data[i].dist);
+		const uint16_t v1 = ctbot_eeprom_read_word(&data[i].voltage);
+		if (dist <= (int16_t) d1) {
+			return (uint16_t) (v0 - (int32_t) (v0 - v1) * (dist - d0) / (d1 - d0));
+		}
+		d0 = d1;
+		v0 = v1;
+	}
+	return 0;
+}
+
+/**
+ * Liefert den Wert eines Abgrund- oder Liniensensors
+ * \param fw	Abstand des Sensors nach vorn [mm]
+ * \param sw	Abstand des Sensors nach links [mm]
+ * \param limit	WORLD_HOLE fuer Abgrundsensoren, WORLD_LINE fuer Liniensensoren
+ * \return		OFFLINE_SIM_DARK oder OFFLINE_SIM_BRIGHT
+ */
+static int16_t floor_sensor(float fw, float sw, uint8_t limit) {
+	float x, y;
+	bot_to_world(fw, sw, &x, &y);
+	const uint8_t value = world_get(x, y);
+	return value >= WORLD_WALL && value < limit ? OFFLINE_SIM_DARK : OFFLINE_SIM_BRIGHT;
+}
+
+/**
+ * Bewegt den Bot um einen Zyklus mit den aktuellen Motorwerten und zaehlt die Encoder weiter
+ */
+static void move(void) {
+	/* wie ct-Sim: Motorwert ist die halbe Radgeschwindigkeit in mm/s, siehe motor_set() */
+	const float dl = motor_left * 2.f * OFFLINE_SIM_STEP_MS / 1000.f;
+	const float dr = motor_right * 2.f * OFFLINE_SIM_STEP_MS / 1000.f;
+	if (dl == 0.f && dr == 0.f) {
+		return;
+	}
+	const float dheading = (dr - dl) / WHEEL_TO_WHEEL_DIAMETER;
+	const float mid = sim_heading + dheading / 2.f;
+	const float x = sim_x + (dl + dr) / 2.f * cosf(mid);
+	const float y = sim_y + (dl + dr) / 2.f * sinf(mid);
+	if (collides(x, y)) {
+		++sim_collisions;
+		return; // Raeder drehen durch, Encoder stehen
+	}
+	sim_x = x;
+	sim_y = y;
+	sim_heading += dheading;
+
+	enc_rest_l += dl * ENCODER_MARKS / WHEEL_PERIMETER;
+	enc_rest_r += dr * ENCODER_MARKS / WHEEL_PERIMETER;
+	const int16_t ticks_l = (int16_t) enc_rest_l;
+	const int16_t ticks_r = (int16_t) enc_rest_r;
+	enc_rest_l -= ticks_l;
+	enc_rest_r -= ticks_r;
+	sensEncL += ticks_l; // wie CMD_SENS_ENC
+	sensEncR += ticks_r;
+}
+
+/**
+ * Gibt die Statistiken aus und beendet das Programm
+ */
+static void offline_sim_end(void) {
+	struct timeval end;
+	GETTIMEOFDAY(&end, NULL);
+	const double secs = (double) (end.tv_sec - sim_start.tv_sec) + (double) (end.tv_usec - sim_start.tv_usec) / 1000000.0;
+	const double sim_secs = sim_ticks * (OFFLINE_SIM_STEP_MS / 1000.0);
+	printf("Offline-Sim beendet: %" PRIu32 " Zyklen (%.1f s Simulationszeit) in %.3f s, %.0f Zyklen/s, %.1fx Echtzeit, %" PRIu32 " Zyklen blockiert\n",
+		sim_ticks, sim_secs, secs, secs > 0.0 ? sim_ticks / secs : 0.0, secs > 0.0 ? sim_secs / secs : 0.0, sim_collisions);
+	printf("Position Welt: x=%d y=%d heading=%d, Bot: x=%d y=%d heading=%d\n", (int16_t) sim_x, (int16_t) sim_y,
+		(int16_t) (sim_heading * (float) (180.0 / M_PI)), x_pos, y_pos, heading_int);
+	free(world);
+	world = NULL;
+	ctbot_shutdown(); // beendet das Programm
+}
+
+/**
+ * Simuliert einen Zyklus (10 ms) mit den aktuellen Motorwerten und setzt die Sensordaten wie nach einem
+ * CMD_DONE vom Sim (Ersatz fuer bot_2_sim_listen()).
+ */
+void offline_sim_step(void) {
+	if (sim_ticks == 0) {
+		GETTIMEOFDAY(&sim_start, NULL); // ohne Initialisierung messen
+		if (sim_remotecall) {
+#ifdef BEHAVIOUR_REMOTECALL_AVAILABLE
+			cmd_remotecall(sim_remotecall);
+#else
+			LOG_ERROR("Offline-Sim: RemoteCall \"%s\" ohne BEHAVIOUR_REMOTECALL_AVAILABLE nicht moeglich", sim_remotecall);
+#endif
+			free(sim_remotecall);
+			sim_remotecall = NULL;
+		}
+	} else if (sim_ticks == sim_ticks_max) {
+		offline_sim_end();
+	}
+
+	move();
+
+	const int16_t dist_l = ir_distance(DISTSENSOR_POS_SW);
+	const int16_t dist_r = ir_distance(-DISTSENSOR_POS_SW);
+	(*sensor_update_distance)(&sensDistL, &sensDistLToggle, sensDistDataL, ir_voltage(sensDistDataL, dist_l));
+	(*sensor_update_distance)(&sensDistR, &sensDistRToggle, sensDistDataR, ir_voltage(sensDistDataR, dist_r));
+	sensBorderL = floor_sensor(BORDERSENSOR_POS_FW, BORDERSENSOR_POS_SW, WORLD_HOLE);
+	sensBorderR = floor_sensor(BORDERSENSOR_POS_FW, -BORDERSENSOR_POS_SW, WORLD_HOLE);
+	sensLineL = floor_sensor(BORDERSENSOR_POS_FW, OFFLINE_SIM_LINE_POS_SW, WORLD_LINE);
+	sensLineR = floor_sensor(BORDERSENSOR_POS_FW, -OFFLINE_SIM_LINE_POS_SW, WORLD_LINE);
+	sensLDRL = sensLDRR = 0x200;
+	sensTrans = sensDoor = sensError = 0;
+#ifdef BPS_AVAILABLE
+	sensBPS = BPS_NO_DATA;
+#endif
+
+	/* wie CMD_DONE vom Sim */
+	++sim_ticks;
+	simultime = (int16_t) ((sim_ticks * OFFLINE_SIM_STEP_MS) % 10000);
+	system_time_isr();
+#ifdef OS_AVAILABLE
+	os_thread_wakeup();
+#endif
+}
+#endif // BOT_2_SIM_AVAILABLE && ! ARM_LINUX_BOARD
+#endif // PC
@@ -29,7 +29,9 @@
 
 #ifdef OS_AVAILABLE
 #include "os_thread.h"
+#include "timer.h"
 #include "log.h"
+#include <stdint.h>
 
 //#define DEBUG_THREADING	/**< Schalter fuer Debug-Ausgaben */
 #define DEBUG_THREAD_N	-1	/**< Thread, dessen Vorgaenge debuggt werden sollen (0-based), -1 fuer alle */
@@ -47,19 +49,30 @@ Tcb_t os_threads[OS_MAX_THREADS];	/**< Array aller Threads */
 Tcb_t * os_thread_running = NULL;	/**< Zeiger auf den Thread, der gerade laeuft */
 pthread_mutex_t os_enterCS_mutex = PTHREAD_MUTEX_INITIALIZER;	/**< Mutex fuer os_enterCS() / os_exitCS() auf PC */
 
+static void (* os_thread_main[OS_MAX_THREADS])(void);	/**< Main-Funktionen der Threads */
+static _Thread_local Tcb_t * this_thread = NULL;		/**< TCB des aktuellen Threads, NULL fuer den Main-Thread */
+
+static pthread_mutex_t sleep_mutex = PTHREAD_MUTEX_INITIALIZER;	/**< Mutex fuer os_thread_sleep() */
+static pthread_cond_t sleep_cond = PTHREAD_COND_INITIALIZER;	/**< Signalisiert eine neue Systemzeit an schlafende Threads */
+static uint8_t sleeping = 0;	/**< Anzahl der Threads in os_thread_sleep() */
+
 /**
  * Gibt einen Zeiger auf den TCB des aktuellen Threads zurueck
- * \return	Zeiger auf TCB aus os_threads[]
+ * \return	Zeiger auf TCB aus os_threads[] oder NULL fuer den Main-Thread
  */
 static Tcb_t * get_this_thread(void) {
-#ifndef WIN32
-	uint8_t i;
-	for (i=0; i<OS_MAX_THREADS-1; i++) {
-		if (os_threads[i] == pthread_self()) {
-			return &os_threads[i];
-		}
-	}
-#endif	// WIN32
+	return this_thread;
+}
+
+/**
+ * Startfunktion fuer alle mit os_create_thread() angelegten Threads
+ * \param *arg	Index des Threads in os_threads[]
+ * \return		NULL
+ */
+static void * thread_start(void * arg) {
+	const uint8_t i = (uint8_t) (uintptr_t) arg;
+	this_thread = &os_threads[i];
+	os_thread_main[i]();
 	return NULL;
 }
 
@@ -82,7 +95,8 @@ Tcb_t * os_create_thread(void * pStack, void (* pIp)(void)) {
 	}
 	uint8_t i = thread_count;
 	thread_count++;
-	pthread_create(&os_threads[i], NULL, (void * (*)(void *)) pIp, NULL);
+	os_thread_main[i] = pIp;
+	pthread_create(&os_threads[i], NULL, thread_start, (void *) (uintptr_t) i);
 	LOG_DEBUG("Thread 0x%08x als Thread Nr. %u angelegt", &os_threads[i], i);
 	/* Zeiger auf TCB des Threads zurueckgeben */
 	return &os_threads[i];
@@ -101,15 +115,47 @@ void os_thread_yield(void) {
  * Blockiert den aktuellten Thread fuer die angegebene Zeit und schaltet
  * auf einen anderen Thread um
  * => coorporative threadswitch
+ * Die Zeit laeuft wie auf dem MCU in Systemzeit (Simulationszeit), der Thread wartet also,
+ * bis tickCount um ms weitergezaehlt hat. Der Main-Thread treibt die Systemzeit selbst voran
+ * (Auswertung von CMD_DONE) und kann nicht auf sie warten, er und andere Threads ausserhalb von
+ * os_threads[] geben daher wie bisher nur die Zeitscheibe ab; so bremst z.B. bot_scan_onthefly_behaviour()
+ * weder den Lock-Step mit dem Sim noch den Offline-Sim oder das Trace-Replay auf Echtzeit.
  * \param ms	Zeit in ms, die der aktuelle Thread blockiert wird
  */
 void os_thread_sleep(uint32_t ms) {
-	(void) ms; // kein warning
-	// NOP
 	Tcb_t * thread = get_this_thread();
 	if (DEBUG_THREAD_N == -1 || thread == &os_threads[DEBUG_THREAD_N]) {
-		LOG_DEBUG("Thread %p soll %u ms schlafen, os_thread_sleep() ist aber nicht implementiert", thread, ms);
+		LOG_DEBUG("Thread %p schlaeft fuer %" PRIu32 " ms", thread, ms);
+	}
+	if (ms == 0 || ! thread) {
+		sched_yield();
+		return;
+	}
+
+	pthread_mutex_lock(&sleep_mutex);
+	const uint32_t wakeup = TIMER_GET_TICKCOUNT_32 + MS_TO_TICKS(ms);
+	++sleeping;
+	while ((int32_t) (TIMER_GET_TICKCOUNT_32 - wakeup) < 0) {
+		pthread_cond_wait(&sleep_cond, &sleep_mutex);
+	}
+	--sleeping;
+	pthread_mutex_unlock(&sleep_mutex);
+
+	if (DEBUG_THREAD_N == -1 || thread == &os_threads[DEBUG_THREAD_N]) {
+		LOG_DEBUG("Thread %p laeuft weiter", thread);
+	}
+}
+
+/**
+ * Weckt die Threads, die in os_thread_sleep() auf die Systemzeit warten.
+ * Wird nach jeder Aktualisierung der Systemzeit (CMD_DONE vom Sim) aufgerufen.
+ */
+void os_thread_wakeup(void) {
+	pthread_mutex_lock(&sleep_mutex);
+	if (sleeping) {
+		pthread_cond_broadcast(&sleep_cond);
 	}
+	pthread_mutex_unlock(&sleep_mutex);
 }
 
 /**
@@ -31,6 +31,9 @@
 #include "log.h"
 #include <stdlib.h>
 #include <stdio.h>
+#ifndef WIN32
+#include <sys/mman.h>
+#endif
 
 uint8_t sdfat_open(const char* filename, pFatFile* p_file, uint8_t mode) {
 	char* file_mode;
@@ -191,6 +194,50 @@ uint8_t sdfat_sync_vol(pSdFat p_instance) {
 	return 0;
 }
 
+void* sdfat_mmap(pFatFile p_file, uint32_t length) {
+#ifndef WIN32
+	if (! p_file || sdfat_flush(p_file)) {
+		return NULL;
+	}
+	if (sdfat_get_filesize(p_file) < length) {
+		LOG_ERROR("sdfat_mmap(): file too small for %" PRIu32 " byte", length);
+		return NULL;
+	}
+
+	void* p_addr = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fileno(p_file), 0);
+	if (p_addr == MAP_FAILED) {
+		LOG_ERROR("sdfat_mmap(%" PRIu32 "): mmap failed:", length);
+		perror(NULL);
+		return NULL;
+	}
+	return p_addr;
+#else
+	(void) p_file;
+	(void) length;
+	return NULL;
+#endif // WIN32
+}
+
+uint8_t sdfat_msync(void* p_addr, uint32_t length) {
+#ifndef WIN32
+	return ! msync(p_addr, length, MS_ASYNC) ? 0 : 1;
+#else
+	(void) p_addr;
+	(void) length;
+	return 1;
+#endif // WIN32
+}
+
+uint8_t sdfat_munmap(void* p_addr, uint32_t length) {
+#ifndef WIN32
+	return ! munmap(p_addr, length) ? 0 : 1;
+#else
+	(void) p_addr;
+	(void) length;
+	return 1;
+#endif // WIN32
+}
+
 void sdfat_test(void) {
 	pFatFile file;
 	if (sdfat_open("test.txt", &file, SDFAT_O_RDWR | SDFAT_O_TRUNC) != 0) {
@@ -119,17 +119,155 @@ void tcp_server_init(void) {
 	}
 }
 
+/** Frame-Typen fuer den Benchmark-Mix */
+enum {
+	MIX_SENS,	/**< Sensordaten wie vom Sim, 10 Kommandos ohne Payload */
+	MIX_MAP,	/**< Map-Block, 4 Kommandos mit je 128 Byte Payload */
+	MIX_LOG,	/**< Log-Zeile, 1 Kommando mit 64 Byte Payload */
+	MIX_RC,		/**< Remote-Call-Auftrag, 1 Kommando mit 33 Byte Payload */
+	MIX_TYPES	/**< Anzahl der Frame-Typen */
+};
+
+/** Eintrag im Benchmark-Mix */
+typedef struct {
+	const char * name;	/**< Bezeichnung auf der Kommandozeile */
+	int count;			/**< Anzahl pro Tick */
+} bench_mix_t;
+
+static bench_mix_t bench_mix[MIX_TYPES] = {
+	{ "sens", 1 },
+	{ "map", 0 },
+	{ "log", 0 },
+	{ "rc", 0 },
+};
+
+static uint8_t bench_csv = 0; /**< Zusammenfassung als CSV ausgeben */
+
+/**
+ * Setzt den Frame-Mix fuer tcp_server_run()
+ * \param *mix	Mix als "typ[:anzahl],...", Typen: sens, map, log, rc; z.B. "sens,map:2,log:4"
+ * \return		0, falls der Mix gueltig war
+ */
+int8_t tcp_server_set_mix(const char * mix) {
+	char tmp[128];
+	if (strlen(mix) >= sizeof(tmp)) {
+		return -1;
+	}
+	strcpy(tmp, mix);
+
+	int i;
+	for (i = 0; i < MIX_TYPES; ++i) {
+		bench_mix[i].count = 0;
+	}
+	char * token;
+	for (token = strtok(tmp, ","); token; token = strtok(NULL, ",")) {
+		char * count = strchr(token, ':');
+		if (count) {
+			*count++ = 0;
+		}
+		for (i = 0; i < MIX_TYPES; ++i) {
+			if (strcmp(token, bench_mix[i].name) == 0) {
+				bench_mix[i].count = count ? atoi(count) : 1;
+				break;
+			}
+		}
+		if (i == MIX_TYPES || bench_mix[i].count < 0) {
+			printf("Unbekannter Frame-Typ \"%s\"\n", token);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Schaltet die Ausgabe der Benchmark-Zusammenfassung als CSV an oder aus
+ * \param csv	1: CSV, 0: Text
+ */
+void tcp_server_set_csv(uint8_t csv) {
+	bench_csv = csv;
+}
+
+/**
+ * Sendet alle Kommandos eines Ticks gemaess Mix und schliesst mit CMD_DONE ab
+ * \param tick		Simulationszeit, wird mit CMD_DONE uebertragen
+ * \param *p_bytes	Zeiger auf Zaehler fuer gesendete Bytes
+ * \return			Anzahl der gesendeten Kommandos
+ */
+static unsigned send_tick(int16_t tick, unsigned long * p_bytes) {
+	static uint8_t map_data[128];
+	static const char log_line[64] = "tcp-server benchmark: Lorem ipsum dolor sit amet, consectetur";
+	static uint8_t rc_data[33] = "bot_drive_distance";
+	unsigned frames = 0;
+	int n;
+
+	for (n = 0; n < bench_mix[MIX_SENS].count; ++n) {
+		command_write(CMD_SENS_IR, SUB_CMD_NORM, tick, 0, 0);
+		command_write(CMD_SENS_ENC, SUB_CMD_NORM, tick, tick, 0);
+		command_write(CMD_SENS_BORDER, SUB_CMD_NORM, tick, tick, 0);
+		command_write(CMD_SENS_LINE, SUB_CMD_NORM, tick, tick, 0);
+		command_write(CMD_SENS_LDR, SUB_CMD_NORM, tick, tick, 0);
+		command_write(CMD_SENS_TRANS, SUB_CMD_NORM, tick, 0, 0);
+		command_write(CMD_SENS_DOOR, SUB_CMD_NORM, tick, 0, 0);
+		command_write(CMD_SENS_MOUSE, SUB_CMD_NORM, tick, tick, 0);
+		command_write(CMD_SENS_ERROR, SUB_CMD_NORM, tick, 0, 0);
+		command_write(CMD_SENS_RC5, SUB_CMD_NORM, tick, 0, 0);
+		frames += 10;
+		*p_bytes += 10 * sizeof(command_t);
+	}
+	for (n = 0; n < bench_mix[MIX_MAP].count; ++n) {
+		uint8_t part;
+		for (part = 0; part < 4; ++part) {
+			command_write_rawdata(CMD_MAP, SUB_MAP_DATA_1 + part, (int16_t) n, tick, sizeof(map_data), map_data);
+		}
+		frames += 4;
+		*p_bytes += 4 * (sizeof(command_t) + sizeof(map_data));
+	}
+	for (n = 0; n < bench_mix[MIX_LOG].count; ++n) {
+		command_write_rawdata(CMD_LOG, SUB_CMD_NORM, 0, 0, sizeof(log_line), log_line);
+		++frames;
+		*p_bytes += sizeof(command_t) + sizeof(log_line);
+	}
+	for (n = 0; n < bench_mix[MIX_RC].count; ++n) {
+		command_write_rawdata(CMD_REMOTE_CALL, SUB_REMOTE_CALL_ORDER, 0, 0, sizeof(rc_data), rc_data);
+		++frames;
+		*p_bytes += sizeof(command_t) + sizeof(rc_data);
+	}
+
+	command_write(CMD_DONE, SUB_CMD_NORM, tick, 0, 0); // flusht auch den Sendepuffer
+	*p_bytes += sizeof(command_t);
+	return frames + 1;
+}
+
+/**
+ * Vergleichsfunktion fuer qsort()
+ */
+static int compare_uint(const void * a, const void * b) {
+	const unsigned x = *(const unsigned *) a;
+	const unsigned y = *(const unsigned *) b;
+	return x < y ? -1 : x > y;
+}
+
 /**
- * Hauptschleife des TCP-Servers
- * \param runs	Anzahl der Durchlaeufe
+ * Hauptschleife des TCP-Servers. Sendet pro Tick die Kommandos gemaess Mix (tcp_server_set_mix()),
+ * wartet auf das Echo des Test-Clients und gibt am Ende Latenz-Perzentile und Durchsatz aus.
+ * \param runs	Anzahl der Durchlaeufe (Ticks)
  */
 void tcp_server_run(int runs) {
-	char buffer[MAX_PAYLOAD + sizeof(command_t)];
-	struct timeval start, stop;
+	uint8_t buffer[MAX_PAYLOAD];
+	struct timeval start, stop, bench_start, bench_stop;
+
+	if (runs <= 0) {
+		runs = 1;
+	}
+	unsigned * rtt = malloc(sizeof(unsigned) * (size_t) runs);
+	if (! rtt) {
+		printf("malloc() failed\n");
+		exit(1);
+	}
 	printf("TCP-Server alive\n");
 
 	uint8_t seq = 1;
-	unsigned long t_sum = 0, t2_sum = 0;
+	unsigned long frames_sent = 0, frames_received = 0, bytes_sent = 0, bytes_received = 0;
 
 	/* Set the size of the in-out parameter */
 	clntLen = sizeof(clientAddr);
@@ -141,72 +279,86 @@ void tcp_server_run(int runs) {
 	}
 
 	printf("Connected to %s on Port: %u\n", inet_ntoa(clientAddr.sin_addr), PORT);
+	set_bot_2_sim();
+	const uint32_t recv_calls = tcp_recv_calls;
 
 	int16_t simultime = 0;
 	int i;
-	for (i=0; i<runs; i++) {
+	GETTIMEOFDAY(&bench_start, NULL);
+	for (i = 0; i < runs; i++) {
 		simultime += 10;
-		//printf("i=%d\n", i);
 		GETTIMEOFDAY(&start, NULL);
-		command_write(CMD_SENS_IR, SUB_CMD_NORM, simultime, 0, 0);
-		command_write(CMD_SENS_ENC, SUB_CMD_NORM, simultime, simultime, 0);
-		command_write(CMD_SENS_BORDER, SUB_CMD_NORM, simultime, simultime, 0);
-		command_write(CMD_SENS_LINE, SUB_CMD_NORM, simultime, simultime, 0);
-		command_write(CMD_SENS_LDR, SUB_CMD_NORM, simultime, simultime, 0);
-		command_write(CMD_SENS_TRANS, SUB_CMD_NORM, simultime, 0, 0);
-		command_write(CMD_SENS_DOOR, SUB_CMD_NORM, simultime, 0, 0);
-		command_write(CMD_SENS_MOUSE, SUB_CMD_NORM, simultime, simultime, 0);
-		command_write(CMD_SENS_ERROR, SUB_CMD_NORM, simultime, 0, 0);
-		command_write(CMD_SENS_RC5, SUB_CMD_NORM, simultime, 0, 0);
-
-		command_write(CMD_DONE, SUB_CMD_NORM, simultime, 0, 0);
-		flushSendBuffer();
-
-		GETTIMEOFDAY(&stop, NULL);
-		int t2 = (stop.tv_sec - start.tv_sec)*1000000 + stop.tv_usec
-				- start.tv_usec;
-		t2_sum += t2;
-		printf("X-Token (%u) out after %u usec\n", simultime, t2);
+		frames_sent += send_tick(simultime, &bytes_sent);
 
 		received_command.request.command = 0;
-		GETTIMEOFDAY(&start, NULL);
 		while (received_command.request.command != CMD_DONE) {
 			int8_t res = command_read();
-			//printf("Command read, result=%d\n", res);
 			if (res != 0) {
 				/* Fehler */
 				printf("Probleme beim Lesen eines Kommandos\n");
-			} else {
-				/* Alles ok, evtl. muessen wir aber eine Payload abholen */
-				if (received_command.payload != 0) {
-					printf("fetching payload (%u bytes)\n", received_command.payload);
-					cmd_functions.read(buffer, received_command.payload);
-				}
-				if (received_command.seq != seq) {
-					printf("Sequenzzaehler falsch! Erwartet: %u Empfangen %u\n", seq, received_command.seq);
+				continue;
+			}
+			/* Payload abholen */
+			int16_t n = 0;
+			while (n < received_command.payload) {
+				const int16_t r = cmd_functions.read(buffer + n, received_command.payload - n);
+				if (r <= 0) {
+					break;
 				}
+				n += r;
+			}
+			++frames_received;
+			bytes_received += sizeof(command_t) + received_command.payload;
+			if (received_command.seq != seq) {
+				printf("Sequenzzaehler falsch! Erwartet: %u Empfangen %u\n", seq, received_command.seq);
 			}
 			seq = received_command.seq + 1;
-			//printf("seq=%u\n", seq);
 		}
 		GETTIMEOFDAY(&stop, NULL);
 
-		int t = (stop.tv_sec - start.tv_sec)*1000000 + stop.tv_usec - start.tv_usec;
-		t_sum += t;
-		printf("X-Token (%u) back after %u usec\n", received_command.data_l, t);
+		rtt[i] = (unsigned) ((stop.tv_sec - start.tv_sec) * 1000000 + stop.tv_usec - start.tv_usec);
 
 		if (received_command.data_l != simultime) {
 			printf("Falschen X-Frame erhalten ==> Exit\n");
 			exit(0);
 		}
 	}
+	GETTIMEOFDAY(&bench_stop, NULL);
 
 	/* Statistik */
-	unsigned int mean_send = (double)t2_sum / (double)i;
-	unsigned int mean_xfer = (double)t_sum / (2.0 * i);
-	printf("\nAverage sendtime: %u usec\nAverage transfertime (1-way): %u usec\n", mean_send, mean_xfer);
+	const double total_s = (double) (bench_stop.tv_sec - bench_start.tv_sec) + (double) (bench_stop.tv_usec - bench_start.tv_usec) / 1e6;
+	double rtt_sum = 0.0;
+	int k;
+	for (k = 0; k < i; ++k) {
+		rtt_sum += rtt[k];
+	}
+	qsort(rtt, (size_t) i, sizeof(unsigned), compare_uint);
+	const unsigned p50 = rtt[(i - 1) * 50 / 100];
+	const unsigned p95 = rtt[(i - 1) * 95 / 100];
+	const unsigned p99 = rtt[(i - 1) * 99 / 100];
+	const double frames_s = (double) (frames_sent + frames_received) / total_s;
+	const double bytes_s = (double) (bytes_sent + bytes_received) / total_s;
+	const double recv_per_tick = (double) (tcp_recv_calls - recv_calls) / (double) i;
+
+	char mix[128] = "";
+	for (k = 0; k < MIX_TYPES; ++k) {
+		if (bench_mix[k].count) {
+			snprintf(mix + strlen(mix), sizeof(mix) - strlen(mix), "%s%s:%d", mix[0] ? "," : "", bench_mix[k].name, bench_mix[k].count);
+		}
+	}
 
-	printf("\nTCP-Server hat seine %d runs durch und beendet sich.\nSo long and thanks for all the fish!\n", runs);
+	if (bench_csv) {
+		printf("mix;ticks;frames_per_tick;bytes_per_tick;rtt_mean_us;rtt_p50_us;rtt_p95_us;rtt_p99_us;rtt_max_us;frames_per_s;bytes_per_s;recv_per_tick\n");
+		printf("%s;%d;%lu;%lu;%.1f;%u;%u;%u;%u;%.0f;%.0f;%.2f\n", mix, i, frames_sent / (unsigned long) i, bytes_sent / (unsigned long) i, rtt_sum / i, p50, p95, p99, rtt[i - 1],
+			frames_s, bytes_s, recv_per_tick);
+	} else {
+		printf("\nMix: %s, %d Ticks, %lu Frames / %lu Byte pro Tick und Richtung\n", mix, i, frames_sent / (unsigned long) i, bytes_sent / (unsigned long) i);
+		printf("Round-trip: mean %.1f usec, p50 %u usec, p95 %u usec, p99 %u usec, max %u usec\n", rtt_sum / i, p50, p95, p99, rtt[i - 1]);
+		printf("Durchsatz (beide Richtungen): %.0f Frames/s, %.0f Byte/s\n", frames_s, bytes_s);
+		printf("recv() calls per tick: %.2f\n", recv_per_tick);
+		printf("\nTCP-Server hat seine %d runs durch und beendet sich.\nSo long and thanks for all the fish!\n", runs);
+	}
+	free(rtt);
 
 #ifdef WIN32
 	WSACleanup();
@@ -225,33 +377,36 @@ void tcp_test_client_init(void) {
 }
 
 /**
- * Hauptschleife des TCP-Test-Clients
+ * Hauptschleife des TCP-Test-Clients. Schickt alle Kommandos samt Payload
+ * unveraendert zurueck, ein Tick endet mit CMD_DONE.
  * \param runs	Anzahl der Durchlaeufe, 0 fuer unendlich
  */
 void tcp_test_client_run(int runs) {
-	char buffer[sizeof(command_t)];
-
 	if (runs > 0) {
-		printf("Answering %d frames\n", runs);
+		printf("Answering %d ticks\n", runs);
 	} else {
-		printf("Answering all frames\n");
+		printf("Answering all ticks\n");
 	}
 
 	int i;
-	for(i=0; runs==0 || i<runs; i++) {
-		//printf("i=%d\n", i);
-		int j;
-		/* 11 Commands lesen und zurueckschicken */
-		for (j=0; j<11; j++) {
-			int len = tcp_read(buffer, sizeof(command_t));
-			//printf("len=%d\n", len);
-			tcp_write(buffer, len);
+	for (i = 0; runs == 0 || i < runs; i++) {
+		uint8_t done = 0;
+		while (! done) {
+			const command_t * cmd = tcp_peek(sizeof(command_t));
+			if (! cmd || cmd->startCode != CMD_STARTCODE) {
+				tcp_consume(1); // bis zum naechsten Startcode verwerfen
+				continue;
+			}
+			/* Kommando inkl. Payload direkt aus dem Empfangspuffer zurueckschicken */
+			const int16_t len = (int16_t) (sizeof(command_t) + cmd->payload);
+			cmd = tcp_peek(len);
+			done = cmd->request.command == CMD_DONE;
+			tcp_write(cmd, len);
+			tcp_consume(len);
 		}
 		flushSendBuffer();
-		printf(".");
-		fflush(stdout);
 	}
-	printf("\nFinished %d frames\n", runs);
+	printf("\nFinished %d ticks, %.2f recv() calls per tick\n", runs, runs > 0 ? (double) tcp_recv_calls / (double) runs : 0.0);
 	tcp_closeConnection(tcp_sock);
 	exit(0);
 }
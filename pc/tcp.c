@@ -33,6 +33,7 @@
 
 #define USE_SEND_BUFFER				/**< Schalter fuer Sendepuffer an/aus */
 #define TCP_SEND_BUFFER_SIZE 4096	/**< Groesse des Sendepuffers / Byte */
+#define TCP_RECV_BUFFER_SIZE 8192	/**< Groesse des Empfangs-Ringpuffers / Byte, muss eine Zweierpotenz sein */
 
 //#define DEBUG_TCP	/**< Schalter fuer Debug-Ausgaben */
 
@@ -64,6 +65,10 @@
 #include <sys/ioctl.h>
 #include <errno.h>
 #include <signal.h>
+#ifdef BOT_2_SIM_ASYNC_AVAILABLE
+#include <poll.h>
+#include <time.h>
+#endif
 #endif // WIN32
 
 #include <stdio.h>      // for printf() and fprintf()
@@ -77,6 +82,32 @@ char * tcp_hostname = NULL;	/**< Hostname, auf dem ct-Sim laeuft */
 static uint8_t sendBuffer[TCP_SEND_BUFFER_SIZE];	/**< Sendepuffer fuer ausgehende Packete */
 static int sendBufferPtr = 0;						/**< Index in den Sendepuffer */
 
+static uint8_t recvBuffer[TCP_RECV_BUFFER_SIZE];	/**< Ringpuffer fuer empfangene Daten */
+static uint32_t recvBufferRead = 0;					/**< Leseindex in den Empfangspuffer (modulo TCP_RECV_BUFFER_SIZE) */
+static uint32_t recvBufferWrite = 0;				/**< Schreibindex in den Empfangspuffer (modulo TCP_RECV_BUFFER_SIZE) */
+static uint8_t recvLinear[MAX_PAYLOAD + sizeof(command_t)]; /**< Kopie fuer tcp_peek(), falls die Daten ueber das Ende des Ringpuffers reichen */
+uint32_t tcp_recv_calls = 0;						/**< Anzahl der recv()-Aufrufe seit Programmstart */
+
+#ifdef BOT_2_SIM_ASYNC_AVAILABLE
+#define TCP_FRAME_QUEUE_SIZE 128	/**< Anzahl der Frames in der Empfangs-Queue, muss eine Zweierpotenz sein */
+#define TCP_POLL_TIMEOUT_MS 100		/**< Timeout fuer poll() im Empfangs-Thread / ms */
+
+/** Ein vom Empfangs-Thread zerlegtes Kommando samt Payload */
+typedef struct {
+	uint16_t length;							/**< Laenge des Frames in Byte */
+	uint8_t data[sizeof(command_t) + MAX_PAYLOAD];	/**< Kommando und Payload */
+} tcp_frame_t;
+
+static tcp_frame_t frameQueue[TCP_FRAME_QUEUE_SIZE];	/**< Lock-freie Queue (ein Erzeuger, ein Verbraucher) fuer empfangene Frames */
+static uint32_t frameQueueHead = 0;		/**< Schreibindex, nur vom Empfangs-Thread veraendert */
+static uint32_t frameQueueTail = 0;		/**< Leseindex, nur vom Verbraucher veraendert */
+static uint16_t frameReadPos = 0;		/**< Leseposition im Frame frameQueueTail */
+static uint8_t receiverState = 0;		/**< 0: kein Empfangs-Thread, 1: Thread laeuft, 2: Verbindung beendet */
+static pthread_t receiverThread;		/**< Empfangs-Thread */
+static pthread_mutex_t frameMutex = PTHREAD_MUTEX_INITIALIZER;	/**< Mutex nur fuer das Warten auf neue Frames */
+static pthread_cond_t frameCond = PTHREAD_COND_INITIALIZER;		/**< Signalisiert neue Frames oder Verbindungsende */
+#endif // BOT_2_SIM_ASYNC_AVAILABLE
+
 #ifndef __WIN32__
 static int server; /**< Server-Socket */
 static struct sockaddr_in serverAddr; /**< lokale Adresse */
@@ -170,6 +201,256 @@ static inline int16_t copy2Buffer(const void * data, unsigned length) {
 	return length;
 }
 
+/**
+ * Holt alle verfuegbaren Daten (soweit Platz ist) mit einem recv() in den Empfangspuffer.
+ * Achtung: blockierend, falls keine Daten anliegen!
+ */
+static void fillRecvBuffer(void) {
+	uint32_t used = recvBufferWrite - recvBufferRead;
+	if (used == 0) {
+		/* Puffer leer, wieder vorne anfangen, damit recv() den ganzen Platz am Stueck hat */
+		recvBufferRead = recvBufferWrite = 0;
+	}
+	const uint32_t pos = recvBufferWrite & (TCP_RECV_BUFFER_SIZE - 1);
+	uint32_t space = TCP_RECV_BUFFER_SIZE - used;
+	if (space > TCP_RECV_BUFFER_SIZE - pos) {
+		space = TCP_RECV_BUFFER_SIZE - pos; // der Rest nach dem Umlauf beim naechsten Aufruf
+	}
+
+	const int n = recv(tcp_sock, (char *) &recvBuffer[pos], space, 0);
+	++tcp_recv_calls;
+	if (n <= 0) {
+		printf("recv() failed or connection closed prematurely\n");
+		exit(1);
+	}
+	recvBufferWrite += (uint32_t) n;
+	LOG_DEBUG("received %d bytes, %u in buffer", n, recvBufferWrite - recvBufferRead);
+}
+
+#ifdef BOT_2_SIM_ASYNC_AVAILABLE
+/**
+ * Empfangs-Thread: Wartet per poll() auf Daten, zerlegt den Datenstrom in Kommandos
+ * und haengt jedes vollstaendige Kommando samt Payload an die Frame-Queue an.
+ * \param *ptr	Datenparameter fuer pthread, wird nicht verwendet
+ * \return		NULL
+ */
+static void * receiver_thread(void * ptr) {
+	(void) ptr;
+	static uint8_t stage[TCP_RECV_BUFFER_SIZE];
+	uint32_t fill = 0;
+	struct pollfd pfd;
+	pfd.fd = tcp_sock;
+	pfd.events = POLLIN;
+
+	while (__atomic_load_n(&receiverState, __ATOMIC_ACQUIRE) == 1) {
+		const int res = poll(&pfd, 1, TCP_POLL_TIMEOUT_MS);
+		if (res == 0 || (res < 0 && errno == EINTR)) {
+			continue;
+		}
+		int n = -1;
+		if (res > 0) {
+			n = recv(tcp_sock, (char *) &stage[fill], sizeof(stage) - fill, 0);
+			++tcp_recv_calls;
+		}
+		if (n <= 0) {
+			break;
+		}
+		fill += (uint32_t) n;
+
+		/* vollstaendige Kommandos in die Queue uebernehmen */
+		uint32_t pos = 0;
+		uint8_t pushed = 0;
+		while (fill - pos >= sizeof(command_t)) {
+			const command_t * cmd = (const command_t *) &stage[pos];
+			if (cmd->startCode != CMD_STARTCODE || cmd->CRC != CMD_STOPCODE) {
+				/* kein gueltiger Kommandokopf, payload ist nicht vertrauenswuerdig: ab dem naechsten Byte neu synchronisieren */
+				++pos;
+				continue;
+			}
+			const uint32_t length = sizeof(command_t) + cmd->payload;
+			if (fill - pos < length) {
+				break; // Rest kommt mit dem naechsten recv()
+			}
+			while (frameQueueHead - __atomic_load_n(&frameQueueTail, __ATOMIC_ACQUIRE) >= TCP_FRAME_QUEUE_SIZE) {
+				/* Queue voll, Verbraucher kommt nicht hinterher */
+				struct timespec s = { 0, 500000L };
+				nanosleep(&s, NULL);
+			}
+			tcp_frame_t * frame = &frameQueue[frameQueueHead & (TCP_FRAME_QUEUE_SIZE - 1)];
+			memcpy(frame->data, cmd, length);
+			frame->length = (uint16_t) length;
+			__atomic_store_n(&frameQueueHead, frameQueueHead + 1, __ATOMIC_RELEASE);
+			pos += length;
+			pushed = 1;
+		}
+		fill -= pos;
+		memmove(stage, &stage[pos], fill);
+
+		if (pushed) {
+			pthread_mutex_lock(&frameMutex);
+			pthread_cond_signal(&frameCond);
+			pthread_mutex_unlock(&frameMutex);
+		}
+	}
+
+	pthread_mutex_lock(&frameMutex);
+	__atomic_store_n(&receiverState, 2, __ATOMIC_RELEASE);
+	pthread_cond_signal(&frameCond);
+	pthread_mutex_unlock(&frameMutex);
+	return NULL;
+}
+
+/**
+ * Startet den Empfangs-Thread fuer die bestehende Verbindung. Danach liefern tcp_read(),
+ * tcp_peek() und tcp_consume() die Daten aus der Frame-Queue des Threads.
+ */
+void tcp_start_receiver(void) {
+	if (tcp_sock == 0 || receiverState != 0) {
+		return;
+	}
+	frameQueueHead = frameQueueTail = 0;
+	frameReadPos = 0;
+	receiverState = 1;
+	if (pthread_create(&receiverThread, NULL, receiver_thread, NULL) != 0) {
+		LOG_ERROR("tcp_start_receiver(): pthread_create() failed");
+		receiverState = 0;
+	}
+}
+
+/**
+ * Gibt das vollstaendig gelesene Frame am Anfang der Queue frei
+ */
+static void release_frame(void) {
+	if (frameQueueTail != __atomic_load_n(&frameQueueHead, __ATOMIC_ACQUIRE)
+			&& frameReadPos >= frameQueue[frameQueueTail & (TCP_FRAME_QUEUE_SIZE - 1)].length) {
+		frameReadPos = 0;
+		__atomic_store_n(&frameQueueTail, frameQueueTail + 1, __ATOMIC_RELEASE);
+	}
+}
+
+/**
+ * Wartet, bis index nicht mehr der Schreibindex der Queue ist, also ein Frame dort bereitliegt.
+ * Beendet das Programm, falls die Verbindung geschlossen wurde.
+ * \param index	Index des gewuenschten Frames
+ */
+static void wait_for_frame(uint32_t index) {
+	if (index != __atomic_load_n(&frameQueueHead, __ATOMIC_ACQUIRE)) {
+		return;
+	}
+	pthread_mutex_lock(&frameMutex);
+	while (index == __atomic_load_n(&frameQueueHead, __ATOMIC_ACQUIRE)) {
+		if (__atomic_load_n(&receiverState, __ATOMIC_ACQUIRE) != 1) {
+			pthread_mutex_unlock(&frameMutex);
+			printf("recv() failed or connection closed prematurely\n");
+			exit(1);
+		}
+		pthread_cond_wait(&frameCond, &frameMutex);
+	}
+	pthread_mutex_unlock(&frameMutex);
+}
+
+/**
+ * Ermittelt die Anzahl der empfangenen, noch nicht (vollstaendig) gelesenen Kommandos.
+ * Wartet hoechstens timeout_ms Millisekunden, falls noch keines vorliegt.
+ * \param timeout_ms	Maximale Wartezeit / ms, 0 fuer sofortige Rueckkehr
+ * \return				Anzahl der Kommandos in der Queue
+ */
+uint16_t tcp_frames_available(uint16_t timeout_ms) {
+	if (receiverState == 0) {
+		return 0;
+	}
+	release_frame();
+	if (timeout_ms && frameQueueTail == __atomic_load_n(&frameQueueHead, __ATOMIC_ACQUIRE)) {
+		struct timespec until;
+		clock_gettime(CLOCK_REALTIME, &until);
+		until.tv_nsec += (long) timeout_ms * 1000000L;
+		until.tv_sec += until.tv_nsec / 1000000000L;
+		until.tv_nsec %= 1000000000L;
+		pthread_mutex_lock(&frameMutex);
+		while (frameQueueTail == __atomic_load_n(&frameQueueHead, __ATOMIC_ACQUIRE) && __atomic_load_n(&receiverState, __ATOMIC_ACQUIRE) == 1) {
+			if (pthread_cond_timedwait(&frameCond, &frameMutex, &until) != 0) {
+				break; // Timeout
+			}
+		}
+		pthread_mutex_unlock(&frameMutex);
+	}
+	const uint32_t n = __atomic_load_n(&frameQueueHead, __ATOMIC_ACQUIRE) - frameQueueTail;
+	if (n == 0 && __atomic_load_n(&receiverState, __ATOMIC_ACQUIRE) != 1) {
+		printf("recv() failed or connection closed prematurely\n");
+		exit(1);
+	}
+	return (uint16_t) n;
+}
+
+/**
+ * Liest Daten aus der Frame-Queue, hoechstens bis zum Ende des aktuellen Frames
+ * \param *data		Zeiger auf die Daten
+ * \param length	Anzahl der gewuenschten Bytes
+ * \return 			Anzahl der uebertragenen Bytes
+ */
+static int16_t queue_read(void * data, int16_t length) {
+	release_frame();
+	wait_for_frame(frameQueueTail);
+	const tcp_frame_t * frame = &frameQueue[frameQueueTail & (TCP_FRAME_QUEUE_SIZE - 1)];
+	uint16_t n = frame->length - frameReadPos;
+	if (n > (uint16_t) length) {
+		n = (uint16_t) length;
+	}
+	memcpy(data, &frame->data[frameReadPos], n);
+	frameReadPos += n;
+	return (int16_t) n;
+}
+
+/**
+ * Stellt length Bytes am Stueck aus der Frame-Queue bereit, ohne sie zu entnehmen
+ * \param length	Anzahl der Bytes
+ * \return			Zeiger auf die Daten
+ */
+static void * queue_peek(int16_t length) {
+	release_frame();
+	wait_for_frame(frameQueueTail);
+	tcp_frame_t * frame = &frameQueue[frameQueueTail & (TCP_FRAME_QUEUE_SIZE - 1)];
+	if (frame->length - frameReadPos >= length) {
+		return &frame->data[frameReadPos]; // Normalfall: Daten liegen in einem Frame
+	}
+
+	/* Daten verteilen sich auf mehrere Frames */
+	uint32_t index = frameQueueTail;
+	uint16_t pos = frameReadPos;
+	int16_t copied = 0;
+	while (copied < length) {
+		wait_for_frame(index);
+		frame = &frameQueue[index & (TCP_FRAME_QUEUE_SIZE - 1)];
+		int16_t n = (int16_t) (frame->length - pos);
+		if (n > length - copied) {
+			n = length - copied;
+		}
+		memcpy(&recvLinear[copied], &frame->data[pos], (size_t) n);
+		copied += n;
+		++index;
+		pos = 0;
+	}
+	return recvLinear;
+}
+
+/**
+ * Entnimmt Daten aus der Frame-Queue, die per queue_peek() gelesen wurden
+ * \param length	Anzahl der Bytes
+ */
+static void queue_consume(int16_t length) {
+	while (length > 0) {
+		release_frame();
+		if (frameQueueTail == __atomic_load_n(&frameQueueHead, __ATOMIC_ACQUIRE)) {
+			return;
+		}
+		const uint16_t avail = frameQueue[frameQueueTail & (TCP_FRAME_QUEUE_SIZE - 1)].length - frameReadPos;
+		const uint16_t n = (uint16_t) length < avail ? (uint16_t) length : avail;
+		frameReadPos += n; // Freigabe erst beim naechsten Zugriff, die Daten bleiben bis dahin gueltig
+		length -= (int16_t) n;
+	}
+}
+#endif // BOT_2_SIM_ASYNC_AVAILABLE
+
 /**
  * Uebertrage Daten per TCP/IP
  * \param *data		Zeiger auf die Daten
@@ -177,11 +458,9 @@ static inline int16_t copy2Buffer(const void * data, unsigned length) {
  * \return 			Anzahl der gesendeten Byte, -1 wenn Fehler
  */
 int16_t tcp_write(const void * data, int16_t length) {
-#ifdef ARM_LINUX_BOARD
 	if (tcp_sock == 0) {
-		return 0;
+		return 0; // keine Verbindung (Linux-Board ohne Sim, Replay), Daten verwerfen
 	}
-#endif // ARM_LINUX_BOARD
 	int16_t bytes_sent;
 #ifdef USE_SEND_BUFFER
 	bytes_sent = copy2Buffer(data, length);
@@ -207,14 +486,74 @@ int16_t tcp_read(void * data, int16_t length) {
 	if (tcp_sock == 0 || length == 0) {
 		return 0; // NOP, aber auch kein Programmabbruch noetig
 	}
-	int16_t bytesReceived = 0;
+#ifdef BOT_2_SIM_ASYNC_AVAILABLE
+	if (receiverState) {
+		return queue_read(data, length);
+	}
+#endif
 
-	if ((bytesReceived = recv(tcp_sock, data, length, 0)) <= 0) {
-		printf("recv() failed or connection closed prematurely\n");
-	    exit(1);
+	if (recvBufferWrite == recvBufferRead) {
+		fillRecvBuffer();
+	}
+
+	uint32_t n = recvBufferWrite - recvBufferRead;
+	if (n > (uint32_t) length) {
+		n = (uint32_t) length;
+	}
+	const uint32_t pos = recvBufferRead & (TCP_RECV_BUFFER_SIZE - 1);
+	const uint32_t first = n < TCP_RECV_BUFFER_SIZE - pos ? n : TCP_RECV_BUFFER_SIZE - pos;
+	memcpy(data, &recvBuffer[pos], first);
+	memcpy((uint8_t *) data + first, recvBuffer, n - first);
+	recvBufferRead += n;
+
+	return (int16_t) n;
+}
+
+/**
+ * Stellt length Bytes am Stueck aus dem Empfangspuffer bereit, ohne sie zu entnehmen.
+ * Achtung: blockierend, bis genug Daten empfangen wurden!
+ * \param length	Anzahl der Bytes, maximal MAX_PAYLOAD + sizeof(command_t)
+ * \return			Zeiger auf die Daten, gueltig bis zum naechsten tcp_peek() / tcp_read()
+ */
+void * tcp_peek(int16_t length) {
+	if (tcp_sock == 0 || length <= 0 || length > (int16_t) sizeof(recvLinear)) {
+		return NULL;
+	}
+#ifdef BOT_2_SIM_ASYNC_AVAILABLE
+	if (receiverState) {
+		return queue_peek(length);
+	}
+#endif
+
+	while (recvBufferWrite - recvBufferRead < (uint32_t) length) {
+		fillRecvBuffer();
 	}
 
-	return bytesReceived;
+	const uint32_t pos = recvBufferRead & (TCP_RECV_BUFFER_SIZE - 1);
+	if (pos + (uint32_t) length <= TCP_RECV_BUFFER_SIZE) {
+		return &recvBuffer[pos];
+	}
+
+	/* Daten reichen ueber das Pufferende hinaus */
+	const uint32_t first = TCP_RECV_BUFFER_SIZE - pos;
+	memcpy(recvLinear, &recvBuffer[pos], first);
+	memcpy(&recvLinear[first], recvBuffer, (uint32_t) length - first);
+	return recvLinear;
+}
+
+/**
+ * Entnimmt Daten aus dem Empfangspuffer, die per tcp_peek() gelesen wurden
+ * \param length	Anzahl der Bytes
+ */
+void tcp_consume(int16_t length) {
+#ifdef BOT_2_SIM_ASYNC_AVAILABLE
+	if (receiverState) {
+		queue_consume(length);
+		return;
+	}
+#endif
+	const uint32_t avail = recvBufferWrite - recvBufferRead;
+	recvBufferRead += (uint32_t) length < avail ? (uint32_t) length : avail;
 }
 
 /**
@@ -270,6 +609,7 @@ void * tcp_init_server(void * ptr) {
 
 	/* wait for a client to connect */
 	LOG_INFO("Waiting for TCP client (in background)...");
+	recvBufferRead = recvBufferWrite = 0;
 	if ((tcp_sock = accept(server, (struct sockaddr *) &clientAddr, &clntLen)) < 0) {
 		LOG_ERROR("accept() failed");
 	}
@@ -289,6 +629,10 @@ void * tcp_init_server(void * ptr) {
  * \return Bytes verfuegbar
  */
 int tcp_data_available(void) {
+	const int buffered = (int) (recvBufferWrite - recvBufferRead);
+	if (buffered >= (int) sizeof(command_t)) {
+		return buffered;
+	}
 	int bytes_avail;
 	int ret = ioctl(tcp_sock, FIONREAD, &bytes_avail);
 	if (ret < 0)	{
@@ -298,7 +642,7 @@ int tcp_data_available(void) {
 		return -1;
 	}
 
-	return bytes_avail;
+	return bytes_avail + buffered;
 }
 #endif // __WIN32__
 
@@ -327,6 +671,7 @@ void tcp_init_client(void) {
 	}
 
 	sendBufferPtr = 0; // Puffer leeren
+	recvBufferRead = recvBufferWrite = 0;
 }
 
 /**
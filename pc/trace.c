@@ -37,19 +37,35 @@
 #include "fifo.h"
 #include "sensor.h"
 #include "motor.h"
+#include "rc5.h"
+#include "timer.h"
+#include "delay.h"
 #include "os_thread.h"
+#include "cmd_tools.h"
+#include "botcontrol.h"
+#include "bot-2-sim.h"
+#include "log.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/time.h>
 
-#define TRACEBUFFER_SIZE	255
+#define TRACE_FIFO_SIZE		65535		/**< Groesse des Trace-Puffers [Byte] */
+#define TRACE_RECORD_SIZE	(2 + 255)	/**< Maximale Laenge eines Trace-Eintrags inkl. Typ und Laenge [Byte] */
+#define TRACE_FILE_BUFFER	(1024 * 1024)	/**< Groesse des stdio-Puffers der Trace-Datei, es wird in grossen Bloecken geschrieben [Byte] */
 static fifo_t trace_fifo;
-static uint8_t trace_entries[TRACEBUFFER_SIZE];
-static char trace_buffer[sizeof(trace_entries)][TRACEBUFFER_SIZE];
-static uint8_t buf_index;
+static uint8_t trace_data[TRACE_FIFO_SIZE];
+static uint8_t trace_record[TRACE_RECORD_SIZE]; /**< Puffer fuer einen Eintrag, der nicht am Stueck in die FIFO passt */
+/** Schuetzt trace_begin() bis trace_end(): RemoteCalls kommen auch aus dem Kommandozeilen-Thread, die FIFO erlaubt aber nur einen Schreiber */
+static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;
 static long time_overflow;
 static pthread_t trace_thread;
 static FILE * trace_file = NULL;
 
+static FILE * replay_file = NULL;		/**< Trace-Datei des Replays oder NULL */
+static uint32_t replay_cycles;			/**< Anzahl der abgespielten Zyklen */
+static struct timeval replay_start;		/**< Startzeit des Replays (erster Zyklus) */
+
 void * trace_main(void * data);
 
 /**
@@ -59,75 +75,190 @@ void * trace_main(void * data);
  */
 void * trace_main(void * data) {
 	(void) data; // kein warning
-	uint8_t index = 0;
 	while (42) {
-		fifo_get_data(&trace_fifo, &index, sizeof(index)); // blockierend
-		fwrite(trace_buffer[index], strlen(trace_buffer[index]), 1, trace_file);
-		trace_buffer[index][0] = 0;
+		const void * ptr;
+		const fifo_size_t n = fifo_get_peek(&trace_fifo, &ptr); // blockierend
+		fwrite(ptr, n, 1, trace_file);
+		fifo_get_commit(&trace_fifo, n);
+	}
+}
+
+/**
+ * Schreibt beim Programmende noch gepufferte Eintraege in die Datei
+ */
+static void trace_flush(void) {
+	uint8_t i;
+	for (i = 0; i < 100 && trace_fifo.count != 0; ++i) {
+		delay(1); // Trace-Thread schreibt noch
+	}
+	fflush(trace_file);
+}
+
+/**
+ * Liefert den Speicher fuer den naechsten Trace-Eintrag, wenn moeglich direkt in der FIFO.
+ * Sperrt den Trace-Puffer bis zum zugehoerigen trace_end().
+ * \param type	Typ des Eintrags (TRACE_REC_*)
+ * \return		Zeiger auf TRACE_RECORD_SIZE Bytes, die Nutzdaten beginnen ab Index 2
+ */
+static uint8_t * trace_begin(uint8_t type) {
+	void * ptr;
+	uint8_t * record = trace_record;
+	pthread_mutex_lock(&trace_mutex);
+	if (fifo_put_peek(&trace_fifo, &ptr) >= TRACE_RECORD_SIZE) {
+		record = ptr;
+	}
+	record[0] = type;
+	return record;
+}
+
+/**
+ * Uebergibt einen mit trace_begin() angelegten Eintrag an den Trace-Thread und gibt den Trace-Puffer wieder frei
+ * \param *record	Zeiger auf den Eintrag
+ * \param length	Laenge der Nutzdaten [Byte]
+ */
+static void trace_end(uint8_t * record, uint8_t length) {
+	record[1] = length;
+	if (record == trace_record) {
+		fifo_put_data(&trace_fifo, record, (fifo_size_t) (length + 2), False);
+	} else {
+		fifo_put_commit(&trace_fifo, (fifo_size_t) (length + 2));
 	}
+	pthread_mutex_unlock(&trace_mutex);
 }
 
 /**
- * Initialisiert das Trace-System
+ * Initialisiert das Trace-System. Waehrend eines Replays wird nach replay.bin geschrieben,
+ * damit die abgespielte Datei erhalten bleibt und beide verglichen werden koennen.
  */
 void trace_init(void) {
-	trace_file = fopen("trace.txt", "wb");
+	const char * base = replay_file ? "replay" : "trace";
+	char name[20];
+	if (ctbot_instance) {
+		snprintf(name, sizeof(name), "%s-%u.bin", base, ctbot_instance);
+	} else {
+		snprintf(name, sizeof(name), "%s.bin", base);
+	}
+	trace_file = fopen(name, "wb");
 	if (trace_file != NULL) {
-		fifo_init(&trace_fifo, trace_entries, sizeof(trace_entries));
+		setvbuf(trace_file, NULL, _IOFBF, TRACE_FILE_BUFFER);
+		const uint8_t version = TRACE_VERSION;
+		fwrite(TRACE_MAGIC, 4, 1, trace_file);
+		fwrite(&version, 1, 1, trace_file);
+		fifo_init(&trace_fifo, trace_data, sizeof(trace_data));
 		pthread_create(&trace_thread, NULL, trace_main, NULL);
-		buf_index = 0;
 		time_overflow = 0;
+		atexit(trace_flush);
 	}
 }
 
+/**
+ * Fuegt dem Trace-Puffer die rohen Sensordaten des aktuellen Zyklus hinzu (vor bot_sens())
+ */
+void trace_add_inputs(void) {
+	if (trace_file == NULL) {
+		return;
+	}
+	trace_rec_input_t input;
+	input.simultime = simultime;
+	input.enc_l = sensEncL;
+	input.enc_r = sensEncR;
+	input.dist_l = sensDistL;
+	input.dist_r = sensDistR;
+	input.dist_l_toggle = sensDistLToggle;
+	input.dist_r_toggle = sensDistRToggle;
+	input.border_l = sensBorderL;
+	input.border_r = sensBorderR;
+	input.line_l = sensLineL;
+	input.line_r = sensLineR;
+	input.ldr_l = sensLDRL;
+	input.ldr_r = sensLDRR;
+#ifdef BPS_AVAILABLE
+	input.bps = sensBPS;
+#else
+	input.bps = 0;
+#endif
+#ifdef RC5_AVAILABLE
+	input.rc5 = rc5_ir_data.ir_data;
+#else
+	input.rc5 = 0;
+#endif
+	input.trans = sensTrans;
+	input.door = sensDoor;
+	input.error = sensError;
+#ifdef MOUSE_AVAILABLE
+	input.mouse_dx = sensMouseDX;
+	input.mouse_dy = sensMouseDY;
+#else
+	input.mouse_dx = 0;
+	input.mouse_dy = 0;
+#endif
+
+	uint8_t * record = trace_begin(TRACE_REC_INPUT);
+	memcpy(&record[2], &input, sizeof(input));
+	trace_end(record, sizeof(input));
+}
+
 /**
  * Fuegt dem Trace-Puffer die aktuellen Sensordaten hinzu
  */
 void trace_add_sensors(void) {
+	if (trace_file == NULL) {
+		return;
+	}
 	if (simultime == 0) {
 		time_overflow++;
 	}
-	long time = simultime + time_overflow * 10000;
-	int n = snprintf(trace_buffer[buf_index], TRACEBUFFER_SIZE, "time=\t%ld\tencL=\t%+d\tencR=\t%+d\tsensDistL=\t%+d\tsensDistR=\t%+d\tRC5_Code=\t0x%04x",
-		time, sensEncL, sensEncR, sensDistL, sensDistR, RC5_Code);
+	trace_rec_sensors_t sensors;
+	sensors.time = (int32_t) (simultime + time_overflow * 10000);
+	sensors.enc_l = sensEncL;
+	sensors.enc_r = sensEncR;
+	sensors.dist_l = sensDistL;
+	sensors.dist_r = sensDistR;
+	sensors.rc5 = RC5_Code;
 #ifdef BPS_AVAILABLE
-	if (n < TRACEBUFFER_SIZE) {
-		n += snprintf(&trace_buffer[buf_index][n], TRACEBUFFER_SIZE - n, "\tsensBPS=\t%u", sensBPS);
-	}
+	sensors.bps = sensBPS;
+	sensors.flags = TRACE_SENSORS_BPS;
+#else
+	sensors.bps = 0;
+	sensors.flags = 0;
 #endif // BPS_AVAILABLE
-	if (n < TRACEBUFFER_SIZE) {
-		n += snprintf(&trace_buffer[buf_index][n], TRACEBUFFER_SIZE - n, "\theading=\t%+.12f\tx_enc=\t%+.12f\ty_enc=\t%+.12f\tx_pos=\t%+d\ty_pos=\t%+d\n",
-			(double) heading, (double) x_enc, (double) y_enc, x_pos, y_pos);
-	}
+	sensors.heading = heading;
+	sensors.x_enc = x_enc;
+	sensors.y_enc = y_enc;
+	sensors.x_pos = x_pos;
+	sensors.y_pos = y_pos;
 
-	fifo_put_data(&trace_fifo, &buf_index, sizeof(buf_index), False);
-	buf_index++;
-	buf_index %= sizeof(trace_entries);
+	uint8_t * record = trace_begin(TRACE_REC_SENSORS);
+	memcpy(&record[2], &sensors, sizeof(sensors));
+	trace_end(record, sizeof(sensors));
 }
 
 /**
  * Fuegt dem Tace-Puffer die aktuellen Aktuatordaten hinzu
  */
 void trace_add_actuators(void) {
-	long time = simultime + time_overflow * 10000;
-	int n = snprintf(trace_buffer[buf_index], TRACEBUFFER_SIZE, "time=\t%ld\tmotorL=\t%+d\tmotorR=\t%+d", time, motor_left, motor_right);
+	if (trace_file == NULL) {
+		return;
+	}
+	trace_rec_actuators_t actuators;
+	actuators.time = (int32_t) (simultime + time_overflow * 10000);
+	actuators.motor_l = motor_left;
+	actuators.motor_r = motor_right;
+
+	uint8_t * record = trace_begin(TRACE_REC_ACTUATORS);
+	memcpy(&record[2], &actuators, sizeof(actuators));
+	uint8_t n = sizeof(actuators);
 
 #ifdef BEHAVIOUR_AVAILABLE
 	Behaviour_t * ptr = get_next_behaviour(NULL);
 	do {
-		if (ptr->active == BEHAVIOUR_ACTIVE && n < TRACEBUFFER_SIZE) {
-			n += snprintf(&trace_buffer[buf_index][n], TRACEBUFFER_SIZE - n, "\tbeh=\t%u", ptr->priority);
+		if (ptr->active == BEHAVIOUR_ACTIVE && n < TRACE_RECORD_SIZE - 2) {
+			record[2 + n++] = ptr->priority;
 		}
 	} while ((ptr = get_next_behaviour(ptr)) != NULL);
 #endif // BEHAVIOUR_AVAILABLE
 
-	if (n < TRACEBUFFER_SIZE) {
-		snprintf(&trace_buffer[buf_index][n], TRACEBUFFER_SIZE - n, "\n");
-	}
-
-	fifo_put_data(&trace_fifo, &buf_index, sizeof(buf_index), False);
-	buf_index++;
-	buf_index %= sizeof(trace_entries);
+	trace_end(record, n);
 }
 
 #ifdef BEHAVIOUR_REMOTECALL_AVAILABLE
@@ -136,25 +267,270 @@ void trace_add_actuators(void) {
  * \param *fkt_name		Funktionsname des RemoteCalls
  * \param param_count	Anzahl der RemoteCall-Parameter
  * \param *params		Zeiger auf RemoteCall-Parameterdaten
+ * \param external		1, falls der RemoteCall von aussen (Sim oder Konsole) kommt
  */
-void trace_add_remotecall(const char * fkt_name, uint8_t param_count, remote_call_data_t * params) {
-	long time = simultime + time_overflow * 10000;
+void trace_add_remotecall(const char * fkt_name, uint8_t param_count, remote_call_data_t * params, uint8_t external) {
+	if (trace_file == NULL) {
+		return;
+	}
+	trace_rec_remotecall_t remotecall;
+	remotecall.time = (int32_t) (simultime + time_overflow * 10000);
+	remotecall.flags = external ? TRACE_REMOTECALL_EXT : 0;
+	remotecall.param_count = param_count;
 
-	int n = snprintf(trace_buffer[buf_index], TRACEBUFFER_SIZE, "time=\t%ld\tRemoteCall=\t%s(", time, fkt_name);
+	uint8_t * record = trace_begin(TRACE_REC_REMOTECALL);
+	memcpy(&record[2], &remotecall, sizeof(remotecall));
+	uint8_t n = sizeof(remotecall);
 	uint8_t i;
 	for (i = 0; i < param_count; ++i) {
-		if (n < TRACEBUFFER_SIZE) {
-			n += snprintf(&trace_buffer[buf_index][n], TRACEBUFFER_SIZE - n, "%d, ", params[i].s16);
+		memcpy(&record[2 + n], &params[i].u32, sizeof(uint32_t));
+		n = (uint8_t) (n + sizeof(uint32_t));
+	}
+	size_t len = strlen(fkt_name);
+	if (len > REMOTE_CALL_FUNCTION_NAME_LEN) {
+		len = REMOTE_CALL_FUNCTION_NAME_LEN;
+	}
+	memcpy(&record[2 + n], fkt_name, len);
+	n = (uint8_t) (n + len);
+
+	trace_end(record, n);
+}
+#endif // BEHAVIOUR_REMOTECALL_AVAILABLE
+
+/**
+ * Oeffnet eine binaere Trace-Datei zum Lesen und prueft den Kopf
+ * \param *name	Dateiname
+ * \param **pp_file	Zeiger auf die geoeffnete Datei, falls alles OK
+ * \return		0, falls alles OK; -1 Datei nicht lesbar, -2 keine Trace-Datei
+ */
+static int8_t trace_open(const char * name, FILE ** pp_file) {
+	FILE * file = fopen(name, "rb");
+	if (file == NULL) {
+		return -1;
+	}
+	char magic[4];
+	uint8_t version;
+	if (fread(magic, sizeof(magic), 1, file) != 1 || memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0
+		|| fread(&version, 1, 1, file) != 1 || version != TRACE_VERSION) {
+		fclose(file);
+		return -2;
+	}
+	setvbuf(file, NULL, _IOFBF, TRACE_FILE_BUFFER);
+	*pp_file = file;
+	return 0;
+}
+
+/**
+ * Liest den naechsten Eintrag aus einer binaeren Trace-Datei
+ * \param *file		Trace-Datei
+ * \param *record	Puffer fuer TRACE_RECORD_SIZE Bytes
+ * \return			0, falls alles OK; -1 am Dateiende oder bei einem unvollstaendigen Eintrag
+ */
+static int8_t trace_read(FILE * file, uint8_t * record) {
+	if (fread(record, 2, 1, file) != 1) {
+		return -1;
+	}
+	if (record[1] != 0 && fread(&record[2], record[1], 1, file) != 1) {
+		return -1;
+	}
+	/* kuerzere Eintraege (aeltere Version) mit 0 auffuellen */
+	memset(&record[2 + record[1]], 0, (size_t) (TRACE_RECORD_SIZE - 2 - record[1]));
+	return 0;
+}
+
+/**
+ * Wandelt eine binaere Trace-Datei in das Textformat um
+ * \param *from	Name der binaeren Trace-Datei
+ * \param *to	Name der Textdatei
+ * \return		0, falls alles OK; -1 Datei nicht lesbar, -2 keine Trace-Datei, -3 Ausgabe fehlgeschlagen
+ */
+int8_t trace_convert(const char * from, const char * to) {
+	FILE * in;
+	const int8_t res = trace_open(from, &in);
+	if (res != 0) {
+		return res;
+	}
+	FILE * out = fopen(to, "wb");
+	if (out == NULL) {
+		fclose(in);
+		return -3;
+	}
+	setvbuf(out, NULL, _IOFBF, TRACE_FILE_BUFFER);
+
+	uint8_t record[TRACE_RECORD_SIZE];
+	while (trace_read(in, record) == 0) {
+		const uint8_t * payload = &record[2];
+		switch (record[0]) {
+		case TRACE_REC_SENSORS: {
+			trace_rec_sensors_t sensors;
+			memcpy(&sensors, payload, sizeof(sensors));
+			fprintf(out, "time=\t%ld\tencL=\t%+d\tencR=\t%+d\tsensDistL=\t%+d\tsensDistR=\t%+d\tRC5_Code=\t0x%04x",
+				(long) sensors.time, sensors.enc_l, sensors.enc_r, sensors.dist_l, sensors.dist_r, sensors.rc5);
+			if (sensors.flags & TRACE_SENSORS_BPS) {
+				fprintf(out, "\tsensBPS=\t%u", sensors.bps);
+			}
+			fprintf(out, "\theading=\t%+.12f\tx_enc=\t%+.12f\ty_enc=\t%+.12f\tx_pos=\t%+d\ty_pos=\t%+d\n",
+				(double) sensors.heading, (double) sensors.x_enc, (double) sensors.y_enc, sensors.x_pos, sensors.y_pos);
+			break;
+		}
+
+		case TRACE_REC_ACTUATORS: {
+			trace_rec_actuators_t actuators;
+			memcpy(&actuators, payload, sizeof(actuators));
+			fprintf(out, "time=\t%ld\tmotorL=\t%+d\tmotorR=\t%+d", (long) actuators.time, actuators.motor_l, actuators.motor_r);
+			uint8_t i;
+			for (i = sizeof(actuators); i < record[1]; ++i) {
+				fprintf(out, "\tbeh=\t%u", payload[i]);
+			}
+			fputc('\n', out);
+			break;
+		}
+
+		case TRACE_REC_REMOTECALL: {
+			trace_rec_remotecall_t remotecall;
+			memcpy(&remotecall, payload, sizeof(remotecall));
+			const uint8_t name = (uint8_t) (sizeof(remotecall) + remotecall.param_count * sizeof(uint32_t));
+			if (name > record[1]) {
+				break; // defekter Eintrag
+			}
+			fprintf(out, "time=\t%ld\tRemoteCall=\t%.*s(", (long) remotecall.time, record[1] - name, (const char *) &payload[name]);
+			uint8_t i;
+			for (i = 0; i < remotecall.param_count; ++i) {
+				uint32_t param;
+				memcpy(&param, &payload[sizeof(remotecall) + i * sizeof(uint32_t)], sizeof(param));
+				fprintf(out, i == 0 ? "%d" : ", %d", (int16_t) param); // wie remote_call_data_t.s16
+			}
+			fputs(")\n", out);
+			break;
+		}
+
+		default:
+			/* TRACE_REC_INPUT gibt es im Textformat nicht */
+			break;
 		}
 	}
-	trace_buffer[buf_index][n - 2] = ')';
-	trace_buffer[buf_index][n - 1] = '\n';
 
-	fifo_put_data(&trace_fifo, &buf_index, sizeof(buf_index), False);
-	buf_index++;
-	buf_index %= sizeof(trace_entries);
+	fclose(in);
+	return fclose(out) == 0 ? 0 : -3;
+}
+
+/**
+ * Schaltet auf Replay um: Die Sensordaten kommen danach aus einer binaeren Trace-Datei statt vom Sim
+ * \param *file	Name der binaeren Trace-Datei
+ * \return		0, falls alles OK; -1 Datei nicht lesbar, -2 keine Trace-Datei
+ */
+int8_t trace_replay_open(const char * file) {
+	const int8_t res = trace_open(file, &replay_file);
+	replay_cycles = 0;
+	return res;
+}
+
+/**
+ * Prueft, ob ein Replay laeuft
+ * \return	1, falls die Sensordaten aus einer Trace-Datei kommen, sonst 0
+ */
+uint8_t trace_replay_active(void) {
+	return replay_file != NULL;
+}
+
+/**
+ * Beendet das Replay und gibt die Anzahl der Zyklen und die Laufzeit aus
+ */
+static void trace_replay_end(void) {
+	struct timeval end;
+	GETTIMEOFDAY(&end, NULL);
+	const double secs = (double) (end.tv_sec - replay_start.tv_sec) + (double) (end.tv_usec - replay_start.tv_usec) / 1000000.0;
+	printf("Replay beendet: %" PRIu32 " Zyklen in %.3f s, %.0f Zyklen/s\n", replay_cycles, secs, secs > 0.0 ? replay_cycles / secs : 0.0);
+	fclose(replay_file);
+	replay_file = NULL;
+	ctbot_shutdown(); // beendet das Programm
+}
+
+#ifdef BEHAVIOUR_REMOTECALL_AVAILABLE
+/**
+ * Startet einen aufgezeichneten RemoteCall erneut, falls er von aussen kam
+ * \param *record	Eintrag vom Typ TRACE_REC_REMOTECALL
+ */
+static void trace_replay_remotecall(const uint8_t * record) {
+	trace_rec_remotecall_t remotecall;
+	memcpy(&remotecall, &record[2], sizeof(remotecall));
+	const uint8_t name = (uint8_t) (sizeof(remotecall) + remotecall.param_count * sizeof(uint32_t));
+	if (! (remotecall.flags & TRACE_REMOTECALL_EXT) || remotecall.param_count > REMOTE_CALL_MAX_PARAM || name > record[1]) {
+		return; // Verhalten starten den RemoteCall im Replay selbst
+	}
+	remote_call_data_t params[REMOTE_CALL_MAX_PARAM];
+	memcpy(params, &record[2 + sizeof(remotecall)], remotecall.param_count * sizeof(uint32_t));
+	char func[REMOTE_CALL_FUNCTION_NAME_LEN + 1];
+	uint8_t len = (uint8_t) (record[1] - name);
+	if (len > REMOTE_CALL_FUNCTION_NAME_LEN) {
+		len = REMOTE_CALL_FUNCTION_NAME_LEN;
+	}
+	memcpy(func, &record[2 + name], len);
+	func[len] = 0;
+	if (bot_remotecall(NULL, func, params) != 0) {
+		LOG_ERROR("Replay: RemoteCall \"%s\" nicht gestartet", func);
+	}
 }
 #endif // BEHAVIOUR_REMOTECALL_AVAILABLE
 
+/**
+ * Uebernimmt die Sensordaten des naechsten Zyklus aus der Trace-Datei (Ersatz fuer bot_2_sim_listen()).
+ * Am Ende der Datei werden Statistiken ausgegeben und das Programm beendet.
+ */
+void trace_replay_step(void) {
+	uint8_t record[TRACE_RECORD_SIZE];
+	if (replay_cycles == 0) {
+		GETTIMEOFDAY(&replay_start, NULL); // ohne Initialisierung messen
+	}
+	while (trace_read(replay_file, record) == 0) {
+		if (record[0] == TRACE_REC_REMOTECALL) {
+#ifdef BEHAVIOUR_REMOTECALL_AVAILABLE
+			trace_replay_remotecall(record);
+#endif
+			continue;
+		}
+		if (record[0] != TRACE_REC_INPUT) {
+			continue; // Ergebnisse der Aufzeichnung, werden neu berechnet
+		}
+
+		trace_rec_input_t input;
+		memcpy(&input, &record[2], sizeof(input));
+		sensEncL = input.enc_l;
+		sensEncR = input.enc_r;
+		sensDistL = input.dist_l;
+		sensDistR = input.dist_r;
+		sensDistLToggle = input.dist_l_toggle;
+		sensDistRToggle = input.dist_r_toggle;
+		sensBorderL = input.border_l;
+		sensBorderR = input.border_r;
+		sensLineL = input.line_l;
+		sensLineR = input.line_r;
+		sensLDRL = input.ldr_l;
+		sensLDRR = input.ldr_r;
+#ifdef BPS_AVAILABLE
+		sensBPS = input.bps;
+#endif
+#ifdef RC5_AVAILABLE
+		rc5_ir_data.ir_data = input.rc5;
+#endif
+		sensTrans = input.trans;
+		sensDoor = input.door;
+		sensError = input.error;
+#ifdef MOUSE_AVAILABLE
+		sensMouseDX = input.mouse_dx;
+		sensMouseDY = input.mouse_dy;
+#endif
+
+		/* wie CMD_DONE vom Sim */
+		simultime = input.simultime;
+		system_time_isr();
+		os_thread_wakeup();
+		++replay_cycles;
+		return;
+	}
+
+	trace_replay_end();
+}
+
 #endif // CREATE_TRACEFILE_AVAILABLE
 #endif // PC
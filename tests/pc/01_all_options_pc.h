@@ -68,5 +68,6 @@
 #define POS_STORE_AVAILABLE					/**< Positionsspeicher vorhanden */
 #define OS_AVAILABLE							/**< Aktiviert BotOS fuer Threads und Scheduling */
 #define ARM_LINUX_BOARD						/**< Code fuer ARM-Linux Board aktivieren, wenn ein ARM-Linux-* Target ausgewaehlt wurde. Fuehrt den high-level Code und die Verhalten aus */
+#define CMD_SNAPSHOT_AVAILABLE				/**< Sensor- bzw. Aktuatorwerte eines Zyklus als ein Snapshot-Kommando uebertragen, sofern die Gegenstelle (ATmega, Linux-Board oder Sim) das unterstuetzt */
 
 #endif /* INCLUDE_BOT_LOCAL_OVERRIDE_H_ */
@@ -56,6 +56,38 @@ for filename in $MYDIR/pc/*.h; do
 
 done
 
+if [ "$#" -eq 0 ]; then
+	# runtime test: driving with scan on the fly in the offline sim has to run much faster than real time,
+	# os_thread_sleep() in the main thread (bot_scan_onthefly_behaviour()) must not stall the simulation
+	filename=$MYDIR/pc/20_all_behaviours_pc.h
+	echo "offline sim scan test with \"$filename\""
+	cp $filename $MYDIR/../bot-local-override.h
+	make DEVICE=PC WERROR=1 TESTRUN=1 -j$cores >/dev/null
+	rc=$?
+	rm $MYDIR/../bot-local-override.h
+	result=""
+	if [[ $rc == 0 ]]; then
+		result=$(timeout 120 ./ct-Bot -w arena -n 30000 -R "bot_drive_area()" </dev/null 2>&1 | grep -a "Offline-Sim beendet")
+		echo "$result"
+		# fixed-point neural net has to match the float net and the reference outputs of neuralnet_fixed_data.inc
+		echo "neuralnet-fixed test"
+		timeout 120 ./ct-Bot -b neuralnet-fixed </dev/null
+		nn_rc=$?
+	fi
+	rm -f ctbot.map trace.txt trace.bin nn-bench.bin nn-bench.tmp
+	make DEVICE=PC clean >/dev/null
+	factor=$(echo "$result" | sed -n 's/.*, \([0-9.]*\)x Echtzeit.*/\1/p')
+	if [ -z "$factor" ] || awk "BEGIN { exit !($factor < 10) }"; then
+		echo ""; echo ""; echo "OFFLINE SIM SCAN TEST FOR PC FAILED."; echo ""; echo ""
+		exit 1
+	fi
+	if [[ $nn_rc != 0 ]]; then
+		echo ""; echo ""; echo "NEURALNET-FIXED TEST FOR PC FAILED."; echo ""; echo ""
+		exit 1
+	fi
+	echo ""
+fi
+
 echo ""; echo ""; echo "ALL TESTS FOR PC PASSED."; echo ""; echo ""
 
 exit 0;
@@ -139,7 +139,7 @@ EEPROM uint8_t gui_keypad_table[][5] = {
 #undef DISPLAY_ABL_STACK_AVAILABLE
 #endif
 
-#ifndef BEHAVIOUR_DRIVE_NEURALNET_AVAILABLE
+#if ! defined BEHAVIOUR_DRIVE_NEURALNET_AVAILABLE || defined NEURALNET_FIXED_AVAILABLE
 #undef DISPLAY_DRIVE_NEURALNET_AVAILABLE
 #endif
 